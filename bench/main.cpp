@@ -0,0 +1,644 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*
+    psimpl-bench - benchmarks of all psimpl algorithms
+
+    Runs each algorithm for each combination of input shape, value type, dimension, container and
+    polyline size, and reports the time per point, throughput, heap allocations and peak memory use as a
+    table, CSV or JSON.
+*/
+
+#include "../lib/psimpl.h"
+#include "../test/generators.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <list>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+
+// ------------------------------------------------------------------------------------------------
+// heap allocation counting
+
+namespace {
+    std::atomic <std::size_t> allocationCount (0);     // number of allocations
+    std::atomic <std::size_t> allocationBytes (0);     // number of allocated bytes
+    std::atomic <std::size_t> heapBytes (0);           // number of bytes currently allocated
+    std::atomic <std::size_t> heapPeakBytes (0);       // maximum of heapBytes since the last reset
+
+    // each allocation is prefixed by its size, keeping the alignment of malloc
+    const std::size_t HEADER_SIZE = 16;
+
+    void* Allocate (std::size_t size) {
+        void* block = std::malloc (size + HEADER_SIZE);
+        if (!block) {
+            throw std::bad_alloc ();
+        }
+        *static_cast <std::size_t*> (block) = size;
+        ++allocationCount;
+        allocationBytes += size;
+        std::size_t current = heapBytes += size;
+        std::size_t peak = heapPeakBytes;
+        while (peak < current && !heapPeakBytes.compare_exchange_weak (peak, current)) {}
+        return static_cast <char*> (block) + HEADER_SIZE;
+    }
+
+    void Release (void* ptr) {
+        if (ptr) {
+            void* block = static_cast <char*> (ptr) - HEADER_SIZE;
+            heapBytes -= *static_cast <std::size_t*> (block);
+            std::free (block);
+        }
+    }
+}
+
+void* operator new (std::size_t size) { return Allocate (size); }
+void* operator new [] (std::size_t size) { return Allocate (size); }
+void operator delete (void* ptr) throw () { Release (ptr); }
+void operator delete [] (void* ptr) throw () { Release (ptr); }
+
+
+namespace psimpl {
+    namespace bench
+{
+    enum Algorithm {
+        NTH_POINT,
+        RADIAL_DISTANCE,
+        PERPENDICULAR_DISTANCE,
+        PERPENDICULAR_DISTANCE_REPEAT,
+        REUMANN_WITKAM,
+        OPHEIM,
+        LANG,
+        DOUGLAS_PEUCKER,
+        DOUGLAS_PEUCKER_N,
+        POSITIONAL_ERRORS,
+        POSITIONAL_ERROR_STATISTICS,
+        ALGORITHM_COUNT
+    };
+
+    const char* algorithmNames [] = {
+        "np", "rd", "pd", "pd4", "rw", "op", "la", "dp", "dpn", "pe", "pes"
+    };
+
+    // QVector iterators are plain pointers, so 'array' also covers the QVector container
+    enum Container {
+        CONTAINER_ARRAY,
+        CONTAINER_VECTOR,
+        CONTAINER_DEQUE,
+        CONTAINER_LIST,
+        CONTAINER_COUNT
+    };
+
+    const char* containerNames [] = { "array", "vector", "deque", "list" };
+
+    enum ValueType {
+        TYPE_FLOAT,
+        TYPE_DOUBLE,
+        TYPE_INT,
+        TYPE_COUNT
+    };
+
+    const char* typeNames [] = { "float", "double", "int" };
+
+    enum Shape {
+        SHAPE_WALK,
+        SHAPE_SPIRAL,
+        SHAPE_GPS,
+        SHAPE_ZIGZAG,
+        SHAPE_COASTLINE,
+        SHAPE_DWELL,
+        SHAPE_COUNT
+    };
+
+    const char* shapeNames [] = { "walk", "spiral", "gps", "zigzag", "coast", "dwell" };
+
+    enum Format {
+        FORMAT_TABLE,
+        FORMAT_CSV,
+        FORMAT_JSON
+    };
+
+    //! \brief Command line options.
+    struct Options {
+        std::vector <bool> algorithms = std::vector <bool> (ALGORITHM_COUNT, true);
+        std::vector <bool> shapes = std::vector <bool> (SHAPE_COUNT, false);
+        std::vector <bool> types = std::vector <bool> (TYPE_COUNT, true);
+        std::vector <bool> containers = std::vector <bool> (CONTAINER_COUNT, true);
+        std::vector <unsigned> dims = { 2, 3 };
+        std::vector <std::size_t> sizes = { 100, 1000, 10000, 100000, 1000000 };
+        double tol = 1;                 //!< distance tolerance
+        double minTime = 0.2;           //!< minimum measurement time per benchmark, in seconds
+        unsigned minRuns = 3;           //!< minimum number of measured runs per benchmark
+        unsigned seed = 1;              //!< generator seed
+        Format format = FORMAT_TABLE;
+    };
+
+    //! \brief The measurements of a single benchmark.
+    struct Result {
+        const char* shape;
+        const char* algorithm;
+        const char* type;
+        unsigned dim;
+        const char* container;
+        std::size_t points;
+        std::size_t outputPoints;       //!< number of output points, or errors
+        unsigned runs;                  //!< number of measured runs
+        double minSeconds;              //!< fastest run
+        double medianSeconds;           //!< median run
+        double allocations;             //!< number of heap allocations per run
+        double allocatedBytes;          //!< number of allocated bytes per run
+        std::size_t peakHeapBytes;      //!< maximum heap size during a run, above the input
+        std::size_t peakRssKb;          //!< peak resident set size of the process
+    };
+
+    // --------------------------------------------------------------------------------------------
+
+    //! \brief Returns the peak resident set size of the process, in KB.
+    std::size_t PeakRssKb () {
+    #if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo (GetCurrentProcess (), &counters, sizeof (counters))) {
+            return counters.PeakWorkingSetSize / 1024;
+        }
+        return 0;
+    #else
+        struct rusage usage;
+        if (getrusage (RUSAGE_SELF, &usage)) {
+            return 0;
+        }
+    #if defined(__APPLE__)
+        return usage.ru_maxrss / 1024;
+    #else
+        return usage.ru_maxrss;
+    #endif
+    #endif
+    }
+
+    //! \brief Generates the input polyline.
+    template <unsigned DIM, class T>
+    std::vector <T> Generate (Shape shape, std::size_t count, unsigned seed, double scale) {
+        using namespace psimpl::test;
+        switch (shape) {
+        case SHAPE_WALK:        return test::Generate <DIM, T> (WalkGenerator <DIM> (seed, 10 * scale), count);
+        case SHAPE_SPIRAL:      return test::Generate <DIM, T> (SpiralGenerator <DIM> (100, 10 * scale), count);
+        case SHAPE_GPS:         return test::Generate <DIM, T> (GpsGenerator <DIM> (seed, 10 * scale, 0.5 * scale), count);
+        case SHAPE_ZIGZAG:      return test::Generate <DIM, T> (ZigZagGenerator <DIM> (count, 10 * scale, 10 * scale), count);
+        case SHAPE_COASTLINE:   return test::Generate <DIM, T> (CoastlineGenerator <DIM> (count, seed, 10 * scale), count);
+        case SHAPE_DWELL:       return test::Generate <DIM, T> (DwellGenerator <DIM> (seed, 100, 1000, 10 * scale), count);
+        case SHAPE_COUNT:       break;
+        }
+        return std::vector <T> ();
+    }
+
+    //! \brief Runs an algorithm once, returns the number of output points, or errors.
+    template <unsigned DIM, class Iterator, class T>
+    std::size_t Simplify (Algorithm algorithm, T tol, Iterator first, Iterator last,
+                          Iterator simplifiedFirst, Iterator simplifiedLast, std::vector <T>& result)
+    {
+        result.clear ();
+        std::back_insert_iterator <std::vector <T> > out (result);
+        std::size_t pointCount = std::distance (first, last) / DIM;
+        switch (algorithm) {
+        case NTH_POINT:
+            simplify_nth_point <DIM> (first, last, 4, out);
+            break;
+        case RADIAL_DISTANCE:
+            simplify_radial_distance <DIM> (first, last, tol, out);
+            break;
+        case PERPENDICULAR_DISTANCE:
+            simplify_perpendicular_distance <DIM> (first, last, tol, out);
+            break;
+        case PERPENDICULAR_DISTANCE_REPEAT:
+            simplify_perpendicular_distance <DIM> (first, last, tol, 4, out);
+            break;
+        case REUMANN_WITKAM:
+            simplify_reumann_witkam <DIM> (first, last, tol, out);
+            break;
+        case OPHEIM:
+            simplify_opheim <DIM> (first, last, tol, static_cast <T> (tol * 4), out);
+            break;
+        case LANG:
+            simplify_lang <DIM> (first, last, tol, 8, out);
+            break;
+        case DOUGLAS_PEUCKER:
+            simplify_douglas_peucker <DIM> (first, last, tol, out);
+            break;
+        case DOUGLAS_PEUCKER_N:
+            simplify_douglas_peucker_n <DIM> (first, last, std::max <unsigned> (2, pointCount / 20), out);
+            break;
+        case POSITIONAL_ERRORS:
+            compute_positional_errors2 <DIM> (first, last, simplifiedFirst, simplifiedLast, out);
+            return result.size ();
+        case POSITIONAL_ERROR_STATISTICS:
+            compute_positional_error_statistics <DIM> (first, last, simplifiedFirst, simplifiedLast);
+            return pointCount;
+        case ALGORITHM_COUNT:
+            break;
+        }
+        return result.size () / DIM;
+    }
+
+    //! \brief Measures an algorithm until both the minimum time and run count are reached.
+    template <unsigned DIM, class Iterator, class T>
+    Result Measure (const Options& options, Algorithm algorithm, T tol, Iterator first, Iterator last,
+                    Iterator simplifiedFirst, Iterator simplifiedLast)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        Result result = Result ();
+        result.algorithm = algorithmNames [algorithm];
+        result.points = std::distance (first, last) / DIM;
+
+        std::vector <T> output;
+        output.reserve (std::distance (first, last));
+        // warm up, and measure allocations of a single run
+        std::size_t count = allocationCount;
+        std::size_t bytes = allocationBytes;
+        std::size_t baseHeap = heapBytes;
+        heapPeakBytes = baseHeap;
+        result.outputPoints = Simplify <DIM> (algorithm, tol, first, last, simplifiedFirst, simplifiedLast, output);
+        result.allocations = static_cast <double> (allocationCount - count);
+        result.allocatedBytes = static_cast <double> (allocationBytes - bytes);
+        result.peakHeapBytes = heapPeakBytes - baseHeap;
+
+        std::vector <double> seconds;
+        double total = 0;
+        while (seconds.size () < options.minRuns || total < options.minTime) {
+            Clock::time_point start = Clock::now ();
+            Simplify <DIM> (algorithm, tol, first, last, simplifiedFirst, simplifiedLast, output);
+            double elapsed = std::chrono::duration <double> (Clock::now () - start).count ();
+            seconds.push_back (elapsed);
+            total += elapsed;
+        }
+        std::sort (seconds.begin (), seconds.end ());
+        result.runs = static_cast <unsigned> (seconds.size ());
+        result.minSeconds = seconds.front ();
+        result.medianSeconds = seconds [seconds.size () / 2];
+        result.peakRssKb = PeakRssKb ();
+        return result;
+    }
+
+    // --------------------------------------------------------------------------------------------
+
+    //! \brief Writes benchmark results in the selected format.
+    class Report {
+    public:
+        explicit Report (Format format) :
+            mFormat (format),
+            mCount (0)
+        {
+            switch (mFormat) {
+            case FORMAT_TABLE:
+                std::printf ("%-6s %-5s %-6s %3s %-6s %10s %10s %10s %12s %10s %12s %12s %10s\n",
+                             "shape", "algo", "type", "dim", "cont", "points", "ns/point", "Mpoints/s",
+                             "out points", "allocs", "alloc bytes", "peak heap", "peak rss");
+                break;
+            case FORMAT_CSV:
+                std::printf ("shape,algorithm,type,dim,container,points,runs,min_ns,median_ns,ns_per_point,"
+                             "points_per_second,output_points,allocations,allocated_bytes,"
+                             "peak_heap_bytes,peak_rss_kb\n");
+                break;
+            case FORMAT_JSON:
+                std::printf ("[");
+                break;
+            }
+            std::fflush (stdout);
+        }
+
+        ~Report () {
+            if (mFormat == FORMAT_JSON) {
+                std::printf ("%s]\n", mCount ? "\n" : "");
+            }
+        }
+
+        void Write (const Result& r) {
+            double nsPerPoint = r.minSeconds * 1e9 / r.points;
+            double pointsPerSecond = r.minSeconds > 0 ? r.points / r.minSeconds : 0;
+            switch (mFormat) {
+            case FORMAT_TABLE:
+                std::printf ("%-6s %-5s %-6s %3u %-6s %10zu %10.2f %10.2f %12zu %10.0f %12.0f %12zu %10zu\n",
+                             r.shape, r.algorithm, r.type, r.dim, r.container, r.points, nsPerPoint,
+                             pointsPerSecond / 1e6, r.outputPoints, r.allocations, r.allocatedBytes,
+                             r.peakHeapBytes, r.peakRssKb);
+                break;
+            case FORMAT_CSV:
+                std::printf ("%s,%s,%s,%u,%s,%zu,%u,%.0f,%.0f,%.4f,%.0f,%zu,%.0f,%.0f,%zu,%zu\n",
+                             r.shape, r.algorithm, r.type, r.dim, r.container, r.points, r.runs,
+                             r.minSeconds * 1e9, r.medianSeconds * 1e9, nsPerPoint, pointsPerSecond,
+                             r.outputPoints, r.allocations, r.allocatedBytes, r.peakHeapBytes,
+                             r.peakRssKb);
+                break;
+            case FORMAT_JSON:
+                std::printf ("%s\n  {\"shape\": \"%s\", \"algorithm\": \"%s\", \"type\": \"%s\", \"dim\": %u, "
+                             "\"container\": \"%s\", \"points\": %zu, \"runs\": %u, "
+                             "\"min_ns\": %.0f, \"median_ns\": %.0f, \"ns_per_point\": %.4f, "
+                             "\"points_per_second\": %.0f, \"output_points\": %zu, "
+                             "\"allocations\": %.0f, \"allocated_bytes\": %.0f, "
+                             "\"peak_heap_bytes\": %zu, \"peak_rss_kb\": %zu}",
+                             mCount ? "," : "", r.shape, r.algorithm, r.type, r.dim, r.container, r.points,
+                             r.runs, r.minSeconds * 1e9, r.medianSeconds * 1e9, nsPerPoint,
+                             pointsPerSecond, r.outputPoints, r.allocations, r.allocatedBytes,
+                             r.peakHeapBytes, r.peakRssKb);
+                break;
+            }
+            ++mCount;
+            std::fflush (stdout);
+        }
+
+    private:
+        Format mFormat;
+        std::size_t mCount;
+    };
+
+    // --------------------------------------------------------------------------------------------
+
+    //! \brief Runs all selected algorithms on a single container.
+    template <unsigned DIM, class Iterator, class T>
+    void RunAlgorithms (const Options& options, Report& report, Shape shape, const char* type, Container container,
+                        T tol, Iterator first, Iterator last, Iterator simplifiedFirst, Iterator simplifiedLast)
+    {
+        for (unsigned a = 0; a < ALGORITHM_COUNT; ++a) {
+            if (!options.algorithms [a]) {
+                continue;
+            }
+            Result result = Measure <DIM> (options, static_cast <Algorithm> (a), tol, first, last,
+                                           simplifiedFirst, simplifiedLast);
+            result.shape = shapeNames [shape];
+            result.type = type;
+            result.dim = DIM;
+            result.container = containerNames [container];
+            report.Write (result);
+        }
+    }
+
+    //! \brief Runs all selected containers and algorithms on a single polyline.
+    template <unsigned DIM, class T>
+    void RunContainers (const Options& options, Report& report, Shape shape, const char* type, T tol,
+                        const std::vector <T>& coords)
+    {
+        // the simplification used by the positional error functions
+        std::vector <T> simplification;
+        simplify_douglas_peucker <DIM> (coords.begin (), coords.end (), tol, std::back_inserter (simplification));
+        const std::vector <T>& simplified = simplification;
+
+        for (unsigned c = 0; c < CONTAINER_COUNT; ++c) {
+            if (!options.containers [c]) {
+                continue;
+            }
+            switch (c) {
+            case CONTAINER_ARRAY:
+            {
+                const T* first = coords.data ();
+                const T* simplifiedFirst = simplified.data ();
+                RunAlgorithms <DIM> (options, report, shape, type, CONTAINER_ARRAY, tol,
+                                     first, first + coords.size (),
+                                     simplifiedFirst, simplifiedFirst + simplified.size ());
+                break;
+            }
+            case CONTAINER_VECTOR:
+                RunAlgorithms <DIM> (options, report, shape, type, CONTAINER_VECTOR, tol,
+                                     coords.begin (), coords.end (), simplified.begin (), simplified.end ());
+                break;
+            case CONTAINER_DEQUE:
+            {
+                const std::deque <T> polyline (coords.begin (), coords.end ());
+                const std::deque <T> simplification (simplified.begin (), simplified.end ());
+                RunAlgorithms <DIM> (options, report, shape, type, CONTAINER_DEQUE, tol,
+                                     polyline.begin (), polyline.end (),
+                                     simplification.begin (), simplification.end ());
+                break;
+            }
+            case CONTAINER_LIST:
+            {
+                const std::list <T> polyline (coords.begin (), coords.end ());
+                const std::list <T> simplification (simplified.begin (), simplified.end ());
+                RunAlgorithms <DIM> (options, report, shape, type, CONTAINER_LIST, tol,
+                                     polyline.begin (), polyline.end (),
+                                     simplification.begin (), simplification.end ());
+                break;
+            }
+            }
+        }
+    }
+
+    //! \brief Runs all benchmarks for a single value type.
+    template <class T>
+    void Run (const Options& options, Report& report, ValueType type) {
+        // integer coordinates are scaled to keep a reasonable resolution
+        double scale = std::numeric_limits <T>::is_integer ? 16 : 1;
+        T tol = static_cast <T> (options.tol * scale);
+        for (unsigned shape = 0; shape < SHAPE_COUNT; ++shape) {
+            if (!options.shapes [shape]) {
+                continue;
+            }
+            for (std::size_t d = 0; d < options.dims.size (); ++d) {
+                for (std::size_t s = 0; s < options.sizes.size (); ++s) {
+                    std::size_t size = options.sizes [s];
+                    switch (options.dims [d]) {
+                    case 2:
+                        RunContainers <2> (options, report, static_cast <Shape> (shape), typeNames [type], tol,
+                                           Generate <2, T> (static_cast <Shape> (shape), size, options.seed, scale));
+                        break;
+                    case 3:
+                        RunContainers <3> (options, report, static_cast <Shape> (shape), typeNames [type], tol,
+                                           Generate <3, T> (static_cast <Shape> (shape), size, options.seed, scale));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------
+
+    void Usage () {
+        std::fprintf (stderr,
+            "usage: psimpl-bench [options]\n"
+            "\n"
+            "Benchmarks each selected algorithm for each input shape, value type, dimension,\n"
+            "container and size.\n"
+            "\n"
+            "options:\n"
+            "  -a <names>         algorithms: np, rd, pd, pd4 (pd with 4 passes), rw, op, la, dp,\n"
+            "                     dpn, pe (positional errors), pes (error statistics), default all\n"
+            "  -g <names>         input shapes: walk (smooth random walk, default), spiral, gps\n"
+            "                     (noisy near-collinear track), zigzag (DP worst case, O(n^2)),\n"
+            "                     coast (fractal coastline), dwell (long static periods)\n"
+            "  --types <names>    value types: float, double, int, default all\n"
+            "  --dims <dims>      dimensions: 2, 3, default both\n"
+            "  -c <names>         containers: array, vector, deque, list, default all\n"
+            "  -s <sizes>         point counts, default 1e2,1e3,1e4,1e5,1e6\n"
+            "  -t <tol>           distance tolerance, default 1; all shapes use steps of about 10\n"
+            "  --min-time <s>     minimum measurement time per benchmark, default 0.2\n"
+            "  --min-runs <n>     minimum number of measured runs per benchmark, default 3\n"
+            "  --seed <n>         generator seed, default 1\n"
+            "  -f <format>        output format: table (default), csv, json\n"
+            "\n"
+            "Lists are comma separated. Timings are reported for the fastest run. Allocations are\n"
+            "counted for a single run, the peak heap excludes the input, and the peak resident\n"
+            "set size is that of the process so far.\n");
+    }
+
+    //! \brief Splits a comma separated list.
+    std::vector <std::string> Split (const char* value) {
+        std::vector <std::string> items;
+        std::string item;
+        for (const char* c = value; ; ++c) {
+            if (*c == ',' || !*c) {
+                items.push_back (item);
+                item.clear ();
+                if (!*c) {
+                    break;
+                }
+                continue;
+            }
+            item += *c;
+        }
+        return items;
+    }
+
+    //! \brief Selects the named entries of a list of names.
+    bool ParseSelection (const char* value, const char* names [], unsigned count, std::vector <bool>& selection) {
+        selection.assign (count, false);
+        std::vector <std::string> items = Split (value);
+        for (std::size_t i = 0; i < items.size (); ++i) {
+            unsigned n = 0;
+            while (n < count && items [i] != names [n]) {
+                ++n;
+            }
+            if (n == count) {
+                return false;
+            }
+            selection [n] = true;
+        }
+        return true;
+    }
+
+    bool ParseDims (const char* value, std::vector <unsigned>& dims) {
+        dims.clear ();
+        std::vector <std::string> items = Split (value);
+        for (std::size_t i = 0; i < items.size (); ++i) {
+            unsigned dim = std::atoi (items [i].c_str ());
+            if (dim != 2 && dim != 3) {
+                return false;
+            }
+            dims.push_back (dim);
+        }
+        return true;
+    }
+
+    bool ParseSizes (const char* value, std::vector <std::size_t>& sizes) {
+        sizes.clear ();
+        std::vector <std::string> items = Split (value);
+        for (std::size_t i = 0; i < items.size (); ++i) {
+            double size = std::atof (items [i].c_str ());
+            if (size < 2) {
+                return false;
+            }
+            sizes.push_back (static_cast <std::size_t> (size));
+        }
+        return true;
+    }
+
+    bool ParseFormat (const char* value, Format& format) {
+        if (!std::strcmp (value, "table")) { format = FORMAT_TABLE; return true; }
+        if (!std::strcmp (value, "csv"))   { format = FORMAT_CSV;   return true; }
+        if (!std::strcmp (value, "json"))  { format = FORMAT_JSON;  return true; }
+        return false;
+    }
+
+    bool ParseOptions (int argc, char* argv [], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv [i];
+            if (i + 1 == argc) {
+                return false;
+            }
+            const char* value = argv [++i];
+            bool ok = true;
+            if (arg == "-a")                ok = ParseSelection (value, algorithmNames, ALGORITHM_COUNT, options.algorithms);
+            else if (arg == "-g")           ok = ParseSelection (value, shapeNames, SHAPE_COUNT, options.shapes);
+            else if (arg == "--types")      ok = ParseSelection (value, typeNames, TYPE_COUNT, options.types);
+            else if (arg == "-c")           ok = ParseSelection (value, containerNames, CONTAINER_COUNT, options.containers);
+            else if (arg == "--dims")       ok = ParseDims (value, options.dims);
+            else if (arg == "-s")           ok = ParseSizes (value, options.sizes);
+            else if (arg == "-t")           options.tol = std::atof (value);
+            else if (arg == "--min-time")   options.minTime = std::atof (value);
+            else if (arg == "--min-runs")   options.minRuns = std::atoi (value);
+            else if (arg == "--seed")       options.seed = std::atoi (value);
+            else if (arg == "-f")           ok = ParseFormat (value, options.format);
+            else                            ok = false;
+            if (!ok) {
+                return false;
+            }
+        }
+        if (std::find (options.shapes.begin (), options.shapes.end (), true) == options.shapes.end ()) {
+            options.shapes [SHAPE_WALK] = true;
+        }
+        return options.tol > 0;
+    }
+}}
+
+
+int main (int argc, char* argv [])
+{
+    using namespace psimpl::bench;
+
+    Options options;
+    if (!ParseOptions (argc, argv, options)) {
+        Usage ();
+        return 2;
+    }
+
+    Report report (options.format);
+    if (options.types [TYPE_FLOAT])  Run <float> (options, report, TYPE_FLOAT);
+    if (options.types [TYPE_DOUBLE]) Run <double> (options, report, TYPE_DOUBLE);
+    if (options.types [TYPE_INT])    Run <int> (options, report, TYPE_INT);
+    return 0;
+}
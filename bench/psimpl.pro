@@ -0,0 +1,15 @@
+# -------------------------------------------------
+# psimpl-bench - benchmarks of all psimpl algorithms
+# -------------------------------------------------
+TARGET = psimpl-bench
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= qt app_bundle
+win32:LIBS += -lpsapi
+
+HEADERS += \
+    ../lib/psimpl.h \
+    ../test/generators.h
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,16 @@
+# -------------------------------------------------
+# C interface to psimpl, built as a shared library
+# -------------------------------------------------
+TARGET = psimpl
+TEMPLATE = lib
+CONFIG += dll
+CONFIG -= qt
+DEFINES += PSIMPL_C_BUILD
+unix:QMAKE_CXXFLAGS += -fvisibility=hidden
+
+HEADERS += \
+    psimpl_c.h \
+    ../lib/psimpl.h
+
+SOURCES += \
+    psimpl_c.cpp
@@ -0,0 +1,158 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "psimpl_c.h"
+#include "../lib/psimpl.h"
+
+
+// explicit instantiations for the value types and dimensions exposed by the C interface
+template class psimpl::PolylineSimplification <2, const float*, float*>;
+template class psimpl::PolylineSimplification <3, const float*, float*>;
+template class psimpl::PolylineSimplification <2, const double*, double*>;
+template class psimpl::PolylineSimplification <3, const double*, double*>;
+
+
+namespace
+{
+    //! \brief stores the number of vertices between out and result in out_n
+    template <unsigned DIM, typename T>
+    inline int Finish (
+        T* out,
+        T* result,
+        size_t* out_n)
+    {
+        *out_n = static_cast <size_t> (result - out) / DIM;
+        return PSIMPL_OK;
+    }
+}
+
+
+#define PSIMPL_C_DEFINE(T, S, D, DIM)                                                           \
+    int psimpl_np_##S##_##D (const T* coords, size_t n, unsigned step,                         \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.NthPoint (coords, coords + n*DIM, step, out), out_n);     \
+    }                                                                                          \
+    int psimpl_rd_##S##_##D (const T* coords, size_t n, T tol,                                 \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.RadialDistance (coords, coords + n*DIM, tol, out), out_n);\
+    }                                                                                          \
+    int psimpl_pd_##S##_##D (const T* coords, size_t n, T tol, unsigned repeat,                \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.PerpendicularDistance (                                   \
+            coords, coords + n*DIM, tol, repeat, out), out_n);                                 \
+    }                                                                                          \
+    int psimpl_rw_##S##_##D (const T* coords, size_t n, T tol,                                 \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.ReumannWitkam (coords, coords + n*DIM, tol, out), out_n); \
+    }                                                                                          \
+    int psimpl_op_##S##_##D (const T* coords, size_t n, T min_tol, T max_tol,                  \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.Opheim (                                                  \
+            coords, coords + n*DIM, min_tol, max_tol, out), out_n);                            \
+    }                                                                                          \
+    int psimpl_la_##S##_##D (const T* coords, size_t n, T tol, unsigned look_ahead,            \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.Lang (                                                    \
+            coords, coords + n*DIM, tol, look_ahead, out), out_n);                             \
+    }                                                                                          \
+    int psimpl_dp_##S##_##D (const T* coords, size_t n, T tol,                                 \
+                             T* out, size_t* out_n)                                            \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.DouglasPeucker (coords, coords + n*DIM, tol, out), out_n);\
+    }                                                                                          \
+    int psimpl_dpn_##S##_##D (const T* coords, size_t n, unsigned count,                       \
+                              T* out, size_t* out_n)                                           \
+    {                                                                                          \
+        if (!coords || !out || !out_n) return PSIMPL_ERROR_NULL;                               \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        return Finish <DIM> (out, ps.DouglasPeuckerN (                                         \
+            coords, coords + n*DIM, count, out), out_n);                                       \
+    }                                                                                          \
+    int psimpl_pos_error2_##S##_##D (const T* original, size_t n,                              \
+                                     const T* simplified, size_t m,                            \
+                                     T* errors, size_t* errors_n)                              \
+    {                                                                                          \
+        if (!original || !simplified || !errors || !errors_n) return PSIMPL_ERROR_NULL;        \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        bool valid = false;                                                                    \
+        T* last = ps.ComputePositionalErrors2 (original, original + n*DIM,                     \
+                                               simplified, simplified + m*DIM,                 \
+                                               errors, &valid);                                \
+        *errors_n = static_cast <size_t> (last - errors);                                      \
+        return valid ? PSIMPL_OK : PSIMPL_ERROR_INVALID;                                       \
+    }                                                                                          \
+    int psimpl_pos_error_stats_##S##_##D (const T* original, size_t n,                         \
+                                          const T* simplified, size_t m,                       \
+                                          psimpl_statistics* stats)                            \
+    {                                                                                          \
+        if (!original || !simplified || !stats) return PSIMPL_ERROR_NULL;                      \
+        psimpl::PolylineSimplification <DIM, const T*, T*> ps;                                 \
+        bool valid = false;                                                                    \
+        psimpl::math::Statistics s = ps.ComputePositionalErrorStatistics (                     \
+            original, original + n*DIM, simplified, simplified + m*DIM, &valid);               \
+        stats->max = s.max;                                                                    \
+        stats->sum = s.sum;                                                                    \
+        stats->mean = s.mean;                                                                  \
+        stats->std = s.std;                                                                    \
+        return valid ? PSIMPL_OK : PSIMPL_ERROR_INVALID;                                       \
+    }
+
+
+extern "C"
+{
+    PSIMPL_C_DEFINE(float,  f32, 2d, 2)
+    PSIMPL_C_DEFINE(float,  f32, 3d, 3)
+    PSIMPL_C_DEFINE(double, f64, 2d, 2)
+    PSIMPL_C_DEFINE(double, f64, 3d, 3)
+}
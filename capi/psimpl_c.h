@@ -0,0 +1,137 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_c.h
+    \brief C interface to the psimpl polyline simplification library.
+
+    Each routine operates directly on caller-owned coordinate buffers; no data is copied at the
+    interface boundary. Routines exist for every simplification algorithm, for float (f32) and
+    double (f64) coordinates, and for 2 and 3 dimensional polylines. The naming scheme is:
+
+        psimpl_<algorithm>_<value type>_<dimension>
+
+    All point counts are expressed in vertices, not in coordinates. The output buffer of a
+    simplification routine must be able to hold at least as many vertices as the input, since
+    invalid input (see PolylineSimplification) is copied to the output unchanged.
+*/
+
+#ifndef PSIMPL_C
+#define PSIMPL_C
+
+
+#include <stddef.h>
+
+
+#if defined(_WIN32) && !defined(PSIMPL_C_STATIC)
+#  if defined(PSIMPL_C_BUILD)
+#    define PSIMPL_C_API __declspec(dllexport)
+#  else
+#    define PSIMPL_C_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__) && defined(PSIMPL_C_BUILD)
+#  define PSIMPL_C_API __attribute__ ((visibility ("default")))
+#else
+#  define PSIMPL_C_API
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Return codes of the psimpl C interface. */
+enum psimpl_status
+{
+    PSIMPL_OK = 0,              /*!< the routine succeeded */
+    PSIMPL_ERROR_NULL = -1,     /*!< a required pointer argument was null */
+    PSIMPL_ERROR_INVALID = -2   /*!< the input was rejected; the output is undefined */
+};
+
+/*! \brief POD structure for storing several statistical values, see psimpl::math::Statistics */
+typedef struct psimpl_statistics
+{
+    double max;
+    double sum;
+    double mean;
+    double std;     /*!< standard deviation */
+} psimpl_statistics;
+
+/*!
+    \brief Declares the C interface for a single value type and dimension.
+
+    \param T    coordinate value type
+    \param S    value type suffix (f32, f64)
+    \param D    dimension suffix (2d, 3d)
+
+    For each routine:
+    - coords/n          the input polyline, consisting of n vertices (n*DIM coordinates)
+    - out/out_n         the output buffer, which must hold n vertices; on success out_n receives
+                        the number of vertices written to it
+*/
+#define PSIMPL_C_DECLARE(T, S, D)                                                               \
+    PSIMPL_C_API int psimpl_np_##S##_##D (const T* coords, size_t n, unsigned step,            \
+                                          T* out, size_t* out_n);                              \
+    PSIMPL_C_API int psimpl_rd_##S##_##D (const T* coords, size_t n, T tol,                    \
+                                          T* out, size_t* out_n);                              \
+    PSIMPL_C_API int psimpl_pd_##S##_##D (const T* coords, size_t n, T tol, unsigned repeat,   \
+                                          T* out, size_t* out_n);                              \
+    PSIMPL_C_API int psimpl_rw_##S##_##D (const T* coords, size_t n, T tol,                    \
+                                          T* out, size_t* out_n);                              \
+    PSIMPL_C_API int psimpl_op_##S##_##D (const T* coords, size_t n, T min_tol, T max_tol,     \
+                                          T* out, size_t* out_n);                              \
+    PSIMPL_C_API int psimpl_la_##S##_##D (const T* coords, size_t n, T tol,                    \
+                                          unsigned look_ahead, T* out, size_t* out_n);         \
+    PSIMPL_C_API int psimpl_dp_##S##_##D (const T* coords, size_t n, T tol,                    \
+                                          T* out, size_t* out_n);                              \
+    PSIMPL_C_API int psimpl_dpn_##S##_##D (const T* coords, size_t n, unsigned count,          \
+                                           T* out, size_t* out_n);                             \
+    PSIMPL_C_API int psimpl_pos_error2_##S##_##D (const T* original, size_t n,                 \
+                                                  const T* simplified, size_t m,               \
+                                                  T* errors, size_t* errors_n);                \
+    PSIMPL_C_API int psimpl_pos_error_stats_##S##_##D (const T* original, size_t n,            \
+                                                       const T* simplified, size_t m,          \
+                                                       psimpl_statistics* stats);
+
+PSIMPL_C_DECLARE(float,  f32, 2d)
+PSIMPL_C_DECLARE(float,  f32, 3d)
+PSIMPL_C_DECLARE(double, f64, 2d)
+PSIMPL_C_DECLARE(double, f64, 3d)
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* PSIMPL_C */
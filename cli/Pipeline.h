@@ -0,0 +1,131 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#ifndef PSIMPL_CLI_PIPELINE
+#define PSIMPL_CLI_PIPELINE
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+
+namespace psimpl {
+    namespace cli
+{
+    /*!
+        \brief A thread safe first-in first-out queue with a maximum capacity.
+
+        Push blocks while the queue is full, and Pop blocks while the queue is empty. After Close
+        is called, Pop returns false once the queue has been drained.
+    */
+    template <class T>
+    class BoundedQueue
+    {
+    public:
+        explicit BoundedQueue (std::size_t capacity) :
+            mCapacity (capacity ? capacity : 1),
+            mClosed (false)
+        {}
+
+        void Push (T item) {
+            std::unique_lock <std::mutex> lock (mMutex);
+            mNotFull.wait (lock, [this] { return mItems.size () < mCapacity; });
+            mItems.push_back (std::move (item));
+            mNotEmpty.notify_one ();
+        }
+
+        bool Pop (T& item) {
+            std::unique_lock <std::mutex> lock (mMutex);
+            mNotEmpty.wait (lock, [this] { return !mItems.empty () || mClosed; });
+            if (mItems.empty ()) {
+                return false;
+            }
+            item = std::move (mItems.front ());
+            mItems.pop_front ();
+            mNotFull.notify_one ();
+            return true;
+        }
+
+        void Close () {
+            std::lock_guard <std::mutex> lock (mMutex);
+            mClosed = true;
+            mNotEmpty.notify_all ();
+        }
+
+    private:
+        std::size_t mCapacity;              //!< maximum number of queued items
+        bool mClosed;                       //!< indicates that no more items will be pushed
+        std::deque <T> mItems;              //!< queued items
+        std::mutex mMutex;                  //!< protects all members
+        std::condition_variable mNotFull;   //!< signaled when an item is popped
+        std::condition_variable mNotEmpty;  //!< signaled when an item is pushed, or on close
+    };
+
+    /*!
+        \brief Limits the number of items that are in flight between two pipeline stages.
+
+        Acquire blocks while the limit is reached, Release frees a slot.
+    */
+    class Window
+    {
+    public:
+        explicit Window (std::size_t limit) :
+            mLimit (limit ? limit : 1),
+            mCount (0)
+        {}
+
+        void Acquire () {
+            std::unique_lock <std::mutex> lock (mMutex);
+            mNotFull.wait (lock, [this] { return mCount < mLimit; });
+            ++mCount;
+        }
+
+        void Release () {
+            std::lock_guard <std::mutex> lock (mMutex);
+            --mCount;
+            mNotFull.notify_one ();
+        }
+
+    private:
+        std::size_t mLimit;                 //!< maximum number of items in flight
+        std::size_t mCount;                 //!< current number of items in flight
+        std::mutex mMutex;                  //!< protects all members
+        std::condition_variable mNotFull;   //!< signaled when an item is released
+    };
+}}
+
+
+#endif // PSIMPL_CLI_PIPELINE
@@ -0,0 +1,592 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+
+#ifndef PSIMPL_CLI_STAGES
+#define PSIMPL_CLI_STAGES
+
+
+#include "Pipeline.h"
+#include "../lib/psimpl.h"
+#include "../lib/psimpl_binary.h"
+#include "../lib/psimpl_wkb.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <istream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+
+namespace psimpl {
+    namespace cli
+{
+    enum Algorithm {
+        NTH_POINT,
+        RADIAL_DISTANCE,
+        PERPENDICULAR_DISTANCE,
+        REUMANN_WITKAM,
+        OPHEIM,
+        LANG,
+        DOUGLAS_PEUCKER,
+        DOUGLAS_PEUCKER_N,
+        NONE
+    };
+
+    enum Format {
+        FORMAT_AUTO,
+        FORMAT_CSV,
+        FORMAT_BINARY,
+        FORMAT_WKB
+    };
+
+    enum ValueType {
+        TYPE_FLOAT,
+        TYPE_DOUBLE,
+        TYPE_SHORT,
+        TYPE_INT
+    };
+
+    //! \brief Command line options.
+    struct Options {
+        Algorithm algorithm = DOUGLAS_PEUCKER;
+        double tol = 1;                 //!< distance tolerance
+        double minTol = 1;              //!< minimum distance tolerance (Opheim)
+        double maxTol = 2;              //!< maximum distance tolerance (Opheim)
+        unsigned n = 2;                 //!< n for nth point, point count for DPn
+        unsigned repeat = 1;            //!< perpendicular distance repeat count
+        unsigned lookAhead = 8;         //!< Lang look ahead
+        unsigned dim = 2;               //!< dimension of CSV and WKB input
+        ValueType type = TYPE_DOUBLE;   //!< value type of CSV input
+        Format inputFormat = FORMAT_AUTO;
+        Format outputFormat = FORMAT_AUTO;
+        std::string input;
+        std::string output;
+        unsigned threads = 0;           //!< number of worker threads, 0 for hardware concurrency; at most queueSize are used
+        std::size_t queueSize = 256;    //!< maximum number of features in flight
+        bool quiet = false;             //!< suppresses the throughput report
+    };
+
+    //! \brief A polyline on its way through the pipeline.
+    template <class T>
+    struct Feature {
+        std::size_t sequence = 0;       //!< position in the input
+        unsigned long line = 0;         //!< line number in the input, 0 for binary input
+        std::vector <T> storage;        //!< coordinates owned by the feature, if any
+        const T* first = 0;             //!< the first coordinate to simplify
+        const T* last = 0;              //!< one beyond the last coordinate to simplify
+        std::vector <T> result;         //!< simplified coordinates
+        bool skipped = false;           //!< indicates if the feature has incomplete points
+    };
+
+    // --------------------------------------------------------------------------------------------
+
+    //! \brief Produces the features of an input file.
+    template <class T>
+    class Source {
+    public:
+        virtual ~Source () {}
+        //! \brief Reads the next feature, returns false at the end of the input.
+        virtual bool Next (Feature <T>& feature) = 0;
+    };
+
+    //! \brief Consumes the simplified features, in input order.
+    template <class T>
+    class Sink {
+    public:
+        virtual ~Sink () {}
+        virtual bool Write (const T* first, const T* last) = 0;
+        virtual bool Close () = 0;
+    };
+
+    //! \brief Reads one feature per line, coordinates separated by commas, semicolons or spaces.
+    //!
+    //! Lines that contain anything other than numbers and separators are reported and skipped.
+    template <class T>
+    class CsvSource : public Source <T> {
+    public:
+        explicit CsvSource (std::istream& stream) :
+            mStream (stream), mLineNumber (0) {}
+
+        bool Next (Feature <T>& feature) {
+            while (std::getline (mStream, mLine)) {
+                ++mLineNumber;
+                if (mLine.empty () || mLine [0] == '#') {
+                    continue;
+                }
+                if (!Parse (feature.storage)) {
+                    continue;
+                }
+                feature.line = mLineNumber;
+                feature.first = feature.storage.empty () ? 0 : &feature.storage [0];
+                feature.last = feature.first + feature.storage.size ();
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        bool Parse (std::vector <T>& storage) {
+            storage.clear ();
+            const char* p = mLine.c_str ();
+            for (;;) {
+                while (*p == ',' || *p == ';' || *p == ' ' || *p == '\t' || *p == '\r') {
+                    ++p;
+                }
+                if (!*p) {
+                    return true;
+                }
+                char* end = 0;
+                double value = std::strtod (p, &end);
+                if (end == p) {
+                    std::fprintf (stderr, "psimpl-cli: skipping line %lu, invalid coordinate at column %lu\n",
+                                  mLineNumber, static_cast <unsigned long> (p - mLine.c_str () + 1));
+                    return false;
+                }
+                storage.push_back (static_cast <T> (value));
+                p = end;
+            }
+        }
+
+    private:
+        std::istream& mStream;
+        unsigned long mLineNumber;
+        std::string mLine;
+    };
+
+    //! \brief Provides the features of a memory mapped binary file, without copying.
+    template <class T>
+    class BinarySource : public Source <T> {
+    public:
+        explicit BinarySource (const BinaryPolylineReader <T>& reader) :
+            mReader (reader), mFeature (0) {}
+
+        bool Next (Feature <T>& feature) {
+            if (mFeature == mReader.feature_count ()) {
+                return false;
+            }
+            feature.storage.clear ();
+            feature.first = mReader.first (mFeature);
+            feature.last = mReader.last (mFeature);
+            ++mFeature;
+            return true;
+        }
+
+    private:
+        const BinaryPolylineReader <T>& mReader;
+        std::size_t mFeature;
+    };
+
+    //! \brief Converts WKB coordinates to the value type of the pipeline.
+    template <class T>
+    struct WkbCopy {
+        template <class InputIterator>
+        void operator () (InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                storage->push_back (static_cast <T> (*first));
+            }
+        }
+
+        std::vector <T>* storage;
+    };
+
+    //! \brief Reads one hex encoded WKB LineString or MultiLineString per line.
+    //!
+    //! Each part of a MultiLineString becomes a separate feature. Geometries that cannot be
+    //! parsed, or that do not match the expected dimension, are reported and skipped.
+    template <class T>
+    class WkbSource : public Source <T> {
+    public:
+        WkbSource (std::istream& stream, unsigned dim) :
+            mStream (stream), mDim (dim), mLineNumber (0), mPart (0) {}
+
+        bool Next (Feature <T>& feature) {
+            while (mPart == mLines.size ()) {
+                if (!ReadGeometry ()) {
+                    return false;
+                }
+            }
+            WkbCopy <T> copy;
+            copy.storage = &feature.storage;
+            feature.storage.clear ();
+            wkb::visit (mLines [mPart++], copy);
+            feature.line = mLineNumber;
+            feature.first = feature.storage.empty () ? 0 : &feature.storage [0];
+            feature.last = feature.first + feature.storage.size ();
+            return true;
+        }
+
+    private:
+        bool ReadGeometry () {
+            mLines.clear ();
+            mPart = 0;
+            if (!std::getline (mStream, mLine)) {
+                return false;
+            }
+            ++mLineNumber;
+            mBytes.clear ();
+            int high = -1;
+            for (std::string::size_type c = 0; c < mLine.size (); ++c) {
+                int nibble = Nibble (mLine [c]);
+                if (nibble < 0) {
+                    continue;   // separators and line endings
+                }
+                if (high < 0) {
+                    high = nibble;
+                }
+                else {
+                    mBytes.push_back (static_cast <unsigned char> (high << 4 | nibble));
+                    high = -1;
+                }
+            }
+            if (mBytes.empty ()) {
+                return true;
+            }
+            const unsigned char* first = &mBytes [0];
+            if (!wkb::parse (first, first + mBytes.size (), mLines)) {
+                std::fprintf (stderr, "psimpl-cli: skipping invalid WKB on line %lu\n", mLineNumber);
+                mLines.clear ();
+            }
+            for (std::size_t l = 0; l < mLines.size (); ++l) {
+                if (mLines [l].dimension () != mDim) {
+                    std::fprintf (stderr, "psimpl-cli: skipping %uD WKB on line %lu\n", mLines [l].dimension (), mLineNumber);
+                    mLines.clear ();
+                }
+            }
+            return true;
+        }
+
+        static int Nibble (char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+    private:
+        std::istream& mStream;
+        unsigned mDim;
+        unsigned long mLineNumber;
+        std::string mLine;
+        std::vector <unsigned char> mBytes;
+        std::vector <wkb::linestring> mLines;
+        std::size_t mPart;
+    };
+
+    //! \brief Writes one feature per line, coordinates separated by commas.
+    template <class T>
+    class CsvSink : public Sink <T> {
+    public:
+        explicit CsvSink (std::ostream& stream) :
+            mStream (stream)
+        {
+            mStream.precision (std::numeric_limits <T>::digits10 + 2);
+        }
+
+        bool Write (const T* first, const T* last) {
+            for (const T* it = first; it != last; ++it) {
+                if (it != first) {
+                    mStream << ',';
+                }
+                mStream << +*it;
+            }
+            mStream << '\n';
+            return static_cast <bool> (mStream);
+        }
+
+        bool Close () {
+            mStream.flush ();
+            return static_cast <bool> (mStream);
+        }
+
+    private:
+        std::ostream& mStream;
+    };
+
+    //! \brief Streams the features to a binary polyline file.
+    template <class T>
+    class BinarySink : public Sink <T> {
+    public:
+        BinarySink () {}
+
+        bool Open (const char* path, unsigned dim) {
+            return mWriter.open (path, dim);
+        }
+
+        bool Write (const T* first, const T* last) {
+            std::copy (first, last, mWriter.feature ());
+            return true;
+        }
+
+        bool Close () {
+            return mWriter.close ();
+        }
+
+    private:
+        BinaryPolylineWriter <T> mWriter;
+    };
+
+    //! \brief Writes each feature as a hex encoded WKB LineString, one per line.
+    template <class T>
+    class WkbSink : public Sink <T> {
+    public:
+        WkbSink (std::ostream& stream, unsigned dim) :
+            mStream (stream), mDim (dim) {}
+
+        bool Write (const T* first, const T* last) {
+            static const char digits [] = "0123456789ABCDEF";
+            mBytes.clear ();
+            wkb::writer writer (mBytes, mDim);
+            std::copy (first, last, writer.begin_linestring ());
+            if (!writer.end_linestring ()) {
+                return false;
+            }
+            mLine.resize (2 * mBytes.size ());
+            for (std::size_t b = 0; b < mBytes.size (); ++b) {
+                mLine [2 * b] = digits [mBytes [b] >> 4];
+                mLine [2 * b + 1] = digits [mBytes [b] & 0x0F];
+            }
+            mStream << mLine << '\n';
+            return static_cast <bool> (mStream);
+        }
+
+        bool Close () {
+            mStream.flush ();
+            return static_cast <bool> (mStream);
+        }
+
+    private:
+        std::ostream& mStream;
+        unsigned mDim;
+        std::vector <unsigned char> mBytes;
+        std::string mLine;
+    };
+
+    // --------------------------------------------------------------------------------------------
+
+    template <unsigned DIM, class T>
+    void Simplify (const Options& options, const T* first, const T* last, std::vector <T>& result) {
+        std::back_insert_iterator <std::vector <T> > out (result);
+        T tol = static_cast <T> (options.tol);
+        switch (options.algorithm) {
+        case NTH_POINT:
+            simplify_nth_point <DIM> (first, last, options.n, out);
+            break;
+        case RADIAL_DISTANCE:
+            simplify_radial_distance <DIM> (first, last, tol, out);
+            break;
+        case PERPENDICULAR_DISTANCE:
+            simplify_perpendicular_distance <DIM> (first, last, tol, options.repeat, out);
+            break;
+        case REUMANN_WITKAM:
+            simplify_reumann_witkam <DIM> (first, last, tol, out);
+            break;
+        case OPHEIM:
+            simplify_opheim <DIM> (first, last, static_cast <T> (options.minTol), static_cast <T> (options.maxTol), out);
+            break;
+        case LANG:
+            simplify_lang <DIM> (first, last, tol, options.lookAhead, out);
+            break;
+        case DOUGLAS_PEUCKER:
+            simplify_douglas_peucker <DIM> (first, last, tol, out, PREFILTER_INDEX);
+            break;
+        case DOUGLAS_PEUCKER_N:
+            simplify_douglas_peucker_n <DIM> (first, last, options.n, out);
+            break;
+        case NONE:
+            std::copy (first, last, out);
+            break;
+        }
+    }
+
+    //! \brief Simplifies a feature, dispatching on its run-time dimension.
+    //!
+    //! Features whose coordinate count is not a multiple of dim are marked as skipped.
+    template <class T>
+    void Simplify (const Options& options, unsigned dim, Feature <T>& feature) {
+        feature.result.clear ();
+        feature.skipped = dim == 0 || (feature.last - feature.first) % dim != 0;
+        if (feature.skipped) {
+            return;
+        }
+        switch (dim) {
+        case 1: Simplify <1> (options, feature.first, feature.last, feature.result); break;
+        case 2: Simplify <2> (options, feature.first, feature.last, feature.result); break;
+        case 3: Simplify <3> (options, feature.first, feature.last, feature.result); break;
+        case 4: Simplify <4> (options, feature.first, feature.last, feature.result); break;
+        }
+    }
+
+    //! \brief Returns the number of worker threads to start.
+    //!
+    //! More workers than features in flight would never receive a feature.
+    inline unsigned WorkerCount (const Options& options) {
+        std::size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency ();
+        threads = std::min (threads, options.queueSize);
+        return threads ? static_cast <unsigned> (threads) : 1;
+    }
+
+    //! \brief Runs the read - simplify - write pipeline, and reports its throughput.
+    //!
+    //! When not all worker threads can be started, the pipeline continues with the workers that
+    //! did start. Returns false when the reader or no worker could be started.
+    template <class T>
+    bool Process (const Options& options, unsigned dim, Source <T>& source, Sink <T>& sink) {
+        typedef std::unique_ptr <Feature <T> > FeaturePtr;
+
+        unsigned threads = WorkerCount (options);
+
+        Window window (options.queueSize);
+        BoundedQueue <FeaturePtr> jobs (options.queueSize);
+        BoundedQueue <FeaturePtr> results (options.queueSize);
+        std::atomic <unsigned> running (threads);
+        std::atomic <unsigned long long> inputPoints (0);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+
+        // reader
+        std::thread reader;
+        try {
+            reader = std::thread ([&] {
+                for (std::size_t sequence = 0; ; ++sequence) {
+                    FeaturePtr feature (new Feature <T>);
+                    if (!source.Next (*feature)) {
+                        break;
+                    }
+                    feature->sequence = sequence;
+                    window.Acquire ();
+                    jobs.Push (std::move (feature));
+                }
+                jobs.Close ();
+            });
+        }
+        catch (const std::system_error& error) {
+            std::fprintf (stderr, "psimpl-cli: cannot start the reader thread (%s)\n", error.what ());
+            return false;
+        }
+
+        // workers
+        std::vector <std::thread> workers;
+        try {
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.push_back (std::thread ([&] {
+                    FeaturePtr feature;
+                    while (jobs.Pop (feature)) {
+                        Simplify (options, dim, *feature);
+                        if (!feature->skipped) {
+                            inputPoints += (feature->last - feature->first) / dim;
+                        }
+                        results.Push (std::move (feature));
+                    }
+                    if (--running == 0) {
+                        results.Close ();
+                    }
+                }));
+            }
+        }
+        catch (const std::system_error& error) {
+            std::fprintf (stderr, "psimpl-cli: cannot start %u worker threads (%s), using %lu\n",
+                          threads, error.what (), static_cast <unsigned long> (workers.size ()));
+            // the workers that did not start never finish
+            if ((running -= threads - static_cast <unsigned> (workers.size ())) == 0) {
+                results.Close ();
+            }
+            threads = static_cast <unsigned> (workers.size ());
+            if (workers.empty ()) {
+                // discard the input, so that the reader finishes
+                FeaturePtr feature;
+                while (jobs.Pop (feature)) {
+                    window.Release ();
+                }
+                reader.join ();
+                return false;
+            }
+        }
+
+        // writer, restores the input order
+        bool ok = true;
+        std::size_t next = 0;
+        unsigned long long outputPoints = 0;
+        unsigned long skipped = 0;
+        std::map <std::size_t, FeaturePtr> pending;
+        FeaturePtr feature;
+        while (results.Pop (feature)) {
+            pending [feature->sequence] = std::move (feature);
+            for (typename std::map <std::size_t, FeaturePtr>::iterator it = pending.find (next);
+                 it != pending.end (); it = pending.find (++next))
+            {
+                const Feature <T>& done = *it->second;
+                const std::vector <T>& result = done.result;
+                if (done.skipped) {
+                    std::fprintf (stderr, "psimpl-cli: skipping feature %lu on line %lu, %lu coordinates do not form %uD points\n",
+                                  static_cast <unsigned long> (done.sequence), done.line,
+                                  static_cast <unsigned long> (done.last - done.first), dim);
+                    ++skipped;
+                }
+                else {
+                    ok = sink.Write (result.empty () ? 0 : &result [0],
+                                     result.empty () ? 0 : &result [0] + result.size ()) && ok;
+                    outputPoints += result.size () / dim;
+                }
+                pending.erase (it);
+                window.Release ();
+            }
+        }
+        reader.join ();
+        for (unsigned t = 0; t < threads; ++t) {
+            workers [t].join ();
+        }
+        ok = sink.Close () && ok;
+
+        double seconds = std::chrono::duration <double> (std::chrono::steady_clock::now () - start).count ();
+        if (!options.quiet) {
+            std::fprintf (stderr,
+                "%lu features, %lu skipped, %llu points in, %llu points out, %u threads, %.3f s, %.0f points/s\n",
+                static_cast <unsigned long> (next), skipped, inputPoints.load (), outputPoints, threads,
+                seconds, seconds > 0 ? inputPoints.load () / seconds : 0.0);
+        }
+        return ok;
+    }
+}}
+
+
+#endif // PSIMPL_CLI_STAGES
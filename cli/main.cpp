@@ -0,0 +1,312 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*
+    psimpl-cli - batch polyline simplification
+
+    Reads polylines (features) from a CSV, binary polyline or WKB file, simplifies them on multiple
+    worker threads, and writes the results in input order. Features stream through bounded
+    queues, so the memory use does not depend on the size of the input.
+*/
+
+#include "Stages.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace psimpl {
+    namespace cli
+{
+    //! \brief Determines the format of a file based on its extension; '-' denotes CSV.
+    Format DetectFormat (const std::string& path) {
+        std::string::size_type dot = path.rfind ('.');
+        std::string extension = dot == std::string::npos ? "" : path.substr (dot + 1);
+        if (extension == "bin" || extension == "psb") {
+            return FORMAT_BINARY;
+        }
+        if (extension == "wkb") {
+            return FORMAT_WKB;
+        }
+        return FORMAT_CSV;
+    }
+
+    //! \brief Determines the value type of a binary polyline file.
+    bool DetectValueType (const std::string& path, ValueType& type) {
+        util::mapped_file file (path.c_str ());
+        if (!file.is_open () || file.size () < sizeof (util::binary_header)) {
+            return false;
+        }
+        const util::binary_header* header = reinterpret_cast <const util::binary_header*> (file.data ());
+        switch (header->value_type) {
+        case util::binary_value_type <float>::code:  type = TYPE_FLOAT;  return true;
+        case util::binary_value_type <double>::code: type = TYPE_DOUBLE; return true;
+        case util::binary_value_type <short>::code:  type = TYPE_SHORT;  return true;
+        case util::binary_value_type <int>::code:    type = TYPE_INT;    return true;
+        }
+        return false;
+    }
+
+    template <class T>
+    bool Run (const Options& options) {
+        // input
+        unsigned dim = options.dim;
+        std::unique_ptr <Source <T> > source;
+        std::ifstream fileInput;
+        BinaryPolylineReader <T> binaryInput;
+        if (options.inputFormat == FORMAT_BINARY) {
+            if (!binaryInput.open (options.input.c_str ())) {
+                std::fprintf (stderr, "psimpl-cli: cannot read binary polyline file '%s'\n", options.input.c_str ());
+                return false;
+            }
+            dim = binaryInput.dimension ();
+            source.reset (new BinarySource <T> (binaryInput));
+        }
+        else {
+            std::istream* stream = &std::cin;
+            if (options.input != "-") {
+                fileInput.open (options.input.c_str ());
+                if (!fileInput) {
+                    std::fprintf (stderr, "psimpl-cli: cannot read '%s'\n", options.input.c_str ());
+                    return false;
+                }
+                stream = &fileInput;
+            }
+            if (options.inputFormat == FORMAT_WKB) {
+                source.reset (new WkbSource <T> (*stream, dim));
+            }
+            else {
+                source.reset (new CsvSource <T> (*stream));
+            }
+        }
+        if (dim < 1 || dim > 4 || (dim < 2 && (options.inputFormat == FORMAT_WKB || options.outputFormat == FORMAT_WKB))) {
+            std::fprintf (stderr, "psimpl-cli: unsupported dimension %u\n", dim);
+            return false;
+        }
+
+        // output
+        std::unique_ptr <Sink <T> > sink;
+        std::ofstream fileOutput;
+        if (options.outputFormat == FORMAT_BINARY) {
+            BinarySink <T>* binarySink = new BinarySink <T>;
+            sink.reset (binarySink);
+            if (!binarySink->Open (options.output.c_str (), dim)) {
+                std::fprintf (stderr, "psimpl-cli: cannot write '%s'\n", options.output.c_str ());
+                return false;
+            }
+        }
+        else {
+            std::ostream* stream = &std::cout;
+            if (options.output != "-") {
+                fileOutput.open (options.output.c_str ());
+                if (!fileOutput) {
+                    std::fprintf (stderr, "psimpl-cli: cannot write '%s'\n", options.output.c_str ());
+                    return false;
+                }
+                stream = &fileOutput;
+            }
+            if (options.outputFormat == FORMAT_WKB) {
+                sink.reset (new WkbSink <T> (*stream, dim));
+            }
+            else {
+                sink.reset (new CsvSink <T> (*stream));
+            }
+        }
+
+        if (!Process (options, dim, *source, *sink)) {
+            std::fprintf (stderr, "psimpl-cli: failed writing '%s'\n", options.output.c_str ());
+            return false;
+        }
+        return true;
+    }
+
+    // --------------------------------------------------------------------------------------------
+
+    void Usage () {
+        std::fprintf (stderr,
+            "usage: psimpl-cli [options] <input> <output>\n"
+            "\n"
+            "Simplifies each polyline of the input, and writes the results in input order.\n"
+            "Use '-' to read from stdin or write to stdout (CSV and WKB only).\n"
+            "Unparsable lines and features with incomplete points are reported and skipped.\n"
+            "\n"
+            "formats (detected by file extension, or forced using --from / --to):\n"
+            "  csv        one polyline per line: x1,y1,x2,y2,... (default)\n"
+            "  bin        binary polyline file (.bin, .psb), see psimpl_binary.h\n"
+            "  wkb        one hex encoded WKB LineString or MultiLineString per line (.wkb);\n"
+            "             the parts of a MultiLineString are written as separate LineStrings\n"
+            "\n"
+            "options:\n"
+            "  -a <name>          algorithm: np, rd, pd, rw, op, la, dp (default), dpn, or\n"
+            "                     none to only convert between formats\n"
+            "  -t <tol>           distance tolerance (rd, pd, rw, la, dp), default 1\n"
+            "  --min-tol <tol>    minimum distance tolerance (op), default 1\n"
+            "  --max-tol <tol>    maximum distance tolerance (op), default 2\n"
+            "  -n <n>             keep each nth point (np), or the point count (dpn), default 2\n"
+            "  -r <repeat>        number of passes (pd), default 1\n"
+            "  -l <look-ahead>    look ahead (la), default 8\n"
+            "  -d <dim>           dimension of CSV and WKB input (1-4), default 2\n"
+            "  --type <type>      value type of CSV input: float, double (default), short, int\n"
+            "  --from <format>    input format: csv, bin, wkb\n"
+            "  --to <format>      output format: csv, bin, wkb\n"
+            "  -j <threads>       number of worker threads, at most the number of features in\n"
+            "                     flight, default: hardware concurrency\n"
+            "  -q <features>      maximum number of features in flight, default 256\n"
+            "  --quiet            do not report throughput on stderr\n");
+    }
+
+    bool ParseFormat (const char* value, Format& format) {
+        if (!std::strcmp (value, "csv")) { format = FORMAT_CSV; return true; }
+        if (!std::strcmp (value, "bin")) { format = FORMAT_BINARY; return true; }
+        if (!std::strcmp (value, "wkb")) { format = FORMAT_WKB; return true; }
+        return false;
+    }
+
+    bool ParseAlgorithm (const char* value, Algorithm& algorithm) {
+        static const char* names [] = { "np", "rd", "pd", "rw", "op", "la", "dp", "dpn", "none" };
+        for (unsigned a = 0; a < sizeof (names) / sizeof (names [0]); ++a) {
+            if (!std::strcmp (value, names [a])) {
+                algorithm = static_cast <Algorithm> (a);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseValueType (const char* value, ValueType& type) {
+        if (!std::strcmp (value, "float"))  { type = TYPE_FLOAT;  return true; }
+        if (!std::strcmp (value, "double")) { type = TYPE_DOUBLE; return true; }
+        if (!std::strcmp (value, "short"))  { type = TYPE_SHORT;  return true; }
+        if (!std::strcmp (value, "int"))    { type = TYPE_INT;    return true; }
+        return false;
+    }
+
+    //! \brief Parses a distance tolerance, which must not be negative.
+    bool ParseTolerance (const char* value, double& tol) {
+        tol = std::atof (value);
+        return tol >= 0;
+    }
+
+    //! \brief Parses a count, which must not be negative.
+    bool ParseCount (const char* value, unsigned& count) {
+        int parsed = std::atoi (value);
+        count = static_cast <unsigned> (parsed);
+        return parsed >= 0;
+    }
+
+    bool ParseOptions (int argc, char* argv [], Options& options) {
+        std::vector <std::string> files;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv [i];
+            if (arg == "--quiet") {
+                options.quiet = true;
+                continue;
+            }
+            if (arg.size () < 2 || arg [0] != '-') {
+                files.push_back (arg);
+                continue;
+            }
+            if (i + 1 == argc) {
+                return false;
+            }
+            const char* value = argv [++i];
+            bool ok = true;
+            if (arg == "-a")                ok = ParseAlgorithm (value, options.algorithm);
+            else if (arg == "-t")           ok = ParseTolerance (value, options.tol);
+            else if (arg == "--min-tol")    ok = ParseTolerance (value, options.minTol);
+            else if (arg == "--max-tol")    ok = ParseTolerance (value, options.maxTol);
+            else if (arg == "-n")           options.n = std::atoi (value);
+            else if (arg == "-r")           options.repeat = std::atoi (value);
+            else if (arg == "-l")           options.lookAhead = std::atoi (value);
+            else if (arg == "-d")           options.dim = std::atoi (value);
+            else if (arg == "--type")       ok = ParseValueType (value, options.type);
+            else if (arg == "--from")       ok = ParseFormat (value, options.inputFormat);
+            else if (arg == "--to")         ok = ParseFormat (value, options.outputFormat);
+            else if (arg == "-j")           ok = ParseCount (value, options.threads);
+            else if (arg == "-q")           options.queueSize = std::atoi (value);
+            else                            ok = false;
+            if (!ok) {
+                return false;
+            }
+        }
+        if (files.size () != 2) {
+            return false;
+        }
+        options.input = files [0];
+        options.output = files [1];
+        if (options.inputFormat == FORMAT_AUTO) {
+            options.inputFormat = DetectFormat (options.input);
+        }
+        if (options.outputFormat == FORMAT_AUTO) {
+            options.outputFormat = DetectFormat (options.output);
+        }
+        if (options.input == "-" && options.inputFormat == FORMAT_BINARY) {
+            return false;
+        }
+        if (options.output == "-" && options.outputFormat == FORMAT_BINARY) {
+            return false;
+        }
+        return true;
+    }
+}}
+
+
+int main (int argc, char* argv [])
+{
+    using namespace psimpl::cli;
+
+    Options options;
+    if (!ParseOptions (argc, argv, options)) {
+        Usage ();
+        return 2;
+    }
+    if (options.inputFormat == FORMAT_BINARY && !DetectValueType (options.input, options.type)) {
+        std::fprintf (stderr, "psimpl-cli: cannot read binary polyline file '%s'\n", options.input.c_str ());
+        return 1;
+    }
+
+    bool ok = false;
+    switch (options.type) {
+    case TYPE_FLOAT:  ok = Run <float> (options);  break;
+    case TYPE_DOUBLE: ok = Run <double> (options); break;
+    case TYPE_SHORT:  ok = Run <short> (options);  break;
+    case TYPE_INT:    ok = Run <int> (options);    break;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+# -------------------------------------------------
+# psimpl-cli - batch polyline simplification
+# -------------------------------------------------
+TARGET = psimpl-cli
+TEMPLATE = app
+CONFIG += console c++11 thread
+CONFIG -= qt app_bundle
+
+HEADERS += \
+    Pipeline.h \
+    Stages.h \
+    ../lib/psimpl.h \
+    ../lib/psimpl_mmap.h \
+    ../lib/psimpl_binary.h
+
+SOURCES += \
+    main.cpp
@@ -37,6 +37,19 @@
 
 namespace psimpl {
 
+    //! Appends each visible part of a polyline to a path.
+    struct PathBuilder
+    {
+        void operator () (const qreal* first, const qreal* last) {
+            path.moveTo (first [0], first [1]);
+            for (first += 2; first != last; first += 2) {
+                path.lineTo (first [0], first [1]);
+            }
+        }
+
+        QPainterPath path;
+    };
+
     RenderArea::RenderArea (QWidget *inParent, Qt::WindowFlags inFlags) :
         QFrame (inParent, inFlags),
         mDrawGeneratedPolyline (true),
@@ -46,10 +59,10 @@ namespace psimpl {
     }
 
     void RenderArea::paintEvent(QPaintEvent * /*inEvent*/) {
-        if (!mGeneratedPolyline.elementCount ())
+        if (!mGeneratedIndex.point_count ())
             return;
 
-        QRectF rect = mGeneratedPolyline.boundingRect ();
+        QRectF rect = mGeneratedRect;
         if (!rect.isValid ())
             return;
 
@@ -68,8 +81,17 @@ namespace psimpl {
         }
 
         if (mDrawGeneratedPolyline) {
+            // simplify to half a pixel, restricted to the visible area
+            QTransform transform = painter.worldTransform ();
+            qreal tol = 0.5 / qMax (transform.m11 (), transform.m22 ());
+            QRectF visible = transform.inverted ().mapRect (QRectF (this->rect ()));
+            qreal min [2] = { visible.left (), visible.top () };
+            qreal max [2] = { visible.right (), visible.bottom () };
+            PathBuilder builder;
+            mGeneratedIndex.Query (min, max, tol, builder);
+
             painter.setPen (Qt::darkBlue);
-            painter.drawPath (mGeneratedPolyline);
+            painter.drawPath (builder.path);
         }
 
         if (!mSimplifiedPolyline.elementCount ())
@@ -112,7 +134,12 @@ namespace psimpl {
     void RenderArea::SetGeneratedPolyline (QVector <qreal>& polyline)
     {
         mSimplifiedPolyline = QPainterPath ();
-        mGeneratedPolyline = Convert (polyline);
+        mGeneratedRect = QRectF ();
+        if (mGeneratedIndex.Build (polyline.constBegin (), polyline.constEnd ())) {
+            qreal min [2], max [2];
+            mGeneratedIndex.Bounds (min, max);
+            mGeneratedRect = QRectF (QPointF (min [0], min [1]), QPointF (max [0], max [1]));
+        }
     }
 
     void RenderArea::SetSimplifiedPolyline (QVector <qreal>& polyline)
@@ -37,6 +37,7 @@
 
 #include <QtGui/QFrame>
 #include <QtGui/QPainterPath>
+#include "../lib/psimpl_lod.h"
 
 
 namespace psimpl {
@@ -44,7 +45,9 @@ namespace psimpl {
     /*!
         \brief A frame that can draw polylines and their simplification.
         
-        Note that the point count of each polyline is always limited to 100.000 to speed up drawing.
+        The generated polyline is indexed once, and each repaint only draws its simplification to
+        half a pixel within the visible area. The point count of the simplified polyline is limited
+        to 100.000 to speed up drawing.
     */
     class RenderArea : public QFrame
     {
@@ -63,7 +66,8 @@ namespace psimpl {
         QPainterPath Convert (QVector <qreal>& polyline);
 
     private:
-        QPainterPath mGeneratedPolyline;
+        LodIndex <2, qreal> mGeneratedIndex;
+        QRectF mGeneratedRect;
         QPainterPath mSimplifiedPolyline;
         bool mDrawGeneratedPolyline;
         bool mDrawSimplifiedPolyline;
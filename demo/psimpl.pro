@@ -13,7 +13,8 @@ HEADERS += MainWindow.h \
     RenderArea.h \
     psimpl_reference.h \
     psimpl.h \
-    ../lib/psimpl.h
+    ../lib/psimpl.h \
+    ../lib/psimpl_lod.h
 FORMS += MainWindow.ui
 OTHER_FILES += \
     resource.rc \
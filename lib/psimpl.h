@@ -95,10 +95,14 @@
 
 #include <queue>
 #include <stack>
+#include <vector>
 #include <numeric>
 #include <algorithm>
 #include <cmath>
 #include <functional>
+#include <limits>
+#include <climits>
+#include <cstddef>
 
 
 /*!
@@ -120,7 +124,7 @@ namespace psimpl
         class scoped_array
         {
         public:
-            scoped_array (unsigned n) {
+            scoped_array (std::size_t n) {
                 array = new T [n];
             }
 
@@ -128,11 +132,11 @@ namespace psimpl
                 delete [] array;
             }
 
-            T& operator [] (int offset) {
+            T& operator [] (std::ptrdiff_t offset) {
                 return array [offset];
             }
 
-            const T& operator [] (int offset) const {
+            const T& operator [] (std::ptrdiff_t offset) const {
                 return array [offset];
             }
 
@@ -157,6 +161,94 @@ namespace psimpl
         template <typename T> inline void swap (scoped_array <T>& a, scoped_array <T>& b) {
             a.swap (b);
         }
+
+        /*!
+            \brief A dynamically allocated, fixed size array of bits.
+
+            Stores one flag per element using a single bit, instead of the byte that is needed by
+            scoped_array <bool>. All bits are initially cleared. Bits that are stored in different
+            words can be modified concurrently.
+        */
+        class bit_array
+        {
+            typedef unsigned word_type;
+
+        public:
+            enum { BITS = sizeof (word_type) * CHAR_BIT };  //!< number of bits per word
+
+            bit_array (std::size_t n) :
+                count (n)
+            {
+                words = new word_type [WordCount (n)];
+                clear ();
+            }
+
+            ~bit_array () {
+                delete [] words;
+            }
+
+            bool operator [] (std::size_t offset) const {
+                return test (offset);
+            }
+
+            bool test (std::size_t offset) const {
+                return (words [offset / BITS] >> (offset % BITS)) & 1u;
+            }
+
+            void set (std::size_t offset) {
+                words [offset / BITS] |= 1u << (offset % BITS);
+            }
+
+            void reset (std::size_t offset) {
+                words [offset / BITS] &= ~(1u << (offset % BITS));
+            }
+
+            void clear () {
+                std::fill_n (words, WordCount (count), word_type (0));
+            }
+
+            std::size_t size () const {
+                return count;
+            }
+
+            //! \brief Returns the number of allocated bytes.
+            std::size_t bytes () const {
+                return WordCount (count) * sizeof (word_type);
+            }
+
+            /*!
+                \brief Finds the first set bit that follows the specified offset.
+
+                \param[in] offset   offset of the bit to start searching after
+                \return             offset of the next set bit, or size () when there is none
+            */
+            std::size_t find_next (std::size_t offset) const {
+                ++offset;
+                while (offset < count) {
+                    word_type word = words [offset / BITS] >> (offset % BITS);
+                    if (word) {
+                        for (; !(word & 1u); word >>= 1) {
+                            ++offset;
+                        }
+                        return offset < count ? offset : count;
+                    }
+                    offset = (offset / BITS + 1) * BITS;
+                }
+                return count;
+            }
+
+        private:
+            static std::size_t WordCount (std::size_t n) {
+                return (n + BITS - 1) / BITS;
+            }
+
+            bit_array (const bit_array&);
+            bit_array& operator= (const bit_array&);
+
+        private:
+            word_type* words;
+            std::size_t count;
+        };
     }
 
     /*!
@@ -438,20 +530,124 @@ namespace psimpl
             stats.max = static_cast <double> (*std::max_element (first, last));
             stats.sum = static_cast <double> (std::accumulate (first, last, init));
             stats.mean = stats.sum / count;
-            std::transform (first, last, first, std::bind2nd (std::minus <value_type> (), stats.mean));
+            value_type mean = static_cast <value_type> (stats.mean);
+            for (InputIterator it = first; it != last; ++it) {
+                *it = *it - mean;
+            }
             stats.std = std::sqrt (static_cast <double> (std::inner_product (first, last, first, init)) / count);
             return stats;
         }
     }
 
+    /*!
+        \brief Specifies how Douglas-Peucker applies its radial distance preprocessing step.
+    */
+    enum Prefilter
+    {
+        PREFILTER_COPY,     //!< copy the points that remain after RD, and approximate the copy
+        PREFILTER_INDEX,    //!< flag the points that remain after RD, and approximate the input
+        PREFILTER_NONE      //!< skip RD, and approximate the input
+    };
+
+    /*!
+        \brief Identifies the phases of a simplification that are reported to an instrumentation
+        policy.
+    */
+    enum Phase
+    {
+        PHASE_PREFILTER,    //!< radial distance preprocessing
+        PHASE_COPY,         //!< copying the input to contiguous storage
+        PHASE_APPROXIMATE,  //!< douglas-peucker approximation
+        PHASE_OUTPUT,       //!< copying the keys to the output
+        PHASE_COUNT         //!< the number of phases
+    };
+
+    /*!
+        \brief Instrumentation policy that records nothing.
+
+        PolylineSimplification reports its work to an instrumentation policy, which is specified
+        as a template parameter. A policy provides the member functions of this class, which are
+        called from within the inner loops of the algorithms. All of them are empty and inline
+        here, which allows the compiler to remove each call, so that the instrumentation compiles
+        out completely. See psimpl_stats.h for a policy that collects statistics.
+    */
+    struct NoInstrumentation
+    {
+        /*!
+            \brief Called after count points were tested against a distance tolerance.
+
+            A point that is tested against several tolerances at once counts only once.
+        */
+        void Distances (std::size_t /*count*/) const {}
+
+        /*!
+            \brief Called for each sub polyline that is taken from the job queue of DP.
+
+            \param[in] pending     the number of queued sub polylines, including this one
+        */
+        void SubPolyline (std::size_t /*pending*/) const {}
+
+        /*!
+            \brief Called after radial distance preprocessing.
+
+            \param[in] pointCount  the number of polyline points
+            \param[in] remaining   the number of points that remain after preprocessing
+        */
+        void Reduced (std::size_t /*pointCount*/, std::size_t /*remaining*/) const {}
+
+        //! \brief Called after allocating a temporary buffer of the specified number of bytes.
+        void Allocated (std::size_t /*bytes*/) const {}
+
+        //! \brief Called at the start of a phase.
+        void Begin (Phase /*phase*/) const {}
+
+        //! \brief Called at the end of a phase.
+        void End (Phase /*phase*/) const {}
+    };
+
+    /*!
+        \brief Interface for stopping long running simplifications early.
+
+        A PolylineSimplification that is given a token checks it at coarse granularity: the
+        linear routines once every CHECK_INTERVAL points, the Douglas-Peucker routines once the
+        sub polylines processed since the previous check contain at least CHECK_INTERVAL points.
+        After the token is cancelled, each routine stops and returns a valid polyline that starts
+        and ends with the first and last point of the input:
+
+        - RD, PD, RW, OP and Lang return the keys found so far, followed by the last point
+        - DP returns the keys found so far; each sub polyline that was not yet processed is
+          approximated by the segment between its end points
+        - DPn returns the best simplification found so far, which equals the DPn
+          simplification with that number of points
+
+        NP performs no work per point, and is never stopped. See psimpl_cancel.h for tokens
+        that are cancelled explicitly or by a deadline.
+    */
+    class CancellationToken
+    {
+    public:
+        enum {
+            CHECK_INTERVAL = 4096   //!< number of points between two checks
+        };
+
+        virtual ~CancellationToken () {}
+
+        //! \brief Returns true when running simplifications should stop.
+        virtual bool Cancelled () const = 0;
+    };
+
     /*!
         \brief Provides various simplification algorithms for n-dimensional simple polylines.
 
-        A polyline is simple when it is non-closed and non-selfintersecting. All algorithms
+        A polyline is simple when it is non-closed and non-selfintersecting. The ring routines
+        handle closed polylines, such as polygon boundaries, instead. All algorithms
         operate on input iterators and output iterators. Note that unisgned integer types are
         NOT supported.
+
+        All routines report their work to the Instrumentation policy, see NoInstrumentation.
+        Long running routines can be stopped early using a CancellationToken.
     */
-    template <unsigned DIM, class InputIterator, class OutputIterator>
+    template <unsigned DIM, class InputIterator, class OutputIterator, class Instrumentation = NoInstrumentation>
     class PolylineSimplification
     {
         typedef typename std::iterator_traits <InputIterator>::difference_type diff_type;
@@ -459,6 +655,20 @@ namespace psimpl
         typedef typename std::iterator_traits <const value_type*>::difference_type ptr_diff_type;
 
     public:
+        /*!
+            \brief Constructs the simplification routines.
+
+            \param[in] instrumentation     receives the work of all routines
+            \param[in] cancellation        [optional] stops all routines early once cancelled;
+                                            must outlive this object
+        */
+        explicit PolylineSimplification (
+            const Instrumentation& instrumentation = Instrumentation (),
+            const CancellationToken* cancellation = 0) :
+            instrumentation (instrumentation),
+            cancellation (cancellation)
+        {}
+
         /*!
             \brief Performs the nth point routine (NP).
 
@@ -575,8 +785,14 @@ namespace psimpl
             // the first point is always part of the simplification
             CopyKeyAdvance (next, result);
 
+            diff_type work = 0;             // points tested since the last cancellation check
+
             // Skip first and last point, because they are always part of the simplification
             for (diff_type index = 1; index < pointCount - 1; ++index) {
+                if (Interrupted (++work)) {
+                    return CopyLast (next, pointCount - 1 - index, result);
+                }
+                instrumentation.Distances (1);
                 if (math::point_distance2 <DIM> (current, next) < tol2) {
                     Advance (next);
                     continue;
@@ -625,7 +841,7 @@ namespace psimpl
 
             // first pass: [first, last) --> temporary array 'tempPoly'
             util::scoped_array <value_type> tempPoly (coordCount);
-            PolylineSimplification <DIM, InputIterator, value_type*> psimpl_to_array;
+            PolylineSimplification <DIM, InputIterator, value_type*, Instrumentation> psimpl_to_array (instrumentation, cancellation);
             diff_type tempCoordCount = std::distance (tempPoly.get (),
                 psimpl_to_array.PerpendicularDistance (first, last, tol, tempPoly.get ()));
 
@@ -639,7 +855,7 @@ namespace psimpl
             // intermediate passes: temporary array 'tempPoly' --> temporary array 'tempResult'
             if (1 < repeat) {
                 util::scoped_array <value_type> tempResult (coordCount);
-                PolylineSimplification <DIM, value_type*, value_type*> psimpl_arrays;
+                PolylineSimplification <DIM, value_type*, value_type*, Instrumentation> psimpl_arrays (instrumentation, cancellation);
 
                 while (--repeat) {
                     tempCoordCount = std::distance (tempResult.get (),
@@ -656,7 +872,7 @@ namespace psimpl
             }
 
             // final pass: temporary array 'tempPoly' --> result
-            PolylineSimplification <DIM, value_type*, OutputIterator> psimpl_from_array;
+            PolylineSimplification <DIM, value_type*, OutputIterator, Instrumentation> psimpl_from_array (instrumentation, cancellation);
             return psimpl_from_array.PerpendicularDistance (
                 tempPoly.get (), tempPoly.get () + coordCount, tol, result);
         }
@@ -719,8 +935,15 @@ namespace psimpl
             // the first point is always part of the simplification
             CopyKey (p0, result);
 
+            diff_type work = 0;     // points tested since the last cancellation check
+            diff_type index2 = 2;   // point index of p2
+
             while (p2 != last) {
+                if (Interrupted (++work)) {
+                    return CopyLast (p2, pointCount - 1 - index2, result);
+                }
                 // test p1 against line segment S(p0, p2)
+                instrumentation.Distances (1);
                 if (math::segment_distance2 <DIM> (p0, p2, p1) < tol2) {
                     CopyKey (p2, result);
                     // move up by two points
@@ -731,6 +954,7 @@ namespace psimpl
                         break;
                     }
                     Advance (p2, 2);
+                    index2 += 2;
                 }
                 else {
                     CopyKey (p1, result);
@@ -738,6 +962,7 @@ namespace psimpl
                     p0 = p1;
                     p1 = p2;
                     Advance (p2);
+                    ++index2;
                 }
             }
             // make sure the last point is part of the simplification
@@ -806,14 +1031,20 @@ namespace psimpl
             InputIterator pi = p1;     // the previous test point
             InputIterator pj = p1;     // the current test point (pi+1)
 
+            diff_type work = 0;     // points tested since the last cancellation check
+
             // the first point is always part of the simplification
             CopyKey (p0, result);
 
             // check each point pj against L(p0, p1)
             for (diff_type j = 2; j < pointCount; ++j) {
+                if (Interrupted (++work)) {
+                    return CopyLast (pj, pointCount - j, result);
+                }
                 pi = pj;
                 Advance (pj);
 
+                instrumentation.Distances (1);
                 if (math::line_distance2 <DIM> (p0, p1, pj) < tol2) {
                     continue;
                 }
@@ -899,13 +1130,19 @@ namespace psimpl
             InputIterator pj =         // the current test point (pi+1)
                 AdvanceCopy (pi);
 
+            diff_type work = 0;         // points tested since the last cancellation check
+
             // the first point is always part of the simplification
             CopyKey (r0, result);
 
             for (diff_type j = 2; j < pointCount; ++j) {
+                if (Interrupted (++work)) {
+                    return CopyLast (pj, pointCount - j, result);
+                }
                 pi = pj;
                 Advance (pj);
 
+                instrumentation.Distances (1);
                 if (!rayDefined) {
                     // discard each point within minimum tolerance
                     if (math::point_distance2 <DIM> (r0, pj) < min_tol2) {
@@ -1003,11 +1240,18 @@ namespace psimpl
             // the first point is always part of the simplification
             CopyKey (current, result);
 
+            diff_type work = 0;                     // points tested since the last cancellation check
+
             while (moved) {
+                if (Interrupted (work)) {
+                    return CopyLast (next, remaining, result);
+                }
                 value_type d2 = 0;
                 InputIterator p = AdvanceCopy (current);
 
                 while (p != next) {
+                    ++work;
+                    instrumentation.Distances (1);
                     d2 = std::max (d2, math::segment_distance2 <DIM> (current, next, p));
                     if (tol2 < d2) {
                         break;
@@ -1043,7 +1287,7 @@ namespace psimpl
             \image html psimpl_dp.png
 
             Note that this algorithm will create a copy of the input polyline during the vertex
-            reduction step.
+            reduction step. Use the overload that takes a Prefilter to avoid this copy.
 
             RD followed by DP is applied to the range [first, last) using the specified tolerance
             tol. The resulting simplified polyline is copied to the output range
@@ -1073,6 +1317,152 @@ namespace psimpl
             InputIterator last,
             value_type tol,
             OutputIterator result)
+        {
+            return DouglasPeucker (first, last, tol, result, PREFILTER_COPY);
+        }
+
+        /*!
+            \brief Performs Douglas-Peucker approximation (DP) using the specified prefilter.
+
+            PREFILTER_COPY is the classic behaviour: the points that remain after RD are copied,
+            and DP operates on that copy. PREFILTER_INDEX flags the points that remain after RD
+            using one bit per point, and DP operates directly on the input while skipping all
+            unflagged points. Both produce the same simplification. PREFILTER_NONE skips RD
+            altogether, and DP operates directly on the input.
+
+            Operating directly on the input requires the coordinates to be stored contiguously,
+            which is the case for pointers and std::vector iterators. For any other InputIterator
+            type the input is copied anyway, and PREFILTER_INDEX behaves like PREFILTER_COPY.
+
+            \sa DouglasPeucker(InputIterator, InputIterator, value_type, OutputIterator)
+
+            \param[in] first        the first coordinate of the first polyline point
+            \param[in] last         one beyond the last coordinate of the last polyline point
+            \param[in] tol          perpendicular (point-to-segment) distance tolerance
+            \param[in] result       destination of the simplified polyline
+            \param[in] prefilter    how to apply the RD preprocessing step
+            \param[out] removed     optional, the number of points removed by RD
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        OutputIterator DouglasPeucker (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result,
+            Prefilter prefilter,
+            diff_type* removed = 0)
+        {
+            if (removed) {
+                *removed = 0;
+            }
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount < 3 || tol == 0) {
+                return std::copy (first, last, result);
+            }
+
+            const value_type* coords = Contiguous (first);
+
+            if (coords && prefilter == PREFILTER_INDEX) {
+                // radial distance routine as preprocessing, without copying
+                util::bit_array reduced (pointCount);   // radial distance results
+                instrumentation.Allocated (reduced.bytes ());
+                ptr_diff_type reducedPointCount = 0;
+                {
+                    ScopedPhase phase (instrumentation, PHASE_PREFILTER);
+                    reducedPointCount = RadialDistanceFilter (coords, pointCount, tol, reduced);
+                }
+                instrumentation.Reduced (pointCount, reducedPointCount);
+                if (removed) {
+                    *removed = static_cast <diff_type> (pointCount - reducedPointCount);
+                }
+
+                // douglas-peucker approximation
+                util::bit_array keys (pointCount);   // douglas-peucker results
+                instrumentation.Allocated (keys.bytes ());
+                {
+                    ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                    DPHelper::Approximate (coords, coordCount, tol, reduced, keys, instrumentation, cancellation);
+                }
+
+                // copy all keys
+                ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+                return CopyKeys (coords, pointCount, keys, result);
+            }
+
+            // only allocate when DP cannot operate directly on the input
+            util::scoped_array <value_type> reduced (
+                coords && prefilter == PREFILTER_NONE ? 0 : coordCount);
+            ptr_diff_type reducedCoordCount = coordCount;
+            if (!coords || prefilter != PREFILTER_NONE) {
+                instrumentation.Allocated (coordCount * sizeof (value_type));
+            }
+
+            if (prefilter != PREFILTER_NONE) {
+                // radial distance routine as preprocessing
+                ScopedPhase phase (instrumentation, PHASE_PREFILTER);
+                PolylineSimplification <DIM, InputIterator, value_type*, Instrumentation>
+                    psimpl_to_array (instrumentation, cancellation);
+                reducedCoordCount = std::distance (reduced.get (),
+                    psimpl_to_array.RadialDistance (first, last, tol, reduced.get ()));
+                coords = reduced.get ();
+                if (removed) {
+                    *removed = static_cast <diff_type> ((coordCount - reducedCoordCount) / DIM);
+                }
+            }
+            else if (!coords) {
+                // non-contiguous input
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                CopyCoords (first, coordCount, reduced.get ());
+                coords = reduced.get ();
+            }
+            ptr_diff_type reducedPointCount = reducedCoordCount / DIM;
+            if (prefilter != PREFILTER_NONE) {
+                instrumentation.Reduced (pointCount, reducedPointCount);
+            }
+
+            // douglas-peucker approximation
+            util::bit_array keys (reducedPointCount);   // douglas-peucker results
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::Approximate (coords, reducedCoordCount, tol, keys, instrumentation, cancellation);
+            }
+
+            // copy all keys
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyKeys (coords, reducedPointCount, keys, result);
+        }
+
+        /*!
+            \brief Performs Douglas-Peucker approximation (DP) using bounding volume pruning.
+
+            After RD, the remaining points are grouped in blocks of consecutive points, each with a
+            bounding sphere. While searching for the key of a sub polyline, a block that lies
+            completely inside the sub polyline is skipped when the bounding sphere proves that
+            none of its points is further away from the segment than the tolerance, or than the
+            best key found so far. The bounds include a conservative margin for rounding errors,
+            which makes the result identical to DouglasPeucker. Smooth polylines benefit the most,
+            as most sub polylines are then resolved with only a few bound tests.
+
+            Integer value types are approximated without pruning.
+
+            \sa DouglasPeucker(InputIterator, InputIterator, value_type, OutputIterator)
+
+            \param[in] first    the first coordinate of the first polyline point
+            \param[in] last     one beyond the last coordinate of the last polyline point
+            \param[in] tol      perpendicular (point-to-segment) distance tolerance
+            \param[in] result   destination of the simplified polyline
+            \return             one beyond the last coordinate of the simplified polyline
+        */
+        OutputIterator DouglasPeuckerAccelerated (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result)
         {
             diff_type coordCount = std::distance (first, last);
             diff_type pointCount = DIM      // protect against zero DIM
@@ -1084,26 +1474,29 @@ namespace psimpl
             }
             // radial distance routine as preprocessing
             util::scoped_array <value_type> reduced (coordCount);   // radial distance results
-            PolylineSimplification <DIM, InputIterator, value_type*> psimpl_to_array;
-            ptr_diff_type reducedCoordCount = std::distance (reduced.get (),
-                psimpl_to_array.RadialDistance (first, last, tol, reduced.get ()));
+            instrumentation.Allocated (coordCount * sizeof (value_type));
+            ptr_diff_type reducedCoordCount = 0;
+            {
+                ScopedPhase phase (instrumentation, PHASE_PREFILTER);
+                PolylineSimplification <DIM, InputIterator, value_type*, Instrumentation>
+                    psimpl_to_array (instrumentation, cancellation);
+                reducedCoordCount = std::distance (reduced.get (),
+                    psimpl_to_array.RadialDistance (first, last, tol, reduced.get ()));
+            }
             ptr_diff_type reducedPointCount = reducedCoordCount / DIM;
+            instrumentation.Reduced (pointCount, reducedPointCount);
 
             // douglas-peucker approximation
-            util::scoped_array <unsigned char> keys (pointCount);         // douglas-peucker results
-            DPHelper::Approximate (reduced.get (), reducedCoordCount, tol, keys.get ());
+            util::bit_array keys (reducedPointCount);   // douglas-peucker results
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::ApproximateAccelerated (reduced.get (), reducedCoordCount, tol, keys, instrumentation, cancellation);
+            }
 
             // copy all keys
-            const value_type* current = reduced.get ();
-            for (ptr_diff_type p=0; p<reducedPointCount; ++p, current += DIM) {
-                if (keys [p]) {
-                    for (unsigned d = 0; d < DIM; ++d) {
-                        *result = current [d];
-                        ++result;
-                    }
-                }
-            }
-            return result;
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyKeys (reduced.get (), reducedPointCount, keys, result);
         }
 
         /*!
@@ -1119,7 +1512,7 @@ namespace psimpl
             preprocessing step, is O(n2) in worst case and O(n log n) on average.
 
             Note that this algorithm will create a copy of the input polyline for performance
-            reasons.
+            reasons, unless its coordinates are stored contiguously.
 
             DPn is applied to the range [first, last). The resulting simplified polyline consists
             of count vertices and is copied to the output range [result, result + count). The
@@ -1160,108 +1553,698 @@ namespace psimpl
                 return std::copy (first, last, result);
             }
 
-            // copy coords
-            util::scoped_array <value_type> coords (coordCount);
-            for (ptr_diff_type c=0; c<coordCount; ++c) {
-                coords [c] = *first;
-                ++first;
+            // copy coords, unless they are stored contiguously
+            const value_type* coords = Contiguous (first);
+            util::scoped_array <value_type> copy (coords ? 0 : coordCount);
+            if (!coords) {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                instrumentation.Allocated (coordCount * sizeof (value_type));
+                CopyCoords (first, coordCount, copy.get ());
+                coords = copy.get ();
             }
 
             // douglas-peucker approximation
-            util::scoped_array <unsigned char> keys (pointCount);
-            DPHelper::ApproximateN (coords.get (), coordCount, count, keys.get ());
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::ApproximateN (coords, coordCount, count, keys, instrumentation, cancellation);
+            }
 
             // copy keys
-            const value_type* current = coords.get ();
-            for (ptr_diff_type p=0; p<pointCount; ++p, current += DIM) {
-                if (keys [p]) {
-                    for (unsigned d = 0; d < DIM; ++d) {
-                        *result = current [d];
-                        ++result;
-                    }
-                }
-            }
-            return result;
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyKeys (coords, pointCount, keys, result);
         }
 
         /*!
-            \brief Computes the squared positional error between a polyline and its simplification.
-
-            For each point in the range [original_first, original_last) the squared distance to the
-            simplification [simplified_first, simplified_last) is calculated. Each positional error
-            is copied to the output range [result, result + count), where count is the number of
-            points in the original polyline. The return value is the end of the output range:
-            result + count.
+            \brief Reports the order in which the Douglas-Peucker variant (DPn) selects keys.
 
-            Note that both the original and simplified polyline must be defined using the same
-            value_type.
+            DPn repeatedly adds the point that is furthest away from the current simplification.
+            This routine performs DPn, and writes each key to the output range at the moment it is
+            selected, as a std::pair of its point index and its squared distance to the
+            simplification at that moment. The first and last polyline point are implicit keys,
+            and are not reported.
 
-            \image html psimpl_pos_error.png
+            Any prefix of m keys, together with the first and last point, forms the DPn
+            simplification with m+2 points. The squared distance of the next key is the largest
+            squared distance of any polyline point to that simplification. Once all remaining points
+            lie on the simplification, DPn keeps selecting them, so they are reported as well, with
+            a squared distance of 0. The output therefore contains min(count, n) - 2 keys, where n
+            is the number of polyline points, unless the approximation is cancelled.
 
-            Input (Type) requirements:
-            1- DIM is not 0, where DIM represents the dimension of the polyline
-            2- The InputIterator type models the concept of a forward iterator
-            3- The InputIterator value type is convertible to a value type of the output iterator
-            4- The ranges [original_first, original_last) and [simplified_first, simplified_last)
-               contain vertex coordinates in multiples of DIM, f.e.: x, y, z, x, y, z, x, y, z
-               when DIM = 3
-            5- The ranges [original_first, original_last) and [simplified_first, simplified_last)
-               contain a minimum of 2 vertices
-            6- The range [simplified_first, simplified_last) represents a simplification of the
-               range [original_first, original_last), meaning each point in the simplification
-               has the exact same coordinates as some point from the original polyline
+            Input (Type) requirements are equal to those of DouglasPeuckerN. In addition:
+            1- KeyIterator must accept std::pair <diff_type, value_type> values
 
-            In case these requirements are not met, the valid flag is set to false OR
-            compile errors may occur.
+            Nothing is written when these requirements are not met.
 
-            \param[in] original_first   the first coordinate of the first polyline point
-            \param[in] original_last    one beyond the last coordinate of the last polyline point
-            \param[in] simplified_first the first coordinate of the first simplified polyline point
-            \param[in] simplified_last  one beyond the last coordinate of the last simplified polyline point
-            \param[in] result           destination of the squared positional errors
-            \param[out] valid           [optional] indicates if the computed positional errors are valid
-            \return                     one beyond the last computed positional error
+            \param[in] first    the first coordinate of the first polyline point
+            \param[in] last     one beyond the last coordinate of the last polyline point
+            \param[in] count    the maximum number of points of the simplification, including the
+                                first and last point
+            \param[in] result   destination of the keys
+            \return             one beyond the last key
         */
-        OutputIterator ComputePositionalErrors2 (
-            InputIterator original_first,
-            InputIterator original_last,
-            InputIterator simplified_first,
-            InputIterator simplified_last,
-            OutputIterator result,
-            bool* valid=0)
+        template <class KeyIterator>
+        KeyIterator DouglasPeuckerNOrder (
+            InputIterator first,
+            InputIterator last,
+            unsigned count,
+            KeyIterator result)
         {
-            diff_type original_coordCount = std::distance (original_first, original_last);
-            diff_type original_pointCount = DIM     // protect against zero DIM
-                                            ? original_coordCount / DIM
-                                            : 0;
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount < 3 || count < 3) {
+                return result;
+            }
+            if (static_cast <diff_type> (count) > pointCount) {
+                count = static_cast <unsigned> (pointCount);
+            }
 
-            diff_type simplified_coordCount = std::distance (simplified_first, simplified_last);
-            diff_type simplified_pointCount = DIM   // protect against zero DIM
-                                              ? simplified_coordCount / DIM
-                                              : 0;
+            // copy coords, unless they are stored contiguously
+            const value_type* coords = Contiguous (first);
+            util::scoped_array <value_type> copy (coords ? 0 : coordCount);
+            if (!coords) {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                instrumentation.Allocated (coordCount * sizeof (value_type));
+                CopyCoords (first, coordCount, copy.get ());
+                coords = copy.get ();
+            }
 
-            // validate input
-            if (original_coordCount % DIM || original_pointCount < 2 ||
-                simplified_coordCount % DIM || simplified_pointCount < 2 ||
-                original_pointCount < simplified_pointCount ||
-                !math::equal <DIM> (original_first, simplified_first))
+            // douglas-peucker approximation
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            std::vector <std::pair <ptr_diff_type, value_type> > order;
             {
-                if (valid) {
-                    *valid = false;
-                }
-                return result;
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::ApproximateN (coords, coordCount, count, keys, instrumentation, cancellation, &order);
             }
 
-            // define (simplified) line segment S(simplified_prev, simplified_first)
-            InputIterator simplified_prev = simplified_first;
-            std::advance (simplified_first, DIM);
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            for (std::size_t i = 0; i < order.size (); ++i) {
+                *result = std::make_pair (static_cast <diff_type> (order [i].first), order [i].second);
+                ++result;
+            }
+            return result;
+        }
 
-            // process each simplified line segment
-            while (simplified_first != simplified_last) {
+        /*!
+            \brief Performs Douglas-Peucker approximation (DP) on a ring.
+
+            A ring is a closed polyline, such as the boundary of a polygon. Simplifying a ring as
+            a polyline keeps its first point, wherever it happens to be, and treats the ring as
+            open at that point. Instead, this routine selects two anchors that lie far apart: the
+            vertex furthest away from the first vertex, and the vertex furthest away from that
+            first anchor. The ring is then approximated cyclically, starting and ending at the
+            first anchor, so that DP selects the second anchor as its first key. The simplified
+            ring always contains at least these two vertices.
+
+            The ring is either explicitly closed, meaning its last point equals its first point,
+            or implicitly closed. The simplified ring is closed in the same way, and its vertices
+            are in the original order, starting at the first key of the input range.
+
+            Like DouglasPeucker, the RD routine is used as a preprocessing step. Note that this
+            algorithm will always create a copy of the input ring.
+
+            Input (Type) requirements:
+            1- DIM is not 0, where DIM represents the dimension of the ring
+            2- The InputIterator type models the concept of a forward iterator
+            3- The InputIterator value type is convertible to a value type of the output iterator
+            4- The range [first, last) contains vertex coordinates in multiples of DIM, f.e.:
+               x, y, z, x, y, z, x, y, z when DIM = 3
+            5- The range [first, last) contains at least 3 vertices, not counting the closing point
+            6- tol is not 0
+
+            In case these requirements are not met, the entire input range [first, last) is copied
+            to the output range [result, result + (last - first)) OR compile errors may occur.
+
+            \sa DouglasPeucker
+
+            \param[in] first    the first coordinate of the first ring point
+            \param[in] last     one beyond the last coordinate of the last ring point
+            \param[in] tol      perpendicular (point-to-segment) distance tolerance
+            \param[in] result   destination of the simplified ring
+            \return             one beyond the last coordinate of the simplified ring
+        */
+        OutputIterator DouglasPeuckerRing (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount < 3 || tol == 0) {
+                return std::copy (first, last, result);
+            }
+
+            // copy the ring, starting and ending at the first anchor
+            util::scoped_array <value_type> ring ((pointCount + 1) * DIM);
+            instrumentation.Allocated ((pointCount + 1) * DIM * sizeof (value_type));
+            ptr_diff_type vertexCount = 0;
+            ptr_diff_type start = 0;
+            bool closed = false;
+            {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                vertexCount = CopyRing (first, pointCount, ring.get (), start, closed);
+            }
+            if (vertexCount < 3) {
+                return std::copy (first, last, result);
+            }
+            ptr_diff_type ringPointCount = vertexCount + 1;
+
+            // radial distance routine as preprocessing
+            util::bit_array reduced (ringPointCount);
+            instrumentation.Allocated (reduced.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_PREFILTER);
+                instrumentation.Reduced (ringPointCount,
+                    RadialDistanceFilter (ring.get (), ringPointCount, tol, reduced));
+            }
+
+            // douglas-peucker approximation
+            util::bit_array keys (ringPointCount);
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::Approximate (ring.get (), ringPointCount * DIM, tol, reduced, keys,
+                                       instrumentation, cancellation);
+                // keep the second anchor when the ring lies within tolerance of the first one
+                if (keys.find_next (0) == static_cast <std::size_t> (vertexCount)) {
+                    keys.set (FindAnchor (ring.get (), vertexCount));
+                }
+            }
+
+            // copy keys
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyRingKeys (ring.get (), vertexCount, keys, start, closed, result);
+        }
+
+        /*!
+            \brief Performs a Douglas-Peucker approximation variant (DPn) on a ring.
+
+            The ring is approximated cyclically from the same anchors as DouglasPeuckerRing.
+            The simplified ring consists of count vertices, not counting the closing point of an
+            explicitly closed ring.
+
+            Input (Type) requirements are equal to those of DouglasPeuckerRing, except for tol. In
+            addition:
+            1- The ring contains more than count vertices, not counting the closing point
+            2- count is at least 3
+
+            In case these requirements are not met, the entire input range [first, last) is copied
+            to the output range [result, result + (last - first)) OR compile errors may occur.
+
+            \sa DouglasPeuckerN, DouglasPeuckerRing
+
+            \param[in] first    the first coordinate of the first ring point
+            \param[in] last     one beyond the last coordinate of the last ring point
+            \param[in] count    the maximum number of vertices of the simplified ring
+            \param[in] result   destination of the simplified ring
+            \return             one beyond the last coordinate of the simplified ring
+        */
+        OutputIterator DouglasPeuckerNRing (
+            InputIterator first,
+            InputIterator last,
+            unsigned count,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount <= static_cast <diff_type> (count) || count < 3) {
+                return std::copy (first, last, result);
+            }
+
+            // copy the ring, starting and ending at the first anchor
+            util::scoped_array <value_type> ring ((pointCount + 1) * DIM);
+            instrumentation.Allocated ((pointCount + 1) * DIM * sizeof (value_type));
+            ptr_diff_type vertexCount = 0;
+            ptr_diff_type start = 0;
+            bool closed = false;
+            {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                vertexCount = CopyRing (first, pointCount, ring.get (), start, closed);
+            }
+            if (vertexCount <= static_cast <ptr_diff_type> (count)) {
+                return std::copy (first, last, result);
+            }
+            ptr_diff_type ringPointCount = vertexCount + 1;
+
+            // douglas-peucker approximation; the first anchor is counted twice
+            util::bit_array keys (ringPointCount);
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::ApproximateN (ring.get (), ringPointCount * DIM, count + 1, keys,
+                                        instrumentation, cancellation);
+            }
+
+            // copy keys
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyRingKeys (ring.get (), vertexCount, keys, start, closed, result);
+        }
+
+        /*!
+            \brief Performs the nth point routine (NP) in place.
+
+            NP never writes a point before it has read it, which allows the simplification to be
+            stored in the input range itself. The points of the simplified polyline are compacted
+            to the front of the range [first, last). The return value is the new end of the
+            polyline: first + m*DIM, where m is the number of vertices of the simplified polyline.
+            The contents of the range [first + m*DIM, last) are unspecified afterwards.
+
+            Input (Type) requirements are equal to those of NthPoint. In addition the Iterator
+            type must be mutable and have the same value type as InputIterator. As Iterator is a
+            member template parameter, the class itself can still be instantiated for a constant
+            InputIterator. In case these requirements are not met, the range [first, last) is left
+            unchanged and last is returned OR compile errors may occur.
+
+            \sa NthPoint
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     n        specifies 'each nth point'
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator NthPointInplace (
+            Iterator first,
+            Iterator last,
+            unsigned n)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            return ps.NthPoint (first, last, n, first);
+        }
+
+        /*!
+            \brief Performs the (radial) distance between points routine (RD) in place.
+
+            \sa NthPointInplace, RadialDistance
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     tol      radial (point-to-point) distance tolerance
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator RadialDistanceInplace (
+            Iterator first,
+            Iterator last,
+            value_type tol)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            return ps.RadialDistance (first, last, tol, first);
+        }
+
+        /*!
+            \brief Repeatedly performs the perpendicular distance routine (PD) in place.
+
+            Each pass operates on the result of the previous pass, so unlike PerpendicularDistance
+            no intermediate simplification results need to be stored.
+
+            \sa NthPointInplace, PerpendicularDistance(InputIterator, InputIterator, value_type, unsigned, OutputIterator)
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     tol      perpendicular (segment-to-point) distance tolerance
+            \param[in]     repeat   the number of times to successively apply the PD routine
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator PerpendicularDistanceInplace (
+            Iterator first,
+            Iterator last,
+            value_type tol,
+            unsigned repeat)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            for (unsigned r = 0; r < repeat; ++r) {
+                Iterator end = ps.PerpendicularDistance (first, last, tol, first);
+                // check if simplification did not improve
+                if (end == last) {
+                    break;
+                }
+                last = end;
+            }
+            return last;
+        }
+
+        /*!
+            \brief Performs the perpendicular distance routine (PD) in place.
+
+            \sa NthPointInplace, PerpendicularDistance(InputIterator, InputIterator, value_type, OutputIterator)
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     tol      perpendicular (segment-to-point) distance tolerance
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator PerpendicularDistanceInplace (
+            Iterator first,
+            Iterator last,
+            value_type tol)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            return ps.PerpendicularDistance (first, last, tol, first);
+        }
+
+        /*!
+            \brief Performs Reumann-Witkam approximation (RW) in place.
+
+            \sa NthPointInplace, ReumannWitkam
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     tol      perpendicular (point-to-line) distance tolerance
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator ReumannWitkamInplace (
+            Iterator first,
+            Iterator last,
+            value_type tol)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            return ps.ReumannWitkam (first, last, tol, first);
+        }
+
+        /*!
+            \brief Performs Opheim approximation (OP) in place.
+
+            \sa NthPointInplace, Opheim
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     min_tol  radial and perpendicular (point-to-ray) distance tolerance
+            \param[in]     max_tol  radial distance tolerance
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator OpheimInplace (
+            Iterator first,
+            Iterator last,
+            value_type min_tol,
+            value_type max_tol)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            return ps.Opheim (first, last, min_tol, max_tol, first);
+        }
+
+        /*!
+            \brief Performs Lang approximation (LA) in place.
+
+            Lang only moves backward within the current search region, which never extends before
+            the most recently written key.
+
+            \sa NthPointInplace, Lang
+
+            \param[in,out] first      the first coordinate of the first polyline point
+            \param[in]     last       one beyond the last coordinate of the last polyline point
+            \param[in]     tol        perpendicular (point-to-segment) distance tolerance
+            \param[in]     look_ahead defines the size of the search region
+            \return                   one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator LangInplace (
+            Iterator first,
+            Iterator last,
+            value_type tol,
+            unsigned look_ahead)
+        {
+            PolylineSimplification <DIM, Iterator, Iterator, Instrumentation> ps (instrumentation, cancellation);
+            return ps.Lang (first, last, tol, look_ahead, first);
+        }
+
+        /*!
+            \brief Performs Douglas-Peucker approximation (DP) in place.
+
+            The radial distance preprocessing step is performed in place. Its result is then
+            approximated, after which the keys are compacted to the front of the range
+            [first, last). Compared to DouglasPeucker this avoids allocating an output range. An
+            internal copy of the points that remain after preprocessing is only made when the
+            coordinates are not stored contiguously.
+
+            \sa NthPointInplace, DouglasPeucker
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     tol      perpendicular (point-to-segment) distance tolerance
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator DouglasPeuckerInplace (
+            Iterator first,
+            Iterator last,
+            value_type tol)
+        {
+            typedef typename std::iterator_traits <Iterator>::difference_type diff_type;
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount < 3 || tol == 0) {
+                return last;
+            }
+            // radial distance routine as preprocessing
+            {
+                ScopedPhase phase (instrumentation, PHASE_PREFILTER);
+                last = RadialDistanceInplace (first, last, tol);
+            }
+            ptr_diff_type reducedCoordCount = std::distance (first, last);
+            ptr_diff_type reducedPointCount = reducedCoordCount / DIM;
+            instrumentation.Reduced (pointCount, reducedPointCount);
+
+            // copy radial distance results, unless they are stored contiguously
+            const value_type* reduced = Contiguous (first);
+            util::scoped_array <value_type> copy (reduced ? 0 : reducedCoordCount);
+            if (!reduced) {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                instrumentation.Allocated (reducedCoordCount * sizeof (value_type));
+                CopyCoords (first, reducedCoordCount, copy.get ());
+                reduced = copy.get ();
+            }
+
+            // douglas-peucker approximation
+            util::bit_array keys (reducedPointCount);   // douglas-peucker results
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::Approximate (reduced, reducedCoordCount, tol, keys, instrumentation, cancellation);
+            }
+
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyKeys (reduced, reducedPointCount, keys, first);
+        }
+
+        /*!
+            \brief Performs a Douglas-Peucker approximation variant (DPn) in place.
+
+            \sa NthPointInplace, DouglasPeuckerN
+
+            \param[in,out] first    the first coordinate of the first polyline point
+            \param[in]     last     one beyond the last coordinate of the last polyline point
+            \param[in]     count    the maximum number of points of the simplified polyline
+            \return                 one beyond the last coordinate of the simplified polyline
+        */
+        template <class Iterator>
+        Iterator DouglasPeuckerNInplace (
+            Iterator first,
+            Iterator last,
+            unsigned count)
+        {
+            typedef typename std::iterator_traits <Iterator>::difference_type diff_type;
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount <= static_cast <diff_type> (count) || count < 2) {
+                return last;
+            }
+
+            // copy coords, unless they are stored contiguously
+            const value_type* coords = Contiguous (first);
+            util::scoped_array <value_type> copy (coords ? 0 : coordCount);
+            if (!coords) {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                instrumentation.Allocated (coordCount * sizeof (value_type));
+                CopyCoords (first, coordCount, copy.get ());
+                coords = copy.get ();
+            }
+
+            // douglas-peucker approximation
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::ApproximateN (coords, coordCount, count, keys, instrumentation, cancellation);
+            }
+
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return CopyKeys (coords, pointCount, keys, first);
+        }
+
+        /*!
+            \brief Computes the squared Douglas-Peucker importance of each polyline point.
+
+            Douglas-Peucker always splits a (sub) polyline at the same key, regardless of the
+            tolerance; the tolerance only determines where the recursion stops. The importance of a
+            point is the largest squared tolerance for which it is still a key. It equals the
+            minimum of the squared distances of the point and all keys that led to it. The first
+            and last point have the largest representable importance, points that are never a key
+            have importance 0.
+
+            Once computed, the simplification for any tolerance tol is found by keeping the points
+            for which tol * tol < importance. This is the same simplification as produced by
+            DouglasPeucker using PREFILTER_NONE. Each importance is copied to the output range
+            [result, result + count), where count is the number of polyline points.
+
+            Input (Type) requirements:
+            1- DIM is not 0, where DIM represents the dimension of the polyline
+            2- The InputIterator type models the concept of a forward iterator
+            3- The InputIterator value type is convertible to a value type of the output iterator
+            4- The range [first, last) contains vertex coordinates in multiples of DIM
+            5- The range [first, last) contains a minimum of 2 vertices
+
+            In case these requirements are not met, the valid flag is set to false OR
+            compile errors may occur.
+
+            \param[in] first    the first coordinate of the first polyline point
+            \param[in] last     one beyond the last coordinate of the last polyline point
+            \param[in] result   destination of the squared importance of each point
+            \param[out] valid   [optional] indicates if the computed importance is valid
+            \return             one beyond the last computed importance
+        */
+        OutputIterator ComputeDouglasPeuckerImportance2 (
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            bool* valid=0)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            // validate input
+            if (coordCount % DIM || pointCount < 2) {
+                if (valid) {
+                    *valid = false;
+                }
+                return result;
+            }
+
+            // copy coords, unless they are stored contiguously
+            const value_type* coords = Contiguous (first);
+            util::scoped_array <value_type> copy (coords ? 0 : coordCount);
+            if (!coords) {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                instrumentation.Allocated (coordCount * sizeof (value_type));
+                CopyCoords (first, coordCount, copy.get ());
+                coords = copy.get ();
+            }
+
+            util::scoped_array <value_type> importance (pointCount);
+            instrumentation.Allocated (pointCount * sizeof (value_type));
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                DPHelper::Importance (coords, coordCount, importance.get (), instrumentation, cancellation);
+            }
+
+            if (valid) {
+                *valid = true;
+            }
+            return std::copy (importance.get (), importance.get () + pointCount, result);
+        }
+
+        /*!
+            \brief Computes the squared positional error between a polyline and its simplification.
+
+            For each point in the range [original_first, original_last) the squared distance to the
+            simplification [simplified_first, simplified_last) is calculated. Each positional error
+            is copied to the output range [result, result + count), where count is the number of
+            points in the original polyline. The return value is the end of the output range:
+            result + count.
+
+            Note that both the original and simplified polyline must be defined using the same
+            value_type.
+
+            \image html psimpl_pos_error.png
+
+            Input (Type) requirements:
+            1- DIM is not 0, where DIM represents the dimension of the polyline
+            2- The InputIterator type models the concept of a forward iterator
+            3- The InputIterator value type is convertible to a value type of the output iterator
+            4- The ranges [original_first, original_last) and [simplified_first, simplified_last)
+               contain vertex coordinates in multiples of DIM, f.e.: x, y, z, x, y, z, x, y, z
+               when DIM = 3
+            5- The ranges [original_first, original_last) and [simplified_first, simplified_last)
+               contain a minimum of 2 vertices
+            6- The range [simplified_first, simplified_last) represents a simplification of the
+               range [original_first, original_last), meaning each point in the simplification
+               has the exact same coordinates as some point from the original polyline
+
+            In case these requirements are not met, the valid flag is set to false OR
+            compile errors may occur.
+
+            \param[in] original_first   the first coordinate of the first polyline point
+            \param[in] original_last    one beyond the last coordinate of the last polyline point
+            \param[in] simplified_first the first coordinate of the first simplified polyline point
+            \param[in] simplified_last  one beyond the last coordinate of the last simplified polyline point
+            \param[in] result           destination of the squared positional errors
+            \param[out] valid           [optional] indicates if the computed positional errors are valid
+            \return                     one beyond the last computed positional error
+        */
+        OutputIterator ComputePositionalErrors2 (
+            InputIterator original_first,
+            InputIterator original_last,
+            InputIterator simplified_first,
+            InputIterator simplified_last,
+            OutputIterator result,
+            bool* valid=0)
+        {
+            diff_type original_coordCount = std::distance (original_first, original_last);
+            diff_type original_pointCount = DIM     // protect against zero DIM
+                                            ? original_coordCount / DIM
+                                            : 0;
+
+            diff_type simplified_coordCount = std::distance (simplified_first, simplified_last);
+            diff_type simplified_pointCount = DIM   // protect against zero DIM
+                                              ? simplified_coordCount / DIM
+                                              : 0;
+
+            // validate input
+            if (original_coordCount % DIM || original_pointCount < 2 ||
+                simplified_coordCount % DIM || simplified_pointCount < 2 ||
+                original_pointCount < simplified_pointCount ||
+                !math::equal <DIM> (original_first, simplified_first))
+            {
+                if (valid) {
+                    *valid = false;
+                }
+                return result;
+            }
+
+            // define (simplified) line segment S(simplified_prev, simplified_first)
+            InputIterator simplified_prev = simplified_first;
+            std::advance (simplified_first, DIM);
+
+            // process each simplified line segment
+            while (simplified_first != simplified_last) {
                 // process each original point until it equals the end of the line segment
                 while (original_first != original_last &&
                        !math::equal <DIM> (original_first, simplified_first))
                 {
+                    instrumentation.Distances (1);
                     *result = math::segment_distance2 <DIM> (simplified_prev, simplified_first,
                                                              original_first);
                     ++result;
@@ -1324,7 +2307,7 @@ namespace psimpl
         {
             diff_type pointCount = std::distance (original_first, original_last) / DIM;
             util::scoped_array <double> errors (pointCount);
-            PolylineSimplification <DIM, InputIterator, double*> ps;
+            PolylineSimplification <DIM, InputIterator, double*, Instrumentation> ps (instrumentation, cancellation);
 
             diff_type errorCount = 
                 std::distance (
@@ -1333,14 +2316,76 @@ namespace psimpl
                                                  simplified_first, simplified_last,
                                                  errors.get (), valid));
 
-            std::transform (errors.get (), errors.get () + errorCount,
-                            errors.get (),
-                            std::function <double(double)> (std::sqrt));
+            std::transform (errors.get (), errors.get () + errorCount,
+                            errors.get (),
+                            static_cast <double (*)(double)> (std::sqrt));
+
+            return math::compute_statistics (errors.get (), errors.get () + errorCount);
+        }
+
+    private:
+        /*!
+            \brief Reports a phase to the instrumentation for the lifetime of this object.
+        */
+        class ScopedPhase {
+        public:
+            ScopedPhase (const Instrumentation& instrumentation, Phase phase) :
+                instrumentation (instrumentation), phase (phase)
+            {
+                instrumentation.Begin (phase);
+            }
+
+            ~ScopedPhase () {
+                instrumentation.End (phase);
+            }
+
+        private:
+            ScopedPhase (const ScopedPhase&);
+            ScopedPhase& operator= (const ScopedPhase&);
+
+        private:
+            const Instrumentation& instrumentation;
+            Phase phase;
+        };
+
+        /*!
+            \brief Checks the cancellation token once at least CHECK_INTERVAL points were tested.
+
+            \param[in,out] work     the number of points tested since the previous check
+            \return                 true when the routine should stop
+        */
+        inline bool Interrupted (
+            diff_type& work) const
+        {
+            if (!cancellation || work < CancellationToken::CHECK_INTERVAL) {
+                return false;
+            }
+            work = 0;
+            return cancellation->Cancelled ();
+        }
+
+        /*!
+            \brief Copies the last polyline point to the output destination, after a routine was
+            interrupted.
 
-            return math::compute_statistics (errors.get (), errors.get () + errorCount);
+            The last point is reached using std::advance, which takes constant time for random
+            access iterators.
+
+            \param[in] it           a point that follows the last copied key
+            \param[in] remaining    the number of points that follow it
+            \param[in] result       destination of the last point
+            \return                 one beyond the last coordinate of the copied point
+        */
+        inline OutputIterator CopyLast (
+            InputIterator it,
+            diff_type remaining,
+            OutputIterator result)
+        {
+            std::advance (it, remaining * static_cast <diff_type> (DIM));
+            CopyKey (it, result);
+            return result;
         }
 
-    private:
         /*!
             \brief Copies the key to the output destination, and increments the iterator.
 
@@ -1447,7 +2492,221 @@ namespace psimpl
             ++remaining;
         }
 
+        /*!
+            \brief Finds the ring vertex that is furthest away from the first vertex.
+
+            \param[in] ring         array of ring coordinates
+            \param[in] vertexCount  number of ring vertices, not counting the closing point
+            \return                 the index of the furthest vertex; the last one in case of ties
+        */
+        ptr_diff_type FindAnchor (
+            const value_type* ring,
+            ptr_diff_type vertexCount)
+        {
+            ptr_diff_type anchor = 0;
+            value_type max_dist2 = 0;
+            for (ptr_diff_type v = 1; v < vertexCount; ++v) {
+                value_type dist2 = math::point_distance2 <DIM> (ring, ring + v * DIM);
+                instrumentation.Distances (1);
+                if (dist2 < max_dist2) {
+                    continue;
+                }
+                anchor = v;
+                max_dist2 = dist2;
+            }
+            return anchor;
+        }
+
+        /*!
+            \brief Copies a ring to an array, rotated to start and end at its first anchor.
+
+            The first anchor is the vertex that is furthest away from the first vertex.
+
+            \param[in] first        the first coordinate of the first ring point
+            \param[in] pointCount   number of ring points, including an optional closing point
+            \param[out] ring        destination array, with room for pointCount + 1 points
+            \param[out] start       index in ring [] of the first vertex of the input range
+            \param[out] closed      indicates if the last ring point equals the first one
+            \return                 the number of ring vertices, not counting the closing point
+        */
+        ptr_diff_type CopyRing (
+            InputIterator first,
+            ptr_diff_type pointCount,
+            value_type* ring,
+            ptr_diff_type& start,
+            bool& closed)
+        {
+            CopyCoords (first, pointCount * DIM, ring);
+            closed = math::equal <DIM> (ring, ring + (pointCount - 1) * DIM);
+            ptr_diff_type vertexCount = closed ? pointCount - 1 : pointCount;
+
+            ptr_diff_type anchor = FindAnchor (ring, vertexCount);
+            start = anchor ? vertexCount - anchor : 0;
+
+            // rotate and close the ring
+            std::rotate (ring, ring + anchor * DIM, ring + vertexCount * DIM);
+            std::copy (ring, ring + DIM, ring + vertexCount * DIM);
+            return vertexCount;
+        }
+
+        /*!
+            \brief Copies the coordinates of all ring keys to the output destination, in their
+            original order.
+
+            \param[in] ring         array of ring coordinates, as created by CopyRing
+            \param[in] vertexCount  number of ring vertices, not counting the closing point
+            \param[in] keys         indicates for each ring point if it is a key
+            \param[in] start        index in ring [] of the first vertex of the input range
+            \param[in] closed       indicates if the first key should be repeated
+            \param[in] result       destination of the copied keys
+            \return                 one beyond the last coordinate of the copied keys
+        */
+        static OutputIterator CopyRingKeys (
+            const value_type* ring,
+            ptr_diff_type vertexCount,
+            const util::bit_array& keys,
+            ptr_diff_type start,
+            bool closed,
+            OutputIterator result)
+        {
+            const value_type* firstKey = 0;
+            for (ptr_diff_type v = 0; v < vertexCount; ++v) {
+                ptr_diff_type index = (start + v) % vertexCount;
+                if (!keys [index]) {
+                    continue;
+                }
+                const value_type* key = ring + index * DIM;
+                if (!firstKey) {
+                    firstKey = key;
+                }
+                result = std::copy (key, key + DIM, result);
+            }
+            if (closed && firstKey) {
+                result = std::copy (firstKey, firstKey + DIM, result);
+            }
+            return result;
+        }
+
+        /*!
+            \brief Copies the coordinates of all keys to the output destination.
+
+            \param[in] coords       array of polyline coordinates
+            \param[in] pointCount   number of points in coords []
+            \param[in] keys         indicates for each polyline point if it is a key
+            \param[in] result       destination of the copied keys
+            \return                 one beyond the last coordinate of the copied keys
+        */
+        template <class Iterator>
+        static Iterator CopyKeys (
+            const value_type* coords,
+            ptr_diff_type pointCount,
+            const util::bit_array& keys,
+            Iterator result)
+        {
+            for (ptr_diff_type p=0; p<pointCount; ++p, coords += DIM) {
+                if (keys [p]) {
+                    for (unsigned d = 0; d < DIM; ++d) {
+                        *result = coords [d];
+                        ++result;
+                    }
+                }
+            }
+            return result;
+        }
+
+        /*!
+            \brief Flags the points that are kept by the (radial) distance routine (RD).
+
+            Produces the same keys as RadialDistance, without copying any coordinates.
+
+            \param[in] coords       array of polyline coordinates
+            \param[in] pointCount   number of points in coords []
+            \param[in] tol          radial (point-to-point) distance tolerance
+            \param[out] keys        indicates for each polyline point if it is a key
+            \return                 the number of keys
+        */
+        ptr_diff_type RadialDistanceFilter (
+            const value_type* coords,
+            ptr_diff_type pointCount,
+            value_type tol,
+            util::bit_array& keys)
+        {
+            value_type tol2 = tol * tol;    // squared distance tolerance
+            const value_type* current = coords;
+            ptr_diff_type keyCount = 2;
+
+            // the first and last point are always part of the simplification
+            keys.clear ();
+            keys.set (0);
+            keys.set (pointCount - 1);
+
+            for (ptr_diff_type index = 1; index < pointCount - 1; ++index) {
+                const value_type* next = coords + index * DIM;
+                instrumentation.Distances (1);
+                if (math::point_distance2 <DIM> (current, next) < tol2) {
+                    continue;
+                }
+                current = next;
+                keys.set (index);
+                ++keyCount;
+            }
+            return keyCount;
+        }
+
+        /*!
+            \brief Copies coordinates from the input range to an array.
+
+            \param[in] first        the first coordinate to copy
+            \param[in] coordCount   number of coordinates to copy
+            \param[out] coords      destination array
+        */
+        template <class Iterator>
+        static void CopyCoords (
+            Iterator first,
+            ptr_diff_type coordCount,
+            value_type* coords)
+        {
+            for (ptr_diff_type c=0; c<coordCount; ++c, ++first) {
+                coords [c] = *first;
+            }
+        }
+
+        /*!
+            \brief Determines if an iterator refers to contiguously stored coordinates.
+
+            \param[in] it   iterator to the first coordinate
+            \return         pointer to the first coordinate, or 0 when the storage is unknown
+        */
+        template <class Iterator>
+        static const value_type* Contiguous (Iterator)
+        {
+            return 0;
+        }
+
+        static const value_type* Contiguous (const value_type* it)
+        {
+            return it;
+        }
+
+        static const value_type* Contiguous (value_type* it)
+        {
+            return it;
+        }
+
+        static const value_type* Contiguous (typename std::vector <value_type>::const_iterator it)
+        {
+            return &*it;
+        }
+
+        static const value_type* Contiguous (typename std::vector <value_type>::iterator it)
+        {
+            return &*it;
+        }
+
     private:
+        //! ParallelSimplification (psimpl_parallel.h) uses DPHelper and ScopedPhase.
+        template <unsigned, class, class, class> friend class ParallelSimplification;
+
         /*!
             \brief Douglas-Peucker approximation helper class.
 
@@ -1457,159 +2716,613 @@ namespace psimpl
         */
         class DPHelper
         {
+            template <unsigned, class, class, class> friend class ParallelSimplification;
+
             //! \brief Defines a sub polyline.
+            template <typename Index>
             struct SubPoly {
-                SubPoly (ptr_diff_type first=0, ptr_diff_type last=0) :
+                SubPoly (Index first=0, Index last=0) :
                     first (first), last (last) {}
 
-                ptr_diff_type first;    //! coord index of the first point
-                ptr_diff_type last;     //! coord index of the last point
+                Index first;    //! point index of the first point
+                Index last;     //! point index of the last point
             };
 
             //! \brief Defines the key of a polyline.
+            template <typename Index>
             struct KeyInfo {
-                KeyInfo (ptr_diff_type index=0, value_type dist2=0) :
+                KeyInfo (Index index=0, value_type dist2=0) :
                     index (index), dist2 (dist2) {}
 
-                ptr_diff_type index;    //! coord index of the key
+                Index index;            //! point index of the key
                 value_type dist2;       //! squared distance of the key to a segment
             };
 
             //! \brief Defines a sub polyline including its key.
+            template <typename Index>
             struct SubPolyAlt {
-                SubPolyAlt (ptr_diff_type first=0, ptr_diff_type last=0) :
+                SubPolyAlt (Index first=0, Index last=0) :
                     first (first), last (last) {}
 
-                ptr_diff_type first;    //! coord index of the first point
-                ptr_diff_type last;     //! coord index of the last point
-                KeyInfo keyInfo;        //! key of this sub poly
+                Index first;                //! point index of the first point
+                Index last;                 //! point index of the last point
+                KeyInfo <Index> keyInfo;    //! key of this sub poly
 
                 bool operator< (const SubPolyAlt& other) const {
                     return keyInfo.dist2 < other.keyInfo.dist2;
                 }
             };
 
+            //! \brief Finds the key of a sub polyline on the calling thread.
+            struct KeySearch {
+                template <typename Index, class PointAccess>
+                KeyInfo <Index> operator () (const PointAccess& points, Index first, Index last) const {
+                    return FindKey (points, first, last);
+                }
+            };
+
+            //! \brief Provides access to all points of a polyline.
+            class Points {
+            public:
+                Points (const value_type* coords, const Instrumentation& instrumentation,
+                        const CancellationToken* cancellation) :
+                    instrumentation (instrumentation), cancellation (cancellation), coords (coords) {}
+
+                const value_type* operator [] (ptr_diff_type index) const {
+                    return coords + index * DIM;
+                }
+
+                template <typename Index>
+                Index Next (Index index) const {
+                    return index + 1;
+                }
+
+                const Instrumentation& instrumentation; //! receives the work of the approximation
+                const CancellationToken* cancellation;  //! stops the approximation early
+
+            private:
+                const value_type* coords;
+            };
+
+            //! \brief Provides access to the flagged points of a polyline.
+            class FilteredPoints {
+            public:
+                FilteredPoints (const value_type* coords, const util::bit_array& filter,
+                                const Instrumentation& instrumentation,
+                                const CancellationToken* cancellation) :
+                    instrumentation (instrumentation), cancellation (cancellation),
+                    coords (coords), filter (filter) {}
+
+                const value_type* operator [] (ptr_diff_type index) const {
+                    return coords + index * DIM;
+                }
+
+                template <typename Index>
+                Index Next (Index index) const {
+                    return static_cast <Index> (filter.find_next (index));
+                }
+
+                const Instrumentation& instrumentation; //! receives the work of the approximation
+                const CancellationToken* cancellation;  //! stops the approximation early
+
+            private:
+                const value_type* coords;
+                const util::bit_array& filter;
+            };
+
+            //! \brief Defines the bounding sphere of a block of consecutive points.
+            struct Block {
+                double center [DIM];    //! center of the bounding box
+                double radius;          //! half the diagonal of the bounding box
+                double extent;          //! largest absolute coordinate value
+            };
+
+            enum { BLOCK_SIZE = 64 };   //! number of points per block
+
+            //! \brief Provides access to all points of a polyline and their blocks.
+            class BlockPoints : public Points {
+            public:
+                BlockPoints (const value_type* coords, const Block* blocks, value_type tol2,
+                             const Instrumentation& instrumentation,
+                             const CancellationToken* cancellation) :
+                    Points (coords, instrumentation, cancellation), blocks (blocks), tol2 (tol2) {}
+
+                const Block* blocks;    //! bounding sphere of each block
+                value_type tol2;        //! squared distance tolerance
+            };
+
         public:
             /*!
                 \brief Performs Douglas-Peucker approximation.
 
+                Point indices are stored using 32 bits whenever the polyline is small enough, which
+                halves the size of the job-queue on 64 bit platforms.
+
+                \param[in] coords       array of polyline coordinates
+                \param[in] coordCount   number of coordinates in coords []
+                \param[in] tol          approximation tolerance
+                \param[out] keys        indicates for each polyline point if it is a key
+                \param[in] instrumentation  receives the work of the approximation
+                \param[in] cancellation     [optional] stops the approximation early
+            */
+            static void Approximate (
+                const value_type* coords,
+                ptr_diff_type coordCount,
+                value_type tol,
+                util::bit_array& keys,
+                const Instrumentation& instrumentation,
+                const CancellationToken* cancellation)
+            {
+                Points points (coords, instrumentation, cancellation);
+                if (IsCompact (coordCount / DIM)) {
+                    DoApproximate <unsigned> (points, coordCount, tol, keys);
+                }
+                else {
+                    DoApproximate <ptr_diff_type> (points, coordCount, tol, keys);
+                }
+            }
+
+            /*!
+                \brief Performs Douglas-Peucker approximation, considering only flagged points.
+
+                The result is identical to approximating a copy of only the flagged points. Note
+                that the first and last point must be flagged.
+
+                \sa Approximate
+
+                \param[in] coords       array of polyline coordinates
+                \param[in] coordCount   number of coordinates in coords []
+                \param[in] tol          approximation tolerance
+                \param[in] filter       indicates for each polyline point if it is considered
+                \param[out] keys        indicates for each polyline point if it is a key
+                \param[in] instrumentation  receives the work of the approximation
+                \param[in] cancellation     [optional] stops the approximation early
+            */
+            static void Approximate (
+                const value_type* coords,
+                ptr_diff_type coordCount,
+                value_type tol,
+                const util::bit_array& filter,
+                util::bit_array& keys,
+                const Instrumentation& instrumentation,
+                const CancellationToken* cancellation)
+            {
+                FilteredPoints points (coords, filter, instrumentation, cancellation);
+                if (IsCompact (coordCount / DIM)) {
+                    DoApproximate <unsigned> (points, coordCount, tol, keys);
+                }
+                else {
+                    DoApproximate <ptr_diff_type> (points, coordCount, tol, keys);
+                }
+            }
+
+            /*!
+                \brief Performs Douglas-Peucker approximation.
+
+                \sa Approximate
+
+                \param[in] coords       array of polyline coordinates
+                \param[in] coordCount   number of coordinates in coords []
+                \param[in] countTol     point count tolerance
+                \param[out] keys        indicates for each polyline point if it is a key
+                \param[in] instrumentation  receives the work of the approximation
+                \param[in] cancellation     [optional] stops the approximation early
+                \param[out] order       [optional] the keys in the order they were found
+            */
+            static void ApproximateN (
+                const value_type* coords,
+                ptr_diff_type coordCount,
+                unsigned countTol,
+                util::bit_array& keys,
+                const Instrumentation& instrumentation,
+                const CancellationToken* cancellation,
+                std::vector <std::pair <ptr_diff_type, value_type> >* order = 0)
+            {
+                Points points (coords, instrumentation, cancellation);
+                if (IsCompact (coordCount / DIM)) {
+                    DoApproximateN <unsigned> (points, coordCount, countTol, keys, order, KeySearch ());
+                }
+                else {
+                    DoApproximateN <ptr_diff_type> (points, coordCount, countTol, keys, order, KeySearch ());
+                }
+            }
+
+            /*!
+                \brief Computes the Douglas-Peucker importance of each polyline point.
+
+                The importance of a key is the minimum of its squared distance to the segment it
+                was found for, and the importance of the key that created that segment. Performing
+                Approximate with tolerance tol marks exactly those points as key for which
+                tol * tol < importance.
+
+                \param[in] coords       array of polyline coordinates
+                \param[in] coordCount   number of coordinates in coords []
+                \param[out] importance  the squared importance of each point
+                \param[in] instrumentation  receives the work of the computation
+                \param[in] cancellation     [optional] stops the computation early, leaving the
+                                            importance of unprocessed points at 0
+            */
+            static void Importance (
+                const value_type* coords,
+                ptr_diff_type coordCount,
+                value_type* importance,
+                const Instrumentation& instrumentation,
+                const CancellationToken* cancellation)
+            {
+                Points points (coords, instrumentation, cancellation);
+                ptr_diff_type pointCount = coordCount / DIM;
+                std::fill (importance, importance + pointCount, value_type (0));
+                importance [0] = std::numeric_limits <value_type>::max ();
+                importance [pointCount - 1] = std::numeric_limits <value_type>::max ();
+
+                typedef std::stack <SubPoly <ptr_diff_type> > Stack;
+                Stack stack;                    // LIFO job-queue containing sub-polylines
+                stack.push (SubPoly <ptr_diff_type> (0, pointCount-1));
+                ptr_diff_type work = 0;         // points processed since the last cancellation check
+
+                while (!stack.empty ()) {
+                    instrumentation.SubPolyline (stack.size ());
+                    SubPoly <ptr_diff_type> subPoly = stack.top ();
+                    stack.pop ();
+                    KeyInfo <ptr_diff_type> keyInfo = FindKey (points, subPoly.first, subPoly.last);
+                    if (keyInfo.index && value_type (0) < keyInfo.dist2) {
+                        // the most recent endpoint of the sub polyline holds the lowest importance
+                        importance [keyInfo.index] = std::min (keyInfo.dist2,
+                            std::min (importance [subPoly.first], importance [subPoly.last]));
+                        stack.push (SubPoly <ptr_diff_type> (keyInfo.index, subPoly.last));
+                        stack.push (SubPoly <ptr_diff_type> (subPoly.first, keyInfo.index));
+                    }
+                    if (Interrupted (points, work, subPoly.last - subPoly.first)) {
+                        break;
+                    }
+                }
+            }
+
+            /*!
+                \brief Performs Douglas-Peucker approximation using bounding volume pruning.
+
+                Produces the same keys as Approximate.
+
+                \sa Approximate
+
                 \param[in] coords       array of polyline coordinates
                 \param[in] coordCount   number of coordinates in coords []
                 \param[in] tol          approximation tolerance
                 \param[out] keys        indicates for each polyline point if it is a key
+                \param[in] instrumentation  receives the work of the approximation
+                \param[in] cancellation     [optional] stops the approximation early
+            */
+            static void ApproximateAccelerated (
+                const value_type* coords,
+                ptr_diff_type coordCount,
+                value_type tol,
+                util::bit_array& keys,
+                const Instrumentation& instrumentation,
+                const CancellationToken* cancellation)
+            {
+                if (std::numeric_limits <value_type>::is_integer) {
+                    Approximate (coords, coordCount, tol, keys, instrumentation, cancellation);
+                    return;
+                }
+                ptr_diff_type pointCount = coordCount / DIM;
+                ptr_diff_type blockCount = (pointCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+                util::scoped_array <Block> blocks (blockCount);
+                instrumentation.Allocated (blockCount * sizeof (Block));
+                for (ptr_diff_type first = 0; first < pointCount; first += BLOCK_SIZE) {
+                    ComputeBlock (coords, first, std::min <ptr_diff_type> (first + BLOCK_SIZE, pointCount),
+                                  blocks [first / BLOCK_SIZE]);
+                }
+                BlockPoints points (coords, blocks.get (), tol * tol, instrumentation, cancellation);
+                if (IsCompact (pointCount)) {
+                    DoApproximate <unsigned> (points, coordCount, tol, keys);
+                }
+                else {
+                    DoApproximate <ptr_diff_type> (points, coordCount, tol, keys);
+                }
+            }
+
+        private:
+            /*!
+                \brief Computes the bounding sphere of the points in the range [first, last).
+
+                \param[in] coords   array of polyline coordinates
+                \param[in] first    the point index of the first point of the block
+                \param[in] last     one beyond the point index of the last point of the block
+                \param[out] block   the bounding sphere
+            */
+            static void ComputeBlock (
+                const value_type* coords,
+                ptr_diff_type first,
+                ptr_diff_type last,
+                Block& block)
+            {
+                double lower [DIM];
+                double upper [DIM];
+                const value_type* p = coords + first * DIM;
+                for (unsigned d = 0; d < DIM; ++d) {
+                    lower [d] = upper [d] = static_cast <double> (p [d]);
+                }
+                for (p += DIM; p < coords + last * DIM; p += DIM) {
+                    for (unsigned d = 0; d < DIM; ++d) {
+                        lower [d] = std::min (lower [d], static_cast <double> (p [d]));
+                        upper [d] = std::max (upper [d], static_cast <double> (p [d]));
+                    }
+                }
+                double radius2 = 0;
+                block.extent = 0;
+                for (unsigned d = 0; d < DIM; ++d) {
+                    block.center [d] = (lower [d] + upper [d]) / 2;
+                    radius2 += (upper [d] - lower [d]) * (upper [d] - lower [d]) / 4;
+                    block.extent = std::max (block.extent, std::max (std::abs (lower [d]), std::abs (upper [d])));
+                }
+                block.radius = std::sqrt (radius2);
+            }
+
+            /*!
+                \brief Computes an upper bound for the squared distance of any point in a block to
+                a segment.
+
+                The bound includes a margin for the rounding errors of math::segment_distance2,
+                which computes the projection fraction as a float.
+
+                \param[in] block    the bounding sphere of the block
+                \param[in] s1       the first coordinate of the start point of the segment
+                \param[in] s2       the first coordinate of the end point of the segment
+                \return             the upper bound
+            */
+            static double Bound (
+                const Block& block,
+                const value_type* s1,
+                const value_type* s2)
+            {
+                const double valueEps = std::max (
+                    static_cast <double> (std::numeric_limits <value_type>::epsilon ()),
+                    static_cast <double> (std::numeric_limits <double>::epsilon ()));
+                const double floatEps = std::numeric_limits <float>::epsilon ();
+
+                double a [DIM];
+                double b [DIM];
+                double c [DIM];
+                double extent = block.extent;
+                double length2 = 0;
+                double reach2 = 0;
+                for (unsigned d = 0; d < DIM; ++d) {
+                    a [d] = static_cast <double> (s1 [d]);
+                    b [d] = static_cast <double> (s2 [d]);
+                    c [d] = block.center [d];
+                    extent = std::max (extent, std::max (std::abs (a [d]), std::abs (b [d])));
+                    length2 += (b [d] - a [d]) * (b [d] - a [d]);
+                    reach2 += (c [d] - a [d]) * (c [d] - a [d]);
+                }
+                double slack = 16 * DIM * (valueEps * extent
+                    + floatEps * (std::sqrt (length2) + std::sqrt (reach2) + block.radius));
+                double bound = std::sqrt (math::segment_distance2 <DIM> (a, b, c))
+                               + block.radius + slack;
+                return bound * bound * (1 + 4 * DIM * valueEps);
+            }
+
+            /*!
+                \brief Determines if point indices can be stored as an unsigned int.
+
+                \param[in] pointCount   number of polyline points
+                \return                 true when each point index fits in an unsigned int
+            */
+            static bool IsCompact (
+                ptr_diff_type pointCount)
+            {
+                return static_cast <std::size_t> (pointCount) <= std::numeric_limits <unsigned>::max ();
+            }
+
+            /*!
+                \brief Checks the cancellation token once the processed sub polylines contain at
+                least CHECK_INTERVAL points.
+
+                \param[in] points       the polyline points
+                \param[in,out] work     the number of points processed since the previous check
+                \param[in] pointCount   the number of points of the processed sub polyline
+                \return                 true when the approximation should stop
+            */
+            template <class PointAccess>
+            static bool Interrupted (
+                const PointAccess& points,
+                ptr_diff_type& work,
+                ptr_diff_type pointCount)
+            {
+                if (!points.cancellation) {
+                    return false;
+                }
+                work += pointCount;
+                if (work < CancellationToken::CHECK_INTERVAL) {
+                    return false;
+                }
+                work = 0;
+                return points.cancellation->Cancelled ();
+            }
+
+            /*!
+                \brief Performs Douglas-Peucker approximation using the specified point index type.
+
+                \sa Approximate
             */
-            static void Approximate (
-                const value_type* coords,
+            template <typename Index, class PointAccess>
+            static void DoApproximate (
+                const PointAccess& points,
                 ptr_diff_type coordCount,
                 value_type tol,
-                unsigned char* keys)
+                util::bit_array& keys)
             {
-                value_type tol2 = tol * tol;    // squared distance tolerance
-                ptr_diff_type pointCount = coordCount / DIM;
+                Index pointCount = static_cast <Index> (coordCount / DIM);
                 // zero out keys
-                std::fill_n (keys, pointCount, 0);
-                keys [0] = 1;                   // the first point is always a key
-                keys [pointCount - 1] = 1;      // the last point is always a key
+                keys.clear ();
+                keys.set (0);                   // the first point is always a key
+                keys.set (pointCount - 1);      // the last point is always a key
+
+                ApproximateRange (points, Index (0), Index (pointCount - 1), tol * tol, keys);
+            }
+
+            /*!
+                \brief Performs Douglas-Peucker approximation of the sub polyline [first, last].
+
+                Only the keys in between first and last are flagged, by calling keys.set (index).
 
-                typedef std::stack <SubPoly> Stack;
+                \param[in] points       the polyline points
+                \param[in] first        the point index of the first point of the sub polyline
+                \param[in] last         the point index of the last point of the sub polyline
+                \param[in] tol2         squared approximation tolerance
+                \param[out] keys        receives the keys, see util::bit_array
+            */
+            template <typename Index, class PointAccess, class Keys>
+            static void ApproximateRange (
+                const PointAccess& points,
+                Index first,
+                Index last,
+                value_type tol2,
+                Keys& keys)
+            {
+                typedef std::stack <SubPoly <Index> > Stack;
                 Stack stack;                    // LIFO job-queue containing sub-polylines
 
-                SubPoly subPoly (0, coordCount-DIM);
+                SubPoly <Index> subPoly (first, last);
                 stack.push (subPoly);           // add complete poly
+                ptr_diff_type work = 0;         // points processed since the last cancellation check
 
                 while (!stack.empty ()) {
+                    points.instrumentation.SubPolyline (stack.size ());
                     subPoly = stack.top ();     // take a sub poly
                     stack.pop ();               // and find its key
-                    KeyInfo keyInfo = FindKey (coords, subPoly.first, subPoly.last);
+                    KeyInfo <Index> keyInfo = FindKey (points, subPoly.first, subPoly.last);
                     if (keyInfo.index && tol2 < keyInfo.dist2) {
                         // store the key if valid
-                        keys [keyInfo.index / DIM] = 1;
+                        keys.set (keyInfo.index);
                         // split the polyline at the key and recurse
-                        stack.push (SubPoly (keyInfo.index, subPoly.last));
-                        stack.push (SubPoly (subPoly.first, keyInfo.index));
+                        stack.push (SubPoly <Index> (keyInfo.index, subPoly.last));
+                        stack.push (SubPoly <Index> (subPoly.first, keyInfo.index));
+                    }
+                    if (Interrupted (points, work, subPoly.last - subPoly.first)) {
+                        break;
                     }
                 }
             }
 
             /*!
-                \brief Performs Douglas-Peucker approximation.
+                \brief Performs Douglas-Peucker approximation using the specified point index type.
 
-                \param[in] coords       array of polyline coordinates
-                \param[in] coordCount   number of coordinates in coords []
-                \param[in] countTol     point count tolerance
-                \param[out] keys        indicates for each polyline point if it is a key
+                \sa ApproximateN
+
+                \param[in] search   finds the key of a sub polyline, see KeySearch
             */
-            static void ApproximateN (
-                const value_type* coords,
+            template <typename Index, class PointAccess, class Search>
+            static void DoApproximateN (
+                const PointAccess& points,
                 ptr_diff_type coordCount,
                 unsigned countTol,
-                unsigned char* keys)
+                util::bit_array& keys,
+                std::vector <std::pair <ptr_diff_type, value_type> >* order,
+                const Search& search)
             {
-                ptr_diff_type pointCount = coordCount / DIM;
+                Index pointCount = static_cast <Index> (coordCount / DIM);
                 // zero out keys
-                std::fill_n (keys, pointCount, 0);
-                keys [0] = 1;                   // the first point is always a key
-                keys [pointCount - 1] = 1;      // the last point is always a key
+                keys.clear ();
+                keys.set (0);                   // the first point is always a key
+                keys.set (pointCount - 1);      // the last point is always a key
                 unsigned keyCount = 2;
 
                 if (countTol == 2) {
                     return;
                 }
 
-                typedef std::priority_queue <SubPolyAlt> PriorityQueue;
+                typedef std::priority_queue <SubPolyAlt <Index> > PriorityQueue;
                 PriorityQueue queue;    // sorted (max dist2) job queue containing sub-polylines
 
-                SubPolyAlt subPoly (0, coordCount-DIM);
-                subPoly.keyInfo = FindKey (coords, subPoly.first, subPoly.last);
+                SubPolyAlt <Index> subPoly (0, pointCount-1);
+                subPoly.keyInfo = search (points, subPoly.first, subPoly.last);
                 queue.push (subPoly);           // add complete poly
+                ptr_diff_type work = 0;         // points processed since the last cancellation check
 
                 while (!queue.empty ()) {
+                    points.instrumentation.SubPolyline (queue.size ());
                     subPoly = queue.top ();     // take a sub poly
                     queue.pop ();
                     // store the key
-                    keys [subPoly.keyInfo.index / DIM] = 1;
+                    keys.set (subPoly.keyInfo.index);
+                    if (order) {
+                        order->push_back (std::make_pair (static_cast <ptr_diff_type> (subPoly.keyInfo.index), subPoly.keyInfo.dist2));
+                    }
                     // check point count tolerance
                     keyCount++;
                     if (keyCount == countTol) {
                         break;
                     }
                     // split the polyline at the key and recurse
-                    SubPolyAlt left (subPoly.first, subPoly.keyInfo.index);
-                    left.keyInfo = FindKey (coords, left.first, left.last);
+                    SubPolyAlt <Index> left (subPoly.first, subPoly.keyInfo.index);
+                    left.keyInfo = search (points, left.first, left.last);
                     if (left.keyInfo.index) {
                         queue.push (left);
                     }
-                    SubPolyAlt right (subPoly.keyInfo.index, subPoly.last);
-                    right.keyInfo = FindKey (coords, right.first, right.last);
+                    SubPolyAlt <Index> right (subPoly.keyInfo.index, subPoly.last);
+                    right.keyInfo = search (points, right.first, right.last);
                     if (right.keyInfo.index) {
                         queue.push (right);
                     }
+                    if (Interrupted (points, work, subPoly.last - subPoly.first)) {
+                        break;
+                    }
                 }
             }
 
-        private:
             /*!
                 \brief Finds the key for the given sub polyline.
 
                 Finds the point in the range [first, last] that is furthest away from the
                 segment (first, last). This point is called the key.
 
-                \param[in] coords   array of polyline coordinates
-                \param[in] first    the first coordinate of the first polyline point
-                \param[in] last     the first coordinate of the last polyline point
+                \param[in] points   the polyline points
+                \param[in] first    the point index of the first polyline point
+                \param[in] last     the point index of the last polyline point
                 \return             the index of the key and its distance, or last when a key
                                     could not be found
             */
-            static KeyInfo FindKey (
-                const value_type* coords,
-                ptr_diff_type first,
-                ptr_diff_type last)
+            template <typename Index, class PointAccess>
+            static KeyInfo <Index> FindKey (
+                const PointAccess& points,
+                Index first,
+                Index last)
+            {
+                return FindKey (points, first, last, static_cast <Index> (first + 1), last);
+            }
+
+            /*!
+                \brief Finds the point in the range [begin, end) that is furthest away from the
+                segment (first, last).
+
+                Allows the search for a key to be split into parts. The key is found in the last
+                part that holds the maximum distance.
+
+                \param[in] points   the polyline points
+                \param[in] first    the point index of the first polyline point
+                \param[in] last     the point index of the last polyline point
+                \param[in] begin    the point index of the first candidate, first < begin
+                \param[in] end      one beyond the point index of the last candidate, end <= last
+                \return             the index of the candidate and its distance, or 0 when the
+                                    range holds no candidate
+            */
+            template <typename Index, class PointAccess>
+            static KeyInfo <Index> FindKey (
+                const PointAccess& points,
+                Index first,
+                Index last,
+                Index begin,
+                Index end)
             {
-                KeyInfo keyInfo;
+                KeyInfo <Index> keyInfo;
+
+                const value_type* s1 = points [first];
+                const value_type* s2 = points [last];
 
-                for (ptr_diff_type current = first + DIM; current < last; current += DIM) {
-                    value_type d2 = math::segment_distance2 <DIM> (coords + first, coords + last,
-                                                                   coords + current);
+                std::size_t evaluations = 0;
+                for (Index current = points.Next (begin - 1); current < end; current = points.Next (current)) {
+                    value_type d2 = math::segment_distance2 <DIM> (s1, s2, points [current]);
+                    ++evaluations;
                     if (d2 < keyInfo.dist2) {
                         continue;
                     }
@@ -1617,9 +3330,65 @@ namespace psimpl
                     keyInfo.index = current;
                     keyInfo.dist2 = d2;
                 }
+                points.instrumentation.Distances (evaluations);
+                return keyInfo;
+            }
+
+            /*!
+                \brief Finds the key for the given sub polyline, skipping blocks that cannot
+                contain it.
+
+                Returns the same key as FindKey, unless that key is within tolerance.
+
+                \param[in] points   the polyline points and their blocks
+                \param[in] first    the point index of the first polyline point
+                \param[in] last     the point index of the last polyline point
+                \return             the index of the key and its distance, or last when a key
+                                    could not be found
+            */
+            template <typename Index>
+            static KeyInfo <Index> FindKey (
+                const BlockPoints& points,
+                Index first,
+                Index last)
+            {
+                KeyInfo <Index> keyInfo;
+
+                const value_type* s1 = points [first];
+                const value_type* s2 = points [last];
+
+                std::size_t evaluations = 0;
+                Index current = first + 1;
+                while (current < last) {
+                    Index step = BLOCK_SIZE - current % BLOCK_SIZE;
+                    Index blockEnd = current + std::min <Index> (step, last - current);
+                    if (step == BLOCK_SIZE && blockEnd - current == step) {
+                        // the sub polyline contains the complete block
+                        double bound = Bound (points.blocks [current / BLOCK_SIZE], s1, s2);
+                        if (bound <= points.tol2 || bound < keyInfo.dist2) {
+                            current = blockEnd;
+                            continue;
+                        }
+                    }
+                    evaluations += blockEnd - current;
+                    for (; current < blockEnd; ++current) {
+                        value_type d2 = math::segment_distance2 <DIM> (s1, s2, points [current]);
+                        if (d2 < keyInfo.dist2) {
+                            continue;
+                        }
+                        // update maximum squared distance and the point it belongs to
+                        keyInfo.index = current;
+                        keyInfo.dist2 = d2;
+                    }
+                }
+                points.instrumentation.Distances (evaluations);
                 return keyInfo;
             }
         };
+
+    private:
+        Instrumentation instrumentation;            //! receives the work of all routines
+        const CancellationToken* cancellation;      //! stops all routines early, when set
     };
 
     /*!
@@ -1812,6 +3581,56 @@ namespace psimpl
         return ps.DouglasPeucker (first, last, tol, result);
     }
 
+    /*!
+        \brief Performs Douglas-Peucker polyline simplification (DP) using the specified prefilter.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeucker.
+
+        \param[in] first        the first coordinate of the first polyline point
+        \param[in] last         one beyond the last coordinate of the last polyline point
+        \param[in] tol          perpendicular (point-to-segment) distance tolerance
+        \param[in] result       destination of the simplified polyline
+        \param[in] prefilter    how to apply the radial distance preprocessing step
+        \param[out] removed     optional, the number of points removed by the prefilter
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator simplify_douglas_peucker (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result,
+        Prefilter prefilter,
+        typename std::iterator_traits <ForwardIterator>::difference_type* removed = 0)
+    {
+        PolylineSimplification <DIM, ForwardIterator, OutputIterator> ps;
+        return ps.DouglasPeucker (first, last, tol, result, prefilter, removed);
+    }
+
+    /*!
+        \brief Performs Douglas-Peucker polyline simplification (DP) using bounding volume pruning.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeuckerAccelerated.
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] tol      perpendicular (point-to-segment) distance tolerance
+        \param[in] result   destination of the simplified polyline
+        \return             one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator simplify_douglas_peucker_accelerated (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result)
+    {
+        PolylineSimplification <DIM, ForwardIterator, OutputIterator> ps;
+        return ps.DouglasPeuckerAccelerated (first, last, tol, result);
+    }
+
     /*!
         \brief Performs a variant of Douglas-Peucker polyline simplification (DPn).
 
@@ -1835,6 +3654,293 @@ namespace psimpl
         return ps.DouglasPeuckerN (first, last, count, result);
     }
 
+    /*!
+        \brief Reports the order in which the Douglas-Peucker variant (DPn) selects keys.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeuckerNOrder.
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] count    the maximum number of points of the simplification
+        \param[in] result   destination of the (point index, squared distance) pairs
+        \return             one beyond the last key
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator order_douglas_peucker_n (
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned count,
+        OutputIterator result)
+    {
+        PolylineSimplification <DIM, ForwardIterator, OutputIterator> ps;
+        return ps.DouglasPeuckerNOrder (first, last, count, result);
+    }
+
+    /*!
+        \brief Performs Douglas-Peucker simplification (DP) on a ring.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeuckerRing.
+
+        \param[in] first    the first coordinate of the first ring point
+        \param[in] last     one beyond the last coordinate of the last ring point
+        \param[in] tol      perpendicular (point-to-segment) distance tolerance
+        \param[in] result   destination of the simplified ring
+        \return             one beyond the last coordinate of the simplified ring
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator simplify_douglas_peucker_ring (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result)
+    {
+        PolylineSimplification <DIM, ForwardIterator, OutputIterator> ps;
+        return ps.DouglasPeuckerRing (first, last, tol, result);
+    }
+
+    /*!
+        \brief Performs a variant of Douglas-Peucker simplification (DPn) on a ring.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeuckerNRing.
+
+        \param[in] first    the first coordinate of the first ring point
+        \param[in] last     one beyond the last coordinate of the last ring point
+        \param[in] count    the maximum number of vertices of the simplified ring
+        \param[in] result   destination of the simplified ring
+        \return             one beyond the last coordinate of the simplified ring
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator simplify_douglas_peucker_n_ring (
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned count,
+        OutputIterator result)
+    {
+        PolylineSimplification <DIM, ForwardIterator, OutputIterator> ps;
+        return ps.DouglasPeuckerNRing (first, last, count, result);
+    }
+
+    /*!
+        \brief Performs the nth point routine (NP) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::NthPointInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     n        specifies 'each nth point'
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_nth_point_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned n)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.NthPointInplace (first, last, n);
+    }
+
+    /*!
+        \brief Performs the (radial) distance between points routine (RD) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::RadialDistanceInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     tol      radial (point-to-point) distance tolerance
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_radial_distance_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.RadialDistanceInplace (first, last, tol);
+    }
+
+    /*!
+        \brief Repeatedly performs the perpendicular distance routine (PD) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::PerpendicularDistanceInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     tol      perpendicular (segment-to-point) distance tolerance
+        \param[in]     repeat   the number of times to successively apply the PD routine.
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_perpendicular_distance_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        unsigned repeat)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.PerpendicularDistanceInplace (first, last, tol, repeat);
+    }
+
+    /*!
+        \brief Performs the perpendicular distance routine (PD) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::PerpendicularDistanceInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     tol      perpendicular (segment-to-point) distance tolerance
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_perpendicular_distance_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.PerpendicularDistanceInplace (first, last, tol);
+    }
+
+    /*!
+        \brief Performs Reumann-Witkam polyline simplification (RW) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::ReumannWitkamInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     tol      perpendicular (point-to-line) distance tolerance
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_reumann_witkam_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.ReumannWitkamInplace (first, last, tol);
+    }
+
+    /*!
+        \brief Performs Opheim polyline simplification (OP) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::OpheimInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     min_tol  minimum distance tolerance
+        \param[in]     max_tol  maximum distance tolerance
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_opheim_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type min_tol,
+        typename std::iterator_traits <ForwardIterator>::value_type max_tol)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.OpheimInplace (first, last, min_tol, max_tol);
+    }
+
+    /*!
+        \brief Performs Lang polyline simplification (LA) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::LangInplace.
+
+        \param[in,out] first      the first coordinate of the first polyline point
+        \param[in]     last       one beyond the last coordinate of the last polyline point
+        \param[in]     tol        perpendicular (point-to-segment) distance tolerance
+        \param[in]     look_ahead defines the size of the search region
+        \return                   one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class BidirectionalIterator>
+    BidirectionalIterator simplify_lang_inplace (
+        BidirectionalIterator first,
+        BidirectionalIterator last,
+        typename std::iterator_traits <BidirectionalIterator>::value_type tol,
+        unsigned look_ahead)
+    {
+        PolylineSimplification <DIM, BidirectionalIterator, BidirectionalIterator> ps;
+        return ps.LangInplace (first, last, tol, look_ahead);
+    }
+
+    /*!
+        \brief Performs Douglas-Peucker polyline simplification (DP) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeuckerInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     tol      perpendicular (point-to-segment) distance tolerance
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_douglas_peucker_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.DouglasPeuckerInplace (first, last, tol);
+    }
+
+    /*!
+        \brief Performs a variant of Douglas-Peucker polyline simplification (DPn) in place.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::DouglasPeuckerNInplace.
+
+        \param[in,out] first    the first coordinate of the first polyline point
+        \param[in]     last     one beyond the last coordinate of the last polyline point
+        \param[in]     count    the maximum number of points of the simplified polyline
+        \return                 one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class ForwardIterator>
+    ForwardIterator simplify_douglas_peucker_n_inplace (
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned count)
+    {
+        PolylineSimplification <DIM, ForwardIterator, ForwardIterator> ps;
+        return ps.DouglasPeuckerNInplace (first, last, count);
+    }
+
+    /*!
+        \brief Computes the squared Douglas-Peucker importance of each polyline point.
+
+        This is a convenience function that provides template type deduction for
+        PolylineSimplification::ComputeDouglasPeuckerImportance2.
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] result   destination of the squared importance of each point
+        \param[out] valid   [optional] indicates if the computed importance is valid
+        \return             one beyond the last computed importance
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator compute_douglas_peucker_importance2 (
+        ForwardIterator first,
+        ForwardIterator last,
+        OutputIterator result,
+        bool* valid=0)
+    {
+        PolylineSimplification <DIM, ForwardIterator, OutputIterator> ps;
+        return ps.ComputeDouglasPeuckerImportance2 (first, last, result, valid);
+    }
+
     /*!
         \brief Computes the squared positional error between a polyline and its simplification.
 
@@ -0,0 +1,554 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_async.h
+    \brief Asynchronous simplification with futures and completion callbacks.
+
+    Event loop servers cannot block on large simplifications. AsyncSimplifier submits jobs to a
+    thread pool, and reports each result through a std::future or a completion callback. A job is
+    any function object without arguments, typically a lambda that runs one of the psimpl
+    routines on a range that outlives the job.
+
+    The jobs run on an Executor. Either AsyncSimplifier creates its own ThreadPool, or it uses an
+    executor that wraps an existing thread pool of the application.
+
+    Back-pressure: the number of jobs that are submitted but not yet completed can be limited.
+    Submit and Post block while the limit is reached; TrySubmit and TryPost return false instead.
+
+    ParallelFor splits a loop over the calling thread and additional threads, either started for
+    the loop or taken from an executor. It is used by the parallel routines of
+    psimpl_parallel.h and psimpl_tiles.h.
+
+    Batching: each job has a cost, the number of coordinates it processes. Jobs that cost less
+    than the batch cost are collected in a batch, which is handed to the executor as a single
+    task once its total cost reaches the batch cost, or when Flush or Wait is called. This keeps
+    the per-job overhead low when millions of tiny polylines are queued. Jobs are only batched
+    when a cost is passed explicitly; the future of a batched job is not ready until its batch is
+    handed to the executor.
+
+    This file requires C++11.
+*/
+
+#ifndef PSIMPL_ASYNC
+#define PSIMPL_ASYNC
+
+
+#include "psimpl.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace psimpl {
+    /*!
+        \brief Runs tasks asynchronously.
+
+        Derive from this interface to run the jobs of an AsyncSimplifier on an existing thread
+        pool.
+    */
+    class Executor
+    {
+    public:
+        virtual ~Executor () {}
+
+        //! \brief Runs the task on some thread, at some point in the future.
+        virtual void Execute (std::function <void ()> task) = 0;
+    };
+
+    /*!
+        \brief Executor that runs tasks on a fixed number of worker threads, in FIFO order.
+    */
+    class ThreadPool : public Executor
+    {
+    public:
+        /*!
+            \param[in] threads  number of worker threads, 0 for hardware concurrency
+        */
+        explicit ThreadPool (unsigned threads=0) :
+            stopping (false)
+        {
+            threads = threads ? threads : std::max (1u, std::thread::hardware_concurrency ());
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.push_back (std::thread (&ThreadPool::Work, this));
+            }
+        }
+
+        //! \brief Runs all queued tasks, and joins the worker threads.
+        ~ThreadPool () {
+            {
+                std::lock_guard <std::mutex> lock (mutex);
+                stopping = true;
+            }
+            available.notify_all ();
+            for (std::size_t t = 0; t < workers.size (); ++t) {
+                workers [t].join ();
+            }
+        }
+
+        void Execute (std::function <void ()> task) {
+            {
+                std::lock_guard <std::mutex> lock (mutex);
+                tasks.push_back (std::move (task));
+            }
+            available.notify_one ();
+        }
+
+        //! \brief Returns the number of worker threads.
+        std::size_t thread_count () const {
+            return workers.size ();
+        }
+
+    private:
+        ThreadPool (const ThreadPool&);
+        ThreadPool& operator= (const ThreadPool&);
+
+        //! \brief Runs tasks until the pool is stopping and no task remains.
+        void Work () {
+            for (;;) {
+                std::function <void ()> task;
+                {
+                    std::unique_lock <std::mutex> lock (mutex);
+                    available.wait (lock, [this] { return stopping || !tasks.empty (); });
+                    if (tasks.empty ()) {
+                        return;
+                    }
+                    task = std::move (tasks.front ());
+                    tasks.pop_front ();
+                }
+                task ();
+            }
+        }
+
+    private:
+        std::vector <std::thread> workers;              //! the worker threads
+        std::deque <std::function <void ()> > tasks;    //! queued tasks
+        std::mutex mutex;                               //! guards tasks and stopping
+        std::condition_variable available;              //! signals a task or stopping
+        bool stopping;                                  //! set by the destructor
+    };
+
+    /*!
+        \brief Calls a function for each index of a range, on multiple threads.
+
+        The calling thread takes part in the loop, and is joined by at most threads - 1
+        additional threads. These are either started for each loop, or run as tasks of an
+        executor. Each index is handed out once, so every thread takes the next index as soon as
+        it completes the previous one. A loop also completes when the executor is busy, or when
+        an additional thread cannot be started: the calling thread then handles the remaining
+        indices itself.
+
+        Once the function throws, no more indices are handed out. The loop still waits for all
+        threads, and then rethrows the first exception on the calling thread.
+    */
+    class ParallelFor
+    {
+    public:
+        /*!
+            \param[in] threads      number of threads, including the calling thread; 0 for
+                                    hardware concurrency
+            \param[in] executor     [optional] runs the additional threads, instead of starting
+                                    them for each loop; must outlive this object
+        */
+        explicit ParallelFor (unsigned threads=0, Executor* executor=0) :
+            threads (threads ? threads : std::max (1u, std::thread::hardware_concurrency ())),
+            executor (executor)
+        {}
+
+        //! \brief Returns the number of threads, including the calling thread.
+        unsigned thread_count () const {
+            return threads;
+        }
+
+        /*!
+            \brief Calls function (i) for each i in [0, count), and waits until all calls
+            completed.
+
+            \param[in] count        number of indices
+            \param[in] function     function object that is called with each index
+        */
+        template <class Function>
+        void operator () (std::size_t count, const Function& function) const {
+            std::shared_ptr <Loop> loop = std::make_shared <Loop> (count);
+            // tasks that start after the loop closed do not touch function
+            std::function <void ()> task = [loop, &function] {
+                {
+                    std::lock_guard <std::mutex> lock (loop->mutex);
+                    if (loop->closed) {
+                        return;
+                    }
+                    ++loop->active;
+                }
+                Run (*loop, function);
+                std::lock_guard <std::mutex> lock (loop->mutex);
+                --loop->active;
+                loop->idle.notify_all ();
+            };
+
+            std::vector <std::thread> workers;
+            try {
+                std::size_t extra = std::min <std::size_t> (threads, count);
+                extra = extra ? extra - 1 : 0;
+                if (!executor) {
+                    workers.reserve (extra);
+                }
+                for (std::size_t t = 0; t < extra; ++t) {
+                    if (executor) {
+                        executor->Execute (task);
+                    }
+                    else {
+                        workers.push_back (std::thread (task));
+                    }
+                }
+            }
+            catch (...) {
+                // continue with the threads that did start
+            }
+            Run (*loop, function);
+            {
+                std::unique_lock <std::mutex> lock (loop->mutex);
+                loop->closed = true;
+                loop->idle.wait (lock, [&loop] { return loop->active == 0; });
+            }
+            for (std::size_t t = 0; t < workers.size (); ++t) {
+                workers [t].join ();
+            }
+            if (loop->error) {
+                std::rethrow_exception (loop->error);
+            }
+        }
+
+    private:
+        //! \brief State of a loop, shared with its tasks.
+        struct Loop {
+            explicit Loop (std::size_t count) :
+                next (0), count (count), active (0), closed (false) {}
+
+            std::atomic <std::size_t> next;     //! the next index to hand out
+            std::size_t count;                  //! number of indices
+            std::mutex mutex;                   //! guards all members below
+            std::condition_variable idle;       //! signals that a task stopped
+            unsigned active;                    //! number of tasks that are running
+            bool closed;                        //! set once the calling thread is done
+            std::exception_ptr error;           //! the first exception thrown by function
+        };
+
+        //! \brief Calls the function for the indices that are handed out, until none remain.
+        template <class Function>
+        static void Run (Loop& loop, const Function& function) {
+            try {
+                for (std::size_t i; (i = loop.next++) < loop.count; ) {
+                    function (i);
+                }
+            }
+            catch (...) {
+                std::lock_guard <std::mutex> lock (loop.mutex);
+                if (!loop.error) {
+                    loop.error = std::current_exception ();
+                }
+                loop.next = loop.count;
+            }
+        }
+
+    private:
+        unsigned threads;       //! number of threads, including the calling thread
+        Executor* executor;     //! runs the additional threads, if any
+    };
+
+    /*!
+        \brief Submits simplification jobs to a thread pool.
+
+        A job is a function object that is called without arguments. Its result is reported
+        through a std::future (Submit), or by calling a callback with the result (Post). Jobs
+        that report through a callback must not throw; use Submit to propagate exceptions.
+        Callbacks are called on a worker thread.
+
+        All member functions may be called concurrently, but not from within a job.
+    */
+    class AsyncSimplifier
+    {
+    public:
+        //! \brief Cost of a job that is never batched.
+        static const std::size_t UNBATCHED = static_cast <std::size_t> (-1);
+
+        /*!
+            \brief Runs the jobs on an internal thread pool.
+
+            \param[in] threads      number of worker threads, 0 for hardware concurrency
+            \param[in] maxPending   maximum number of incomplete jobs, 0 for no limit
+            \param[in] batchCost    jobs that cost less are batched, 0 disables batching
+        */
+        explicit AsyncSimplifier (unsigned threads=0, std::size_t maxPending=0, std::size_t batchCost=16384) :
+            pool (new ThreadPool (threads)), executor (*pool),
+            maxPending (maxPending), batchCost (batchCost), pending (0), queuedCost (0)
+        {}
+
+        /*!
+            \brief Runs the jobs on a user supplied executor, which must outlive this object.
+
+            \param[in] executor     runs the (batched) jobs
+            \param[in] maxPending   maximum number of incomplete jobs, 0 for no limit
+            \param[in] batchCost    jobs that cost less are batched, 0 disables batching
+        */
+        explicit AsyncSimplifier (Executor& executor, std::size_t maxPending=0, std::size_t batchCost=16384) :
+            executor (executor),
+            maxPending (maxPending), batchCost (batchCost), pending (0), queuedCost (0)
+        {}
+
+        //! \brief Waits for all jobs to complete.
+        ~AsyncSimplifier () {
+            Wait ();
+        }
+
+        /*!
+            \brief Submits a job, and returns a future for its result.
+
+            Blocks while the maximum number of incomplete jobs is reached.
+
+            \param[in] job      function object that is called without arguments
+            \param[in] cost     number of coordinates processed by the job
+            \return             the future result of the job
+        */
+        template <class Job>
+        auto Submit (Job job, std::size_t cost=UNBATCHED) -> std::future <decltype (job ())> {
+            std::future <decltype (job ())> future;
+            Enqueue (MakeTask (job, future), cost, true);
+            return future;
+        }
+
+        /*!
+            \brief Submits a job, unless the maximum number of incomplete jobs is reached.
+
+            \param[in] job      function object that is called without arguments
+            \param[out] future  the future result of the job, when submitted
+            \param[in] cost     number of coordinates processed by the job
+            \return             true when the job was submitted
+        */
+        template <class Job>
+        bool TrySubmit (Job job, std::future <decltype (job ())>& future,
+                        std::size_t cost=UNBATCHED)
+        {
+            std::future <decltype (job ())> result;
+            if (!Enqueue (MakeTask (job, result), cost, false)) {
+                return false;
+            }
+            future = std::move (result);
+            return true;
+        }
+
+        /*!
+            \brief Submits a job, whose result is passed to a callback.
+
+            Blocks while the maximum number of incomplete jobs is reached.
+
+            \param[in] job      function object that is called without arguments
+            \param[in] callback function object that is called with the result of the job
+            \param[in] cost     number of coordinates processed by the job
+        */
+        template <class Job, class Callback>
+        void Post (Job job, Callback callback, std::size_t cost=UNBATCHED) {
+            Enqueue (std::bind (callback, std::bind (job)), cost, true);
+        }
+
+        /*!
+            \brief Submits a job whose result is passed to a callback, unless the maximum number
+            of incomplete jobs is reached.
+
+            \param[in] job      function object that is called without arguments
+            \param[in] callback function object that is called with the result of the job
+            \param[in] cost     number of coordinates processed by the job
+            \return             true when the job was submitted
+        */
+        template <class Job, class Callback>
+        bool TryPost (Job job, Callback callback, std::size_t cost=UNBATCHED) {
+            return Enqueue (std::bind (callback, std::bind (job)), cost, false);
+        }
+
+        /*!
+            \brief Submits the simplification of a range, and returns a future for the simplified
+            coordinates.
+
+            The algorithm is called as algorithm (first, last, result), where result is a
+            std::back_insert_iterator of a std::vector of the range value type. The range must
+            outlive the job.
+
+            The job is not batched, unless a cost is passed; std::distance (first, last) is a
+            suitable cost when the caller calls Flush or Wait after submitting its jobs.
+
+            \param[in] first        the first coordinate of the first polyline point
+            \param[in] last         one beyond the last coordinate of the last polyline point
+            \param[in] algorithm    function object that performs the simplification
+            \param[in] cost         number of coordinates processed by the job
+            \return                 the future simplified coordinates
+        */
+        template <class ForwardIterator, class Algorithm>
+        std::future <std::vector <typename std::iterator_traits <ForwardIterator>::value_type> > Simplify (
+            ForwardIterator first,
+            ForwardIterator last,
+            Algorithm algorithm,
+            std::size_t cost=UNBATCHED)
+        {
+            typedef std::vector <typename std::iterator_traits <ForwardIterator>::value_type> Coords;
+            return Submit ([=] () -> Coords {
+                Coords result;
+                algorithm (first, last, std::back_inserter (result));
+                return result;
+            }, cost);
+        }
+
+        //! \brief Hands the current batch to the executor.
+        void Flush () {
+            std::unique_lock <std::mutex> lock (mutex);
+            FlushBatch (lock);
+        }
+
+        //! \brief Flushes the current batch, and waits for all jobs to complete.
+        void Wait () {
+            std::unique_lock <std::mutex> lock (mutex);
+            FlushBatch (lock);
+            completed.wait (lock, [this] { return pending == 0; });
+        }
+
+        //! \brief Returns the number of submitted jobs that did not complete yet.
+        std::size_t pending_count () const {
+            std::lock_guard <std::mutex> lock (mutex);
+            return pending;
+        }
+
+    private:
+        typedef std::function <void ()> Task;
+
+        AsyncSimplifier (const AsyncSimplifier&);
+        AsyncSimplifier& operator= (const AsyncSimplifier&);
+
+        //! \brief Wraps a job in a task that fulfills a future.
+        template <class Job, class Result>
+        static Task MakeTask (Job& job, std::future <Result>& future) {
+            std::shared_ptr <std::packaged_task <Result ()> > task =
+                std::make_shared <std::packaged_task <Result ()> > (std::move (job));
+            future = task->get_future ();
+            return [task] { (*task) (); };
+        }
+
+        /*!
+            \brief Queues a task, or hands it to the executor directly.
+
+            \param[in] task     the task
+            \param[in] cost     number of coordinates processed by the task
+            \param[in] block    wait while the maximum number of incomplete jobs is reached
+            \return             false when the task was not submitted
+        */
+        bool Enqueue (Task task, std::size_t cost, bool block) {
+            std::unique_lock <std::mutex> lock (mutex);
+            if (maxPending && pending >= maxPending) {
+                if (!block) {
+                    return false;
+                }
+                // batched jobs count as pending, and must be able to complete
+                FlushBatch (lock);
+                completed.wait (lock, [this] { return pending < maxPending; });
+            }
+            ++pending;
+            if (cost >= batchCost) {
+                lock.unlock ();
+                executor.Execute (Single (std::move (task)));
+                return true;
+            }
+            batch.push_back (std::move (task));
+            queuedCost += cost;
+            if (queuedCost >= batchCost) {
+                FlushBatch (lock);
+            }
+            return true;
+        }
+
+        //! \brief Hands the current batch to the executor; the lock is released meanwhile.
+        void FlushBatch (std::unique_lock <std::mutex>& lock) {
+            if (batch.empty ()) {
+                return;
+            }
+            std::shared_ptr <std::vector <Task> > tasks = std::make_shared <std::vector <Task> > ();
+            tasks->swap (batch);
+            queuedCost = 0;
+            lock.unlock ();
+            executor.Execute ([this, tasks] {
+                for (std::size_t t = 0; t < tasks->size (); ++t) {
+                    (*tasks) [t] ();
+                }
+                Completed (tasks->size ());
+            });
+            lock.lock ();
+        }
+
+        //! \brief Wraps a single task, such that its completion is recorded.
+        Task Single (Task task) {
+            return [this, task] {
+                task ();
+                Completed (1);
+            };
+        }
+
+        //! \brief Records the completion of count jobs.
+        void Completed (std::size_t count) {
+            // notify while locked, such that Wait cannot return and destroy this object before
+            std::lock_guard <std::mutex> lock (mutex);
+            pending -= count;
+            completed.notify_all ();
+        }
+
+    private:
+        std::unique_ptr <ThreadPool> pool;  //! the internal thread pool, if any
+        Executor& executor;                 //! runs the (batched) jobs
+        std::size_t maxPending;             //! maximum number of incomplete jobs, 0 for no limit
+        std::size_t batchCost;              //! jobs that cost less are batched
+        mutable std::mutex mutex;           //! guards all members below
+        std::condition_variable completed;  //! signals the completion of jobs
+        std::size_t pending;                //! number of incomplete jobs, including the batch
+        std::size_t queuedCost;             //! total cost of the jobs in the batch
+        std::vector <Task> batch;           //! jobs that are not yet handed to the executor
+    };
+}
+
+
+#endif // PSIMPL_ASYNC
@@ -0,0 +1,428 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_binary.h
+    \brief Memory mappable binary polyline files.
+
+    A binary polyline file stores any number of polylines (features) of the same dimension and
+    value type. The coordinates are stored raw, in native byte order, so that a memory mapped file
+    can be handed to any PolylineSimplification routine without parsing. The layout is:
+
+<pre>
+    offset                  size                    contents
+    0                       64                      binary_header
+    64                      point_count*DIM*size    coordinates of all features, back to back
+    offsets_position        (feature_count+1)*8     point index of the first point of each
+                                                    feature, followed by point_count
+</pre>
+
+    The coordinates start at a 64 byte boundary, and the offsets table at an 8 byte boundary.
+*/
+
+#ifndef PSIMPL_BINARY
+#define PSIMPL_BINARY
+
+
+#include "psimpl_mmap.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <stdint.h>
+
+
+namespace psimpl {
+    namespace util
+{
+    /*!
+        \brief The header of a binary polyline file.
+    */
+    struct binary_header
+    {
+        enum {
+            SIZE = 64,                  //!< header size in bytes, and alignment of the coordinates
+            VERSION = 1,                //!< current file format version
+            ENDIAN_MARK = 0x01020304    //!< byte order marker, written in native byte order
+        };
+
+        char magic [8];             //!< "PSIMPLB" followed by a terminating zero
+        uint32_t version;           //!< file format version
+        uint32_t byte_order;        //!< ENDIAN_MARK in the byte order of the writer
+        uint32_t dimension;         //!< number of coordinates per point
+        uint32_t value_type;        //!< binary_value_type code of the coordinate type
+        uint32_t value_size;        //!< size of a single coordinate in bytes
+        uint32_t reserved0;         //!< zero
+        uint64_t feature_count;     //!< number of features
+        uint64_t point_count;       //!< total number of points of all features
+        uint64_t offsets_position;  //!< byte position of the offsets table
+        uint64_t reserved1;         //!< zero
+    };
+
+    /*!
+        \brief Maps a coordinate type to its binary_header::value_type code.
+
+        Only the specialized types can be stored.
+    */
+    template <class T> struct binary_value_type;
+    template <> struct binary_value_type <float>  { enum { code = 1 }; };
+    template <> struct binary_value_type <double> { enum { code = 2 }; };
+    template <> struct binary_value_type <short>  { enum { code = 3 }; };
+    template <> struct binary_value_type <int>    { enum { code = 4 }; };
+}
+
+    /*!
+        \brief Provides read-only access to a memory mapped binary polyline file.
+
+        The coordinates of each feature are returned as a pointer range, which can be passed
+        directly to any PolylineSimplification routine.
+
+        \sa psimpl_binary.h
+    */
+    template <class T>
+    class BinaryPolylineReader
+    {
+    public:
+        BinaryPolylineReader () :
+            header (0), coords (0), offsets (0) {}
+
+        /*!
+            \brief Maps and validates the specified file.
+
+            \param[in] path     the file to open
+            \return             true when the file is a valid binary polyline file with
+                                coordinates of type T
+        */
+        bool open (const char* path) {
+            close ();
+            if (!file.open (path) || !Validate ()) {
+                close ();
+                return false;
+            }
+            return true;
+        }
+
+        //! \brief Removes the mapping.
+        void close () {
+            file.close ();
+            header = 0;
+            coords = 0;
+            offsets = 0;
+        }
+
+        bool is_open () const {
+            return header != 0;
+        }
+
+        //! \brief Returns the number of coordinates per point.
+        unsigned dimension () const {
+            return header->dimension;
+        }
+
+        std::size_t feature_count () const {
+            return static_cast <std::size_t> (header->feature_count);
+        }
+
+        //! \brief Returns the total number of points of all features.
+        std::size_t point_count () const {
+            return static_cast <std::size_t> (header->point_count);
+        }
+
+        //! \brief Returns the first coordinate of the first point of a feature.
+        const T* first (std::size_t feature) const {
+            return coords + static_cast <std::size_t> (offsets [feature]) * header->dimension;
+        }
+
+        //! \brief Returns one beyond the last coordinate of the last point of a feature.
+        const T* last (std::size_t feature) const {
+            return coords + static_cast <std::size_t> (offsets [feature + 1]) * header->dimension;
+        }
+
+    private:
+        /*!
+            \brief Validates the header and the offsets table of the mapped file.
+        */
+        bool Validate () {
+            if (file.size () < util::binary_header::SIZE) {
+                return false;
+            }
+            const util::binary_header* h = reinterpret_cast <const util::binary_header*> (file.data ());
+            if (std::memcmp (h->magic, "PSIMPLB", 8) != 0 ||
+                h->version != util::binary_header::VERSION ||
+                h->byte_order != util::binary_header::ENDIAN_MARK ||
+                h->value_type != static_cast <uint32_t> (util::binary_value_type <T>::code) ||
+                h->value_size != sizeof (T) ||
+                h->dimension == 0)
+            {
+                return false;
+            }
+            // check the extent of the coordinates and of the offsets table, without overflowing
+            uint64_t size = file.size ();
+            uint64_t maxPoints = (size - util::binary_header::SIZE) / sizeof (T) / h->dimension;
+            if (h->point_count > maxPoints ||
+                h->offsets_position % 8 ||
+                h->offsets_position < util::binary_header::SIZE + h->point_count * h->dimension * sizeof (T) ||
+                h->offsets_position > size ||
+                h->feature_count >= (size - h->offsets_position) / 8)
+            {
+                return false;
+            }
+            const uint64_t* o = reinterpret_cast <const uint64_t*> (file.data () + h->offsets_position);
+            if (o [0] != 0 || o [h->feature_count] != h->point_count) {
+                return false;
+            }
+            for (uint64_t f = 0; f < h->feature_count; ++f) {
+                if (o [f + 1] < o [f]) {
+                    return false;
+                }
+            }
+            header = h;
+            coords = reinterpret_cast <const T*> (file.data () + util::binary_header::SIZE);
+            offsets = o;
+            return true;
+        }
+
+        BinaryPolylineReader (const BinaryPolylineReader&);
+        BinaryPolylineReader& operator= (const BinaryPolylineReader&);
+
+    private:
+        util::mapped_file file;                 //! the mapped file
+        const util::binary_header* header;      //! header of the mapped file
+        const T* coords;                        //! first coordinate of the first feature
+        const uint64_t* offsets;                //! offsets table of the mapped file
+    };
+
+    /*!
+        \brief Writes a binary polyline file.
+
+        Coordinates are written through an output iterator, which allows the result of any
+        PolylineSimplification routine to be streamed straight to disk:
+
+<pre>
+    psimpl::BinaryPolylineWriter <float> writer;
+    writer.open ("simplified.bin", 2);
+    psimpl::simplify_douglas_peucker <2> (first, last, tol, writer.feature ());
+    writer.close ();
+</pre>
+
+        \sa psimpl_binary.h
+    */
+    template <class T>
+    class BinaryPolylineWriter
+    {
+    public:
+        /*!
+            \brief Output iterator that appends coordinates to the current feature.
+        */
+        class sink
+        {
+        public:
+            typedef std::output_iterator_tag iterator_category;
+            typedef void value_type;
+            typedef void difference_type;
+            typedef void pointer;
+            typedef void reference;
+
+            explicit sink (BinaryPolylineWriter* writer) :
+                writer (writer) {}
+
+            sink& operator= (T value) {
+                writer->Put (value);
+                return *this;
+            }
+
+            sink& operator* () {
+                return *this;
+            }
+
+            sink& operator++ () {
+                return *this;
+            }
+
+            sink operator++ (int) {
+                return *this;
+            }
+
+        private:
+            BinaryPolylineWriter* writer;
+        };
+
+        enum { BUFFER_SIZE = 1 << 16 };     //! number of coordinates that are buffered
+
+        BinaryPolylineWriter () :
+            file (0), dim (0), coordCount (0), failed (false)
+        {
+            buffer.reserve (BUFFER_SIZE);
+        }
+
+        ~BinaryPolylineWriter () {
+            close ();
+        }
+
+        /*!
+            \brief Creates the specified file, after closing any previous file.
+
+            \param[in] path         the file to create
+            \param[in] dimension    number of coordinates per point
+            \return                 true when the file could be created
+        */
+        bool open (const char* path, unsigned dimension) {
+            close ();
+            if (dimension == 0) {
+                return false;
+            }
+            file = std::fopen (path, "wb");
+            if (!file) {
+                return false;
+            }
+            dim = dimension;
+            coordCount = 0;
+            failed = false;
+            offsets.clear ();
+            // reserve space for the header, which is written on close
+            char zero [util::binary_header::SIZE] = {0};
+            Write (zero, sizeof (zero));
+            return !failed;
+        }
+
+        /*!
+            \brief Finishes the current feature, if any, and starts a new feature.
+
+            The writer fails when the finished feature does not consist of complete points.
+
+            \return     output iterator that appends coordinates to the new feature
+        */
+        sink feature () {
+            EndFeature ();
+            offsets.push_back (dim ? coordCount / dim : 0);
+            return sink (this);
+        }
+
+        /*!
+            \brief Writes the offsets table and the header, and closes the file.
+
+            \return     true when the file was completely written, and each feature consisted of
+                        complete points only
+        */
+        bool close () {
+            if (!file) {
+                return false;
+            }
+            Flush ();
+            EndFeature ();
+
+            uint64_t pointCount = coordCount / dim;
+            // pad the coordinates to an 8 byte boundary
+            uint64_t position = util::binary_header::SIZE + coordCount * sizeof (T);
+            char zero [8] = {0};
+            Write (zero, static_cast <std::size_t> ((8 - position % 8) % 8));
+
+            util::binary_header header;
+            std::memset (&header, 0, sizeof (header));
+            std::memcpy (header.magic, "PSIMPLB", 8);
+            header.version = util::binary_header::VERSION;
+            header.byte_order = util::binary_header::ENDIAN_MARK;
+            header.dimension = dim;
+            header.value_type = util::binary_value_type <T>::code;
+            header.value_size = sizeof (T);
+            header.feature_count = offsets.size ();
+            header.point_count = pointCount;
+            header.offsets_position = (position + 7) / 8 * 8;
+
+            offsets.push_back (pointCount);
+            for (std::size_t f = 1; f < offsets.size (); ++f) {
+                if (offsets [f] < offsets [f-1]) {
+                    failed = true;
+                }
+            }
+            Write (&offsets [0], offsets.size () * sizeof (uint64_t));
+
+            if (std::fseek (file, 0, SEEK_SET) != 0) {
+                failed = true;
+            }
+            Write (&header, sizeof (header));
+            if (std::fclose (file) != 0) {
+                failed = true;
+            }
+            file = 0;
+            offsets.clear ();
+            return !failed;
+        }
+
+    private:
+        //! \brief Appends a single coordinate to the current feature.
+        void Put (T value) {
+            buffer.push_back (value);
+            ++coordCount;
+            if (buffer.size () == BUFFER_SIZE) {
+                Flush ();
+            }
+        }
+
+        //! \brief Fails the writer when the current feature ends with an incomplete point.
+        void EndFeature () {
+            if (dim && coordCount % dim) {
+                failed = true;
+            }
+        }
+
+        void Flush () {
+            if (!buffer.empty ()) {
+                Write (&buffer [0], buffer.size () * sizeof (T));
+                buffer.clear ();
+            }
+        }
+
+        void Write (const void* data, std::size_t size) {
+            if (!file || (size && std::fwrite (data, 1, size, file) != size)) {
+                failed = true;
+            }
+        }
+
+        friend class sink;
+
+        BinaryPolylineWriter (const BinaryPolylineWriter&);
+        BinaryPolylineWriter& operator= (const BinaryPolylineWriter&);
+
+    private:
+        std::FILE* file;                    //! the file being written
+        unsigned dim;                       //! number of coordinates per point
+        uint64_t coordCount;                //! number of coordinates written so far
+        bool failed;                        //! indicates if any write failed
+        std::vector <T> buffer;             //! coordinates that still need to be written
+        std::vector <uint64_t> offsets;     //! point index of the first point of each feature
+    };
+}
+
+
+#endif // PSIMPL_BINARY
@@ -0,0 +1,137 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_cancel.h
+    \brief Cancellation tokens for stopping long running simplifications.
+
+    A CancellationToken is passed to the constructor of PolylineSimplification, after which each
+    of its routines checks the token at coarse granularity, and returns a valid best-effort
+    simplification once it is cancelled. For instance, to keep a request within 50 ms:
+
+    <pre>
+    psimpl::Deadline deadline (std::chrono::milliseconds (50));
+    psimpl::PolylineSimplification <2, const double*, double*> ps (
+        psimpl::NoInstrumentation (), &deadline);
+    ps.DouglasPeuckerN (first, last, count, result);
+    </pre>
+*/
+
+#ifndef PSIMPL_CANCEL
+#define PSIMPL_CANCEL
+
+
+#include "psimpl.h"
+#include <atomic>
+#include <chrono>
+
+
+namespace psimpl {
+    /*!
+        \brief Cancellation token that is cancelled explicitly, possibly from another thread.
+    */
+    class CancellationFlag : public CancellationToken
+    {
+    public:
+        CancellationFlag () :
+            cancelled (false)
+        {}
+
+        //! \brief Stops all simplifications that use this token.
+        void Cancel () {
+            cancelled.store (true, std::memory_order_relaxed);
+        }
+
+        //! \brief Allows the token to be used again.
+        void Reset () {
+            cancelled.store (false, std::memory_order_relaxed);
+        }
+
+        bool Cancelled () const {
+            return cancelled.load (std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic <bool> cancelled;   //! set by Cancel
+    };
+
+    /*!
+        \brief Cancellation token that is cancelled once a point in time has passed.
+
+        A deadline may be combined with another token, in which case it is also cancelled when
+        that token is.
+    */
+    class Deadline : public CancellationToken
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        /*!
+            \brief Creates a deadline that expires after the specified time budget.
+
+            \param[in] budget   time budget, starting now
+            \param[in] parent   [optional] token that cancels the deadline early
+        */
+        explicit Deadline (clock::duration budget, const CancellationToken* parent = 0) :
+            deadline (clock::now () + budget), parent (parent)
+        {}
+
+        /*!
+            \brief Creates a deadline that expires at the specified point in time.
+
+            \param[in] deadline the point in time at which the deadline expires
+            \param[in] parent   [optional] token that cancels the deadline early
+        */
+        explicit Deadline (clock::time_point deadline, const CancellationToken* parent = 0) :
+            deadline (deadline), parent (parent)
+        {}
+
+        //! \brief Returns the time that remains until the deadline expires, or zero.
+        clock::duration Remaining () const {
+            clock::time_point now = clock::now ();
+            return now < deadline ? deadline - now : clock::duration::zero ();
+        }
+
+        bool Cancelled () const {
+            return (parent && parent->Cancelled ()) || deadline <= clock::now ();
+        }
+
+    private:
+        clock::time_point deadline;         //! the point in time at which the deadline expires
+        const CancellationToken* parent;    //! optional token that cancels the deadline early
+    };
+}
+
+
+#endif // PSIMPL_CANCEL
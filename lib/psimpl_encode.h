@@ -0,0 +1,354 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_encode.h
+    \brief Output iterators that compress a polyline while it is being simplified.
+
+    Simplified polylines are usually quantized, delta encoded and packed into variable length
+    integers before they are transmitted. The output iterators in this file perform these steps
+    for each coordinate as it is written, so that a simplification algorithm writes its result
+    straight into a compact byte buffer:
+
+<pre>
+    std::vector <unsigned char> bytes;
+    psimpl::simplify_douglas_peucker <2> (first, last, tol,
+        psimpl::make_varint_delta_iterator <2> (std::back_inserter (bytes), 1e6));
+</pre>
+
+    Two encodings are supported:
+    - varint delta: the zigzag encoded delta of each quantized coordinate is written as a base
+      128 varint, as in TWKB and protocol buffers. Any dimension is supported.
+    - Google encoded polyline: the zigzag encoded delta of each quantized coordinate is written
+      in groups of 5 bits, as printable ASCII characters. Only 2D points are supported.
+
+    Each encoding has a matching decoder.
+*/
+
+#ifndef PSIMPL_ENCODE
+#define PSIMPL_ENCODE
+
+
+#include <cmath>
+#include <iterator>
+#include <stdint.h>
+
+
+namespace psimpl {
+    namespace util
+{
+    //! \brief Maps a signed integer to an unsigned integer, such that small magnitudes stay small.
+    inline uint64_t zigzag_encode (int64_t value) {
+        return (static_cast <uint64_t> (value) << 1) ^ static_cast <uint64_t> (value >> 63);
+    }
+
+    //! \brief Inverse of zigzag_encode.
+    inline int64_t zigzag_decode (uint64_t value) {
+        return static_cast <int64_t> (value >> 1) ^ -static_cast <int64_t> (value & 1);
+    }
+
+    //! \brief Multiplies value by factor, and rounds the result half away from zero.
+    inline int64_t quantize (double value, double factor) {
+        double scaled = value * factor;
+        return static_cast <int64_t> (scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    }
+
+    /*!
+        \brief Writes an unsigned integer as a base 128 varint, least significant group first.
+
+        \param[in] value    the value to encode
+        \param[in] result   destination of the encoded bytes
+        \return             one beyond the last encoded byte
+    */
+    template <class OutputIterator>
+    OutputIterator encode_varint (uint64_t value, OutputIterator result) {
+        while (value >= 0x80) {
+            *result = static_cast <unsigned char> (value | 0x80);
+            ++result;
+            value >>= 7;
+        }
+        *result = static_cast <unsigned char> (value);
+        ++result;
+        return result;
+    }
+
+    /*!
+        \brief Reads a base 128 varint.
+
+        \param[in] first    the first byte of the varint
+        \param[in] last     one beyond the last readable byte
+        \param[out] value   the decoded value
+        \return             one beyond the last byte of the varint, or 0 when the varint is
+                            truncated or longer than 64 bits
+    */
+    inline const unsigned char* decode_varint (const unsigned char* first, const unsigned char* last, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; first != last && shift < 64; shift += 7) {
+            unsigned char byte = *first++;
+            value |= static_cast <uint64_t> (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return first;
+            }
+        }
+        return 0;
+    }
+}
+
+    /*!
+        \brief Output iterator that quantizes, delta encodes and varint packs coordinates.
+
+        Each coordinate is multiplied by a factor and rounded. The difference with the previous
+        quantized coordinate of the same dimension is zigzag encoded, and written as a varint.
+        The first point is encoded relative to the origin.
+
+        The encoding state is part of the iterator; continue writing through the iterator that is
+        returned by a simplification function to append further points.
+
+        \tparam DIM             number of coordinates per point
+        \tparam OutputIterator  destination of the encoded bytes
+    */
+    template <unsigned DIM, class OutputIterator>
+    class varint_delta_iterator
+    {
+    public:
+        typedef std::output_iterator_tag iterator_category;
+        typedef void value_type;
+        typedef void difference_type;
+        typedef void pointer;
+        typedef void reference;
+
+        /*!
+            \param[in] result   destination of the encoded bytes
+            \param[in] factor   quantization factor, for instance 1e6 to keep 6 decimals
+        */
+        varint_delta_iterator (OutputIterator result, double factor) :
+            result (result), factor (factor), dim (0), coordCount (0)
+        {
+            for (unsigned d = 0; d < DIM; ++d) {
+                previous [d] = 0;
+            }
+        }
+
+        template <typename T>
+        varint_delta_iterator& operator= (T value) {
+            int64_t quantized = util::quantize (static_cast <double> (value), factor);
+            result = util::encode_varint (util::zigzag_encode (quantized - previous [dim]), result);
+            previous [dim] = quantized;
+            dim = dim + 1 == DIM ? 0 : dim + 1;
+            ++coordCount;
+            return *this;
+        }
+
+        varint_delta_iterator& operator* () { return *this; }
+        varint_delta_iterator& operator++ () { return *this; }
+        varint_delta_iterator& operator++ (int) { return *this; }
+
+        //! \brief Returns one beyond the last encoded byte.
+        OutputIterator base () const {
+            return result;
+        }
+
+        //! \brief Returns the number of encoded coordinates.
+        std::size_t coordinate_count () const {
+            return coordCount;
+        }
+
+    private:
+        OutputIterator result;      //! destination of the encoded bytes
+        double factor;              //! quantization factor
+        int64_t previous [DIM];     //! last quantized coordinate per dimension
+        unsigned dim;               //! dimension of the next coordinate
+        std::size_t coordCount;     //! number of encoded coordinates
+    };
+
+    /*!
+        \brief Output iterator that writes 2D points as a Google encoded polyline.
+
+        Each coordinate is rounded to the specified number of decimals and delta encoded. The
+        zigzag encoded delta is written in groups of 5 bits, each offset by 63 to form a printable
+        character. Points are encoded in the order in which their coordinates are written, which
+        for Google Maps is latitude followed by longitude.
+
+        \tparam OutputIterator  destination of the encoded characters
+    */
+    template <class OutputIterator>
+    class google_polyline_iterator
+    {
+    public:
+        typedef std::output_iterator_tag iterator_category;
+        typedef void value_type;
+        typedef void difference_type;
+        typedef void pointer;
+        typedef void reference;
+
+        /*!
+            \param[in] result       destination of the encoded characters
+            \param[in] precision    number of decimals, 5 for Google Maps, 6 for OSRM and Valhalla
+        */
+        explicit google_polyline_iterator (OutputIterator result, unsigned precision = 5) :
+            result (result), factor (std::pow (10.0, static_cast <int> (precision))), dim (0)
+        {
+            previous [0] = previous [1] = 0;
+        }
+
+        template <typename T>
+        google_polyline_iterator& operator= (T value) {
+            int64_t quantized = util::quantize (static_cast <double> (value), factor);
+            uint64_t encoded = util::zigzag_encode (quantized - previous [dim]);
+            while (encoded >= 0x20) {
+                *result = static_cast <char> ((0x20 | (encoded & 0x1F)) + 63);
+                ++result;
+                encoded >>= 5;
+            }
+            *result = static_cast <char> (encoded + 63);
+            ++result;
+            previous [dim] = quantized;
+            dim ^= 1;
+            return *this;
+        }
+
+        google_polyline_iterator& operator* () { return *this; }
+        google_polyline_iterator& operator++ () { return *this; }
+        google_polyline_iterator& operator++ (int) { return *this; }
+
+        //! \brief Returns one beyond the last encoded character.
+        OutputIterator base () const {
+            return result;
+        }
+
+    private:
+        OutputIterator result;      //! destination of the encoded characters
+        double factor;              //! 10^precision
+        int64_t previous [2];       //! last quantized coordinate per dimension
+        unsigned dim;               //! dimension of the next coordinate
+    };
+
+    //! \brief Creates a varint_delta_iterator, deducing the type of the byte destination.
+    template <unsigned DIM, class OutputIterator>
+    varint_delta_iterator <DIM, OutputIterator> make_varint_delta_iterator (OutputIterator result, double factor) {
+        return varint_delta_iterator <DIM, OutputIterator> (result, factor);
+    }
+
+    //! \brief Creates a google_polyline_iterator, deducing the type of the character destination.
+    template <class OutputIterator>
+    google_polyline_iterator <OutputIterator> make_google_polyline_iterator (OutputIterator result, unsigned precision = 5) {
+        return google_polyline_iterator <OutputIterator> (result, precision);
+    }
+
+    /*!
+        \brief Decodes coordinates written by a varint_delta_iterator.
+
+        \param[in] first    the first encoded byte
+        \param[in] last     one beyond the last encoded byte
+        \param[in] factor   quantization factor used during encoding
+        \param[in] result   destination of the decoded coordinates
+        \param[out] valid   [optional] indicates if the input was complete and well formed
+        \return             one beyond the last decoded coordinate
+    */
+    template <unsigned DIM, class OutputIterator>
+    OutputIterator decode_varint_delta (
+        const unsigned char* first,
+        const unsigned char* last,
+        double factor,
+        OutputIterator result,
+        bool* valid=0)
+    {
+        int64_t previous [DIM] = {};
+        unsigned dim = 0;
+        while (first && first != last) {
+            uint64_t value = 0;
+            first = util::decode_varint (first, last, value);
+            if (first) {
+                previous [dim] += util::zigzag_decode (value);
+                *result = previous [dim] / factor;
+                ++result;
+                dim = dim + 1 == DIM ? 0 : dim + 1;
+            }
+        }
+        if (valid) {
+            *valid = first && dim == 0;
+        }
+        return result;
+    }
+
+    /*!
+        \brief Decodes a Google encoded polyline.
+
+        \param[in] first        the first encoded character
+        \param[in] last         one beyond the last encoded character
+        \param[in] result       destination of the decoded coordinates
+        \param[in] precision    number of decimals used during encoding
+        \param[out] valid       [optional] indicates if the input was complete and well formed
+        \return                 one beyond the last decoded coordinate
+    */
+    template <class OutputIterator>
+    OutputIterator decode_google_polyline (
+        const char* first,
+        const char* last,
+        OutputIterator result,
+        unsigned precision = 5,
+        bool* valid=0)
+    {
+        double factor = std::pow (10.0, static_cast <int> (precision));
+        int64_t previous [2] = { 0, 0 };
+        unsigned dim = 0;
+        bool ok = true;
+        while (ok && first != last) {
+            uint64_t value = 0;
+            unsigned shift = 0;
+            int chunk = 0;
+            do {
+                chunk = first == last ? -1 : *first++ - 63;
+                ok = chunk >= 0 && chunk < 64 && shift < 64;
+                if (ok) {
+                    value |= static_cast <uint64_t> (chunk & 0x1F) << shift;
+                    shift += 5;
+                }
+            } while (ok && chunk >= 0x20);
+            if (ok) {
+                previous [dim] += util::zigzag_decode (value);
+                *result = previous [dim] / factor;
+                ++result;
+                dim ^= 1;
+            }
+        }
+        if (valid) {
+            *valid = ok && dim == 0;
+        }
+        return result;
+    }
+}
+
+
+#endif // PSIMPL_ENCODE
@@ -0,0 +1,612 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_generator.h
+    \brief Lazy simplification using C++20 coroutines.
+
+    The generate_* functions are lazy versions of the sequential simplification routines: NP,
+    RD, PD (single pass), RW, OP and LA. Instead of copying the coordinates of all keys to an
+    output range, they return a Generator that produces an iterator to the first coordinate of
+    each key, when the consumer asks for it. A consumer that only needs a prefix of the
+    simplification can stop early, and one that renders a polyline over multiple frames can
+    spread the work across those frames:
+
+    \code
+    auto keys = psimpl::generate_radial_distance <2> (coords.begin (), coords.end (), tol);
+    for (auto key : keys) {
+        if (!Draw (key [0], key [1])) {
+            break;  // the remainder of the polyline is never simplified
+        }
+    }
+    \endcode
+
+    The produced keys are identical to the keys of the corresponding simplify_* function. In
+    case the input requirements of that function are not met, each complete point is produced.
+    The range [first, last) must outlive the generator.
+
+    This file requires C++20 coroutine support, and is empty otherwise.
+*/
+
+#ifndef PSIMPL_GENERATOR
+#define PSIMPL_GENERATOR
+
+
+#include "psimpl.h"
+
+#if defined (__cpp_impl_coroutine)
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+
+namespace psimpl {
+    /*!
+        \brief A lazily produced sequence of values, that can be traversed once.
+
+        The coroutine that produces the values only runs while the consumer advances an
+        iterator. Destroying the generator abandons the remaining values.
+
+        \tparam T   the type of the produced values
+    */
+    template <class T>
+    class Generator
+    {
+    public:
+        class promise_type;
+
+    private:
+        typedef std::coroutine_handle <promise_type> handle;
+
+    public:
+        class promise_type
+        {
+        public:
+            Generator get_return_object () {
+                return Generator (handle::from_promise (*this));
+            }
+
+            std::suspend_always initial_suspend () noexcept { return std::suspend_always (); }
+            std::suspend_always final_suspend () noexcept { return std::suspend_always (); }
+
+            std::suspend_always yield_value (T value) {
+                current = std::move (value);
+                return std::suspend_always ();
+            }
+
+            void return_void () {}
+
+            void unhandled_exception () {
+                exception = std::current_exception ();
+            }
+
+        private:
+            friend class Generator;
+
+            T current;                      //! the most recently produced value
+            std::exception_ptr exception;   //! exception thrown by the coroutine, if any
+        };
+
+        /*!
+            \brief Input iterator over the produced values.
+
+            Incrementing the iterator resumes the coroutine until it produces the next value.
+        */
+        class iterator
+        {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T* pointer;
+            typedef const T& reference;
+
+            iterator () :
+                coroutine (0)
+            {}
+
+            reference operator * () const { return coroutine->promise ().current; }
+            pointer operator -> () const { return &coroutine->promise ().current; }
+
+            iterator& operator ++ () {
+                Resume (*coroutine);
+                return *this;
+            }
+
+            void operator ++ (int) {
+                ++*this;
+            }
+
+            bool operator == (const iterator& other) const {
+                return Done () == other.Done ();
+            }
+
+            bool operator != (const iterator& other) const {
+                return !(*this == other);
+            }
+
+        private:
+            friend class Generator;
+
+            explicit iterator (handle* coroutine) :
+                coroutine (coroutine)
+            {}
+
+            bool Done () const {
+                return !coroutine || coroutine->done ();
+            }
+
+            handle* coroutine;  //! the coroutine of the generator, 0 for the end iterator
+        };
+
+        Generator (Generator&& other) noexcept :
+            coroutine (std::exchange (other.coroutine, handle ()))
+        {}
+
+        Generator& operator = (Generator&& other) noexcept {
+            std::swap (coroutine, other.coroutine);
+            return *this;
+        }
+
+        ~Generator () {
+            if (coroutine) {
+                coroutine.destroy ();
+            }
+        }
+
+        /*!
+            \brief Produces the first value.
+
+            Subsequent calls do not restart the sequence, but return an iterator to the current
+            value.
+
+            \return     iterator to the current value
+        */
+        iterator begin () {
+            if (coroutine && !started) {
+                started = true;
+                Resume (coroutine);
+            }
+            return iterator (&coroutine);
+        }
+
+        iterator end () {
+            return iterator ();
+        }
+
+    private:
+        explicit Generator (handle coroutine) :
+            coroutine (coroutine)
+        {}
+
+        Generator (const Generator&);
+        Generator& operator = (const Generator&);
+
+        //! \brief Runs the coroutine until it produces a value or finishes.
+        static void Resume (handle coroutine) {
+            coroutine.resume ();
+            if (coroutine.promise ().exception) {
+                std::rethrow_exception (std::exchange (coroutine.promise ().exception, std::exception_ptr ()));
+            }
+        }
+
+    private:
+        handle coroutine;       //! the coroutine that produces the values
+        bool started = false;   //! indicates if the first value was requested
+    };
+
+    namespace generator
+    {
+        //! \brief Produces each complete point of [first, last), for invalid input.
+        template <unsigned DIM, class ForwardIterator>
+        Generator <ForwardIterator> each_point (
+            ForwardIterator first,
+            ForwardIterator last)
+        {
+            for (std::ptrdiff_t pointCount = DIM ? std::distance (first, last) / DIM : 0;
+                 pointCount; --pointCount)
+            {
+                co_yield first;
+                std::advance (first, DIM);
+            }
+        }
+    }
+
+    /*!
+        \brief Lazily performs the nth point routine (NP).
+
+        \sa simplify_nth_point
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] n        specifies 'each nth point'
+        \return             generator of iterators to the first coordinate of each key
+    */
+    template <unsigned DIM, class ForwardIterator>
+    Generator <ForwardIterator> generate_nth_point (
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned n)
+    {
+        std::ptrdiff_t coordCount = std::distance (first, last);
+        std::ptrdiff_t pointCount = DIM         // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+
+        // validate input and check if simplification required
+        if (coordCount % DIM || pointCount < 3 || n < 2) {
+            for (ForwardIterator point : generator::each_point <DIM> (first, last)) {
+                co_yield point;
+            }
+            co_return;
+        }
+
+        // the first point is always part of the simplification
+        co_yield first;
+
+        // each nth point, and the last point
+        for (std::ptrdiff_t remaining = pointCount - 1; remaining; ) {
+            std::ptrdiff_t moved = std::min <std::ptrdiff_t> (n, remaining);
+            std::advance (first, moved * DIM);
+            remaining -= moved;
+            co_yield first;
+        }
+    }
+
+    /*!
+        \brief Lazily performs the (radial) distance between points routine (RD).
+
+        \sa simplify_radial_distance
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] tol      radial (point-to-point) distance tolerance
+        \return             generator of iterators to the first coordinate of each key
+    */
+    template <unsigned DIM, class ForwardIterator>
+    Generator <ForwardIterator> generate_radial_distance (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        std::ptrdiff_t coordCount = std::distance (first, last);
+        std::ptrdiff_t pointCount = DIM         // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+        typename std::iterator_traits <ForwardIterator>::value_type tol2 = tol * tol;
+
+        // validate input and check if simplification required
+        if (coordCount % DIM || pointCount < 3 || tol2 == 0) {
+            for (ForwardIterator point : generator::each_point <DIM> (first, last)) {
+                co_yield point;
+            }
+            co_return;
+        }
+
+        ForwardIterator current = first;    // indicates the current key
+        ForwardIterator next = first;       // used to find the next key
+
+        // the first point is always part of the simplification
+        co_yield current;
+        std::advance (next, DIM);
+
+        // Skip first and last point, because they are always part of the simplification
+        for (std::ptrdiff_t index = 1; index < pointCount - 1; ++index) {
+            if (math::point_distance2 <DIM> (current, next) >= tol2) {
+                current = next;
+                co_yield current;
+            }
+            std::advance (next, DIM);
+        }
+        // the last point is always part of the simplification
+        co_yield next;
+    }
+
+    /*!
+        \brief Lazily performs a single pass of the perpendicular distance routine (PD).
+
+        \sa simplify_perpendicular_distance
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] tol      perpendicular (segment-to-point) distance tolerance
+        \return             generator of iterators to the first coordinate of each key
+    */
+    template <unsigned DIM, class ForwardIterator>
+    Generator <ForwardIterator> generate_perpendicular_distance (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        std::ptrdiff_t coordCount = std::distance (first, last);
+        std::ptrdiff_t pointCount = DIM         // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+        typename std::iterator_traits <ForwardIterator>::value_type tol2 = tol * tol;
+
+        // validate input and check if simplification required
+        if (coordCount % DIM || pointCount < 3 || tol2 == 0) {
+            for (ForwardIterator point : generator::each_point <DIM> (first, last)) {
+                co_yield point;
+            }
+            co_return;
+        }
+
+        ForwardIterator p0 = first;
+        ForwardIterator p1 = std::next (p0, DIM);
+        ForwardIterator p2 = std::next (p1, DIM);
+
+        // the first point is always part of the simplification
+        co_yield p0;
+
+        while (p2 != last) {
+            // test p1 against line segment S(p0, p2)
+            if (math::segment_distance2 <DIM> (p0, p2, p1) < tol2) {
+                co_yield p2;
+                // move up by two points
+                p0 = p2;
+                std::advance (p1, 2 * DIM);
+                if (p1 == last) {
+                    // protect against advancing p2 beyond last
+                    break;
+                }
+                std::advance (p2, 2 * DIM);
+            }
+            else {
+                co_yield p1;
+                // move up by one point
+                p0 = p1;
+                p1 = p2;
+                std::advance (p2, DIM);
+            }
+        }
+        // make sure the last point is part of the simplification
+        if (p1 != last) {
+            co_yield p1;
+        }
+    }
+
+    /*!
+        \brief Lazily performs Reumann-Witkam approximation (RW).
+
+        \sa simplify_reumann_witkam
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] tol      perpendicular (point-to-line) distance tolerance
+        \return             generator of iterators to the first coordinate of each key
+    */
+    template <unsigned DIM, class ForwardIterator>
+    Generator <ForwardIterator> generate_reumann_witkam (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol)
+    {
+        std::ptrdiff_t coordCount = std::distance (first, last);
+        std::ptrdiff_t pointCount = DIM         // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+        typename std::iterator_traits <ForwardIterator>::value_type tol2 = tol * tol;
+
+        // validate input and check if simplification required
+        if (coordCount % DIM || pointCount < 3 || tol2 == 0) {
+            for (ForwardIterator point : generator::each_point <DIM> (first, last)) {
+                co_yield point;
+            }
+            co_return;
+        }
+
+        // define the line L(p0, p1)
+        ForwardIterator p0 = first;                 // indicates the current key
+        ForwardIterator p1 = std::next (first, DIM);// indicates the next point after p0
+
+        // keep track of two test points
+        ForwardIterator pi = p1;    // the previous test point
+        ForwardIterator pj = p1;    // the current test point (pi+1)
+
+        // the first point is always part of the simplification
+        co_yield p0;
+
+        // check each point pj against L(p0, p1)
+        for (std::ptrdiff_t j = 2; j < pointCount; ++j) {
+            pi = pj;
+            std::advance (pj, DIM);
+
+            if (math::line_distance2 <DIM> (p0, p1, pj) < tol2) {
+                continue;
+            }
+            // found the next key at pi
+            co_yield pi;
+            // define new line L(pi, pj)
+            p0 = pi;
+            p1 = pj;
+        }
+        // the last point is always part of the simplification
+        co_yield pj;
+    }
+
+    /*!
+        \brief Lazily performs Opheim approximation (OP).
+
+        \sa simplify_opheim
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] min_tol  radial and perpendicular (point-to-ray) distance tolerance
+        \param[in] max_tol  radial distance tolerance
+        \return             generator of iterators to the first coordinate of each key
+    */
+    template <unsigned DIM, class ForwardIterator>
+    Generator <ForwardIterator> generate_opheim (
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type min_tol,
+        typename std::iterator_traits <ForwardIterator>::value_type max_tol)
+    {
+        std::ptrdiff_t coordCount = std::distance (first, last);
+        std::ptrdiff_t pointCount = DIM         // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+        typename std::iterator_traits <ForwardIterator>::value_type min_tol2 = min_tol * min_tol;
+        typename std::iterator_traits <ForwardIterator>::value_type max_tol2 = max_tol * max_tol;
+
+        // validate input and check if simplification required
+        if (coordCount % DIM || pointCount < 3 || min_tol2 == 0 || max_tol2 == 0) {
+            for (ForwardIterator point : generator::each_point <DIM> (first, last)) {
+                co_yield point;
+            }
+            co_return;
+        }
+
+        // define the ray R(r0, r1)
+        ForwardIterator r0 = first; // indicates the current key and start of the ray
+        ForwardIterator r1 = first; // indicates a point on the ray
+        bool rayDefined = false;
+
+        // keep track of two test points
+        ForwardIterator pi = r0;    // the previous test point
+        ForwardIterator pj =        // the current test point (pi+1)
+            std::next (pi, DIM);
+
+        // the first point is always part of the simplification
+        co_yield r0;
+
+        for (std::ptrdiff_t j = 2; j < pointCount; ++j) {
+            pi = pj;
+            std::advance (pj, DIM);
+
+            if (!rayDefined) {
+                // discard each point within minimum tolerance
+                if (math::point_distance2 <DIM> (r0, pj) < min_tol2) {
+                    continue;
+                }
+                // the last point within minimum tolerance pi defines the ray R(r0, r1)
+                r1 = pi;
+                rayDefined = true;
+            }
+
+            // check each point pj against R(r0, r1)
+            if (math::point_distance2 <DIM> (r0, pj) < max_tol2 &&
+                math::ray_distance2 <DIM> (r0, r1, pj) < min_tol2)
+            {
+                continue;
+            }
+            // found the next key at pi
+            co_yield pi;
+            // define new ray R(pi, pj)
+            r0 = pi;
+            rayDefined = false;
+        }
+        // the last point is always part of the simplification
+        co_yield pj;
+    }
+
+    /*!
+        \brief Lazily performs Lang approximation (LA).
+
+        \sa simplify_lang
+
+        \param[in] first        the first coordinate of the first polyline point
+        \param[in] last         one beyond the last coordinate of the last polyline point
+        \param[in] tol          perpendicular (point-to-segment) distance tolerance
+        \param[in] look_ahead   defines the size of the search region
+        \return                 generator of iterators to the first coordinate of each key
+    */
+    template <unsigned DIM, class BidirectionalIterator>
+    Generator <BidirectionalIterator> generate_lang (
+        BidirectionalIterator first,
+        BidirectionalIterator last,
+        typename std::iterator_traits <BidirectionalIterator>::value_type tol,
+        unsigned look_ahead)
+    {
+        typedef typename std::iterator_traits <BidirectionalIterator>::value_type value_type;
+
+        std::ptrdiff_t coordCount = std::distance (first, last);
+        std::ptrdiff_t pointCount = DIM         // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+        value_type tol2 = tol * tol;
+
+        // validate input and check if simplification required
+        if (coordCount % DIM || pointCount < 3 || look_ahead < 2 || tol2 == 0) {
+            for (BidirectionalIterator point : generator::each_point <DIM> (first, last)) {
+                co_yield point;
+            }
+            co_return;
+        }
+
+        BidirectionalIterator current = first;      // indicates the current key
+        BidirectionalIterator next = first;         // used to find the next key
+
+        std::ptrdiff_t remaining = pointCount - 1;  // the number of points remaining after next
+        std::ptrdiff_t moved = std::min <std::ptrdiff_t> (look_ahead, remaining);
+        std::advance (next, moved * DIM);
+        remaining -= moved;
+
+        // the first point is always part of the simplification
+        co_yield current;
+
+        while (moved) {
+            value_type d2 = 0;
+            BidirectionalIterator p = std::next (current, DIM);
+
+            while (p != next) {
+                d2 = std::max (d2, math::segment_distance2 <DIM> (current, next, p));
+                if (tol2 < d2) {
+                    break;
+                }
+                std::advance (p, DIM);
+            }
+            if (d2 < tol2) {
+                current = next;
+                co_yield current;
+                moved = std::min <std::ptrdiff_t> (look_ahead, remaining);
+                std::advance (next, moved * DIM);
+                remaining -= moved;
+            }
+            else {
+                std::advance (next, -static_cast <std::ptrdiff_t> (DIM));
+                ++remaining;
+            }
+        }
+    }
+}
+
+#endif // __cpp_impl_coroutine
+
+
+#endif // PSIMPL_GENERATOR
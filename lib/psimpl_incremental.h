@@ -0,0 +1,393 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_incremental.h
+    \brief Incremental Douglas-Peucker simplification of an editable polyline.
+
+    IncrementalDouglasPeucker keeps the Douglas-Peucker recursion tree of a polyline: the range
+    of each sub polyline, its key and the squared distance of that key. When a point is moved,
+    inserted or erased, only the sub polylines that contain the point are revisited:
+
+    - when the point lies inside a sub polyline, only its own distance is compared against the
+      current key, and only the child that contains it is revisited;
+    - when the point is (or was) the key, or an endpoint of the sub polyline, the sub polyline is
+      scanned again; its children are kept when the key did not change.
+
+    Subtrees that are not affected keep their keys. The resulting simplification is always
+    identical to running simplify_douglas_peucker with PREFILTER_NONE on the edited polyline.
+*/
+
+#ifndef PSIMPL_INCREMENTAL
+#define PSIMPL_INCREMENTAL
+
+
+#include "psimpl.h"
+#include <algorithm>
+#include <vector>
+
+
+namespace psimpl {
+    /*!
+        \brief Maintains the Douglas-Peucker simplification of a polyline under local edits.
+
+        Point indices refer to the current (edited) polyline. Edits of the first or last point
+        change the segment of the complete polyline, and are handled by rebuilding the tree.
+
+        \tparam DIM     number of coordinates per point
+        \tparam T       coordinate type
+    */
+    template <unsigned DIM, class T>
+    class IncrementalDouglasPeucker
+    {
+    public:
+        IncrementalDouglasPeucker () :
+            tol (0),
+            tol2 (0),
+            root (npos)
+        {}
+
+        /*!
+            \brief Assigns a polyline, and computes its simplification.
+
+            \param[in] first    the first coordinate of the first polyline point
+            \param[in] last     one beyond the last coordinate of the last polyline point
+            \param[in] tol      perpendicular (point-to-segment) distance tolerance
+            \return             false when the range contains an incomplete point, or less than
+                                2 points; the polyline is cleared in that case
+        */
+        template <class ForwardIterator>
+        bool Assign (ForwardIterator first, ForwardIterator last, T tol) {
+            coords.assign (first, last);
+            this->tol = tol;
+            tol2 = tol * tol;
+            if (coords.size () % DIM || coords.size () < 2 * DIM) {
+                coords.clear ();
+                nodes.clear ();
+                unused.clear ();
+                root = npos;
+                return false;
+            }
+            Rebuild ();
+            return true;
+        }
+
+        //! \brief Returns the number of polyline points.
+        std::size_t point_count () const {
+            return coords.size () / DIM;
+        }
+
+        //! \brief Returns the coordinates of the polyline point at index.
+        const T* Point (std::size_t index) const {
+            return &coords [index * DIM];
+        }
+
+        /*!
+            \brief Moves the point at index.
+
+            \param[in] index    the index of the point to move
+            \param[in] point    the DIM new coordinates
+            \return             false when index is out of range
+        */
+        bool Move (std::size_t index, const T* point) {
+            if (index >= point_count ()) {
+                return false;
+            }
+            std::copy (point, point + DIM, coords.begin () + index * DIM);
+            Update (index);
+            return true;
+        }
+
+        /*!
+            \brief Inserts a point before index.
+
+            \param[in] index    the index of the new point, point_count () appends the point
+            \param[in] point    the DIM coordinates of the new point
+            \return             false when index is out of range
+        */
+        bool Insert (std::size_t index, const T* point) {
+            std::size_t pointCount = point_count ();
+            if (root == npos || index > pointCount) {
+                return false;
+            }
+            coords.insert (coords.begin () + index * DIM, point, point + DIM);
+            if (index == 0 || index == pointCount) {
+                Rebuild ();
+                return true;
+            }
+            Shift (index, 1);
+            Update (index);
+            return true;
+        }
+
+        /*!
+            \brief Erases the point at index.
+
+            \param[in] index    the index of the point to erase
+            \return             false when index is out of range, or when the polyline would be
+                                left with less than 2 points
+        */
+        bool Erase (std::size_t index) {
+            std::size_t pointCount = point_count ();
+            if (index >= pointCount || pointCount < 3) {
+                return false;
+            }
+            if (index == 0 || index == pointCount - 1) {
+                coords.erase (coords.begin () + index * DIM, coords.begin () + (index + 1) * DIM);
+                Rebuild ();
+                return true;
+            }
+            // the sub polyline for which the point is the key, if any
+            std::size_t node = root;
+            while (nodes [node].key != npos && nodes [node].key != index) {
+                node = index < nodes [node].key ? nodes [node].left : nodes [node].right;
+            }
+            bool isKey = nodes [node].key == index;
+            if (isKey) {
+                ReleaseChildren (node);
+            }
+            coords.erase (coords.begin () + index * DIM, coords.begin () + (index + 1) * DIM);
+            Shift (index + 1, -1);
+            if (isKey) {
+                // the remaining points keep their distance to the segment of all ancestors
+                Grow (node);
+            }
+            return true;
+        }
+
+        /*!
+            \brief Copies the current simplification.
+
+            \param[in] result   destination of the simplified polyline
+            \return             one beyond the last coordinate of the simplified polyline
+        */
+        template <class OutputIterator>
+        OutputIterator Simplification (OutputIterator result) const {
+            if (root == npos || tol == 0) {
+                // same as simplify_douglas_peucker
+                return std::copy (coords.begin (), coords.end (), result);
+            }
+            result = std::copy (Point (0), Point (0) + DIM, result);
+            std::vector <std::size_t> stack (1, root);
+            while (!stack.empty ()) {
+                const Node& node = nodes [stack.back ()];
+                stack.pop_back ();
+                if (node.key == npos) {
+                    result = std::copy (Point (node.last), Point (node.last) + DIM, result);
+                    continue;
+                }
+                stack.push_back (node.right);
+                stack.push_back (node.left);
+            }
+            return result;
+        }
+
+    private:
+        //! \brief A sub polyline [first, last] of the recursion tree.
+        struct Node {
+            std::size_t first;      //! index of the first point
+            std::size_t last;       //! index of the last point
+            std::size_t key;        //! index of the key, npos when not split
+            T dist2;                //! squared distance of the key
+            std::size_t left;       //! sub polyline [first, key]
+            std::size_t right;      //! sub polyline [key, last]
+        };
+
+        static const std::size_t npos = static_cast <std::size_t> (-1);
+
+        //! \brief Squared distance of a point to the segment of a sub polyline.
+        T Distance2 (const Node& node, std::size_t index) const {
+            return math::segment_distance2 <DIM> (Point (node.first), Point (node.last), Point (index));
+        }
+
+        //! \brief Finds the key of a sub polyline, exactly like DPHelper::FindKey.
+        std::size_t FindKey (const Node& node, T& dist2) const {
+            std::size_t key = npos;
+            dist2 = 0;
+            for (std::size_t current = node.first + 1; current < node.last; ++current) {
+                T d2 = Distance2 (node, current);
+                if (d2 < dist2) {
+                    continue;
+                }
+                key = current;
+                dist2 = d2;
+            }
+            return key;
+        }
+
+        //! \brief Creates a node without key.
+        std::size_t Allocate (std::size_t first, std::size_t last) {
+            Node node;
+            node.first = first;
+            node.last = last;
+            node.key = node.left = node.right = npos;
+            node.dist2 = 0;
+            if (unused.empty ()) {
+                nodes.push_back (node);
+                return nodes.size () - 1;
+            }
+            std::size_t index = unused.back ();
+            unused.pop_back ();
+            nodes [index] = node;
+            return index;
+        }
+
+        //! \brief Releases all descendants of a node.
+        void ReleaseChildren (std::size_t index) {
+            std::vector <std::size_t> stack;
+            if (nodes [index].key != npos) {
+                stack.push_back (nodes [index].left);
+                stack.push_back (nodes [index].right);
+            }
+            nodes [index].key = nodes [index].left = nodes [index].right = npos;
+            while (!stack.empty ()) {
+                std::size_t current = stack.back ();
+                stack.pop_back ();
+                if (nodes [current].key != npos) {
+                    stack.push_back (nodes [current].left);
+                    stack.push_back (nodes [current].right);
+                }
+                unused.push_back (current);
+            }
+        }
+
+        //! \brief Recursively splits a node without children.
+        void Grow (std::size_t index) {
+            std::vector <std::size_t> stack (1, index);
+            while (!stack.empty ()) {
+                std::size_t current = stack.back ();
+                stack.pop_back ();
+                T dist2;
+                std::size_t key = FindKey (nodes [current], dist2);
+                if (key == npos || !(tol2 < dist2)) {
+                    continue;
+                }
+                std::size_t left = Allocate (nodes [current].first, key);
+                std::size_t right = Allocate (key, nodes [current].last);
+                Node& node = nodes [current];
+                node.key = key;
+                node.dist2 = dist2;
+                node.left = left;
+                node.right = right;
+                stack.push_back (right);
+                stack.push_back (left);
+            }
+        }
+
+        //! \brief Rebuilds the complete tree.
+        void Rebuild () {
+            nodes.clear ();
+            unused.clear ();
+            root = Allocate (0, point_count () - 1);
+            Grow (root);
+        }
+
+        //! \brief Adds delta to all point indices that are not less than index.
+        void Shift (std::size_t index, int delta) {
+            std::vector <std::size_t> stack (1, root);
+            while (!stack.empty ()) {
+                Node& node = nodes [stack.back ()];
+                stack.pop_back ();
+                if (node.last < index) {
+                    continue;
+                }
+                node.last += delta;
+                if (node.first >= index) {
+                    node.first += delta;
+                }
+                if (node.key != npos) {
+                    if (node.key >= index) {
+                        node.key += delta;
+                    }
+                    stack.push_back (node.left);
+                    stack.push_back (node.right);
+                }
+            }
+        }
+
+        //! \brief Updates all sub polylines affected by a change of the point at index.
+        void Update (std::size_t index) {
+            std::vector <std::size_t> stack (1, root);
+            while (!stack.empty ()) {
+                std::size_t current = stack.back ();
+                stack.pop_back ();
+                const Node& node = nodes [current];
+                if (index < node.first || node.last < index) {
+                    continue;
+                }
+                if (index == node.first || index == node.last || index == node.key) {
+                    // all distances, or the distance of the key changed
+                    T dist2;
+                    std::size_t key = FindKey (node, dist2);
+                    if (node.key != npos && node.key == key && tol2 < dist2) {
+                        nodes [current].dist2 = dist2;
+                        stack.push_back (node.left);
+                        stack.push_back (node.right);
+                    }
+                    else {
+                        ReleaseChildren (current);
+                        Grow (current);
+                    }
+                    continue;
+                }
+                T d2 = Distance2 (node, index);
+                if (node.key == npos) {
+                    // all other points are within tolerance
+                    if (tol2 < d2) {
+                        Grow (current);
+                    }
+                    continue;
+                }
+                if (node.dist2 < d2 || (node.dist2 == d2 && node.key < index)) {
+                    // the point becomes the new key
+                    ReleaseChildren (current);
+                    Grow (current);
+                    continue;
+                }
+                stack.push_back (index < node.key ? node.left : node.right);
+            }
+        }
+
+    private:
+        std::vector <T> coords;             //! the polyline coordinates
+        T tol;                              //! distance tolerance
+        T tol2;                             //! squared distance tolerance
+        std::vector <Node> nodes;           //! the recursion tree
+        std::vector <std::size_t> unused;   //! released nodes
+        std::size_t root;                   //! the complete polyline
+    };
+}
+
+
+#endif // PSIMPL_INCREMENTAL
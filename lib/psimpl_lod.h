@@ -0,0 +1,352 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_lod.h
+    \brief Level of detail index for viewport queries.
+
+    Interactive viewers repeatedly need a polyline simplified to a pixel tolerance, restricted to
+    the visible area. LodIndex computes the Douglas-Peucker importance of each point once, and
+    stores it in a bounding volume hierarchy over consecutive point ranges. Each node holds the
+    bounding box of its points and their maximum importance.
+
+    A query for a viewport and tolerance only visits the nodes that are near the viewport. A
+    node that does not contain any point of the simplification is not descended; only the
+    simplification points around it are looked up, using the maximum importance of the nodes.
+    The result equals the Douglas-Peucker simplification (without radial distance prefilter) for
+    that tolerance, reduced to those segments that intersect the viewport. Like Douglas-Peucker,
+    a zero tolerance keeps all points, including duplicate and collinear points.
+*/
+
+#ifndef PSIMPL_LOD
+#define PSIMPL_LOD
+
+
+#include "psimpl.h"
+#include <algorithm>
+#include <vector>
+
+
+namespace psimpl {
+    /*!
+        \brief Bounding volume hierarchy that answers (viewport, tolerance) simplification
+        queries.
+
+        \tparam DIM     number of coordinates per point
+        \tparam T       floating point coordinate type
+    */
+    template <unsigned DIM, class T>
+    class LodIndex
+    {
+    public:
+        enum {
+            LEAF_SIZE = 32      //!< maximum number of segments per leaf node
+        };
+
+        LodIndex () {}
+
+        /*!
+            \brief Builds the index for a polyline.
+
+            \param[in] first    the first coordinate of the first polyline point
+            \param[in] last     one beyond the last coordinate of the last polyline point
+            \return             false when the range does not contain at least 2 complete points
+        */
+        template <class ForwardIterator>
+        bool Build (ForwardIterator first, ForwardIterator last) {
+            coords.assign (first, last);
+            importance.clear ();
+            nodes.clear ();
+            bool valid = false;
+            compute_douglas_peucker_importance2 <DIM> (coords.begin (), coords.end (),
+                std::back_inserter (importance), &valid);
+            if (!valid) {
+                coords.clear ();
+                importance.clear ();
+                return false;
+            }
+            nodes.reserve (4 * (importance.size () / LEAF_SIZE + 1));
+            BuildNode (0, importance.size () - 1);
+            return true;
+        }
+
+        //! \brief Returns the number of indexed points.
+        std::size_t point_count () const {
+            return importance.size ();
+        }
+
+        //! \brief Returns the bounding box of the polyline.
+        void Bounds (T* min, T* max) const {
+            for (unsigned d = 0; d < DIM; ++d) {
+                min [d] = nodes.empty () ? T () : nodes [0].min [d];
+                max [d] = nodes.empty () ? T () : nodes [0].max [d];
+            }
+        }
+
+        /*!
+            \brief Simplifies the polyline using tolerance tol, restricted to a viewport.
+
+            Each maximal sequence of simplification segments that intersect the viewport is passed
+            to the sink as a separate part, by calling sink (first, last) with the coordinates of
+            the part.
+
+            \param[in] min      the minimum coordinates of the viewport
+            \param[in] max      the maximum coordinates of the viewport
+            \param[in] tol      the simplification tolerance, 0 to keep all points
+            \param[in] sink     receives the visible parts of the simplification
+            \return             the number of points passed to the sink
+        */
+        template <class Sink>
+        std::size_t Query (const T* min, const T* max, T tol, Sink& sink) const {
+            if (nodes.empty ()) {
+                return 0;
+            }
+            Search search (min, max, tol);
+            Visit (0, search);
+
+            std::size_t pointCount = 0;
+            std::vector <T> part;
+            for (std::size_t c = 0; c < search.chains.size (); ++c) {
+                const std::vector <std::size_t>& chain = search.chains [c];
+                for (std::size_t k = 0; k + 1 < chain.size (); ++k) {
+                    const T* p = &coords [chain [k] * DIM];
+                    const T* q = &coords [chain [k + 1] * DIM];
+                    if (!Intersects (p, q, min, max)) {
+                        Emit (part, sink, pointCount);
+                        continue;
+                    }
+                    if (part.empty ()) {
+                        part.insert (part.end (), p, p + DIM);
+                    }
+                    part.insert (part.end (), q, q + DIM);
+                }
+                Emit (part, sink, pointCount);
+            }
+            return pointCount;
+        }
+
+    private:
+        //! \brief A range of consecutive points [first, last].
+        struct Node {
+            std::size_t first;      //! index of the first point
+            std::size_t last;       //! index of the last point
+            std::size_t left;       //! index of the left child node, 0 for leaf nodes
+            std::size_t right;      //! index of the right child node, 0 for leaf nodes
+            T min [DIM];            //! minimum coordinates of the points
+            T max [DIM];            //! maximum coordinates of the points
+            T importance;           //! maximum importance of the points
+        };
+
+        //! \brief State of a query.
+        struct Search {
+            Search (const T* min, const T* max, T tol) :
+                tol2 (tol * tol == 0 ? T (-1) : tol * tol)  // a point with importance 0 is kept as well
+            {
+                // original points lie within tol of the simplification segment they belong to
+                for (unsigned d = 0; d < DIM; ++d) {
+                    this->min [d] = min [d] - tol;
+                    this->max [d] = max [d] + tol;
+                }
+            }
+
+            T min [DIM];                                        //! viewport extended by tol
+            T max [DIM];                                        //! viewport extended by tol
+            T tol2;                                             //! squared tolerance, -1 for zero tolerance
+            std::vector <std::vector <std::size_t> > chains;    //! consecutive simplification points
+            std::vector <std::size_t> keys;                     //! scratch space
+        };
+
+        static const std::size_t npos = static_cast <std::size_t> (-1);
+
+        //! \brief Builds the node for points [first, last], returns its index.
+        std::size_t BuildNode (std::size_t first, std::size_t last) {
+            std::size_t index = nodes.size ();
+            nodes.push_back (Node ());
+            Node node;
+            node.first = first;
+            node.last = last;
+            node.left = node.right = 0;
+            if (last - first > LEAF_SIZE) {
+                // children share the middle point, so that each segment is covered by a node
+                std::size_t middle = first + (last - first) / 2;
+                node.left = BuildNode (first, middle);
+                node.right = BuildNode (middle, last);
+                const Node& left = nodes [node.left];
+                const Node& right = nodes [node.right];
+                for (unsigned d = 0; d < DIM; ++d) {
+                    node.min [d] = std::min (left.min [d], right.min [d]);
+                    node.max [d] = std::max (left.max [d], right.max [d]);
+                }
+                node.importance = std::max (left.importance, right.importance);
+            }
+            else {
+                for (unsigned d = 0; d < DIM; ++d) {
+                    node.min [d] = node.max [d] = coords [first * DIM + d];
+                }
+                node.importance = importance [first];
+                for (std::size_t i = first + 1; i <= last; ++i) {
+                    for (unsigned d = 0; d < DIM; ++d) {
+                        node.min [d] = std::min (node.min [d], coords [i * DIM + d]);
+                        node.max [d] = std::max (node.max [d], coords [i * DIM + d]);
+                    }
+                    node.importance = std::max (node.importance, importance [i]);
+                }
+            }
+            nodes [index] = node;
+            return index;
+        }
+
+        //! \brief Collects the simplification points near the viewport, in polyline order.
+        void Visit (std::size_t index, Search& search) const {
+            const Node& node = nodes [index];
+            for (unsigned d = 0; d < DIM; ++d) {
+                if (node.max [d] < search.min [d] || search.max [d] < node.min [d]) {
+                    return;
+                }
+            }
+            if (node.left && search.tol2 < node.importance) {
+                Visit (node.left, search);
+                Visit (node.right, search);
+                return;
+            }
+            // the keys of this node, enclosed by the nearest keys outside of it
+            search.keys.clear ();
+            std::size_t prev = node.first ? FindPrevious (0, node.first, search.tol2) : npos;
+            if (prev != npos) {
+                search.keys.push_back (prev);
+            }
+            if (search.tol2 < node.importance) {
+                for (std::size_t i = node.first; i <= node.last; ++i) {
+                    if (search.tol2 < importance [i]) {
+                        search.keys.push_back (i);
+                    }
+                }
+            }
+            std::size_t next = FindNext (0, node.last, search.tol2);
+            if (next != npos) {
+                search.keys.push_back (next);
+            }
+            // append to the current chain, or start a new one
+            std::vector <std::vector <std::size_t> >& chains = search.chains;
+            if (chains.empty () || chains.back ().back () < search.keys.front ()) {
+                chains.push_back (search.keys);
+                return;
+            }
+            for (std::size_t k = 0; k < search.keys.size (); ++k) {
+                if (chains.back ().back () < search.keys [k]) {
+                    chains.back ().push_back (search.keys [k]);
+                }
+            }
+        }
+
+        //! \brief Finds the last point before index that is part of the simplification.
+        std::size_t FindPrevious (std::size_t index, std::size_t before, T tol2) const {
+            const Node& node = nodes [index];
+            if (node.first >= before || !(tol2 < node.importance)) {
+                return npos;
+            }
+            if (node.left) {
+                std::size_t found = FindPrevious (node.right, before, tol2);
+                return found != npos ? found : FindPrevious (node.left, before, tol2);
+            }
+            for (std::size_t i = std::min (node.last + 1, before); i-- > node.first; ) {
+                if (tol2 < importance [i]) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+
+        //! \brief Finds the first point after index that is part of the simplification.
+        std::size_t FindNext (std::size_t index, std::size_t after, T tol2) const {
+            const Node& node = nodes [index];
+            if (node.last <= after || !(tol2 < node.importance)) {
+                return npos;
+            }
+            if (node.left) {
+                std::size_t found = FindNext (node.left, after, tol2);
+                return found != npos ? found : FindNext (node.right, after, tol2);
+            }
+            for (std::size_t i = std::max (node.first, after + 1); i <= node.last; ++i) {
+                if (tol2 < importance [i]) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+
+        //! \brief Determines if segment (p, q) intersects the box [min, max].
+        static bool Intersects (const T* p, const T* q, const T* min, const T* max) {
+            double t0 = 0;
+            double t1 = 1;
+            for (unsigned d = 0; d < DIM; ++d) {
+                double delta = static_cast <double> (q [d]) - p [d];
+                double lo = static_cast <double> (min [d]) - p [d];
+                double hi = static_cast <double> (max [d]) - p [d];
+                if (delta == 0) {
+                    if (lo > 0 || hi < 0) {
+                        return false;
+                    }
+                    continue;
+                }
+                double ta = lo / delta;
+                double tb = hi / delta;
+                t0 = std::max (t0, std::min (ta, tb));
+                t1 = std::min (t1, std::max (ta, tb));
+                if (t0 > t1) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //! \brief Passes a non empty part to the sink.
+        template <class Sink>
+        static void Emit (std::vector <T>& part, Sink& sink, std::size_t& pointCount) {
+            if (!part.empty ()) {
+                sink (&part [0], &part [0] + part.size ());
+                pointCount += part.size () / DIM;
+                part.clear ();
+            }
+        }
+
+    private:
+        std::vector <T> coords;         //! the polyline coordinates
+        std::vector <T> importance;     //! squared importance of each point
+        std::vector <Node> nodes;       //! the hierarchy, the root node comes first
+    };
+}
+
+
+#endif // PSIMPL_LOD
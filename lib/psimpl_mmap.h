@@ -0,0 +1,513 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_mmap.h
+    \brief Memory mapped files, and out-of-core Douglas-Peucker approximation.
+
+    The out-of-core Douglas-Peucker routine never copies the polyline coordinates. Instead, both
+    the radial distance preprocessing step and the approximation flag points using one bit per
+    point, while all coordinates are read straight from (memory mapped) storage. Sub polylines
+    are processed level by level in file order, so that each level results in a single sequential
+    sweep over the file, instead of the random access pattern of a depth first traversal.
+*/
+
+#ifndef PSIMPL_MMAP
+#define PSIMPL_MMAP
+
+
+#include "psimpl.h"
+#include <vector>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+
+namespace psimpl {
+    namespace util
+{
+    /*!
+        \brief A read-only memory mapping of a complete file.
+
+        The mapping is page aligned, which makes it suitable for storing any value type.
+    */
+    class mapped_file
+    {
+    public:
+        mapped_file () :
+            ptr (0), length (0), opened (false)
+        {
+            Init ();
+        }
+
+        explicit mapped_file (const char* path) :
+            ptr (0), length (0), opened (false)
+        {
+            Init ();
+            open (path);
+        }
+
+        ~mapped_file () {
+            close ();
+        }
+
+        /*!
+            \brief Maps the specified file, after closing any previous mapping.
+
+            \param[in] path     the file to map
+            \return             true when the file could be mapped
+        */
+        bool open (const char* path) {
+            close ();
+#if defined(_WIN32)
+            file = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, 0);
+            if (file == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx (file, &fileSize)) {
+                close ();
+                return false;
+            }
+            length = static_cast <std::size_t> (fileSize.QuadPart);
+            if (length) {
+                mapping = CreateFileMappingA (file, 0, PAGE_READONLY, 0, 0, 0);
+                if (!mapping) {
+                    close ();
+                    return false;
+                }
+                ptr = static_cast <const char*> (MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0));
+                if (!ptr) {
+                    close ();
+                    return false;
+                }
+            }
+#else
+            int fd = ::open (path, O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat info;
+            if (fstat (fd, &info) != 0) {
+                ::close (fd);
+                return false;
+            }
+            length = static_cast <std::size_t> (info.st_size);
+            if (length) {
+                void* addr = mmap (0, length, PROT_READ, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED) {
+                    ::close (fd);
+                    length = 0;
+                    return false;
+                }
+                ptr = static_cast <const char*> (addr);
+            }
+            ::close (fd);   // the mapping remains valid
+#endif
+            opened = true;
+            return true;
+        }
+
+        //! \brief Removes the mapping.
+        void close () {
+#if defined(_WIN32)
+            if (ptr) {
+                UnmapViewOfFile (ptr);
+            }
+            if (mapping) {
+                CloseHandle (mapping);
+            }
+            if (file != INVALID_HANDLE_VALUE) {
+                CloseHandle (file);
+            }
+            Init ();
+#else
+            if (ptr) {
+                munmap (const_cast <char*> (ptr), length);
+            }
+#endif
+            ptr = 0;
+            length = 0;
+            opened = false;
+        }
+
+        bool is_open () const {
+            return opened;
+        }
+
+        //! \brief Returns the first byte of the mapping, or 0 for empty files.
+        const char* data () const {
+            return ptr;
+        }
+
+        //! \brief Returns the size of the mapping in bytes.
+        std::size_t size () const {
+            return length;
+        }
+
+    private:
+        void Init () {
+#if defined(_WIN32)
+            file = INVALID_HANDLE_VALUE;
+            mapping = 0;
+#endif
+        }
+
+        mapped_file (const mapped_file&);
+        mapped_file& operator= (const mapped_file&);
+
+    private:
+        const char* ptr;        //! first byte of the mapping
+        std::size_t length;     //! size of the mapping in bytes
+        bool opened;            //! indicates if a file is mapped
+#if defined(_WIN32)
+        HANDLE file;            //! handle of the mapped file
+        HANDLE mapping;         //! handle of the file mapping object
+#endif
+    };
+
+    /*!
+        \brief Advises the operating system that a memory range will be accessed.
+
+        This is only a hint, which is ignored on platforms that do not support it.
+
+        \param[in] addr         the first byte of the range
+        \param[in] length       the size of the range in bytes
+        \param[in] sequential   true for sequential access of the complete range, false to request
+                                that the range is read ahead
+    */
+    inline void advise (
+        const void* addr,
+        std::size_t length,
+        bool sequential)
+    {
+#if defined(_WIN32)
+        (void) addr;
+        (void) length;
+        (void) sequential;
+#else
+        if (!addr || !length) {
+            return;
+        }
+        // madvise requires a page aligned address
+        std::size_t page = static_cast <std::size_t> (sysconf (_SC_PAGESIZE));
+        std::size_t offset = reinterpret_cast <std::size_t> (addr) % page;
+        void* start = static_cast <char*> (const_cast <void*> (addr)) - offset;
+        madvise (start, length + offset, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+#endif
+    }
+}
+
+    /*!
+        \brief Out-of-core Douglas-Peucker approximation (DP).
+
+        Produces exactly the same simplification as PolylineSimplification::DouglasPeucker, while
+        only using two bits of memory per point (one for the radial distance preprocessing step,
+        and one for the keys) plus a job list that is proportional to the number of keys.
+
+        The coordinates are read in chunks of CHUNK_POINTS points, and the next chunk is always
+        requested ahead of time. Since DP finds the same keys regardless of the order in which
+        sub polylines are approximated, all sub polylines of the same level are processed in file
+        order during a single sweep.
+    */
+    template <unsigned DIM, class T>
+    class OutOfCoreDouglasPeucker
+    {
+        typedef std::ptrdiff_t index_type;
+
+        //! \brief Defines a sub polyline.
+        struct SubPoly {
+            SubPoly (index_type first=0, index_type last=0) :
+                first (first), last (last) {}
+
+            index_type first;   //! point index of the first point
+            index_type last;    //! point index of the last point
+        };
+
+        //! \brief Defines the key of a polyline.
+        struct KeyInfo {
+            KeyInfo (index_type index=0, T dist2=0) :
+                index (index), dist2 (dist2) {}
+
+            index_type index;   //! point index of the key
+            T dist2;            //! squared distance of the key to a segment
+        };
+
+    public:
+        enum { CHUNK_POINTS = 1 << 16 };    //! number of points read ahead
+
+        /*!
+            \brief Performs Douglas-Peucker approximation (DP).
+
+            RD followed by DP is applied to the range [first, last) using the specified tolerance
+            tol. The resulting simplified polyline is copied to the output range
+            [result, result + m*DIM), where m is the number of vertices of the simplified
+            polyline. The return value is the end of the output range: result + m*DIM.
+
+            The input requirements are the same as for PolylineSimplification::DouglasPeucker.
+            In case these requirements are not met, the entire input range [first, last) is
+            copied to the output range [result, result + (last - first)).
+
+            \param[in] first    the first coordinate of the first polyline point
+            \param[in] last     one beyond the last coordinate of the last polyline point
+            \param[in] tol      perpendicular (point-to-segment) distance tolerance
+            \param[in] result   destination of the simplified polyline
+            \return             one beyond the last coordinate of the simplified polyline
+        */
+        template <class OutputIterator>
+        static OutputIterator Simplify (
+            const T* first,
+            const T* last,
+            T tol,
+            OutputIterator result)
+        {
+            index_type coordCount = last - first;
+            index_type pointCount = DIM      // protect against zero DIM
+                                    ? coordCount / DIM
+                                    : 0;
+            // validate input and check if simplification required
+            if (coordCount % DIM || pointCount < 3 || tol == 0) {
+                return std::copy (first, last, result);
+            }
+            util::advise (first, coordCount * sizeof (T), true);
+
+            // radial distance routine as preprocessing
+            util::bit_array reduced (pointCount);
+            RadialDistance (first, pointCount, tol, reduced);
+
+            // douglas-peucker approximation
+            util::bit_array keys (pointCount);
+            Approximate (first, pointCount, tol, reduced, keys);
+
+            // copy all keys
+            for (index_type p = 0; p < pointCount; p = keys.find_next (p)) {
+                result = std::copy (first + p * DIM, first + (p + 1) * DIM, result);
+            }
+            return result;
+        }
+
+    private:
+        /*!
+            \brief Requests the chunk of points that follows the specified point index.
+
+            \param[in] coords       array of polyline coordinates
+            \param[in] pointCount   number of points in coords []
+            \param[in] index        point index of the first point of the chunk
+            \return                 point index of the first point that follows the chunk
+        */
+        static index_type ReadAhead (
+            const T* coords,
+            index_type pointCount,
+            index_type index)
+        {
+            index_type end = std::min <index_type> (pointCount, index + CHUNK_POINTS);
+            if (index < end) {
+                util::advise (coords + index * DIM, (end - index) * DIM * sizeof (T), false);
+            }
+            return end;
+        }
+
+        /*!
+            \brief Flags the points that are kept by the (radial) distance routine (RD).
+
+            Produces the same keys as PolylineSimplification::RadialDistance.
+        */
+        static void RadialDistance (
+            const T* coords,
+            index_type pointCount,
+            T tol,
+            util::bit_array& keys)
+        {
+            T tol2 = tol * tol;     // squared distance tolerance
+            const T* current = coords;
+            index_type requested = 0;   // one beyond the last requested point index
+
+            // the first and last point are always part of the simplification
+            keys.set (0);
+            keys.set (pointCount - 1);
+
+            for (index_type index = 1; index < pointCount - 1; ++index) {
+                if (index + CHUNK_POINTS > requested) {
+                    requested = ReadAhead (coords, pointCount, std::max (index, requested));
+                }
+                const T* next = coords + index * DIM;
+                if (math::point_distance2 <DIM> (current, next) < tol2) {
+                    continue;
+                }
+                current = next;
+                keys.set (index);
+            }
+        }
+
+        /*!
+            \brief Performs Douglas-Peucker approximation, considering only the flagged points.
+
+            Each iteration processes all sub polylines of a single level in file order.
+        */
+        static void Approximate (
+            const T* coords,
+            index_type pointCount,
+            T tol,
+            const util::bit_array& filter,
+            util::bit_array& keys)
+        {
+            T tol2 = tol * tol;     // squared distance tolerance
+            keys.set (0);           // the first point is always a key
+            keys.set (pointCount - 1);  // the last point is always a key
+
+            std::vector <SubPoly> level (1, SubPoly (0, pointCount - 1));
+            std::vector <SubPoly> nextLevel;
+
+            while (!level.empty ()) {
+                nextLevel.clear ();
+                for (typename std::vector <SubPoly>::const_iterator it = level.begin (); it != level.end (); ++it) {
+                    KeyInfo keyInfo = FindKey (coords, pointCount, filter, it->first, it->last);
+                    if (keyInfo.index && tol2 < keyInfo.dist2) {
+                        // store the key if valid
+                        keys.set (keyInfo.index);
+                        // split the polyline at the key, keeping the sub polylines in file order
+                        nextLevel.push_back (SubPoly (it->first, keyInfo.index));
+                        nextLevel.push_back (SubPoly (keyInfo.index, it->last));
+                    }
+                }
+                level.swap (nextLevel);
+            }
+        }
+
+        /*!
+            \brief Finds the key for the given sub polyline.
+
+            Finds the flagged point in the range [first, last] that is furthest away from the
+            segment (first, last), while requesting the coordinates one chunk ahead.
+
+            \return     the index of the key and its distance, or 0 when a key could not be found
+        */
+        static KeyInfo FindKey (
+            const T* coords,
+            index_type pointCount,
+            const util::bit_array& filter,
+            index_type first,
+            index_type last)
+        {
+            KeyInfo keyInfo;
+
+            const T* s1 = coords + first * DIM;
+            const T* s2 = coords + last * DIM;
+            // only read ahead for large sub polylines, small ones are covered by sequential access
+            index_type requested = last - first < CHUNK_POINTS ? pointCount : first;
+
+            for (index_type current = filter.find_next (first); current < last; current = filter.find_next (current)) {
+                if (current + CHUNK_POINTS > requested) {
+                    requested = ReadAhead (coords, pointCount, std::max (current, requested));
+                }
+                T d2 = math::segment_distance2 <DIM> (s1, s2, coords + current * DIM);
+                if (d2 < keyInfo.dist2) {
+                    continue;
+                }
+                // update maximum squared distance and the point it belongs to
+                keyInfo.index = current;
+                keyInfo.dist2 = d2;
+            }
+            return keyInfo;
+        }
+    };
+
+    /*!
+        \brief Performs out-of-core Douglas-Peucker polyline simplification (DP).
+
+        This is a convenience function for OutOfCoreDouglasPeucker::Simplify.
+
+        \param[in] first    the first coordinate of the first polyline point
+        \param[in] last     one beyond the last coordinate of the last polyline point
+        \param[in] tol      perpendicular (point-to-segment) distance tolerance
+        \param[in] result   destination of the simplified polyline
+        \return             one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class T, class OutputIterator>
+    OutputIterator simplify_douglas_peucker_out_of_core (
+        const T* first,
+        const T* last,
+        T tol,
+        OutputIterator result)
+    {
+        return OutOfCoreDouglasPeucker <DIM, T>::Simplify (first, last, tol, result);
+    }
+
+    /*!
+        \brief Performs out-of-core Douglas-Peucker polyline simplification (DP) of a file.
+
+        The file is memory mapped, and should contain nothing but the polyline coordinates, each
+        stored as a T in native byte order.
+
+        \param[in] path     the file containing the polyline coordinates
+        \param[in] tol      perpendicular (point-to-segment) distance tolerance
+        \param[in] result   destination of the simplified polyline
+        \param[out] valid   [optional] indicates if the file could be mapped, and if its size is a
+                            multiple of sizeof (T)
+        \return             one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class T, class OutputIterator>
+    OutputIterator simplify_douglas_peucker_mapped (
+        const char* path,
+        T tol,
+        OutputIterator result,
+        bool* valid=0)
+    {
+        util::mapped_file file (path);
+        if (!file.is_open () || file.size () % sizeof (T)) {
+            if (valid) {
+                *valid = false;
+            }
+            return result;
+        }
+        if (valid) {
+            *valid = true;
+        }
+        const T* first = reinterpret_cast <const T*> (file.data ());
+        return OutOfCoreDouglasPeucker <DIM, T>::Simplify (first, first + file.size () / sizeof (T), tol, result);
+    }
+}
+
+
+#endif // PSIMPL_MMAP
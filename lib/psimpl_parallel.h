@@ -0,0 +1,1257 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_parallel.h
+    \brief Parallel simplification, and execution policy overloads of the convenience functions.
+
+    ParallelSimplification performs the routines that can be parallelized soundly on multiple
+    threads. Each routine produces exactly the same result as its sequential counterpart:
+
+    - RD, PD, RW and OP: the polyline is split into chunks. Each chunk is simplified
+      speculatively, as if the point just before it were a key. Afterwards the chunk seams are
+      reconciled from left to right: the true simplification is followed from the state at the
+      end of the previous chunk, until it selects a speculative key. From that key on, the
+      speculative keys are correct, because the state of these routines after selecting a key
+      only depends on that key. The serial part is usually limited to a few points per seam.
+    - DP: the RD preprocessing step is chunked as above, and flags the points that remain
+      instead of copying them. Large sub polylines are searched for their key using all
+      threads, until there are enough independent sub polylines to approximate them in
+      parallel.
+    - DPn: the key of each large sub polyline is searched using all threads.
+    - Positional errors: the simplified points are matched to the original points sequentially,
+      after which the errors are computed in parallel.
+    - NP and Lang: these are not parallelized; they delegate to PolylineSimplification.
+
+    All routines operate on the coordinates in place when the input iterators are pointers.
+    Any other input, such as a std::list or std::deque, is copied once into a temporary buffer
+    first, which requires O(n) extra memory.
+
+    The overloads of the convenience functions take an execution policy as first argument, like
+    the parallel algorithms of the standard library: psimpl::execution::seq, par or par_unseq.
+    Define PSIMPL_STD_EXECUTION to accept std::execution::seq, par and par_unseq as well. This
+    is not the default, because including <execution> may require linking an additional
+    library, such as TBB for libstdc++. The routines never use the standard parallel
+    algorithms; they run on threads of their own, or on the tasks of an Executor, see
+    ParallelFor in psimpl_async.h.
+
+    This file requires C++11.
+*/
+
+#ifndef PSIMPL_PARALLEL
+#define PSIMPL_PARALLEL
+
+
+#include "psimpl.h"
+#include "psimpl_async.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#if defined (PSIMPL_STD_EXECUTION)
+#include <execution>
+#endif
+
+
+namespace psimpl {
+    namespace execution
+    {
+        //! \brief Requests sequential execution.
+        struct sequenced_policy {};
+
+        //! \brief Requests parallel execution.
+        struct parallel_policy {};
+
+        //! \brief Requests parallel execution; treated as parallel_policy.
+        struct parallel_unsequenced_policy {};
+
+        static const sequenced_policy seq = sequenced_policy ();
+        static const parallel_policy par = parallel_policy ();
+        static const parallel_unsequenced_policy par_unseq = parallel_unsequenced_policy ();
+
+        //! \brief Determines if a type is an execution policy.
+        template <class Policy> struct is_execution_policy : std::false_type {};
+        template <> struct is_execution_policy <sequenced_policy> : std::true_type {};
+        template <> struct is_execution_policy <parallel_policy> : std::true_type {};
+        template <> struct is_execution_policy <parallel_unsequenced_policy> : std::true_type {};
+
+        //! \brief Determines if an execution policy allows parallel execution.
+        template <class Policy> struct is_parallel_policy : std::true_type {};
+        template <> struct is_parallel_policy <sequenced_policy> : std::false_type {};
+
+#if defined (PSIMPL_STD_EXECUTION)
+        template <> struct is_execution_policy <std::execution::sequenced_policy> : std::true_type {};
+        template <> struct is_execution_policy <std::execution::parallel_policy> : std::true_type {};
+        template <> struct is_execution_policy <std::execution::parallel_unsequenced_policy> : std::true_type {};
+        template <> struct is_parallel_policy <std::execution::sequenced_policy> : std::false_type {};
+#endif
+
+        /*!
+            \brief Returns the number of threads to use for an execution policy.
+
+            \return     1 for sequential execution, 0 for all hardware threads
+        */
+        template <class Policy>
+        unsigned thread_count (const Policy&) {
+            return is_parallel_policy <Policy>::value ? 0 : 1;
+        }
+
+        /*!
+            \brief Return type of the convenience functions that take an execution policy.
+
+            Removes those overloads unless Policy is an execution policy.
+        */
+        template <class Policy, class Result>
+        struct enable_if_policy :
+            std::enable_if <is_execution_policy <typename std::decay <Policy>::type>::value, Result>
+        {};
+    }
+
+    /*!
+        \brief Instrumentation policy that forwards the work of multiple threads to another
+        policy, one call at a time.
+
+        \sa NoInstrumentation
+    */
+    template <class Instrumentation>
+    class SynchronizedInstrumentation
+    {
+    public:
+        /*!
+            \param[in] instrumentation  receives the work; must outlive this object
+            \param[in] mutex            serializes the calls; must outlive this object
+        */
+        SynchronizedInstrumentation (const Instrumentation& instrumentation, std::mutex& mutex) :
+            instrumentation (&instrumentation), mutex (&mutex)
+        {}
+
+        void Distances (std::size_t count) const {
+            std::lock_guard <std::mutex> lock (*mutex);
+            instrumentation->Distances (count);
+        }
+
+        void SubPolyline (std::size_t pending) const {
+            std::lock_guard <std::mutex> lock (*mutex);
+            instrumentation->SubPolyline (pending);
+        }
+
+        void Reduced (std::size_t pointCount, std::size_t remaining) const {
+            std::lock_guard <std::mutex> lock (*mutex);
+            instrumentation->Reduced (pointCount, remaining);
+        }
+
+        void Allocated (std::size_t bytes) const {
+            std::lock_guard <std::mutex> lock (*mutex);
+            instrumentation->Allocated (bytes);
+        }
+
+        void Begin (Phase phase) const {
+            std::lock_guard <std::mutex> lock (*mutex);
+            instrumentation->Begin (phase);
+        }
+
+        void End (Phase phase) const {
+            std::lock_guard <std::mutex> lock (*mutex);
+            instrumentation->End (phase);
+        }
+
+    private:
+        const Instrumentation* instrumentation;     //! receives the work
+        std::mutex* mutex;                          //! serializes the calls
+    };
+
+    //! \brief Records nothing, without locking.
+    template <>
+    class SynchronizedInstrumentation <NoInstrumentation> : public NoInstrumentation
+    {
+    public:
+        SynchronizedInstrumentation (const NoInstrumentation&, std::mutex&) {}
+    };
+
+    /*!
+        \brief Performs polyline simplification routines on multiple threads.
+
+        The results are identical to those of PolylineSimplification. Using a single thread, all
+        routines simply delegate to PolylineSimplification. The Douglas-Peucker routines use the
+        approximation of PolylineSimplification, including its compact keys and point indices.
+
+        Input that is not stored contiguously is copied before it is simplified in parallel,
+        which requires O(n) extra memory.
+
+        \tparam DIM             number of coordinates per point
+        \tparam InputIterator   input iterator type, models a forward iterator
+        \tparam OutputIterator  output iterator type
+        \tparam Instrumentation receives the work of all routines, see NoInstrumentation; the
+                                work of multiple threads is reported one call at a time
+    */
+    template <unsigned DIM, class InputIterator, class OutputIterator, class Instrumentation = NoInstrumentation>
+    class ParallelSimplification
+    {
+        typedef typename std::iterator_traits <InputIterator>::difference_type diff_type;
+        typedef typename std::iterator_traits <InputIterator>::value_type value_type;
+        typedef std::ptrdiff_t ptr_diff_type;
+        typedef PolylineSimplification <DIM, InputIterator, OutputIterator, Instrumentation> Sequential;
+        typedef typename Sequential::ScopedPhase ScopedPhase;
+        typedef SynchronizedInstrumentation <Instrumentation> Shared;
+        typedef typename PolylineSimplification <DIM, const value_type*, const value_type*, Shared>::DPHelper DPHelper;
+        typedef typename DPHelper::Points Points;
+        typedef typename DPHelper::FilteredPoints FilteredPoints;
+
+    public:
+        /*!
+            \param[in] threads          number of threads, 0 for hardware concurrency
+            \param[in] chunkSize        minimum number of points per chunk, 0 for the default
+            \param[in] executor         [optional] runs the additional threads, instead of starting
+                                        them for each routine; must outlive this object
+            \param[in] instrumentation  receives the work of all routines
+        */
+        explicit ParallelSimplification (
+            unsigned threads=0,
+            std::size_t chunkSize=0,
+            Executor* executor=0,
+            const Instrumentation& instrumentation = Instrumentation ()) :
+            parallel (threads, executor),
+            threads (parallel.thread_count ()),
+            chunkSize (chunkSize ? chunkSize : static_cast <std::size_t> (MIN_CHUNK)),
+            instrumentation (instrumentation)
+        {}
+
+        //! \brief Returns the number of threads.
+        unsigned thread_count () const {
+            return threads;
+        }
+
+        //! \brief Returns the minimum number of points per chunk.
+        std::size_t chunk_size () const {
+            return chunkSize;
+        }
+
+        /*!
+            \brief Performs the nth point routine (NP) sequentially.
+
+            \sa PolylineSimplification::NthPoint
+        */
+        OutputIterator NthPoint (
+            InputIterator first,
+            InputIterator last,
+            unsigned n,
+            OutputIterator result)
+        {
+            return Sequential (instrumentation).NthPoint (first, last, n, result);
+        }
+
+        /*!
+            \brief Performs the (radial) distance between points routine (RD) on chunks.
+
+            \sa PolylineSimplification::RadialDistance
+        */
+        OutputIterator RadialDistance (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount < 3 || tol * tol == 0 || ChunkCount (pointCount) < 2) {
+                return Sequential (instrumentation).RadialDistance (first, last, tol, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            SpeculativeKeys (RadialDistanceRoutine (coords, tol), pointCount, keys);
+            return Sequential::CopyKeys (coords, pointCount, keys, result);
+        }
+
+        /*!
+            \brief Performs the perpendicular distance routine (PD) on chunks.
+
+            \sa PolylineSimplification::PerpendicularDistance
+        */
+        OutputIterator PerpendicularDistance (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount < 3 || tol * tol == 0 || ChunkCount (pointCount) < 2) {
+                return Sequential (instrumentation).PerpendicularDistance (first, last, tol, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            PerpendicularDistanceKeys (coords, pointCount, tol, keys);
+            return Sequential::CopyKeys (coords, pointCount, keys, result);
+        }
+
+        /*!
+            \brief Repeatedly performs the perpendicular distance routine (PD) on chunks.
+
+            The first pass reads the input directly when it is stored contiguously. Each pass
+            that removes points stores its result in a temporary buffer, which requires O(n)
+            extra memory.
+
+            \sa PolylineSimplification::PerpendicularDistance
+        */
+        OutputIterator PerpendicularDistance (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            unsigned repeat,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount < 3 || tol * tol == 0 || repeat < 2 ||
+                ChunkCount (pointCount) < 2)
+            {
+                return Sequential (instrumentation).PerpendicularDistance (first, last, tol, repeat, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+            ptr_diff_type count = pointCount;
+            std::vector <value_type> poly;
+            while (repeat-- && count > 2) {
+                util::bit_array keys (count);
+                instrumentation.Allocated (keys.bytes ());
+                PerpendicularDistanceKeys (coords, count, tol, keys);
+                std::vector <value_type> simplified;
+                simplified.reserve (count * DIM);
+                instrumentation.Allocated (count * DIM * sizeof (value_type));
+                Sequential::CopyKeys (coords, count, keys, std::back_inserter (simplified));
+                // check if simplification did not improve
+                if (simplified.size () == static_cast <std::size_t> (count * DIM)) {
+                    break;
+                }
+                poly.swap (simplified);
+                coords = &poly [0];
+                count = static_cast <ptr_diff_type> (poly.size () / DIM);
+            }
+            return std::copy (coords, coords + count * DIM, result);
+        }
+
+        /*!
+            \brief Performs Reumann-Witkam approximation (RW) on chunks.
+
+            \sa PolylineSimplification::ReumannWitkam
+        */
+        OutputIterator ReumannWitkam (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount < 3 || tol * tol == 0 || ChunkCount (pointCount) < 2) {
+                return Sequential (instrumentation).ReumannWitkam (first, last, tol, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            SpeculativeKeys (ReumannWitkamRoutine (coords, tol), pointCount, keys);
+            return Sequential::CopyKeys (coords, pointCount, keys, result);
+        }
+
+        /*!
+            \brief Performs Opheim approximation (OP) on chunks.
+
+            \sa PolylineSimplification::Opheim
+        */
+        OutputIterator Opheim (
+            InputIterator first,
+            InputIterator last,
+            value_type min_tol,
+            value_type max_tol,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount < 3 || min_tol * min_tol == 0 || max_tol * max_tol == 0 ||
+                ChunkCount (pointCount) < 2)
+            {
+                return Sequential (instrumentation).Opheim (first, last, min_tol, max_tol, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            SpeculativeKeys (OpheimRoutine (coords, min_tol, max_tol), pointCount, keys);
+            return Sequential::CopyKeys (coords, pointCount, keys, result);
+        }
+
+        /*!
+            \brief Performs Lang approximation (LA) sequentially.
+
+            \sa PolylineSimplification::Lang
+        */
+        OutputIterator Lang (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            unsigned look_ahead,
+            OutputIterator result)
+        {
+            return Sequential (instrumentation).Lang (first, last, tol, look_ahead, result);
+        }
+
+        /*!
+            \brief Performs Douglas-Peucker approximation (DP), including its RD preprocessing
+            step, on multiple threads.
+
+            \sa PolylineSimplification::DouglasPeucker
+        */
+        OutputIterator DouglasPeucker (
+            InputIterator first,
+            InputIterator last,
+            value_type tol,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount < 3 || tol == 0 || threads < 2) {
+                return Sequential (instrumentation).DouglasPeucker (first, last, tol, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+
+            // radial distance routine as preprocessing, flagging the points that remain
+            util::bit_array filter (pointCount);
+            instrumentation.Allocated (filter.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_PREFILTER);
+                SpeculativeKeys (RadialDistanceRoutine (coords, tol), pointCount, filter);
+            }
+            instrumentation.Reduced (pointCount, KeyCount (filter));
+
+            // douglas-peucker approximation of the flagged points
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                std::mutex mutex;
+                Shared shared (instrumentation, mutex);
+                FilteredPoints points (coords, filter, shared, 0);
+                if (DPHelper::IsCompact (pointCount)) {
+                    Approximate <unsigned> (points, pointCount, tol * tol, keys);
+                }
+                else {
+                    Approximate <ptr_diff_type> (points, pointCount, tol * tol, keys);
+                }
+            }
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return Sequential::CopyKeys (coords, pointCount, keys, result);
+        }
+
+        /*!
+            \brief Performs the Douglas-Peucker approximation variant (DPn), searching large sub
+            polylines on multiple threads.
+
+            \sa PolylineSimplification::DouglasPeuckerN
+        */
+        OutputIterator DouglasPeuckerN (
+            InputIterator first,
+            InputIterator last,
+            unsigned count,
+            OutputIterator result)
+        {
+            diff_type coordCount = std::distance (first, last);
+            diff_type pointCount = DIM      // protect against zero DIM
+                                   ? coordCount / DIM
+                                   : 0;
+            if (coordCount % DIM || pointCount <= static_cast <diff_type> (count) || count < 2 ||
+                threads < 2 || pointCount < 2 * MIN_SEARCH)
+            {
+                return Sequential (instrumentation).DouglasPeuckerN (first, last, count, result);
+            }
+            std::vector <value_type> copy;
+            const value_type* coords = Coords (first, last, copy);
+            util::bit_array keys (pointCount);
+            instrumentation.Allocated (keys.bytes ());
+            {
+                ScopedPhase phase (instrumentation, PHASE_APPROXIMATE);
+                std::mutex mutex;
+                Shared shared (instrumentation, mutex);
+                Points points (coords, shared, 0);
+                if (DPHelper::IsCompact (pointCount)) {
+                    DPHelper::template DoApproximateN <unsigned> (points, coordCount, count, keys, 0, KeySearch (*this));
+                }
+                else {
+                    DPHelper::template DoApproximateN <ptr_diff_type> (points, coordCount, count, keys, 0, KeySearch (*this));
+                }
+            }
+            ScopedPhase phase (instrumentation, PHASE_OUTPUT);
+            return Sequential::CopyKeys (coords, pointCount, keys, result);
+        }
+
+        /*!
+            \brief Computes the squared positional error of each original point on multiple
+            threads.
+
+            \sa PolylineSimplification::ComputePositionalErrors2
+        */
+        OutputIterator ComputePositionalErrors2 (
+            InputIterator original_first,
+            InputIterator original_last,
+            InputIterator simplified_first,
+            InputIterator simplified_last,
+            OutputIterator result,
+            bool* valid=0)
+        {
+            std::vector <value_type> errors;
+            if (!PositionalErrors (original_first, original_last, simplified_first, simplified_last,
+                                   errors, valid))
+            {
+                return Sequential (instrumentation).ComputePositionalErrors2 (original_first, original_last,
+                    simplified_first, simplified_last, result, valid);
+            }
+            return std::copy (errors.begin (), errors.end (), result);
+        }
+
+        /*!
+            \brief Computes statistics for the positional errors, which are computed on multiple
+            threads.
+
+            \sa PolylineSimplification::ComputePositionalErrorStatistics
+        */
+        math::Statistics ComputePositionalErrorStatistics (
+            InputIterator original_first,
+            InputIterator original_last,
+            InputIterator simplified_first,
+            InputIterator simplified_last,
+            bool* valid=0)
+        {
+            std::vector <value_type> errors;
+            if (!PositionalErrors (original_first, original_last, simplified_first, simplified_last,
+                                   errors, valid))
+            {
+                return Sequential (instrumentation).ComputePositionalErrorStatistics (original_first, original_last,
+                    simplified_first, simplified_last, valid);
+            }
+            std::vector <double> distances (errors.begin (), errors.end ());
+            std::transform (distances.begin (), distances.end (), distances.begin (),
+                            static_cast <double (*)(double)> (std::sqrt));
+            return math::compute_statistics (distances.begin (), distances.end ());
+        }
+
+    private:
+        enum {
+            MIN_CHUNK = 4096,   //! default minimum number of points per chunk
+            MIN_SEARCH = 32768, //! minimum number of points for a parallel key search
+            TASKS = 4           //! independent sub polylines per thread before approximating them
+        };
+
+        //! \brief Collects the keys that are found on one thread.
+        struct KeyList {
+            void set (std::size_t index) {
+                indices.push_back (index);
+            }
+
+            std::vector <std::size_t> indices;  //! point index of each key
+        };
+
+        /*!
+            \brief Finds the key of a sub polyline, searching large ones using all threads.
+
+            \sa PolylineSimplification::DPHelper::KeySearch
+        */
+        struct KeySearch {
+            explicit KeySearch (const ParallelSimplification& ps) :
+                ps (ps) {}
+
+            template <typename Index, class PointAccess>
+            typename DPHelper::template KeyInfo <Index> operator () (
+                const PointAccess& points, Index first, Index last) const
+            {
+                typedef typename DPHelper::template KeyInfo <Index> KeyInfo;
+
+                if (static_cast <ptr_diff_type> (last - first) < 2 * MIN_SEARCH) {
+                    return DPHelper::FindKey (points, first, last);
+                }
+                ptr_diff_type partCount = std::min <ptr_diff_type> (ps.threads, (last - first) / MIN_SEARCH);
+                std::vector <KeyInfo> keyInfos (partCount);
+                ps.parallel (partCount, [&] (std::size_t part) {
+                    keyInfos [part] = DPHelper::FindKey (points, first, last,
+                        static_cast <Index> (ChunkBegin (first + 1, last, part, partCount)),
+                        static_cast <Index> (ChunkBegin (first + 1, last, part + 1, partCount)));
+                });
+                // the last part holding the maximum distance
+                KeyInfo keyInfo;
+                for (ptr_diff_type part = 0; part < partCount; ++part) {
+                    if (keyInfos [part].index && !(keyInfos [part].dist2 < keyInfo.dist2)) {
+                        keyInfo = keyInfos [part];
+                    }
+                }
+                return keyInfo;
+            }
+
+            const ParallelSimplification& ps;   //! provides the threads
+        };
+
+        //! \brief Returns the number of chunks for a polyline.
+        ptr_diff_type ChunkCount (ptr_diff_type pointCount) const {
+            return std::max <ptr_diff_type> (1, std::min <ptr_diff_type> (
+                threads, pointCount / static_cast <ptr_diff_type> (chunkSize)));
+        }
+
+        /*!
+            \brief Returns the first point index of a chunk of [first, last).
+
+            Each chunk but the first starts at a word of a util::bit_array, so that the chunks
+            can flag their keys concurrently.
+        */
+        static ptr_diff_type ChunkBegin (ptr_diff_type first, ptr_diff_type last,
+                                         ptr_diff_type chunk, ptr_diff_type chunkCount)
+        {
+            if (chunk == 0 || chunk == chunkCount) {
+                return chunk ? last : first;
+            }
+            ptr_diff_type begin = first + (last - first) * chunk / chunkCount;
+            return std::max <ptr_diff_type> (first, begin - begin % util::bit_array::BITS);
+        }
+
+        //! \brief Returns the coordinates, copying them unless they are stored contiguously.
+        const value_type* Coords (InputIterator first, InputIterator last, std::vector <value_type>& copy) const {
+            const value_type* coords = Sequential::Contiguous (first);
+            if (!coords) {
+                ScopedPhase phase (instrumentation, PHASE_COPY);
+                copy.assign (first, last);
+                instrumentation.Allocated (copy.size () * sizeof (value_type));
+                coords = &copy [0];
+            }
+            return coords;
+        }
+
+        //! \brief Returns the number of flagged points.
+        static ptr_diff_type KeyCount (const util::bit_array& keys) {
+            ptr_diff_type count = keys.size () && keys [0] ? 1 : 0;
+            for (std::size_t p = keys.find_next (0); p < keys.size (); p = keys.find_next (p)) {
+                ++count;
+            }
+            return count;
+        }
+
+        //! \brief Clears the flags of the points in [first, last).
+        static void Reset (util::bit_array& keys, ptr_diff_type first, ptr_diff_type last) {
+            for (; first < last; ++first) {
+                keys.reset (first);
+            }
+        }
+
+        /*!
+            \brief Key selection of the (radial) distance between points routine.
+
+            The state is the current key.
+        */
+        struct RadialDistanceRoutine {
+            typedef ptr_diff_type State;
+
+            RadialDistanceRoutine (const value_type* coords, value_type tol) :
+                coords (coords), tol2 (tol * tol) {}
+
+            //! \brief Returns the state after selecting key p.
+            State Start (ptr_diff_type p) const {
+                return p;
+            }
+
+            //! \brief Tests if point p is the next key, and updates the state if it is.
+            bool Test (State& key, ptr_diff_type p) const {
+                if (math::point_distance2 <DIM> (coords + key * DIM, coords + p * DIM) < tol2) {
+                    return false;
+                }
+                key = p;
+                return true;
+            }
+
+            const value_type* coords;   //! polyline coordinates
+            value_type tol2;            //! squared distance tolerance
+        };
+
+        /*!
+            \brief Key selection of the Reumann-Witkam routine.
+
+            The state is the current key p0, which defines the line L(p0, p0+1). Point p is the
+            next key when point p+1 lies too far from that line.
+        */
+        struct ReumannWitkamRoutine {
+            typedef ptr_diff_type State;
+
+            ReumannWitkamRoutine (const value_type* coords, value_type tol) :
+                coords (coords), tol2 (tol * tol) {}
+
+            //! \brief Returns the state after selecting key p.
+            State Start (ptr_diff_type p) const {
+                return p;
+            }
+
+            //! \brief Tests if point p is the next key, and updates the state if it is.
+            bool Test (State& key, ptr_diff_type p) const {
+                if (math::line_distance2 <DIM> (coords + key * DIM, coords + (key + 1) * DIM,
+                                                coords + (p + 1) * DIM) < tol2)
+                {
+                    return false;
+                }
+                key = p;
+                return true;
+            }
+
+            const value_type* coords;   //! polyline coordinates
+            value_type tol2;            //! squared distance tolerance
+        };
+
+        /*!
+            \brief Key selection of the Opheim routine.
+
+            The state is the current key r0, and the ray R(r0, r1) once it is defined. Point p is
+            the next key when point p+1 lies outside the search area.
+        */
+        struct OpheimRoutine {
+            struct State {
+                State (ptr_diff_type r0=0) :
+                    r0 (r0), r1 (r0), rayDefined (false) {}
+
+                ptr_diff_type r0;   //! point index of the current key and start of the ray
+                ptr_diff_type r1;   //! point index of a point on the ray
+                bool rayDefined;    //! indicates if r1 is valid
+            };
+
+            OpheimRoutine (const value_type* coords, value_type min_tol, value_type max_tol) :
+                coords (coords), min_tol2 (min_tol * min_tol), max_tol2 (max_tol * max_tol) {}
+
+            //! \brief Returns the state after selecting key p.
+            State Start (ptr_diff_type p) const {
+                return State (p);
+            }
+
+            //! \brief Tests if point p is the next key, and updates the state if it is.
+            bool Test (State& state, ptr_diff_type p) const {
+                const value_type* r0 = coords + state.r0 * DIM;
+                const value_type* pj = coords + (p + 1) * DIM;
+                if (!state.rayDefined) {
+                    // discard each point within minimum tolerance
+                    if (math::point_distance2 <DIM> (r0, pj) < min_tol2) {
+                        return false;
+                    }
+                    // the last point within minimum tolerance defines the ray R(r0, r1)
+                    state.r1 = p;
+                    state.rayDefined = true;
+                }
+                if (math::point_distance2 <DIM> (r0, pj) < max_tol2 &&
+                    math::ray_distance2 <DIM> (r0, coords + state.r1 * DIM, pj) < min_tol2)
+                {
+                    return false;
+                }
+                state = State (p);
+                return true;
+            }
+
+            const value_type* coords;   //! polyline coordinates
+            value_type min_tol2;        //! squared minimum distance tolerance
+            value_type max_tol2;        //! squared maximum distance tolerance
+        };
+
+        /*!
+            \brief Flags the keys of a routine that tests each point once, in order.
+
+            The candidate keys [1, pointCount-1) are split into chunks. Each chunk is simplified
+            speculatively, as if the point just before it were a key. The seams are then reconciled
+            by continuing the true simplification into each chunk, until it selects a speculative
+            key. At that point both are in the same state, so the remaining speculative keys of
+            the chunk are correct.
+
+            \tparam Routine     the key selection, see RadialDistanceRoutine
+        */
+        template <class Routine>
+        void SpeculativeKeys (const Routine& routine, ptr_diff_type pointCount, util::bit_array& keys) const {
+            typedef typename Routine::State State;
+
+            ptr_diff_type chunkCount = ChunkCount (pointCount);
+            std::vector <State> lastState (chunkCount);
+
+            // the first and last point are always part of the simplification
+            keys.set (0);
+            keys.set (pointCount - 1);
+            parallel (chunkCount, [&] (std::size_t chunk) {
+                ptr_diff_type begin = ChunkBegin (1, pointCount - 1, chunk, chunkCount);
+                ptr_diff_type end = ChunkBegin (1, pointCount - 1, chunk + 1, chunkCount);
+                State state = routine.Start (begin - 1);
+                for (ptr_diff_type p = begin; p < end; ++p) {
+                    if (routine.Test (state, p)) {
+                        keys.set (p);
+                    }
+                }
+                lastState [chunk] = state;
+            });
+            std::size_t distances = pointCount - 2;
+
+            // reconcile the seams
+            State state = lastState [0];
+            for (ptr_diff_type chunk = 1; chunk < chunkCount; ++chunk) {
+                ptr_diff_type begin = ChunkBegin (1, pointCount - 1, chunk, chunkCount);
+                ptr_diff_type end = ChunkBegin (1, pointCount - 1, chunk + 1, chunkCount);
+                ptr_diff_type p = begin;
+                for (; p < end; ++p) {
+                    ++distances;
+                    if (!routine.Test (state, p)) {
+                        keys.reset (p);
+                        continue;
+                    }
+                    if (keys [p]) {
+                        break;
+                    }
+                    keys.set (p);
+                }
+                if (p < end) {
+                    // synchronized with the speculative keys
+                    state = lastState [chunk];
+                }
+            }
+            instrumentation.Distances (distances);
+        }
+
+        //! \brief Returns the key that follows key p0 in the perpendicular distance routine.
+        static ptr_diff_type NextPerpendicularKey (const value_type* coords, ptr_diff_type pointCount,
+                                                  value_type tol2, ptr_diff_type p0, std::size_t& distances)
+        {
+            if (p0 + 2 >= pointCount) {
+                return pointCount - 1;
+            }
+            // test p1 against line segment S(p0, p2)
+            ++distances;
+            return math::segment_distance2 <DIM> (coords + p0 * DIM, coords + (p0 + 2) * DIM,
+                                                  coords + (p0 + 1) * DIM) < tol2
+                   ? p0 + 2
+                   : p0 + 1;
+        }
+
+        /*!
+            \brief Flags the keys of the perpendicular distance routine.
+
+            Unlike the other routines, PD skips points, so the chunks are reconciled by following
+            the chain of keys instead.
+
+            \sa SpeculativeKeys
+        */
+        void PerpendicularDistanceKeys (const value_type* coords, ptr_diff_type pointCount, value_type tol,
+                                        util::bit_array& keys) const
+        {
+            value_type tol2 = tol * tol;    // squared distance tolerance
+            ptr_diff_type chunkCount = ChunkCount (pointCount);
+            std::vector <ptr_diff_type> lastKey (chunkCount);
+            std::vector <std::size_t> distances (chunkCount, 0);
+
+            // the last point is always part of the simplification
+            keys.set (pointCount - 1);
+            parallel (chunkCount, [&] (std::size_t chunk) {
+                ptr_diff_type key = ChunkBegin (0, pointCount - 1, chunk, chunkCount);
+                ptr_diff_type end = ChunkBegin (0, pointCount - 1, chunk + 1, chunkCount);
+                for (ptr_diff_type p = key; p < end;
+                     p = NextPerpendicularKey (coords, pointCount, tol2, p, distances [chunk]))
+                {
+                    keys.set (p);
+                    key = p;
+                }
+                lastKey [chunk] = key;
+            });
+
+            // reconcile the seams
+            ptr_diff_type key = lastKey [0];
+            for (ptr_diff_type chunk = 1; chunk < chunkCount; ++chunk) {
+                ptr_diff_type begin = ChunkBegin (0, pointCount - 1, chunk, chunkCount);
+                ptr_diff_type end = ChunkBegin (0, pointCount - 1, chunk + 1, chunkCount);
+                ptr_diff_type p = NextPerpendicularKey (coords, pointCount, tol2, key, distances [0]);
+                Reset (keys, begin, std::min (p, end));
+                while (p < end && !keys [p]) {
+                    keys.set (p);
+                    key = p;
+                    p = NextPerpendicularKey (coords, pointCount, tol2, p, distances [0]);
+                    Reset (keys, key + 1, std::min (p, end));
+                }
+                if (p < end) {
+                    // synchronized with the speculative keys
+                    key = lastKey [chunk];
+                }
+            }
+            instrumentation.Distances (std::accumulate (distances.begin (), distances.end (), std::size_t (0)));
+        }
+
+        /*!
+            \brief Performs Douglas-Peucker approximation, see DPHelper::Approximate.
+
+            Sub polylines are split breadth first, searching large ones using all threads, until
+            there are enough of them to approximate each one on a single thread. The keys that
+            are found on the threads are collected per sub polyline, and flagged afterwards.
+        */
+        template <typename Index, class PointAccess>
+        void Approximate (const PointAccess& points, ptr_diff_type pointCount, value_type tol2,
+                          util::bit_array& keys) const
+        {
+            typedef typename DPHelper::template SubPoly <Index> SubPoly;
+            typedef typename DPHelper::template KeyInfo <Index> KeyInfo;
+
+            // the first and last point are always keys
+            keys.set (0);
+            keys.set (pointCount - 1);
+
+            KeySearch search (*this);
+            std::vector <SubPoly> subPolys (1, SubPoly (0, static_cast <Index> (pointCount - 1)));
+            while (!subPolys.empty () && subPolys.size () < threads * static_cast <std::size_t> (TASKS)) {
+                std::vector <SubPoly> children;
+                for (std::size_t s = 0; s < subPolys.size (); ++s) {
+                    points.instrumentation.SubPolyline (subPolys.size () - s + children.size ());
+                    const SubPoly& subPoly = subPolys [s];
+                    KeyInfo keyInfo = search (points, subPoly.first, subPoly.last);
+                    if (keyInfo.index && tol2 < keyInfo.dist2) {
+                        keys.set (keyInfo.index);
+                        children.push_back (SubPoly (subPoly.first, keyInfo.index));
+                        children.push_back (SubPoly (keyInfo.index, subPoly.last));
+                    }
+                }
+                subPolys.swap (children);
+            }
+
+            // each sub polyline only finds keys in between its first and last point
+            std::vector <KeyList> found (subPolys.size ());
+            parallel (subPolys.size (), [&] (std::size_t s) {
+                DPHelper::ApproximateRange (points, subPolys [s].first, subPolys [s].last, tol2, found [s]);
+            });
+            for (std::size_t s = 0; s < found.size (); ++s) {
+                for (std::size_t k = 0; k < found [s].indices.size (); ++k) {
+                    keys.set (found [s].indices [k]);
+                }
+            }
+        }
+
+        /*!
+            \brief Computes the squared positional errors in parallel.
+
+            \return     false when the input is too small, or when its requirements are not met
+        */
+        bool PositionalErrors (
+            InputIterator original_first,
+            InputIterator original_last,
+            InputIterator simplified_first,
+            InputIterator simplified_last,
+            std::vector <value_type>& errors,
+            bool* valid) const
+        {
+            diff_type original_coordCount = std::distance (original_first, original_last);
+            diff_type original_pointCount = DIM     // protect against zero DIM
+                                            ? original_coordCount / DIM
+                                            : 0;
+            diff_type simplified_coordCount = std::distance (simplified_first, simplified_last);
+            diff_type simplified_pointCount = DIM   // protect against zero DIM
+                                              ? simplified_coordCount / DIM
+                                              : 0;
+
+            // leave invalid input and small polylines to the sequential routine
+            if (original_coordCount % DIM || simplified_coordCount % DIM || simplified_pointCount < 2 ||
+                original_pointCount < simplified_pointCount || ChunkCount (original_pointCount) < 2)
+            {
+                return false;
+            }
+            std::vector <value_type> originalCopy;
+            const value_type* original = Coords (original_first, original_last, originalCopy);
+            std::vector <value_type> simplifiedCopy;
+            const value_type* simplified = Coords (simplified_first, simplified_last, simplifiedCopy);
+            if (!math::equal <DIM> (original, simplified)) {
+                return false;
+            }
+
+            // the original point index that matches each simplified point
+            std::vector <ptr_diff_type> matches (simplified_pointCount, 0);
+            ptr_diff_type o = 0;
+            for (ptr_diff_type s = 1; s < simplified_pointCount; ++s) {
+                while (o < original_pointCount && !math::equal <DIM> (original + o * DIM, simplified + s * DIM)) {
+                    ++o;
+                }
+                matches [s] = o;
+            }
+            ptr_diff_type errorCount = o < original_pointCount ? o + 1 : o;
+            errors.assign (errorCount, value_type (0));
+
+            ptr_diff_type chunkCount = ChunkCount (o);
+            parallel (chunkCount, [&] (std::size_t chunk) {
+                ptr_diff_type begin = ChunkBegin (0, o, chunk, chunkCount);
+                ptr_diff_type end = ChunkBegin (0, o, chunk + 1, chunkCount);
+                // the simplified segment that contains the first point of the chunk
+                ptr_diff_type s = std::upper_bound (matches.begin () + 1, matches.end (), begin) - matches.begin ();
+                for (ptr_diff_type p = begin; p < end; ++p) {
+                    while (matches [s] <= p) {
+                        ++s;
+                    }
+                    errors [p] = math::segment_distance2 <DIM> (simplified + (s - 1) * DIM,
+                                                                simplified + s * DIM,
+                                                                original + p * DIM);
+                }
+            });
+
+            if (valid) {
+                *valid = o < original_pointCount;
+            }
+            return true;
+        }
+
+    private:
+        ParallelFor parallel;               //! runs loops on all threads
+        unsigned threads;                   //! number of threads
+        std::size_t chunkSize;              //! minimum number of points per chunk
+        Instrumentation instrumentation;    //! receives the work of all routines
+    };
+
+    /*!
+        \brief Performs the nth point routine (NP) using an execution policy.
+
+        NP is not parallelized; this overload completes the execution policy interface.
+
+        \sa simplify_nth_point, ParallelSimplification::NthPoint
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_nth_point (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned n,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.NthPoint (first, last, n, result);
+    }
+
+    /*!
+        \brief Performs the (radial) distance between points routine (RD) using an execution
+        policy.
+
+        \sa simplify_radial_distance, ParallelSimplification::RadialDistance
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_radial_distance (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.RadialDistance (first, last, tol, result);
+    }
+
+    /*!
+        \brief Performs the perpendicular distance routine (PD) using an execution policy.
+
+        \sa simplify_perpendicular_distance, ParallelSimplification::PerpendicularDistance
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_perpendicular_distance (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.PerpendicularDistance (first, last, tol, result);
+    }
+
+    /*!
+        \brief Repeatedly performs the perpendicular distance routine (PD) using an execution
+        policy.
+
+        \sa simplify_perpendicular_distance, ParallelSimplification::PerpendicularDistance
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_perpendicular_distance (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        unsigned repeat,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.PerpendicularDistance (first, last, tol, repeat, result);
+    }
+
+    /*!
+        \brief Performs Reumann-Witkam polyline simplification (RW) using an execution policy.
+
+        \sa simplify_reumann_witkam, ParallelSimplification::ReumannWitkam
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_reumann_witkam (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.ReumannWitkam (first, last, tol, result);
+    }
+
+    /*!
+        \brief Performs Opheim polyline simplification (OP) using an execution policy.
+
+        \sa simplify_opheim, ParallelSimplification::Opheim
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_opheim (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type min_tol,
+        typename std::iterator_traits <ForwardIterator>::value_type max_tol,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.Opheim (first, last, min_tol, max_tol, result);
+    }
+
+    /*!
+        \brief Performs Lang polyline simplification (LA) using an execution policy.
+
+        Lang is not parallelized; this overload completes the execution policy interface.
+
+        \sa simplify_lang, ParallelSimplification::Lang
+    */
+    template <unsigned DIM, class ExecutionPolicy, class BidirectionalIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_lang (
+        ExecutionPolicy&& policy,
+        BidirectionalIterator first,
+        BidirectionalIterator last,
+        typename std::iterator_traits <BidirectionalIterator>::value_type tol,
+        unsigned look_ahead,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, BidirectionalIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.Lang (first, last, tol, look_ahead, result);
+    }
+
+    /*!
+        \brief Performs Douglas-Peucker polyline simplification (DP) using an execution policy.
+
+        \sa simplify_douglas_peucker, ParallelSimplification::DouglasPeucker
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_douglas_peucker (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        typename std::iterator_traits <ForwardIterator>::value_type tol,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.DouglasPeucker (first, last, tol, result);
+    }
+
+    /*!
+        \brief Performs a variant of Douglas-Peucker polyline simplification (DPn) using an
+        execution policy.
+
+        \sa simplify_douglas_peucker_n, ParallelSimplification::DouglasPeuckerN
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type simplify_douglas_peucker_n (
+        ExecutionPolicy&& policy,
+        ForwardIterator first,
+        ForwardIterator last,
+        unsigned count,
+        OutputIterator result)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.DouglasPeuckerN (first, last, count, result);
+    }
+
+    /*!
+        \brief Computes the squared positional error between a polyline and its simplification
+        using an execution policy.
+
+        \sa compute_positional_errors2, ParallelSimplification::ComputePositionalErrors2
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator, class OutputIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, OutputIterator>::type compute_positional_errors2 (
+        ExecutionPolicy&& policy,
+        ForwardIterator original_first,
+        ForwardIterator original_last,
+        ForwardIterator simplified_first,
+        ForwardIterator simplified_last,
+        OutputIterator result,
+        bool* valid=0)
+    {
+        ParallelSimplification <DIM, ForwardIterator, OutputIterator> ps (execution::thread_count (policy));
+        return ps.ComputePositionalErrors2 (original_first, original_last, simplified_first, simplified_last, result, valid);
+    }
+
+    /*!
+        \brief Computes statistics for the positional errors between a polyline and its
+        simplification using an execution policy.
+
+        \sa compute_positional_error_statistics, ParallelSimplification::ComputePositionalErrorStatistics
+    */
+    template <unsigned DIM, class ExecutionPolicy, class ForwardIterator>
+    typename execution::enable_if_policy <ExecutionPolicy, math::Statistics>::type compute_positional_error_statistics (
+        ExecutionPolicy&& policy,
+        ForwardIterator original_first,
+        ForwardIterator original_last,
+        ForwardIterator simplified_first,
+        ForwardIterator simplified_last,
+        bool* valid=0)
+    {
+        ParallelSimplification <DIM, ForwardIterator, ForwardIterator> ps (execution::thread_count (policy));
+        return ps.ComputePositionalErrorStatistics (original_first, original_last, simplified_first, simplified_last, valid);
+    }
+}
+
+
+#endif // PSIMPL_PARALLEL
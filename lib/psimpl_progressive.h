@@ -0,0 +1,433 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_progressive.h
+    \brief Progressive encoding of polylines, based on the key order of Douglas-Peucker (DPn).
+
+    DPn selects keys in order of decreasing importance: each key is the point furthest away from
+    the simplification formed by the keys before it. The progressive encoder writes the first and
+    last point, followed by all keys in that order. Every prefix of the stream therefore describes
+    a DPn simplification, and each key carries the maximum distance of the original polyline to
+    the simplification that includes it. A client can render a coarse shape as soon as the first
+    bytes arrive, refine it while the rest streams in, and stop downloading once the error is
+    small enough.
+
+    Stream layout, using the varint and zigzag encodings of psimpl_encode.h:
+<pre>
+    header      DIM (byte), precision (zigzag), point count, key count
+    first point DIM quantized coordinates (zigzag)
+    last point  DIM deltas to the first point (zigzag)
+    error       maximum distance of the polyline to the segment (first, last), quantized
+    key *       point index, DIM residuals (zigzag), maximum distance after adding this key
+</pre>
+
+    Coordinates of a key are stored as the residual to the linear interpolation of the two keys
+    that enclose it, which keeps the residuals small.
+*/
+
+#ifndef PSIMPL_PROGRESSIVE
+#define PSIMPL_PROGRESSIVE
+
+
+#include "psimpl.h"
+#include "psimpl_encode.h"
+#include <cmath>
+#include <map>
+#include <vector>
+
+
+namespace psimpl {
+    namespace util
+{
+    /*!
+        \brief Ordered set of quantized polyline points, used by both the progressive encoder and
+        decoder to predict the coordinates of the next key.
+    */
+    template <unsigned DIM>
+    class progressive_points
+    {
+    public:
+        typedef std::map <uint64_t, std::size_t> index_map;
+
+        //! \brief Adds a quantized point.
+        void insert (uint64_t index, const int64_t* point) {
+            slots [index] = coords.size () / DIM;
+            coords.insert (coords.end (), point, point + DIM);
+        }
+
+        bool contains (uint64_t index) const {
+            return slots.find (index) != slots.end ();
+        }
+
+        /*!
+            \brief Predicts a point by interpolating between the points that enclose its index.
+
+            \param[in] index        point index, in between the first and last point
+            \param[out] prediction  the predicted quantized point
+        */
+        void predict (uint64_t index, int64_t* prediction) const {
+            typename index_map::const_iterator next = slots.upper_bound (index);
+            typename index_map::const_iterator prev = next;
+            --prev;
+            const int64_t* a = &coords [prev->second * DIM];
+            const int64_t* b = &coords [next->second * DIM];
+            double fraction = static_cast <double> (index - prev->first) / static_cast <double> (next->first - prev->first);
+            for (unsigned d = 0; d < DIM; ++d) {
+                prediction [d] = a [d] + quantize (static_cast <double> (b [d] - a [d]) * fraction, 1.0);
+            }
+        }
+
+        //! \brief Writes all points in polyline order, dividing each coordinate by factor.
+        template <class OutputIterator>
+        OutputIterator copy (double factor, OutputIterator result) const {
+            for (typename index_map::const_iterator it = slots.begin (); it != slots.end (); ++it) {
+                for (unsigned d = 0; d < DIM; ++d) {
+                    *result = coords [it->second * DIM + d] / factor;
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        std::size_t size () const {
+            return slots.size ();
+        }
+
+        void clear () {
+            slots.clear ();
+            coords.clear ();
+        }
+
+    private:
+        index_map slots;                //! maps point indices to storage slots
+        std::vector <int64_t> coords;   //! quantized coordinates, in insertion order
+    };
+}
+
+    /*!
+        \brief Encodes a polyline progressively, in Douglas-Peucker (DPn) key order.
+
+        Input (Type) requirements:
+        1- DIM is not 0, where DIM represents the dimension of the polyline
+        2- The ForwardIterator type models the concept of a forward iterator
+        3- The ForwardIterator value type is convertible to a double
+        4- The OutputIterator type accepts unsigned char values
+        5- The range [first, last) contains only vertex coordinates in multiples of DIM
+        6- The range [first, last) contains at least 2 vertices
+
+        Nothing is written when these requirements are not met.
+
+        \param[in] first        the first coordinate of the first polyline point
+        \param[in] last         one beyond the last coordinate of the last polyline point
+        \param[in] precision    number of decimals to keep, in [-7, 7]
+        \param[in] result       destination of the encoded bytes
+        \return                 one beyond the last encoded byte
+    */
+    template <unsigned DIM, class ForwardIterator, class OutputIterator>
+    OutputIterator progressive_encode (
+        ForwardIterator first,
+        ForwardIterator last,
+        int precision,
+        OutputIterator result)
+    {
+        std::vector <double> coords;
+        for (; first != last; ++first) {
+            coords.push_back (static_cast <double> (*first));
+        }
+        std::size_t pointCount = DIM ? coords.size () / DIM : 0;
+        if (!DIM || coords.size () % DIM || pointCount < 2 || precision < -7 || precision > 7) {
+            return result;
+        }
+
+        typedef std::pair <std::ptrdiff_t, double> Key;
+        std::vector <Key> keys;
+        order_douglas_peucker_n <DIM> (coords.begin (), coords.end (),
+            static_cast <unsigned> (pointCount), std::back_inserter (keys));
+
+        double factor = std::pow (10.0, precision);
+        *result = static_cast <unsigned char> (DIM);
+        ++result;
+        result = util::encode_varint (util::zigzag_encode (precision), result);
+        result = util::encode_varint (pointCount, result);
+        result = util::encode_varint (keys.size (), result);
+
+        // first and last point
+        util::progressive_points <DIM> points;
+        int64_t q0 [DIM];
+        int64_t q1 [DIM];
+        for (unsigned d = 0; d < DIM; ++d) {
+            q0 [d] = util::quantize (coords [d], factor);
+            q1 [d] = util::quantize (coords [(pointCount - 1) * DIM + d], factor);
+            result = util::encode_varint (util::zigzag_encode (q0 [d]), result);
+        }
+        for (unsigned d = 0; d < DIM; ++d) {
+            result = util::encode_varint (util::zigzag_encode (q1 [d] - q0 [d]), result);
+        }
+        points.insert (0, q0);
+        points.insert (pointCount - 1, q1);
+        result = util::encode_varint (keys.empty () ? 0 : util::quantize (std::sqrt (keys [0].second), factor), result);
+
+        // keys
+        for (std::size_t k = 0; k < keys.size (); ++k) {
+            uint64_t index = static_cast <uint64_t> (keys [k].first);
+            int64_t prediction [DIM];
+            int64_t q [DIM];
+            points.predict (index, prediction);
+            result = util::encode_varint (index, result);
+            for (unsigned d = 0; d < DIM; ++d) {
+                q [d] = util::quantize (coords [index * DIM + d], factor);
+                result = util::encode_varint (util::zigzag_encode (q [d] - prediction [d]), result);
+            }
+            points.insert (index, q);
+            double error = k + 1 < keys.size () ? std::sqrt (keys [k + 1].second) : 0;
+            result = util::encode_varint (util::quantize (error, factor), result);
+        }
+        return result;
+    }
+
+    /*!
+        \brief Incrementally decodes a progressively encoded polyline.
+
+        Bytes can be appended as they arrive. After each append, the decoder provides the best
+        simplification that can be formed from all complete keys received so far, together with
+        the maximum distance of the original polyline to that simplification.
+
+<pre>
+    psimpl::ProgressiveDecoder <2> decoder;
+    while (decoder.error () > tolerance && !decoder.complete () && receive (chunk)) {
+        decoder.append (chunk.begin (), chunk.end ());
+    }
+    decoder.simplification (std::back_inserter (polyline));
+</pre>
+    */
+    template <unsigned DIM>
+    class ProgressiveDecoder
+    {
+    public:
+        ProgressiveDecoder () :
+            position (0), headerComplete (false), isValid (true), factor (1), pointCount (0),
+            keyCount (0), decodedKeys (0), maxError (0)
+        {}
+
+        /*!
+            \brief Appends received bytes, and decodes all keys that are complete.
+
+            \param[in] first    the first received byte
+            \param[in] last     one beyond the last received byte
+            \return             false when the stream is malformed
+        */
+        bool append (const unsigned char* first, const unsigned char* last) {
+            buffer.insert (buffer.end (), first, last);
+            if (isValid && !headerComplete) {
+                DecodeHeader ();
+            }
+            while (isValid && headerComplete && decodedKeys < keyCount && DecodeKey ()) {}
+            // drop decoded bytes
+            buffer.erase (buffer.begin (), buffer.begin () + position);
+            position = 0;
+            return isValid;
+        }
+
+        //! \brief Indicates if no malformed data was encountered.
+        bool valid () const {
+            return isValid;
+        }
+
+        //! \brief Indicates if the first and last point have been received.
+        bool ready () const {
+            return headerComplete;
+        }
+
+        //! \brief Indicates if all keys have been received.
+        bool complete () const {
+            return headerComplete && decodedKeys == keyCount;
+        }
+
+        //! \brief Returns the number of points of the original polyline.
+        std::size_t point_count () const {
+            return static_cast <std::size_t> (pointCount);
+        }
+
+        //! \brief Returns the number of points of the current simplification.
+        std::size_t simplification_point_count () const {
+            return points.size ();
+        }
+
+        /*!
+            \brief Returns the maximum distance of the original polyline to the current
+            simplification, excluding the quantization error.
+        */
+        double error () const {
+            return headerComplete ? maxError : HUGE_VAL;
+        }
+
+        //! \brief Writes the coordinates of the current simplification.
+        template <class OutputIterator>
+        OutputIterator simplification (OutputIterator result) const {
+            return points.copy (factor, result);
+        }
+
+    private:
+        //! \brief Reads a varint at the current position, returns false when more bytes are needed.
+        bool Read (std::size_t& pos, uint64_t& value) const {
+            if (pos >= buffer.size ()) {
+                return false;
+            }
+            const unsigned char* first = &buffer [0] + pos;
+            const unsigned char* last = &buffer [0] + buffer.size ();
+            const unsigned char* next = util::decode_varint (first, last, value);
+            if (!next) {
+                return false;
+            }
+            pos += next - first;
+            return true;
+        }
+
+        void DecodeHeader () {
+            std::size_t pos = position;
+            uint64_t precision, count, keys, value;
+            int64_t q0 [DIM];
+            int64_t q1 [DIM];
+            if (pos >= buffer.size ()) {
+                return;
+            }
+            if (buffer [pos++] != DIM) {
+                isValid = false;
+                return;
+            }
+            if (!Read (pos, precision) || !Read (pos, count) || !Read (pos, keys)) {
+                return;
+            }
+            for (unsigned d = 0; d < DIM; ++d) {
+                if (!Read (pos, value)) {
+                    return;
+                }
+                q0 [d] = util::zigzag_decode (value);
+            }
+            for (unsigned d = 0; d < DIM; ++d) {
+                if (!Read (pos, value)) {
+                    return;
+                }
+                q1 [d] = q0 [d] + util::zigzag_decode (value);
+            }
+            if (!Read (pos, value)) {
+                return;
+            }
+            if (count < 2 || keys > count - 2) {
+                isValid = false;
+                return;
+            }
+            factor = std::pow (10.0, static_cast <int> (util::zigzag_decode (precision)));
+            pointCount = count;
+            keyCount = keys;
+            maxError = value / factor;
+            points.insert (0, q0);
+            points.insert (count - 1, q1);
+            position = pos;
+            headerComplete = true;
+        }
+
+        bool DecodeKey () {
+            std::size_t pos = position;
+            uint64_t index, value;
+            int64_t q [DIM];
+            if (!Read (pos, index)) {
+                return false;
+            }
+            if (index == 0 || index >= pointCount - 1 || points.contains (index)) {
+                isValid = false;
+                return false;
+            }
+            points.predict (index, q);
+            for (unsigned d = 0; d < DIM; ++d) {
+                if (!Read (pos, value)) {
+                    return false;
+                }
+                q [d] += util::zigzag_decode (value);
+            }
+            if (!Read (pos, value)) {
+                return false;
+            }
+            points.insert (index, q);
+            maxError = value / factor;
+            position = pos;
+            ++decodedKeys;
+            return true;
+        }
+
+        ProgressiveDecoder (const ProgressiveDecoder&);
+        ProgressiveDecoder& operator= (const ProgressiveDecoder&);
+
+    private:
+        std::vector <unsigned char> buffer;         //! received bytes that have not been decoded
+        std::size_t position;                       //! first byte that has not been decoded
+        bool headerComplete;                        //! indicates if the header was decoded
+        bool isValid;                               //! indicates if the stream is well formed
+        double factor;                              //! 10^precision
+        uint64_t pointCount;                        //! number of points of the original polyline
+        uint64_t keyCount;                          //! number of keys in the stream
+        uint64_t decodedKeys;                       //! number of decoded keys
+        double maxError;                            //! error of the current simplification
+        util::progressive_points <DIM> points;      //! points of the current simplification
+    };
+
+    /*!
+        \brief Decodes the simplification described by a (prefix of a) progressively encoded
+        polyline.
+
+        \param[in] first    the first encoded byte
+        \param[in] last     one beyond the last received byte
+        \param[in] result   destination of the simplified polyline
+        \param[out] error   [optional] maximum distance of the original polyline to the result
+        \return             one beyond the last coordinate of the simplified polyline
+    */
+    template <unsigned DIM, class OutputIterator>
+    OutputIterator progressive_decode (
+        const unsigned char* first,
+        const unsigned char* last,
+        OutputIterator result,
+        double* error=0)
+    {
+        ProgressiveDecoder <DIM> decoder;
+        decoder.append (first, last);
+        if (error) {
+            *error = decoder.error ();
+        }
+        return decoder.simplification (result);
+    }
+}
+
+
+#endif // PSIMPL_PROGRESSIVE
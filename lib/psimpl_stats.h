@@ -0,0 +1,157 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_stats.h
+    \brief Instrumentation policy that collects simplification statistics.
+
+    PolylineSimplification reports its work to the instrumentation policy that is passed as its
+    fourth template parameter. The default policy, NoInstrumentation, compiles out completely.
+    StatsInstrumentation accumulates the work in a SimplificationStats structure instead:
+
+    <pre>
+    psimpl::SimplificationStats stats;
+    psimpl::StatsInstrumentation instrumentation (stats);
+    psimpl::PolylineSimplification <2, const double*, double*, psimpl::StatsInstrumentation>
+        ps (instrumentation);
+    ps.DouglasPeucker (first, last, tol, result);
+    </pre>
+
+    Any class that provides the member functions of NoInstrumentation can be used as a policy,
+    for instance to forward each event to a callback or a profiler.
+*/
+
+#ifndef PSIMPL_STATS
+#define PSIMPL_STATS
+
+
+#include "psimpl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+
+namespace psimpl {
+    /*!
+        \brief Work performed by one or more simplifications.
+    */
+    struct SimplificationStats
+    {
+        SimplificationStats () { Reset (); }
+
+        //! \brief Clears all statistics.
+        void Reset () {
+            distances = subPolylines = maxDepth = 0;
+            inputPoints = reducedPoints = 0;
+            allocations = allocatedBytes = 0;
+            std::fill (seconds, seconds + PHASE_COUNT, 0.0);
+        }
+
+        //! \brief Returns the fraction of points that remained after radial distance preprocessing.
+        double ReductionRatio () const {
+            return inputPoints ? static_cast <double> (reducedPoints) / inputPoints : 1.0;
+        }
+
+        //! \brief Returns the time spent in all phases, in seconds.
+        double TotalSeconds () const {
+            double total = 0;
+            for (unsigned p = 0; p < PHASE_COUNT; ++p) {
+                total += seconds [p];
+            }
+            return total;
+        }
+
+        std::size_t distances;          //!< number of points tested against a distance tolerance
+        std::size_t subPolylines;       //!< number of sub polylines processed by Douglas-Peucker
+        std::size_t maxDepth;           //!< maximum number of queued sub polylines
+        std::size_t inputPoints;        //!< number of points before radial distance preprocessing
+        std::size_t reducedPoints;      //!< number of points after radial distance preprocessing
+        std::size_t allocations;        //!< number of temporary buffers
+        std::size_t allocatedBytes;     //!< total size of all temporary buffers
+        double seconds [PHASE_COUNT];   //!< time spent in each phase, in seconds
+    };
+
+    /*!
+        \brief Instrumentation policy that accumulates the work in a SimplificationStats structure.
+
+        Copies of a policy report to the same structure, which allows a PolylineSimplification
+        to share it with the routines it uses internally. The structure is not synchronized;
+        use one per thread.
+
+        \sa NoInstrumentation
+    */
+    class StatsInstrumentation
+    {
+        typedef std::chrono::steady_clock clock;
+
+    public:
+        explicit StatsInstrumentation (SimplificationStats& stats) :
+            stats (&stats)
+        {}
+
+        void Distances (std::size_t count) const {
+            stats->distances += count;
+        }
+
+        void SubPolyline (std::size_t pending) const {
+            ++stats->subPolylines;
+            stats->maxDepth = std::max (stats->maxDepth, pending);
+        }
+
+        void Reduced (std::size_t pointCount, std::size_t remaining) const {
+            stats->inputPoints += pointCount;
+            stats->reducedPoints += remaining;
+        }
+
+        void Allocated (std::size_t bytes) const {
+            ++stats->allocations;
+            stats->allocatedBytes += bytes;
+        }
+
+        void Begin (Phase phase) const {
+            start [phase] = clock::now ();
+        }
+
+        void End (Phase phase) const {
+            stats->seconds [phase] += std::chrono::duration <double> (clock::now () - start [phase]).count ();
+        }
+
+    private:
+        SimplificationStats* stats;                     //! receives the work
+        mutable clock::time_point start [PHASE_COUNT];  //! start time of each active phase
+    };
+}
+
+
+#endif // PSIMPL_STATS
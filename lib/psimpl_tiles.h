@@ -0,0 +1,517 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_tiles.h
+    \brief Builds a tile pyramid of simplified and clipped polylines.
+
+    Slippy map tiles need every feature simplified at every zoom level, using a tolerance that
+    halves per level, and clipped to the tiles it crosses. TilePyramid computes the
+    Douglas-Peucker importance of each feature only once, derives the simplification for each
+    zoom level by filtering on that importance, and clips the result to (buffered) tile bounds.
+
+    Features are read in batches of bounded size. Within a batch, importance is computed in
+    parallel over features, and tiling in parallel over features and zoom levels. The clipped
+    parts are handed to a sink in a deterministic order: by feature, zoom level and tile.
+
+    Only 2D polylines with floating point coordinates are supported. This file requires C++11.
+*/
+
+#ifndef PSIMPL_TILES
+#define PSIMPL_TILES
+
+
+#include "psimpl.h"
+#include "psimpl_async.h"
+#include "psimpl_binary.h"
+#include "psimpl_wkb.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace psimpl {
+    //! \brief Identifies a tile; tile (0, 0) is the top left tile of each zoom level.
+    struct TileKey
+    {
+        TileKey (unsigned zoom=0, unsigned x=0, unsigned y=0) :
+            zoom (zoom), x (x), y (y) {}
+
+        bool operator< (const TileKey& other) const {
+            return zoom != other.zoom ? zoom < other.zoom : x != other.x ? x < other.x : y < other.y;
+        }
+
+        bool operator== (const TileKey& other) const {
+            return zoom == other.zoom && x == other.x && y == other.y;
+        }
+
+        unsigned zoom;  //!< zoom level
+        unsigned x;     //!< column, from left to right
+        unsigned y;     //!< row, from top to bottom
+    };
+
+    //! \brief Defines the extent, zoom levels and tolerances of a tile pyramid.
+    struct TileGrid
+    {
+        TileGrid () :
+            minX (0), minY (0), maxX (1), maxY (1), minZoom (0), maxZoom (14),
+            tolerance (1.0 / 4096), buffer (1.0 / 64)
+        {}
+
+        //! \brief Returns the simplification tolerance of a zoom level.
+        double Tolerance (unsigned zoom) const {
+            return std::ldexp (tolerance, -static_cast <int> (zoom));
+        }
+
+        //! \brief Returns the width of the tiles of a zoom level.
+        double TileWidth (unsigned zoom) const {
+            return std::ldexp (maxX - minX, -static_cast <int> (zoom));
+        }
+
+        //! \brief Returns the height of the tiles of a zoom level.
+        double TileHeight (unsigned zoom) const {
+            return std::ldexp (maxY - minY, -static_cast <int> (zoom));
+        }
+
+        double minX;        //!< left edge of the pyramid
+        double minY;        //!< bottom edge of the pyramid
+        double maxX;        //!< right edge of the pyramid
+        double maxY;        //!< top edge of the pyramid
+        unsigned minZoom;   //!< first zoom level
+        unsigned maxZoom;   //!< last zoom level, at most 30
+        double tolerance;   //!< simplification tolerance at zoom level 0, halves per level
+        double buffer;      //!< margin around each tile, as a fraction of the tile size
+    };
+
+    /*!
+        \brief Builds a tile pyramid of simplified and clipped 2D polylines.
+
+        The source is a function object that is called as bool (std::vector <T>& coords); it
+        fills coords with the next feature and returns false at the end of the input.
+
+        The sink is a function object that is called as
+        void (const TileKey& tile, std::size_t feature, const T* first, const T* last), once for
+        each part of a feature that intersects a tile. Both are only called from the thread that
+        calls Build.
+
+        \tparam T   floating point coordinate type
+    */
+    template <class T>
+    class TilePyramid
+    {
+    public:
+        /*!
+            \param[in] grid         the pyramid definition
+            \param[in] threads      number of worker threads, 0 for hardware concurrency
+            \param[in] batchSize    maximum number of features in memory
+            \param[in] executor     [optional] runs the worker threads, instead of starting them
+                                    for each batch; must outlive this object
+        */
+        explicit TilePyramid (const TileGrid& grid, unsigned threads=0, std::size_t batchSize=256,
+                              Executor* executor=0) :
+            grid (grid), parallel (threads, executor),
+            batchSize (std::max <std::size_t> (batchSize, 1))
+        {}
+
+        /*!
+            \brief Reads all features from source, and writes their tiled parts to sink.
+
+            \return     the number of features read
+        */
+        template <class Source, class Sink>
+        std::size_t Build (Source& source, Sink& sink) const {
+            const unsigned zoomCount = grid.maxZoom >= grid.minZoom ? grid.maxZoom - grid.minZoom + 1 : 0;
+            std::vector <Feature> batch (batchSize);
+            std::size_t featureCount = 0;
+            bool more = true;
+            while (more) {
+                std::size_t count = 0;
+                for (; count < batchSize; ++count) {
+                    Feature& feature = batch [count];
+                    feature.coords.clear ();
+                    if (!source (feature.coords)) {
+                        more = false;
+                        break;
+                    }
+                }
+                // importance per feature
+                parallel (count, [&] (std::size_t f) {
+                    Feature& feature = batch [f];
+                    feature.importance.clear ();
+                    compute_douglas_peucker_importance2 <2> (feature.coords.begin (), feature.coords.end (),
+                        std::back_inserter (feature.importance));
+                    feature.zooms.assign (zoomCount, std::vector <Part> ());
+                });
+                // tiles per feature and zoom level
+                parallel (count * zoomCount, [&] (std::size_t job) {
+                    Feature& feature = batch [job / zoomCount];
+                    unsigned z = static_cast <unsigned> (job % zoomCount);
+                    Tile (feature, grid.minZoom + z, feature.zooms [z]);
+                });
+                // write in feature order
+                for (std::size_t f = 0; f < count; ++f) {
+                    for (unsigned z = 0; z < zoomCount; ++z) {
+                        const std::vector <Part>& parts = batch [f].zooms [z];
+                        for (std::size_t p = 0; p < parts.size (); ++p) {
+                            const std::vector <T>& coords = parts [p].coords;
+                            sink (parts [p].key, featureCount + f, &coords [0], &coords [0] + coords.size ());
+                        }
+                    }
+                }
+                featureCount += count;
+            }
+            return featureCount;
+        }
+
+    private:
+        //! \brief A feature clipped to a tile.
+        struct Part {
+            TileKey key;                //! the tile
+            std::vector <T> coords;     //! the clipped coordinates
+        };
+
+        //! \brief A feature on its way through the pyramid.
+        struct Feature {
+            std::vector <T> coords;                     //! the original coordinates
+            std::vector <T> importance;                 //! squared importance of each point
+            std::vector <std::vector <Part> > zooms;    //! parts per zoom level
+        };
+
+        //! \brief Returns the clamped tile index of an offset along an axis.
+        static unsigned TileIndex (double offset, double size, unsigned tileCount) {
+            double index = std::floor (offset / size);
+            return index < 0 ? 0 : index >= tileCount ? tileCount - 1 : static_cast <unsigned> (index);
+        }
+
+        //! \brief Simplifies a feature for a zoom level, and clips it to each tile it crosses.
+        void Tile (const Feature& feature, unsigned zoom, std::vector <Part>& parts) const {
+            if (feature.importance.size () < 2) {
+                return;
+            }
+            // simplify
+            const T tol = static_cast <T> (grid.Tolerance (zoom));
+            std::vector <T> points;
+            for (std::size_t i = 0; i < feature.importance.size (); ++i) {
+                if (tol * tol < feature.importance [i]) {
+                    points.push_back (feature.coords [2 * i]);
+                    points.push_back (feature.coords [2 * i + 1]);
+                }
+            }
+
+            // find the segments per tile
+            const unsigned tileCount = 1u << zoom;
+            const double width = grid.TileWidth (zoom);
+            const double height = grid.TileHeight (zoom);
+            const double bx = grid.buffer * width;
+            const double by = grid.buffer * height;
+            std::map <TileKey, std::vector <std::size_t> > segments;
+            const std::size_t segmentCount = points.size () / 2 - 1;
+            for (std::size_t s = 0; s < segmentCount; ++s) {
+                const T* p = &points [2 * s];
+                unsigned y0 = TileIndex (grid.maxY - std::max (p [1], p [3]) - by, height, tileCount);
+                unsigned y1 = TileIndex (grid.maxY - std::min (p [1], p [3]) + by, height, tileCount);
+                // per row, only the columns spanned by the part of the segment inside that row
+                for (unsigned y = y0; y <= y1; ++y) {
+                    double t0 = 0;
+                    double t1 = 1;
+                    if (y0 != y1) {
+                        const double row [4] = {
+                            std::min (p [0], p [2]),
+                            grid.maxY - (y + 1) * height - by,
+                            std::max (p [0], p [2]),
+                            grid.maxY - y * height + by
+                        };
+                        if (!ClipSegment (p, p + 2, row, t0, t1)) {
+                            continue;
+                        }
+                    }
+                    double xa = t0 == 0 ? p [0] : p [0] + t0 * (p [2] - p [0]);
+                    double xb = t1 == 1 ? p [2] : p [0] + t1 * (p [2] - p [0]);
+                    unsigned x0 = TileIndex (std::min (xa, xb) - bx - grid.minX, width, tileCount);
+                    unsigned x1 = TileIndex (std::max (xa, xb) + bx - grid.minX, width, tileCount);
+                    for (unsigned x = x0; x <= x1; ++x) {
+                        segments [TileKey (zoom, x, y)].push_back (s);
+                    }
+                }
+            }
+
+            // clip the segments of each tile, joining consecutive segments
+            for (typename std::map <TileKey, std::vector <std::size_t> >::const_iterator it = segments.begin ();
+                 it != segments.end (); ++it)
+            {
+                const TileKey& key = it->first;
+                const double bounds [4] = {
+                    grid.minX + key.x * width - bx,
+                    grid.maxY - (key.y + 1) * height - by,
+                    grid.minX + (key.x + 1) * width + bx,
+                    grid.maxY - key.y * height + by
+                };
+                bool open = false;
+                std::size_t previous = 0;
+                for (std::size_t i = 0; i < it->second.size (); ++i) {
+                    std::size_t s = it->second [i];
+                    const T* p = &points [2 * s];
+                    double t0 = 0;
+                    double t1 = 1;
+                    if (!ClipSegment (p, p + 2, bounds, t0, t1)) {
+                        open = false;
+                        continue;
+                    }
+                    if (!(open && previous + 1 == s && t0 == 0)) {
+                        if (t0 == t1) {
+                            open = false;
+                            continue;       // touches the tile in a single point
+                        }
+                        parts.push_back (Part ());
+                        parts.back ().key = key;
+                        Interpolate (p, p + 2, t0, parts.back ().coords);
+                    }
+                    Interpolate (p, p + 2, t1, parts.back ().coords);
+                    open = t1 == 1;
+                    previous = s;
+                }
+            }
+        }
+
+        //! \brief Appends the point at parameter t of segment (p, q).
+        static void Interpolate (const T* p, const T* q, double t, std::vector <T>& coords) {
+            for (unsigned d = 0; d < 2; ++d) {
+                coords.push_back (t == 0 ? p [d] : t == 1 ? q [d] : static_cast <T> (p [d] + t * (q [d] - p [d])));
+            }
+        }
+
+        /*!
+            \brief Clips segment (p, q) to a rectangle (Liang-Barsky).
+
+            \param[in] p            the first point of the segment
+            \param[in] q            the last point of the segment
+            \param[in] bounds       the rectangle: min x, min y, max x, max y
+            \param[in,out] t0       parameter of the first visible point
+            \param[in,out] t1       parameter of the last visible point
+            \return                 false when the segment lies outside the rectangle
+        */
+        static bool ClipSegment (const T* p, const T* q, const double* bounds, double& t0, double& t1) {
+            for (unsigned d = 0; d < 2; ++d) {
+                double delta = q [d] - p [d];
+                double edges [2][2] = {
+                    { -delta, p [d] - bounds [d] },
+                    { delta, bounds [d + 2] - p [d] }
+                };
+                for (unsigned e = 0; e < 2; ++e) {
+                    double direction = edges [e][0];
+                    double distance = edges [e][1];
+                    if (direction == 0) {
+                        if (distance < 0) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    double t = distance / direction;
+                    if (direction < 0) {
+                        if (t > t1) {
+                            return false;
+                        }
+                        t0 = std::max (t0, t);
+                    }
+                    else {
+                        if (t < t0) {
+                            return false;
+                        }
+                        t1 = std::min (t1, t);
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        TileGrid grid;              //! the pyramid definition
+        ParallelFor parallel;       //! runs loops on all worker threads
+        std::size_t batchSize;      //! maximum number of features in memory
+    };
+
+    /*!
+        \brief Tile pyramid sink that writes one file of hex encoded WKB LineStrings per tile.
+
+        Files are named prefix + "zoom-x-y.wkb". Output is buffered per tile, and flushed to the
+        files whenever the buffered size exceeds a limit, which bounds the size of the buffered
+        output regardless of the number of tiles. The writer does remember the key of each tile
+        that it wrote, in order to truncate each file on first use only, so that part of its
+        memory use grows with the number of tiles.
+    */
+    template <class T>
+    class WkbTileWriter
+    {
+    public:
+        /*!
+            \param[in] prefix       path prefix of the tile files
+            \param[in] limit        maximum number of buffered bytes
+        */
+        explicit WkbTileWriter (const std::string& prefix, std::size_t limit = 16 << 20) :
+            prefix (prefix), limit (limit), buffered (0), ok (true)
+        {}
+
+        ~WkbTileWriter () {
+            Flush ();
+        }
+
+        void operator () (const TileKey& key, std::size_t /*feature*/, const T* first, const T* last) {
+            static const char digits [] = "0123456789ABCDEF";
+            bytes.clear ();
+            wkb::writer writer (bytes, 2);
+            std::copy (first, last, writer.begin_linestring ());
+            writer.end_linestring ();
+
+            std::string& text = tiles [key];
+            for (std::size_t b = 0; b < bytes.size (); ++b) {
+                text += digits [bytes [b] >> 4];
+                text += digits [bytes [b] & 0x0F];
+            }
+            text += '\n';
+            buffered += 2 * bytes.size () + 1;
+            if (buffered > limit) {
+                Flush ();
+            }
+        }
+
+        /*!
+            \brief Writes all buffered output to the tile files.
+
+            \return     false if any file could not be written
+        */
+        bool Flush () {
+            for (typename std::map <TileKey, std::string>::iterator it = tiles.begin (); it != tiles.end (); ++it) {
+                char name [64];
+                std::sprintf (name, "%u-%u-%u.wkb", it->first.zoom, it->first.x, it->first.y);
+                // truncate files on first use, append afterwards
+                bool existing = !written.insert (it->first).second;
+                std::FILE* file = std::fopen ((prefix + name).c_str (), existing ? "ab" : "wb");
+                ok = file && std::fwrite (it->second.data (), 1, it->second.size (), file) == it->second.size () && ok;
+                ok = file && std::fclose (file) == 0 && ok;
+            }
+            tiles.clear ();
+            buffered = 0;
+            return ok;
+        }
+
+    private:
+        WkbTileWriter (const WkbTileWriter&);
+        WkbTileWriter& operator= (const WkbTileWriter&);
+
+    private:
+        std::string prefix;                         //! path prefix of the tile files
+        std::size_t limit;                          //! maximum number of buffered bytes
+        std::size_t buffered;                       //! number of buffered bytes
+        bool ok;                                    //! indicates if all writes succeeded
+        std::map <TileKey, std::string> tiles;      //! buffered output per tile
+        std::set <TileKey> written;                 //! tiles that have a file
+        std::vector <unsigned char> bytes;          //! WKB of the current part
+    };
+
+    /*!
+        \brief Tile pyramid sink that writes one binary polyline file per zoom level.
+
+        Each clipped part becomes a feature of the file prefix + "zoom.bin". The tile and the
+        input feature of each part are listed, in the same order, in the text file
+        prefix + "zoom.tiles", one "x y feature" line per part.
+    */
+    template <class T>
+    class BinaryTileWriter
+    {
+    public:
+        explicit BinaryTileWriter (const std::string& prefix) :
+            prefix (prefix), ok (true)
+        {}
+
+        ~BinaryTileWriter () {
+            Close ();
+        }
+
+        void operator () (const TileKey& key, std::size_t feature, const T* first, const T* last) {
+            Level& level = levels [key.zoom];
+            if (!level.writer) {
+                char name [32];
+                std::sprintf (name, "%u", key.zoom);
+                level.writer.reset (new BinaryPolylineWriter <T>);
+                ok = level.writer->open ((prefix + name + ".bin").c_str (), 2) && ok;
+                level.index = std::fopen ((prefix + name + ".tiles").c_str (), "w");
+                ok = level.index && ok;
+            }
+            std::copy (first, last, level.writer->feature ());
+            if (level.index) {
+                std::fprintf (level.index, "%u %u %lu\n", key.x, key.y, static_cast <unsigned long> (feature));
+            }
+        }
+
+        /*!
+            \brief Completes all files.
+
+            \return     false if any file could not be written
+        */
+        bool Close () {
+            for (typename std::map <unsigned, Level>::iterator it = levels.begin (); it != levels.end (); ++it) {
+                ok = it->second.writer->close () && ok;
+                ok = (!it->second.index || std::fclose (it->second.index) == 0) && ok;
+            }
+            levels.clear ();
+            return ok;
+        }
+
+    private:
+        //! \brief Output files of a zoom level.
+        struct Level {
+            Level () :
+                index (0) {}
+
+            std::shared_ptr <BinaryPolylineWriter <T> > writer;     //! the clipped parts
+            std::FILE* index;                                       //! tile and feature per part
+        };
+
+        BinaryTileWriter (const BinaryTileWriter&);
+        BinaryTileWriter& operator= (const BinaryTileWriter&);
+
+    private:
+        std::string prefix;                     //! path prefix of the files
+        bool ok;                                //! indicates if all writes succeeded
+        std::map <unsigned, Level> levels;      //! output files per zoom level
+    };
+}
+
+
+#endif // PSIMPL_TILES
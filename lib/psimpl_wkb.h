@@ -0,0 +1,993 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*!
+    \file psimpl_wkb.h
+    \brief Zero-copy readers and writers for WKB and TWKB LineStrings and MultiLineStrings.
+
+    The readers never copy coordinates. A WKB LineString is exposed as a range of random access
+    iterators that read each coordinate straight from the WKB buffer, swapping bytes only when the
+    WKB byte order differs from the host byte order. A TWKB LineString is exposed as a range of
+    forward iterators that decode the coordinates on the fly. Both can be passed directly to any
+    PolylineSimplification routine.
+
+    The writers append to a byte buffer through output iterators, so a simplified polyline is
+    encoded while it is being produced. WKB element counts are patched in once they are known,
+    TWKB coordinates are held in a separate buffer until their count has been written.
+
+    Supported geometry types are LineString and MultiLineString, in 2D (XY), 3D (XYZ or XYM) and
+    4D (XYZM). WKB may use ISO or extended (PostGIS EWKB) type codes, including an SRID.
+*/
+
+#ifndef PSIMPL_WKB
+#define PSIMPL_WKB
+
+
+#include "psimpl_encode.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <vector>
+#include <stdint.h>
+
+
+namespace psimpl {
+    namespace util
+{
+    //! \brief Determines if the host stores integers least significant byte first.
+    inline bool host_is_little_endian () {
+        const uint16_t one = 1;
+        return *reinterpret_cast <const unsigned char*> (&one) == 1;
+    }
+}
+
+    /*!
+        \brief Contains the Well-Known Binary (WKB) reader and writer.
+    */
+    namespace wkb
+{
+    //! \brief WKB byte order flags.
+    enum byte_order {
+        XDR = 0,    //!< big endian
+        NDR = 1     //!< little endian
+    };
+
+    //! \brief WKB geometry types.
+    enum geometry_type {
+        LINESTRING = 2,
+        MULTILINESTRING = 5
+    };
+
+    /*!
+        \brief Random access iterator over the unaligned double coordinates of a WKB buffer.
+
+        \tparam SWAP    indicates if the byte order of each coordinate needs to be reversed
+    */
+    template <bool SWAP>
+    class coordinate_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef double value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const double* pointer;
+        typedef double reference;
+
+        coordinate_iterator (const unsigned char* p = 0) :
+            p (p) {}
+
+        double operator* () const {
+            return Read (p);
+        }
+
+        double operator[] (difference_type n) const {
+            return Read (p + n * 8);
+        }
+
+        coordinate_iterator& operator++ () { p += 8; return *this; }
+        coordinate_iterator& operator-- () { p -= 8; return *this; }
+        coordinate_iterator operator++ (int) { coordinate_iterator it (*this); p += 8; return it; }
+        coordinate_iterator operator-- (int) { coordinate_iterator it (*this); p -= 8; return it; }
+        coordinate_iterator& operator+= (difference_type n) { p += n * 8; return *this; }
+        coordinate_iterator& operator-= (difference_type n) { p -= n * 8; return *this; }
+        coordinate_iterator operator+ (difference_type n) const { return coordinate_iterator (p + n * 8); }
+        coordinate_iterator operator- (difference_type n) const { return coordinate_iterator (p - n * 8); }
+        difference_type operator- (const coordinate_iterator& it) const { return (p - it.p) / 8; }
+
+        bool operator== (const coordinate_iterator& it) const { return p == it.p; }
+        bool operator!= (const coordinate_iterator& it) const { return p != it.p; }
+        bool operator< (const coordinate_iterator& it) const { return p < it.p; }
+        bool operator> (const coordinate_iterator& it) const { return p > it.p; }
+        bool operator<= (const coordinate_iterator& it) const { return p <= it.p; }
+        bool operator>= (const coordinate_iterator& it) const { return p >= it.p; }
+
+    private:
+        static double Read (const unsigned char* bytes) {
+            double value;
+            if (SWAP) {
+                unsigned char swapped [8];
+                for (unsigned b = 0; b < 8; ++b) {
+                    swapped [b] = bytes [7 - b];
+                }
+                std::memcpy (&value, swapped, 8);
+            }
+            else {
+                std::memcpy (&value, bytes, 8);
+            }
+            return value;
+        }
+
+    private:
+        const unsigned char* p;     //! first byte of the current coordinate
+    };
+
+    /*!
+        \brief A LineString inside a WKB buffer.
+    */
+    class linestring
+    {
+    public:
+        typedef coordinate_iterator <false> native_iterator;
+        typedef coordinate_iterator <true> swapped_iterator;
+
+        linestring (const unsigned char* coords = 0, std::size_t pointCount = 0, unsigned dim = 2, bool swap = false,
+                    bool measured = false) :
+            coords (coords), pointCount (pointCount), dim (dim), swap (swap), measured (measured) {}
+
+        //! \brief Returns the number of coordinates per point.
+        unsigned dimension () const {
+            return dim;
+        }
+
+        //! \brief Indicates if the points have a z coordinate.
+        bool has_z () const {
+            return dim == 4 || (dim == 3 && !measured);
+        }
+
+        //! \brief Indicates if the points have an m coordinate.
+        bool has_m () const {
+            return measured;
+        }
+
+        std::size_t point_count () const {
+            return pointCount;
+        }
+
+        //! \brief Indicates if the WKB byte order equals the host byte order.
+        bool native () const {
+            return !swap;
+        }
+
+        native_iterator native_begin () const {
+            return native_iterator (coords);
+        }
+
+        native_iterator native_end () const {
+            return native_iterator (coords + pointCount * dim * 8);
+        }
+
+        swapped_iterator swapped_begin () const {
+            return swapped_iterator (coords);
+        }
+
+        swapped_iterator swapped_end () const {
+            return swapped_iterator (coords + pointCount * dim * 8);
+        }
+
+        /*!
+            \brief Returns the coordinates as a plain array, when the WKB byte order equals the
+            host byte order, and the coordinates happen to be aligned.
+
+            \return     the first coordinate, or 0 when the coordinates cannot be accessed directly
+        */
+        const double* data () const {
+            if (swap || reinterpret_cast <std::size_t> (coords) % sizeof (double)) {
+                return 0;
+            }
+            return reinterpret_cast <const double*> (coords);
+        }
+
+    private:
+        const unsigned char* coords;    //! first byte of the first coordinate
+        std::size_t pointCount;         //! number of points
+        unsigned dim;                   //! number of coordinates per point
+        bool swap;                      //! indicates if coordinates need to be byte swapped
+        bool measured;                  //! indicates if the points have an m coordinate
+    };
+
+    /*!
+        \brief Calls function (first, last) with the fastest iterator type for a LineString.
+
+        A plain pointer range is used when possible, native_iterator when only the alignment is
+        off, and swapped_iterator otherwise. The function therefore needs to accept all three
+        iterator types, for instance by being a function object with a templated call operator.
+
+        \param[in] line         the LineString
+        \param[in] function     the function to call
+    */
+    template <class Function>
+    void visit (const linestring& line, Function& function) {
+        if (const double* coords = line.data ()) {
+            function (coords, coords + line.point_count () * line.dimension ());
+        }
+        else if (line.native ()) {
+            function (line.native_begin (), line.native_end ());
+        }
+        else {
+            function (line.swapped_begin (), line.swapped_end ());
+        }
+    }
+
+    //! \brief Reads a 32 bit unsigned integer in the specified byte order.
+    inline uint32_t read_uint32 (const unsigned char* bytes, bool swap) {
+        unsigned char ordered [4];
+        for (unsigned b = 0; b < 4; ++b) {
+            ordered [b] = bytes [swap ? 3 - b : b];
+        }
+        uint32_t value;
+        std::memcpy (&value, ordered, 4);
+        return value;
+    }
+
+    /*!
+        \brief Parses the header of a WKB geometry.
+
+        \param[in] first        the first byte of the geometry
+        \param[in] last         one beyond the last readable byte
+        \param[out] type        the geometry type, without dimension flags
+        \param[out] dim         the number of coordinates per point
+        \param[out] swap        indicates if the geometry byte order differs from the host
+        \param[out] measured    indicates if the points have an m coordinate
+        \return                 one beyond the header, or 0 in case of an error
+    */
+    inline const unsigned char* parse_header (
+        const unsigned char* first,
+        const unsigned char* last,
+        uint32_t& type,
+        unsigned& dim,
+        bool& swap,
+        bool& measured)
+    {
+        if (last - first < 5 || first [0] > NDR) {
+            return 0;
+        }
+        swap = (first [0] == NDR) != util::host_is_little_endian ();
+        uint32_t code = read_uint32 (first + 1, swap);
+        first += 5;
+
+        // extended (EWKB) flags
+        bool z = (code & 0x80000000u) != 0;
+        bool m = (code & 0x40000000u) != 0;
+        if (code & 0x20000000u) {
+            if (last - first < 4) {
+                return 0;
+            }
+            first += 4;     // skip SRID
+        }
+        code &= 0x0FFFFFFFu;
+        // ISO dimension offsets
+        switch (code / 1000) {
+        case 0: break;
+        case 1: z = true; break;
+        case 2: m = true; break;
+        case 3: z = m = true; break;
+        default: return 0;
+        }
+        type = code % 1000;
+        dim = 2 + (z ? 1 : 0) + (m ? 1 : 0);
+        measured = m;
+        return first;
+    }
+
+    //! \brief Parses the header of a WKB geometry, see parse_header above.
+    inline const unsigned char* parse_header (
+        const unsigned char* first,
+        const unsigned char* last,
+        uint32_t& type,
+        unsigned& dim,
+        bool& swap)
+    {
+        bool measured;
+        return parse_header (first, last, type, dim, swap, measured);
+    }
+
+    /*!
+        \brief Parses a LineString or MultiLineString, appending each LineString.
+
+        Nothing is appended when the geometry is invalid.
+
+        \param[in] first        the first byte of the geometry
+        \param[in] last         one beyond the last readable byte
+        \param[out] lines       the LineStrings of the geometry
+        \return                 one beyond the last byte of the geometry, or 0 in case of an error
+    */
+    inline const unsigned char* parse (
+        const unsigned char* first,
+        const unsigned char* last,
+        std::vector <linestring>& lines)
+    {
+        uint32_t type;
+        unsigned dim;
+        bool swap;
+        bool measured;
+        first = parse_header (first, last, type, dim, swap, measured);
+        if (!first || last - first < 4) {
+            return 0;
+        }
+        uint32_t count = read_uint32 (first, swap);
+        first += 4;
+
+        if (type == LINESTRING) {
+            if (static_cast <std::size_t> (last - first) / (dim * 8) < count) {
+                return 0;
+            }
+            lines.push_back (linestring (first, count, dim, swap, measured));
+            return first + static_cast <std::size_t> (count) * dim * 8;
+        }
+        if (type == MULTILINESTRING) {
+            std::size_t initialCount = lines.size ();
+            for (uint32_t l = 0; l < count && first; ++l) {
+                uint32_t partType;
+                unsigned partDim;
+                bool partSwap;
+                if (!parse_header (first, last, partType, partDim, partSwap) || partType != LINESTRING) {
+                    first = 0;
+                    break;
+                }
+                first = parse (first, last, lines);
+            }
+            if (!first) {
+                // drop the parts that were already appended
+                lines.erase (lines.begin () + initialCount, lines.end ());
+            }
+            return first;
+        }
+        return 0;
+    }
+
+    /*!
+        \brief Writes little endian WKB LineStrings and MultiLineStrings using ISO type codes.
+
+        Coordinates are appended to the buffer through an output iterator:
+
+<pre>
+    std::vector <unsigned char> buffer;
+    psimpl::wkb::writer writer (buffer, 2);
+    psimpl::simplify_douglas_peucker <2> (first, last, tol, writer.begin_linestring ());
+    writer.end_linestring ();
+</pre>
+    */
+    class writer
+    {
+    public:
+        //! \brief Output iterator that appends coordinates to the current LineString.
+        class sink
+        {
+        public:
+            typedef std::output_iterator_tag iterator_category;
+            typedef void value_type;
+            typedef void difference_type;
+            typedef void pointer;
+            typedef void reference;
+
+            explicit sink (writer* w) :
+                w (w) {}
+
+            sink& operator= (double value) {
+                w->Put (value);
+                return *this;
+            }
+
+            sink& operator* () { return *this; }
+            sink& operator++ () { return *this; }
+            sink operator++ (int) { return *this; }
+
+        private:
+            writer* w;
+        };
+
+        /*!
+            \param[in] buffer   destination of the WKB
+            \param[in] dim      number of coordinates per point: 2 (XY), 3 (XYZ) or 4 (XYZM)
+        */
+        writer (std::vector <unsigned char>& buffer, unsigned dim) :
+            buffer (buffer), dim (dim), measured (dim == 4), lineCount (0), linePosition (0),
+            countPosition (0), multiCountPosition (0), coordCount (0), inMulti (false)
+        {}
+
+        /*!
+            \param[in] buffer   destination of the WKB
+            \param[in] layout   LineString whose dimensions (XY, XYZ, XYM or XYZM) are written
+        */
+        writer (std::vector <unsigned char>& buffer, const linestring& layout) :
+            buffer (buffer), dim (layout.dimension ()), measured (layout.has_m ()), lineCount (0),
+            linePosition (0), countPosition (0), multiCountPosition (0), coordCount (0), inMulti (false)
+        {}
+
+        //! \brief Starts a MultiLineString, subsequent LineStrings become its parts.
+        void begin_multi () {
+            multiCountPosition = WriteHeader (MULTILINESTRING);
+            lineCount = 0;
+            inMulti = true;
+        }
+
+        //! \brief Completes the current MultiLineString.
+        void end_multi () {
+            Patch (multiCountPosition, lineCount);
+            inMulti = false;
+        }
+
+        /*!
+            \brief Starts a LineString.
+
+            \return     output iterator that appends coordinates to the LineString
+        */
+        sink begin_linestring () {
+            linePosition = buffer.size ();
+            countPosition = WriteHeader (LINESTRING);
+            coordCount = 0;
+            return sink (this);
+        }
+
+        /*!
+            \brief Completes the current LineString.
+
+            A LineString that ends with an incomplete point is removed from the buffer.
+
+            \return     true when the LineString consists of complete points only
+        */
+        bool end_linestring () {
+            if (coordCount % dim) {
+                buffer.resize (linePosition);
+                return false;
+            }
+            Patch (countPosition, static_cast <uint32_t> (coordCount / dim));
+            if (inMulti) {
+                ++lineCount;
+            }
+            return true;
+        }
+
+    private:
+        std::size_t WriteHeader (uint32_t type) {
+            buffer.push_back (NDR);
+            uint32_t code = type + (dim == 3 ? (measured ? 2000 : 1000) : dim == 4 ? 3000 : 0);
+            Write (code);
+            std::size_t position = buffer.size ();
+            Write (uint32_t (0));   // patched once known
+            return position;
+        }
+
+        void Patch (std::size_t position, uint32_t value) {
+            for (unsigned b = 0; b < 4; ++b) {
+                buffer [position + b] = static_cast <unsigned char> (value >> (8 * b));
+            }
+        }
+
+        void Write (uint32_t value) {
+            for (unsigned b = 0; b < 4; ++b) {
+                buffer.push_back (static_cast <unsigned char> (value >> (8 * b)));
+            }
+        }
+
+        void Put (double value) {
+            unsigned char bytes [8];
+            std::memcpy (bytes, &value, 8);
+            bool swap = !util::host_is_little_endian ();
+            for (unsigned b = 0; b < 8; ++b) {
+                buffer.push_back (bytes [swap ? 7 - b : b]);
+            }
+            ++coordCount;
+        }
+
+        writer (const writer&);
+        writer& operator= (const writer&);
+
+    private:
+        std::vector <unsigned char>& buffer;    //! destination of the WKB
+        unsigned dim;                           //! number of coordinates per point
+        bool measured;                          //! indicates if the points have an m coordinate
+        uint32_t lineCount;                     //! number of parts of the current MultiLineString
+        std::size_t linePosition;               //! position of the current LineString
+        std::size_t countPosition;              //! position of the point count of the LineString
+        std::size_t multiCountPosition;         //! position of the part count of the MultiLineString
+        std::size_t coordCount;                 //! number of coordinates of the current LineString
+        bool inMulti;                           //! indicates if a MultiLineString is being written
+    };
+}
+
+    /*!
+        \brief Contains the Tiny Well-Known Binary (TWKB) reader and writer.
+    */
+    namespace twkb
+{
+    //! \brief TWKB geometry types.
+    enum geometry_type {
+        LINESTRING = 2,
+        MULTILINESTRING = 5
+    };
+
+    //! \brief TWKB metadata flags.
+    enum metadata {
+        HAS_BBOX = 0x01,
+        HAS_SIZE = 0x02,
+        HAS_IDLIST = 0x04,
+        HAS_EXTENDED_DIMS = 0x08,
+        IS_EMPTY = 0x10
+    };
+
+    //! \brief Returns 10 to the power of precision.
+    inline double scale (int precision) {
+        double factor = 1;
+        for (int p = 0; p < precision; ++p) factor *= 10;
+        for (int p = 0; p > precision; --p) factor /= 10;
+        return factor;
+    }
+
+    /*!
+        \brief Forward iterator that decodes the coordinates of a TWKB LineString on the fly.
+
+        Copies of the iterator can be advanced independently, which makes it suitable for all
+        algorithms that require forward iterators.
+    */
+    class coordinate_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef double value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const double* pointer;
+        typedef double reference;
+
+        coordinate_iterator () :
+            p (0), limit (0), dim (0), index (0), count (0), value (0) {}
+
+        /*!
+            \param[in] p            first byte of the first encoded coordinate
+            \param[in] limit        one beyond the last readable byte
+            \param[in] dim          number of coordinates per point
+            \param[in] count        number of coordinates
+            \param[in] start        coordinates of the point preceding the LineString
+            \param[in] factors      10^precision for each dimension
+            \param[in] index        coordinate index, count denotes the end iterator
+        */
+        coordinate_iterator (const unsigned char* p, const unsigned char* limit, unsigned dim,
+                             std::ptrdiff_t count, const int64_t* start, const double* factors,
+                             std::ptrdiff_t index) :
+            p (p), limit (limit), dim (dim), index (index), count (count), value (0)
+        {
+            for (unsigned d = 0; d < 4; ++d) {
+                acc [d] = d < dim ? start [d] : 0;
+                factor [d] = d < dim ? factors [d] : 1;
+            }
+            if (index < count) {
+                Decode ();
+            }
+        }
+
+        double operator* () const {
+            return value;
+        }
+
+        coordinate_iterator& operator++ () {
+            if (++index < count) {
+                Decode ();
+            }
+            return *this;
+        }
+
+        coordinate_iterator operator++ (int) {
+            coordinate_iterator it (*this);
+            ++*this;
+            return it;
+        }
+
+        bool operator== (const coordinate_iterator& it) const { return index == it.index; }
+        bool operator!= (const coordinate_iterator& it) const { return index != it.index; }
+
+    private:
+        void Decode () {
+            uint64_t delta = 0;
+            const unsigned char* next = p ? util::decode_varint (p, limit, delta) : 0;
+            p = next ? next : limit;    // invalid input was rejected by parse
+            unsigned d = static_cast <unsigned> (index % dim);
+            acc [d] += util::zigzag_decode (delta);
+            value = acc [d] / factor [d];
+        }
+
+    private:
+        const unsigned char* p;     //! first byte of the next encoded coordinate
+        const unsigned char* limit; //! one beyond the last readable byte
+        unsigned dim;               //! number of coordinates per point
+        std::ptrdiff_t index;       //! index of the current coordinate
+        std::ptrdiff_t count;       //! number of coordinates
+        int64_t acc [4];            //! quantized value of the last decoded coordinate per dimension
+        double factor [4];          //! 10^precision per dimension
+        double value;               //! current coordinate
+    };
+
+    /*!
+        \brief A LineString inside a TWKB buffer.
+    */
+    class linestring
+    {
+    public:
+        typedef coordinate_iterator iterator;
+
+        linestring (const unsigned char* coords, const unsigned char* limit, std::size_t pointCount,
+                    unsigned dim, const int64_t* start, const double* factors, int precision = 0,
+                    unsigned char dims = 0) :
+            coords (coords), limit (limit), pointCount (pointCount), dim (dim), xyPrecision (precision),
+            dims (dims)
+        {
+            for (unsigned d = 0; d < 4; ++d) {
+                this->start [d] = d < dim ? start [d] : 0;
+                this->factors [d] = d < dim ? factors [d] : 1;
+            }
+        }
+
+        //! \brief Returns the number of coordinates per point.
+        unsigned dimension () const {
+            return dim;
+        }
+
+        std::size_t point_count () const {
+            return pointCount;
+        }
+
+        //! \brief Returns the number of decimals of x and y.
+        int precision () const {
+            return xyPrecision;
+        }
+
+        //! \brief Indicates if the points have a z coordinate.
+        bool has_z () const {
+            return (dims & 0x01) != 0;
+        }
+
+        //! \brief Indicates if the points have an m coordinate.
+        bool has_m () const {
+            return (dims & 0x02) != 0;
+        }
+
+        //! \brief Returns the number of decimals of z.
+        int z_precision () const {
+            return has_z () ? (dims >> 2) & 0x07 : 0;
+        }
+
+        //! \brief Returns the number of decimals of m.
+        int m_precision () const {
+            return has_m () ? (dims >> 5) & 0x07 : 0;
+        }
+
+        iterator begin () const {
+            return iterator (coords, limit, dim, Count (), start, factors, 0);
+        }
+
+        iterator end () const {
+            return iterator (coords, limit, dim, Count (), start, factors, Count ());
+        }
+
+    private:
+        std::ptrdiff_t Count () const {
+            return static_cast <std::ptrdiff_t> (pointCount * dim);
+        }
+
+    private:
+        const unsigned char* coords;    //! first byte of the first encoded coordinate
+        const unsigned char* limit;     //! one beyond the last readable byte
+        std::size_t pointCount;         //! number of points
+        unsigned dim;                   //! number of coordinates per point
+        int64_t start [4];              //! coordinates of the point preceding the LineString
+        double factors [4];             //! 10^precision per dimension
+        int xyPrecision;                //! number of decimals of x and y
+        unsigned char dims;             //! extended dimensions byte of the header, 0 when absent
+    };
+
+    /*!
+        \brief Parses a TWKB LineString or MultiLineString, appending each LineString.
+
+        Coordinates are delta encoded across the whole geometry, so locating a LineString requires
+        decoding all coordinates in front of it. This is done once here; the coordinates
+        themselves are decoded again, lazily, by the iterators of each LineString. Nothing is
+        appended when the geometry is invalid.
+
+        \param[in] first        the first byte of the geometry
+        \param[in] last         one beyond the last readable byte
+        \param[out] lines       the LineStrings of the geometry
+        \return                 one beyond the last byte of the geometry, or 0 in case of an error
+    */
+    inline const unsigned char* parse (
+        const unsigned char* first,
+        const unsigned char* last,
+        std::vector <linestring>& lines)
+    {
+        if (last - first < 2) {
+            return 0;
+        }
+        unsigned type = first [0] & 0x0F;
+        int precision = static_cast <int> (util::zigzag_decode (first [0] >> 4));
+        unsigned flags = first [1];
+        first += 2;
+
+        unsigned dim = 2;
+        double factors [4] = { scale (precision), scale (precision), 1, 1 };
+        unsigned char dims = 0;
+        if (flags & HAS_EXTENDED_DIMS) {
+            if (first == last) {
+                return 0;
+            }
+            dims = *first++;
+            if (dims & 0x01) {
+                factors [dim++] = scale ((dims >> 2) & 0x07);
+            }
+            if (dims & 0x02) {
+                factors [dim++] = scale ((dims >> 5) & 0x07);
+            }
+        }
+        uint64_t value = 0;
+        if (flags & HAS_SIZE) {
+            if (!(first = util::decode_varint (first, last, value)) || static_cast <uint64_t> (last - first) < value) {
+                return 0;
+            }
+            last = first + value;
+        }
+        if (flags & HAS_BBOX) {
+            for (unsigned i = 0; i < 2 * dim && first; ++i) {
+                first = util::decode_varint (first, last, value);
+            }
+        }
+        if (!first || (type != LINESTRING && type != MULTILINESTRING)) {
+            return 0;
+        }
+        if (flags & IS_EMPTY) {
+            return first;
+        }
+
+        uint64_t lineCount = 1;
+        if (type == MULTILINESTRING) {
+            if (!(first = util::decode_varint (first, last, lineCount))) {
+                return 0;
+            }
+            if (flags & HAS_IDLIST) {
+                for (uint64_t i = 0; i < lineCount && first; ++i) {
+                    first = util::decode_varint (first, last, value);
+                }
+            }
+        }
+        int64_t acc [4] = { 0, 0, 0, 0 };
+        std::size_t initialCount = lines.size ();
+        for (uint64_t l = 0; l < lineCount && first; ++l) {
+            uint64_t pointCount = 0;
+            if (!(first = util::decode_varint (first, last, pointCount)) ||
+                pointCount > static_cast <uint64_t> (last - first))
+            {
+                first = 0;
+                break;
+            }
+            lines.push_back (linestring (first, last, static_cast <std::size_t> (pointCount), dim, acc, factors,
+                                         precision, dims));
+            for (uint64_t c = 0; c < pointCount * dim && first; ++c) {
+                first = util::decode_varint (first, last, value);
+                acc [c % dim] += util::zigzag_decode (value);
+            }
+        }
+        if (!first) {
+            // drop the LineStrings that were already appended
+            lines.erase (lines.begin () + initialCount, lines.end ());
+        }
+        return first;
+    }
+
+    /*!
+        \brief Writes TWKB LineStrings and MultiLineStrings.
+
+        Coordinates are quantized, delta encoded and appended to the buffer through an output
+        iterator. Since the point count precedes the coordinates as a varint of unknown length,
+        the coordinates of a LineString are encoded into a separate buffer, which is appended
+        after the count once the LineString is complete. The parts of a MultiLineString are
+        likewise held back until their number is known.
+    */
+    class writer
+    {
+    public:
+        //! \brief Output iterator that appends coordinates to the current LineString.
+        class sink
+        {
+        public:
+            typedef std::output_iterator_tag iterator_category;
+            typedef void value_type;
+            typedef void difference_type;
+            typedef void pointer;
+            typedef void reference;
+
+            explicit sink (writer* w) :
+                w (w) {}
+
+            sink& operator= (double value) {
+                w->Put (value);
+                return *this;
+            }
+
+            sink& operator* () { return *this; }
+            sink& operator++ () { return *this; }
+            sink operator++ (int) { return *this; }
+
+        private:
+            writer* w;
+        };
+
+        /*!
+            \param[in] buffer       destination of the TWKB
+            \param[in] dim          number of coordinates per point: 2 (XY), 3 (XYZ) or 4 (XYZM)
+            \param[in] precision    number of decimals of x and y, in [-7, 7]
+            \param[in] zprecision   number of decimals of z, in [0, 7]
+            \param[in] mprecision   number of decimals of m, in [0, 7]
+        */
+        writer (std::vector <unsigned char>& buffer, unsigned dim, int precision, int zprecision = 0, int mprecision = 0) :
+            buffer (buffer), dim (dim), precision (precision), zprecision (zprecision), mprecision (mprecision),
+            hasZ (dim > 2), hasM (dim == 4), lineCount (0), linePosition (0), coordCount (0), inMulti (false)
+        {
+            Init ();
+        }
+
+        /*!
+            \param[in] buffer   destination of the TWKB
+            \param[in] layout   LineString whose dimensions (XY, XYZ, XYM or XYZM) and precisions
+                                are written
+        */
+        writer (std::vector <unsigned char>& buffer, const linestring& layout) :
+            buffer (buffer), dim (layout.dimension ()), precision (layout.precision ()),
+            zprecision (layout.z_precision ()), mprecision (layout.m_precision ()),
+            hasZ (layout.has_z ()), hasM (layout.has_m ()), lineCount (0), linePosition (0), coordCount (0),
+            inMulti (false)
+        {
+            Init ();
+        }
+
+        //! \brief Starts a MultiLineString, subsequent LineStrings become its parts.
+        void begin_multi () {
+            WriteHeader (MULTILINESTRING);
+            parts.clear ();
+            lineCount = 0;
+            inMulti = true;
+        }
+
+        //! \brief Completes the current MultiLineString.
+        void end_multi () {
+            util::encode_varint (lineCount, std::back_inserter (buffer));
+            buffer.insert (buffer.end (), parts.begin (), parts.end ());
+            parts.clear ();
+            inMulti = false;
+        }
+
+        /*!
+            \brief Starts a LineString.
+
+            \return     output iterator that appends coordinates to the LineString
+        */
+        sink begin_linestring () {
+            linePosition = buffer.size ();
+            if (!inMulti) {
+                WriteHeader (LINESTRING);
+            }
+            std::copy (acc, acc + 4, start);
+            coords.clear ();
+            coordCount = 0;
+            return sink (this);
+        }
+
+        /*!
+            \brief Completes the current LineString.
+
+            A LineString that ends with an incomplete point is discarded.
+
+            \return     true when the LineString consists of complete points only
+        */
+        bool end_linestring () {
+            if (coordCount % dim) {
+                // deltas of subsequent parts continue from the previous LineString
+                std::copy (start, start + 4, acc);
+                buffer.resize (linePosition);
+                return false;
+            }
+            std::vector <unsigned char>& target = inMulti ? parts : buffer;
+            util::encode_varint (coordCount / dim, std::back_inserter (target));
+            target.insert (target.end (), coords.begin (), coords.end ());
+            if (inMulti) {
+                ++lineCount;
+            }
+            return true;
+        }
+
+    private:
+        void Init () {
+            factors [0] = factors [1] = scale (precision);
+            factors [2] = scale (hasZ ? zprecision : mprecision);
+            factors [3] = scale (mprecision);
+            Reset ();
+        }
+
+        void Reset () {
+            for (unsigned d = 0; d < 4; ++d) {
+                acc [d] = 0;
+            }
+        }
+
+        void WriteHeader (unsigned type) {
+            Reset ();
+            buffer.push_back (static_cast <unsigned char> (type | (util::zigzag_encode (precision) << 4)));
+            if (!hasZ && !hasM) {
+                buffer.push_back (0);
+            }
+            else {
+                buffer.push_back (HAS_EXTENDED_DIMS);
+                buffer.push_back (static_cast <unsigned char> (
+                    (hasZ ? 0x01 | (zprecision << 2) : 0) | (hasM ? 0x02 | (mprecision << 5) : 0)));
+            }
+        }
+
+        void Put (double value) {
+            unsigned d = static_cast <unsigned> (coordCount++ % dim);
+            int64_t quantized = util::quantize (value, factors [d]);
+            util::encode_varint (util::zigzag_encode (quantized - acc [d]), std::back_inserter (coords));
+            acc [d] = quantized;
+        }
+
+        writer (const writer&);
+        writer& operator= (const writer&);
+
+    private:
+        std::vector <unsigned char>& buffer;    //! destination of the TWKB
+        std::vector <unsigned char> coords;     //! encoded coordinates of the current LineString
+        std::vector <unsigned char> parts;      //! encoded parts of the current MultiLineString
+        unsigned dim;                           //! number of coordinates per point
+        int precision;                          //! number of decimals of x and y
+        int zprecision;                         //! number of decimals of z
+        int mprecision;                         //! number of decimals of m
+        bool hasZ;                              //! indicates if the points have a z coordinate
+        bool hasM;                              //! indicates if the points have an m coordinate
+        double factors [4];                     //! 10^precision per dimension
+        int64_t acc [4];                        //! last quantized coordinate per dimension
+        int64_t start [4];                      //! acc at the start of the current LineString
+        uint64_t lineCount;                     //! number of parts of the current MultiLineString
+        std::size_t linePosition;               //! size of the buffer when the LineString started
+        std::size_t coordCount;                 //! number of coordinates of the current LineString
+        bool inMulti;                           //! indicates if a MultiLineString is being written
+    };
+}}
+
+
+#endif // PSIMPL_WKB
@@ -0,0 +1,1032 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+/*
+    Python extension module exposing psimpl to NumPy (or any other buffer provider).
+
+    Polylines are passed as two dimensional buffers of shape (n, 2) or (n, 3) containing float32
+    or float64 values. Contiguous and strided buffers are both read in place through the buffer
+    protocol; no input data is copied. The GIL is released while the simplification runs.
+
+    The result is either a (m, DIM) array with the simplified polyline, or, when indices=True, a
+    (m,) array of Py_ssize_t (numpy.intp) with the indices of the kept vertices. When NumPy is
+    available results are returned as numpy.ndarray, otherwise as memoryview.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "../lib/psimpl.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+
+namespace
+{
+    //! \brief the algorithms exposed by this module
+    enum Algorithm
+    {
+        NTH_POINT,
+        RADIAL_DISTANCE,
+        PERPENDICULAR_DISTANCE,
+        REUMANN_WITKAM,
+        OPHEIM,
+        LANG,
+        DOUGLAS_PEUCKER,
+        DOUGLAS_PEUCKER_N
+    };
+
+    //! \brief the parameters of a single simplification call
+    struct Params
+    {
+        Params () :
+            algorithm (DOUGLAS_PEUCKER),
+            tol (0),
+            max_tol (0),
+            n (0),
+            indices (0)
+        {}
+
+        Algorithm algorithm;
+        double tol;         //!< tol or min_tol
+        double max_tol;     //!< max_tol (opheim)
+        unsigned n;         //!< n, repeat, look_ahead or count
+        int indices;        //!< return indices instead of coordinates
+    };
+
+    /*!
+        \brief Random access iterator over the coordinates of a strided (n, DIM) buffer.
+
+        Values are read with memcpy, so the buffer does not need to be aligned.
+    */
+    template <typename T, unsigned DIM>
+    class strided_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef Py_ssize_t difference_type;
+        typedef const T* pointer;
+        typedef T reference;
+
+        strided_iterator (const char* base=0, Py_ssize_t pointStride=0, Py_ssize_t coordStride=0,
+                          Py_ssize_t index=0) :
+            mBase (base),
+            mPointStride (pointStride),
+            mCoordStride (coordStride),
+            mIndex (index)
+        {}
+
+        T operator * () const {
+            T value;
+            std::memcpy (&value, mBase + (mIndex / DIM) * mPointStride
+                                       + (mIndex % DIM) * mCoordStride, sizeof (T));
+            return value;
+        }
+
+        T operator [] (difference_type n) const { return *(*this + n); }
+
+        strided_iterator& operator ++ () { ++mIndex; return *this; }
+        strided_iterator& operator -- () { --mIndex; return *this; }
+        strided_iterator operator ++ (int) { strided_iterator it (*this); ++mIndex; return it; }
+        strided_iterator operator -- (int) { strided_iterator it (*this); --mIndex; return it; }
+        strided_iterator& operator += (difference_type n) { mIndex += n; return *this; }
+        strided_iterator& operator -= (difference_type n) { mIndex -= n; return *this; }
+        strided_iterator operator + (difference_type n) const { strided_iterator it (*this); return it += n; }
+        strided_iterator operator - (difference_type n) const { strided_iterator it (*this); return it -= n; }
+        difference_type operator - (const strided_iterator& other) const { return mIndex - other.mIndex; }
+
+        bool operator == (const strided_iterator& other) const { return mIndex == other.mIndex; }
+        bool operator != (const strided_iterator& other) const { return mIndex != other.mIndex; }
+        bool operator <  (const strided_iterator& other) const { return mIndex <  other.mIndex; }
+        bool operator >  (const strided_iterator& other) const { return mIndex >  other.mIndex; }
+        bool operator <= (const strided_iterator& other) const { return mIndex <= other.mIndex; }
+        bool operator >= (const strided_iterator& other) const { return mIndex >= other.mIndex; }
+
+    private:
+        const char* mBase;
+        Py_ssize_t mPointStride;    //!< byte offset between successive points
+        Py_ssize_t mCoordStride;    //!< byte offset between successive coordinates of a point
+        Py_ssize_t mIndex;          //!< coordinate index
+    };
+
+    //! \brief a single polyline: an acquired input buffer and its output
+    struct Job
+    {
+        Job () :
+            pointCount (0),
+            dim (0),
+            isDouble (false),
+            contiguous (false),
+            data (0),
+            resultCount (0),
+            output (0),
+            indices (0)
+        {
+            std::memset (&view, 0, sizeof (view));
+        }
+
+        Py_buffer view;
+        Py_ssize_t pointCount;
+        unsigned dim;
+        bool isDouble;
+        bool contiguous;
+        const char* data;           //!< first coordinate of the first point
+        Py_ssize_t strides [2];
+        Py_ssize_t resultCount;     //!< number of points in the simplification
+        char* output;               //!< simplification, at least pointCount points, unless indices is set
+        Py_ssize_t* indices;        //!< optional indices of the simplification points
+    };
+
+    PyObject* sAsArray = 0;         //!< numpy.asarray, or null when numpy is unavailable
+
+    //! \brief a coordinate that remembers the polyline point it belongs to
+    template <typename T>
+    struct indexed_value
+    {
+        operator T () const { return value; }
+
+        T value;
+        Py_ssize_t point;   //!< index of the point in the original polyline
+        unsigned coord;     //!< index of the coordinate within its point
+    };
+
+    /*!
+        \brief Random access iterator over the coordinates of selected points of a polyline.
+
+        Each coordinate is returned as an indexed_value, which lets index_writer recover the index
+        of each point that a routine copies to its output.
+    */
+    template <typename T, unsigned DIM, class Iterator>
+    class gather_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef Py_ssize_t difference_type;
+        typedef const T* pointer;
+        typedef indexed_value <T> reference;
+
+        gather_iterator (Iterator base=Iterator (), const Py_ssize_t* points=0, Py_ssize_t index=0) :
+            mBase (base),
+            mPoints (points),
+            mIndex (index)
+        {}
+
+        indexed_value <T> operator * () const {
+            Py_ssize_t point = mPoints [mIndex / DIM];
+            unsigned coord = static_cast <unsigned> (mIndex % DIM);
+            indexed_value <T> value = { mBase [point * DIM + coord], point, coord };
+            return value;
+        }
+
+        indexed_value <T> operator [] (difference_type n) const { return *(*this + n); }
+
+        gather_iterator& operator ++ () { ++mIndex; return *this; }
+        gather_iterator& operator -- () { --mIndex; return *this; }
+        gather_iterator operator ++ (int) { gather_iterator it (*this); ++mIndex; return it; }
+        gather_iterator operator -- (int) { gather_iterator it (*this); --mIndex; return it; }
+        gather_iterator& operator += (difference_type n) { mIndex += n; return *this; }
+        gather_iterator& operator -= (difference_type n) { mIndex -= n; return *this; }
+        gather_iterator operator + (difference_type n) const { gather_iterator it (*this); return it += n; }
+        gather_iterator operator - (difference_type n) const { gather_iterator it (*this); return it -= n; }
+        difference_type operator - (const gather_iterator& other) const { return mIndex - other.mIndex; }
+
+        bool operator == (const gather_iterator& other) const { return mIndex == other.mIndex; }
+        bool operator != (const gather_iterator& other) const { return mIndex != other.mIndex; }
+        bool operator <  (const gather_iterator& other) const { return mIndex <  other.mIndex; }
+        bool operator >  (const gather_iterator& other) const { return mIndex >  other.mIndex; }
+        bool operator <= (const gather_iterator& other) const { return mIndex <= other.mIndex; }
+        bool operator >= (const gather_iterator& other) const { return mIndex >= other.mIndex; }
+
+    private:
+        Iterator mBase;             //!< first coordinate of the original polyline
+        const Py_ssize_t* mPoints;  //!< indices of the selected points
+        Py_ssize_t mIndex;          //!< coordinate index within the selected points
+    };
+
+    //! \brief output iterator that stores the index of each point written to it
+    template <typename T>
+    class index_writer
+    {
+    public:
+        typedef std::output_iterator_tag iterator_category;
+        typedef void value_type;
+        typedef void difference_type;
+        typedef void pointer;
+        typedef void reference;
+
+        explicit index_writer (Py_ssize_t* out=0) :
+            mOut (out)
+        {}
+
+        index_writer& operator = (const indexed_value <T>& value) {
+            if (value.coord == 0) {
+                *mOut++ = value.point;
+            }
+            return *this;
+        }
+
+        index_writer& operator * () { return *this; }
+        index_writer& operator ++ () { return *this; }
+        index_writer operator ++ (int) { return *this; }
+
+        Py_ssize_t* get () const { return mOut; }
+
+    private:
+        Py_ssize_t* mOut;
+    };
+
+    /*!
+        \brief Applies the requested algorithm to the polyline at first, and stores the indices of
+        the kept points.
+
+        Most routines copy their keys straight from the input, so they run over a gather_iterator
+        and write to an index_writer. Repeated PD runs each pass over the points kept by the
+        previous pass. DP and DPn copy the input internally; their keys are derived from the DP
+        importance and the DPn key order instead.
+
+        \return     the number of kept points
+    */
+    template <unsigned DIM, typename T, class Iterator>
+    Py_ssize_t SimplifyIndices (
+        const Params& params,
+        Iterator first,
+        Py_ssize_t pointCount,
+        Py_ssize_t* indices)
+    {
+        typedef gather_iterator <T, DIM, Iterator> Gather;
+        typedef index_writer <T> Writer;
+
+        if (!pointCount) {
+            return 0;
+        }
+        std::vector <Py_ssize_t> points (pointCount);
+        for (Py_ssize_t p = 0; p < pointCount; ++p) {
+            points [p] = p;
+        }
+        Gather begin (first, &points [0]);
+        Gather end (first, &points [0], pointCount * DIM);
+        Writer result (indices);
+
+        psimpl::PolylineSimplification <DIM, Gather, Writer> ps;
+        T tol = static_cast <T> (params.tol);
+
+        switch (params.algorithm) {
+        case NTH_POINT:
+            return ps.NthPoint (begin, end, params.n, result).get () - indices;
+        case RADIAL_DISTANCE:
+            return ps.RadialDistance (begin, end, tol, result).get () - indices;
+        case PERPENDICULAR_DISTANCE:
+            {
+                // stop as soon as a pass does not remove any points
+                Py_ssize_t count = pointCount;
+                for (unsigned pass = 0; pass < params.n; ++pass) {
+                    Py_ssize_t passCount = ps.PerpendicularDistance (
+                        begin, Gather (first, &points [0], count * DIM), tol, result).get () - indices;
+                    std::copy (indices, indices + passCount, points.begin ());
+                    if (passCount == count) {
+                        break;
+                    }
+                    count = passCount;
+                }
+                std::copy (points.begin (), points.begin () + count, indices);
+                return count;
+            }
+        case REUMANN_WITKAM:
+            return ps.ReumannWitkam (begin, end, tol, result).get () - indices;
+        case OPHEIM:
+            return ps.Opheim (begin, end, tol, static_cast <T> (params.max_tol), result).get () - indices;
+        case LANG:
+            return ps.Lang (begin, end, tol, params.n, result).get () - indices;
+        case DOUGLAS_PEUCKER:
+            {
+                if (pointCount < 3 || tol == 0) {
+                    break;
+                }
+                // RD followed by DP, which keeps the points whose importance exceeds tol
+                Py_ssize_t count = ps.RadialDistance (begin, end, tol, result).get () - indices;
+                std::copy (indices, indices + count, points.begin ());
+                std::vector <T> importance (count);
+                psimpl::PolylineSimplification <DIM, Gather, T*> importer;
+                importer.ComputeDouglasPeuckerImportance2 (
+                    begin, Gather (first, &points [0], count * DIM), &importance [0]);
+                T tol2 = tol * tol;
+                Py_ssize_t keyCount = 0;
+                for (Py_ssize_t p = 0; p < count; ++p) {
+                    if (tol2 < importance [p]) {
+                        indices [keyCount++] = points [p];
+                    }
+                }
+                return keyCount;
+            }
+        case DOUGLAS_PEUCKER_N:
+            {
+                if (params.n < 2 || pointCount <= static_cast <Py_ssize_t> (params.n)) {
+                    break;
+                }
+                // the first and last point, followed by the keys in the order DPn selects them
+                typedef std::vector <std::pair <Py_ssize_t, T> > Order;
+                Order order;
+                psimpl::PolylineSimplification <DIM, Iterator, std::back_insert_iterator <Order> > orderer;
+                orderer.DouglasPeuckerNOrder (first, first + pointCount * DIM, params.n, std::back_inserter (order));
+                Py_ssize_t keyCount = 0;
+                indices [keyCount++] = 0;
+                indices [keyCount++] = pointCount - 1;
+                for (size_t k = 0; k < order.size (); ++k) {
+                    indices [keyCount++] = order [k].first;
+                }
+                std::sort (indices, indices + keyCount);
+                return keyCount;
+            }
+        }
+        // invalid input is kept entirely
+        std::copy (points.begin (), points.end (), indices);
+        return pointCount;
+    }
+
+    //! \brief applies the requested algorithm to [first, last)
+    template <unsigned DIM, typename T, class Iterator>
+    T* Simplify (
+        const Params& params,
+        Iterator first,
+        Iterator last,
+        T* result)
+    {
+        psimpl::PolylineSimplification <DIM, Iterator, T*> ps;
+        T tol = static_cast <T> (params.tol);
+
+        switch (params.algorithm) {
+        case NTH_POINT:
+            return ps.NthPoint (first, last, params.n, result);
+        case RADIAL_DISTANCE:
+            return ps.RadialDistance (first, last, tol, result);
+        case PERPENDICULAR_DISTANCE:
+            return ps.PerpendicularDistance (first, last, tol, params.n, result);
+        case REUMANN_WITKAM:
+            return ps.ReumannWitkam (first, last, tol, result);
+        case OPHEIM:
+            return ps.Opheim (first, last, tol, static_cast <T> (params.max_tol), result);
+        case LANG:
+            return ps.Lang (first, last, tol, params.n, result);
+        case DOUGLAS_PEUCKER:
+            return ps.DouglasPeucker (first, last, tol, result);
+        case DOUGLAS_PEUCKER_N:
+            return ps.DouglasPeuckerN (first, last, params.n, result);
+        }
+        return std::copy (first, last, result);
+    }
+
+    //! \brief runs a job for a specific dimension and value type; must not touch python objects
+    template <unsigned DIM, typename T>
+    void Run (
+        const Params& params,
+        Job& job)
+    {
+        T* result = reinterpret_cast <T*> (job.output);
+
+        if (job.contiguous) {
+            const T* first = reinterpret_cast <const T*> (job.data);
+            const T* last = first + job.pointCount * DIM;
+            job.resultCount = job.indices
+                              ? SimplifyIndices <DIM, T> (params, first, job.pointCount, job.indices)
+                              : (Simplify <DIM> (params, first, last, result) - result) / DIM;
+        }
+        else {
+            typedef strided_iterator <T, DIM> Iterator;
+            Iterator first (job.data, job.strides [0], job.strides [1]);
+            Iterator last (job.data, job.strides [0], job.strides [1], job.pointCount * DIM);
+            job.resultCount = job.indices
+                              ? SimplifyIndices <DIM, T> (params, first, job.pointCount, job.indices)
+                              : (Simplify <DIM> (params, first, last, result) - result) / DIM;
+        }
+    }
+
+    //! \brief runs a job; must not touch python objects
+    void Run (
+        const Params& params,
+        Job& job)
+    {
+        if (job.dim == 2) {
+            job.isDouble ? Run <2, double> (params, job) : Run <2, float> (params, job);
+        }
+        else {
+            job.isDouble ? Run <3, double> (params, job) : Run <3, float> (params, job);
+        }
+    }
+
+    //! \brief checks if a buffer format string denotes the native type 'type'
+    bool IsFormat (
+        const char* format,
+        char type)
+    {
+        if (!format) {
+            return type == 'B';
+        }
+        if (*format == '@' || *format == '=' || *format == '|') {
+            ++format;
+        }
+        else if (*format == '<' || *format == '>' || *format == '!') {
+            const int one = 1;
+            bool little = *reinterpret_cast <const char*> (&one) == 1;
+            if ((*format == '<') != little) {
+                return false;
+            }
+            ++format;
+        }
+        return format [0] == type && format [1] == 0;
+    }
+
+    //! \brief acquires the buffer of a (sub) polyline and validates its shape and type
+    bool Acquire (
+        PyObject* obj,
+        Job& job)
+    {
+        if (PyObject_GetBuffer (obj, &job.view, PyBUF_STRIDES | PyBUF_FORMAT) < 0) {
+            return false;
+        }
+        const Py_buffer& v = job.view;
+        if (v.ndim != 2 || (v.shape [1] != 2 && v.shape [1] != 3)) {
+            PyErr_SetString (PyExc_ValueError, "polyline must have shape (n, 2) or (n, 3)");
+            return false;
+        }
+        if (IsFormat (v.format, 'd') && v.itemsize == sizeof (double)) {
+            job.isDouble = true;
+        }
+        else if (IsFormat (v.format, 'f') && v.itemsize == sizeof (float)) {
+            job.isDouble = false;
+        }
+        else {
+            PyErr_SetString (PyExc_TypeError, "polyline must contain native float32 or float64 values");
+            return false;
+        }
+        job.pointCount = v.shape [0];
+        job.dim = static_cast <unsigned> (v.shape [1]);
+        job.data = static_cast <const char*> (v.buf);
+        job.strides [0] = v.strides [0];
+        job.strides [1] = v.strides [1];
+        job.contiguous = v.strides [1] == v.itemsize && v.strides [0] == v.itemsize * v.shape [1];
+        return true;
+    }
+
+    //! \brief releases the input buffers of all jobs
+    void Release (
+        std::vector <Job>& jobs)
+    {
+        for (size_t j = 0; j < jobs.size (); ++j) {
+            if (jobs [j].view.obj) {
+                PyBuffer_Release (&jobs [j].view);
+            }
+        }
+    }
+
+    //! \brief wraps a bytearray as a memoryview (or numpy array) of the given shape
+    PyObject* MakeArray (
+        PyObject* bytes,
+        const char* format,
+        Py_ssize_t rows,
+        Py_ssize_t cols)
+    {
+        PyObject* view = PyMemoryView_FromObject (bytes);
+        Py_DECREF (bytes);
+        if (!view) {
+            return 0;
+        }
+        // memoryview cannot cast to a shape that contains zeros
+        PyObject* shape = !rows
+                          ? Py_BuildValue ("()")
+                          : cols
+                          ? Py_BuildValue ("(nn)", rows, cols)
+                          : Py_BuildValue ("(n)", rows);
+        PyObject* cast = !shape
+                         ? 0
+                         : rows
+                         ? PyObject_CallMethod (view, "cast", "sO", format, shape)
+                         : PyObject_CallMethod (view, "cast", "s", format);
+        Py_XDECREF (shape);
+        Py_DECREF (view);
+        if (!cast || !sAsArray) {
+            return cast;
+        }
+        PyObject* array = PyObject_CallFunctionObjArgs (sAsArray, cast, NULL);
+        Py_DECREF (cast);
+        if (array && !rows && cols) {
+            PyObject* reshaped = PyObject_CallMethod (array, "reshape", "nn", rows, cols);
+            Py_DECREF (array);
+            array = reshaped;
+        }
+        return array;
+    }
+
+    //! \brief allocates the output of each job, either its points or its indices; returns the owning bytearrays
+    bool Allocate (
+        std::vector <Job>& jobs,
+        std::vector <PyObject*>& outputs,
+        bool withIndices)
+    {
+        for (size_t j = 0; j < jobs.size (); ++j) {
+            Job& job = jobs [j];
+            Py_ssize_t size = withIndices
+                              ? job.pointCount * static_cast <Py_ssize_t> (sizeof (Py_ssize_t))
+                              : job.pointCount * job.dim * job.view.itemsize;
+            PyObject* out = PyByteArray_FromStringAndSize (0, size);
+            if (!out) {
+                return false;
+            }
+            outputs.push_back (out);
+            if (withIndices) {
+                job.indices = reinterpret_cast <Py_ssize_t*> (PyByteArray_AS_STRING (out));
+            }
+            else {
+                job.output = PyByteArray_AS_STRING (out);
+            }
+        }
+        return true;
+    }
+
+    //! \brief runs all jobs with the GIL released
+    void RunAll (
+        const Params& params,
+        std::vector <Job>& jobs)
+    {
+        Py_BEGIN_ALLOW_THREADS
+        for (size_t j = 0; j < jobs.size (); ++j) {
+            Run (params, jobs [j]);
+        }
+        Py_END_ALLOW_THREADS
+    }
+
+    //! \brief converts the output of a job into a python array; steals the bytearray
+    PyObject* MakeResult (
+        const Job& job,
+        PyObject* output)
+    {
+        if (job.indices) {
+            if (PyByteArray_Resize (output, job.resultCount * sizeof (Py_ssize_t)) < 0) {
+                Py_DECREF (output);
+                return 0;
+            }
+            return MakeArray (output, "n", job.resultCount, 0);
+        }
+        if (PyByteArray_Resize (output, job.resultCount * job.dim * job.view.itemsize) < 0) {
+            Py_DECREF (output);
+            return 0;
+        }
+        return MakeArray (output, job.isDouble ? "d" : "f", job.resultCount, job.dim);
+    }
+
+    //! \brief simplifies a sequence of polylines and returns a list of results
+    PyObject* SimplifyList (
+        const Params& params,
+        PyObject* polylines)
+    {
+        PyObject* seq = PySequence_Fast (polylines, "polylines must be a sequence");
+        if (!seq) {
+            return 0;
+        }
+        Py_ssize_t count = PySequence_Fast_GET_SIZE (seq);
+        std::vector <Job> jobs (count);
+        std::vector <PyObject*> outputs;
+        PyObject* list = 0;
+
+        bool ok = true;
+        for (Py_ssize_t j = 0; ok && j < count; ++j) {
+            ok = Acquire (PySequence_Fast_GET_ITEM (seq, j), jobs [j]);
+        }
+        if (ok && Allocate (jobs, outputs, params.indices != 0)) {
+            RunAll (params, jobs);
+            list = PyList_New (count);
+            for (Py_ssize_t j = 0; list && j < count; ++j) {
+                PyObject* result = MakeResult (jobs [j], outputs [j]);
+                outputs [j] = 0;
+                if (!result) {
+                    Py_CLEAR (list);
+                    break;
+                }
+                PyList_SET_ITEM (list, j, result);
+            }
+        }
+        for (size_t j = 0; j < outputs.size (); ++j) {
+            Py_XDECREF (outputs [j]);
+        }
+        Release (jobs);
+        Py_DECREF (seq);
+        return list;
+    }
+
+    //! \brief simplifies a single polyline
+    PyObject* SimplifyOne (
+        const Params& params,
+        PyObject* polyline)
+    {
+        PyObject* list = PyList_New (1);
+        if (!list) {
+            return 0;
+        }
+        Py_INCREF (polyline);
+        PyList_SET_ITEM (list, 0, polyline);
+        PyObject* results = SimplifyList (params, list);
+        Py_DECREF (list);
+        if (!results) {
+            return 0;
+        }
+        PyObject* result = PyList_GET_ITEM (results, 0);
+        Py_INCREF (result);
+        Py_DECREF (results);
+        return result;
+    }
+
+    /*!
+        \brief Simplifies a ragged array: all polylines stored back to back in a single buffer.
+
+        Polyline i consists of the points [offsets [i], offsets [i+1]). Returns a tuple with the
+        simplified points and their offsets; with indices=True the returned points are replaced
+        by indices into the original buffer.
+    */
+    PyObject* SimplifyRagged (
+        const Params& params,
+        PyObject* points,
+        PyObject* offsetsObj)
+    {
+        Job all;
+        if (!Acquire (points, all)) {
+            if (all.view.obj) {
+                PyBuffer_Release (&all.view);
+            }
+            return 0;
+        }
+        Py_buffer offsets;
+        if (PyObject_GetBuffer (offsetsObj, &offsets, PyBUF_STRIDES | PyBUF_FORMAT) < 0) {
+            PyBuffer_Release (&all.view);
+            return 0;
+        }
+        PyObject* result = 0;
+        std::vector <Job> jobs;
+        std::vector <Py_ssize_t> begins;
+        Py_ssize_t offsetCount = offsets.ndim == 1 ? offsets.shape [0] : 0;
+        bool ok = offsets.ndim == 1 && (IsFormat (offsets.format, 'q') || IsFormat (offsets.format, 'l') ||
+                                        IsFormat (offsets.format, 'n')) && offsets.itemsize == 8;
+        if (!ok) {
+            PyErr_SetString (PyExc_TypeError, "offsets must be a one dimensional int64 array");
+        }
+        for (Py_ssize_t i = 0; ok && i + 1 < offsetCount; ++i) {
+            long long begin, end;
+            std::memcpy (&begin, static_cast <const char*> (offsets.buf) + i * offsets.strides [0], 8);
+            std::memcpy (&end, static_cast <const char*> (offsets.buf) + (i + 1) * offsets.strides [0], 8);
+            if (begin < 0 || end < begin || end > all.pointCount) {
+                PyErr_SetString (PyExc_ValueError, "offsets must be ascending and within bounds");
+                ok = false;
+                break;
+            }
+            Job job = all;
+            std::memset (&job.view, 0, sizeof (job.view));
+            job.view.itemsize = all.view.itemsize;
+            job.data = all.data + begin * all.strides [0];
+            job.pointCount = static_cast <Py_ssize_t> (end - begin);
+            jobs.push_back (job);
+            begins.push_back (static_cast <Py_ssize_t> (begin));
+        }
+        // all simplifications are written back to back into a single output buffer
+        PyObject* output = 0;
+        PyObject* indexOutput = 0;
+        if (ok) {
+            if (params.indices) {
+                indexOutput = PyByteArray_FromStringAndSize (0, all.pointCount * sizeof (Py_ssize_t));
+            }
+            else {
+                output = PyByteArray_FromStringAndSize (0, all.pointCount * all.dim * all.view.itemsize);
+            }
+            ok = output || indexOutput;
+        }
+        if (ok) {
+            char* out = output ? PyByteArray_AS_STRING (output) : 0;
+            Py_ssize_t* idx = indexOutput
+                              ? reinterpret_cast <Py_ssize_t*> (PyByteArray_AS_STRING (indexOutput))
+                              : 0;
+            Py_ssize_t total = 0;
+            std::vector <long long> resultOffsets (1, 0);
+
+            Py_BEGIN_ALLOW_THREADS
+            for (size_t j = 0; j < jobs.size (); ++j) {
+                jobs [j].output = out ? out + total * all.dim * all.view.itemsize : 0;
+                jobs [j].indices = idx ? idx + total : 0;
+                Run (params, jobs [j]);
+                if (idx) {
+                    for (Py_ssize_t k = 0; k < jobs [j].resultCount; ++k) {
+                        idx [total + k] += begins [j];
+                    }
+                }
+                total += jobs [j].resultCount;
+                resultOffsets.push_back (total);
+            }
+            Py_END_ALLOW_THREADS
+
+            PyObject* offsetBytes = PyByteArray_FromStringAndSize (
+                reinterpret_cast <const char*> (&resultOffsets [0]),
+                resultOffsets.size () * sizeof (long long));
+            PyObject* values = 0;
+            if (indexOutput) {
+                if (PyByteArray_Resize (indexOutput, total * sizeof (Py_ssize_t)) == 0) {
+                    values = MakeArray (indexOutput, "n", total, 0);
+                }
+                else {
+                    Py_DECREF (indexOutput);
+                }
+                indexOutput = 0;
+            }
+            else {
+                if (PyByteArray_Resize (output, total * all.dim * all.view.itemsize) == 0) {
+                    values = MakeArray (output, all.isDouble ? "d" : "f", total, all.dim);
+                }
+                else {
+                    Py_DECREF (output);
+                }
+                output = 0;
+            }
+            PyObject* newOffsets = offsetBytes
+                                   ? MakeArray (offsetBytes, "q", resultOffsets.size (), 0)
+                                   : 0;
+            if (values && newOffsets) {
+                result = PyTuple_Pack (2, values, newOffsets);
+            }
+            Py_XDECREF (values);
+            Py_XDECREF (newOffsets);
+        }
+        Py_XDECREF (output);
+        Py_XDECREF (indexOutput);
+        PyBuffer_Release (&offsets);
+        PyBuffer_Release (&all.view);
+        return result;
+    }
+
+    //! \brief maps an algorithm name onto its identifier
+    bool ParseAlgorithm (
+        const char* name,
+        Algorithm& algorithm)
+    {
+        static const struct { const char* name; Algorithm algorithm; } table [] = {
+            { "np",  NTH_POINT },
+            { "rd",  RADIAL_DISTANCE },
+            { "pd",  PERPENDICULAR_DISTANCE },
+            { "rw",  REUMANN_WITKAM },
+            { "op",  OPHEIM },
+            { "la",  LANG },
+            { "dp",  DOUGLAS_PEUCKER },
+            { "dpn", DOUGLAS_PEUCKER_N }
+        };
+        for (size_t i = 0; i < sizeof (table) / sizeof (table [0]); ++i) {
+            if (std::strcmp (name, table [i].name) == 0) {
+                algorithm = table [i].algorithm;
+                return true;
+            }
+        }
+        PyErr_Format (PyExc_ValueError, "unknown algorithm '%s'", name);
+        return false;
+    }
+
+    //! \brief parses the keyword arguments shared by the batch functions
+    bool ParseBatchParams (
+        const char* algorithm,
+        double tol,
+        double min_tol,
+        double max_tol,
+        unsigned n,
+        unsigned repeat,
+        unsigned look_ahead,
+        unsigned count,
+        int indices,
+        Params& params)
+    {
+        if (!ParseAlgorithm (algorithm, params.algorithm)) {
+            return false;
+        }
+        params.indices = indices;
+        switch (params.algorithm) {
+        case NTH_POINT:                 params.n = n; break;
+        case PERPENDICULAR_DISTANCE:    params.tol = tol; params.n = repeat; break;
+        case OPHEIM:                    params.tol = min_tol; params.max_tol = max_tol; break;
+        case LANG:                      params.tol = tol; params.n = look_ahead; break;
+        case DOUGLAS_PEUCKER_N:         params.n = count; break;
+        default:                        params.tol = tol; break;
+        }
+        return true;
+    }
+}
+
+
+extern "C"
+{
+    static PyObject* psimpl_nth_point (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "n", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = NTH_POINT;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "OI|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.n, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_radial_distance (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "tol", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = RADIAL_DISTANCE;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "Od|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.tol, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_perpendicular_distance (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "tol", "repeat", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = PERPENDICULAR_DISTANCE;
+        params.n = 1;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "Od|Ip", const_cast <char**> (kwlist),
+                                          &polyline, &params.tol, &params.n, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_reumann_witkam (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "tol", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = REUMANN_WITKAM;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "Od|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.tol, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_opheim (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "min_tol", "max_tol", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = OPHEIM;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "Odd|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.tol, &params.max_tol, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_lang (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "tol", "look_ahead", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = LANG;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "OdI|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.tol, &params.n, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_douglas_peucker (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "tol", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = DOUGLAS_PEUCKER;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "Od|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.tol, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_douglas_peucker_n (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polyline", "count", "indices", 0 };
+        PyObject* polyline;
+        Params params;
+        params.algorithm = DOUGLAS_PEUCKER_N;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "OI|p", const_cast <char**> (kwlist),
+                                          &polyline, &params.n, &params.indices)) {
+            return 0;
+        }
+        return SimplifyOne (params, polyline);
+    }
+
+    static PyObject* psimpl_simplify_list (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "polylines", "algorithm", "tol", "min_tol", "max_tol", "n",
+                                         "repeat", "look_ahead", "count", "indices", 0 };
+        PyObject* polylines;
+        const char* algorithm;
+        double tol = 0, min_tol = 0, max_tol = 0;
+        unsigned n = 0, repeat = 1, look_ahead = 0, count = 0;
+        int indices = 0;
+        Params params;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "Os|$dddIIIIp", const_cast <char**> (kwlist),
+                                          &polylines, &algorithm, &tol, &min_tol, &max_tol, &n,
+                                          &repeat, &look_ahead, &count, &indices) ||
+            !ParseBatchParams (algorithm, tol, min_tol, max_tol, n, repeat, look_ahead, count,
+                               indices, params))
+        {
+            return 0;
+        }
+        return SimplifyList (params, polylines);
+    }
+
+    static PyObject* psimpl_simplify_ragged (PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* kwlist [] = { "points", "offsets", "algorithm", "tol", "min_tol", "max_tol",
+                                         "n", "repeat", "look_ahead", "count", "indices", 0 };
+        PyObject* points;
+        PyObject* offsets;
+        const char* algorithm;
+        double tol = 0, min_tol = 0, max_tol = 0;
+        unsigned n = 0, repeat = 1, look_ahead = 0, count = 0;
+        int indices = 0;
+        Params params;
+        if (!PyArg_ParseTupleAndKeywords (args, kwargs, "OOs|$dddIIIIp", const_cast <char**> (kwlist),
+                                          &points, &offsets, &algorithm, &tol, &min_tol, &max_tol,
+                                          &n, &repeat, &look_ahead, &count, &indices) ||
+            !ParseBatchParams (algorithm, tol, min_tol, max_tol, n, repeat, look_ahead, count,
+                               indices, params))
+        {
+            return 0;
+        }
+        return SimplifyRagged (params, points, offsets);
+    }
+
+    static PyMethodDef psimpl_methods [] = {
+        { "nth_point", (PyCFunction) psimpl_nth_point, METH_VARARGS | METH_KEYWORDS,
+          "nth_point(polyline, n, indices=False)\n\nKeeps the first, last and each nth point." },
+        { "radial_distance", (PyCFunction) psimpl_radial_distance, METH_VARARGS | METH_KEYWORDS,
+          "radial_distance(polyline, tol, indices=False)\n\nRemoves successive points that are clustered together." },
+        { "perpendicular_distance", (PyCFunction) psimpl_perpendicular_distance, METH_VARARGS | METH_KEYWORDS,
+          "perpendicular_distance(polyline, tol, repeat=1, indices=False)\n\nRepeatedly applies the perpendicular distance routine." },
+        { "reumann_witkam", (PyCFunction) psimpl_reumann_witkam, METH_VARARGS | METH_KEYWORDS,
+          "reumann_witkam(polyline, tol, indices=False)\n\nReumann-Witkam simplification." },
+        { "opheim", (PyCFunction) psimpl_opheim, METH_VARARGS | METH_KEYWORDS,
+          "opheim(polyline, min_tol, max_tol, indices=False)\n\nOpheim simplification." },
+        { "lang", (PyCFunction) psimpl_lang, METH_VARARGS | METH_KEYWORDS,
+          "lang(polyline, tol, look_ahead, indices=False)\n\nLang simplification." },
+        { "douglas_peucker", (PyCFunction) psimpl_douglas_peucker, METH_VARARGS | METH_KEYWORDS,
+          "douglas_peucker(polyline, tol, indices=False)\n\nDouglas-Peucker simplification." },
+        { "douglas_peucker_n", (PyCFunction) psimpl_douglas_peucker_n, METH_VARARGS | METH_KEYWORDS,
+          "douglas_peucker_n(polyline, count, indices=False)\n\nDouglas-Peucker variant that keeps count points." },
+        { "simplify_list", (PyCFunction) psimpl_simplify_list, METH_VARARGS | METH_KEYWORDS,
+          "simplify_list(polylines, algorithm, *, tol, min_tol, max_tol, n, repeat, look_ahead, count, indices=False)\n\n"
+          "Simplifies each polyline of a sequence; algorithm is one of np, rd, pd, rw, op, la, dp, dpn." },
+        { "simplify_ragged", (PyCFunction) psimpl_simplify_ragged, METH_VARARGS | METH_KEYWORDS,
+          "simplify_ragged(points, offsets, algorithm, *, tol, min_tol, max_tol, n, repeat, look_ahead, count, indices=False)\n\n"
+          "Simplifies the polylines points[offsets[i]:offsets[i+1]] and returns (points, offsets)." },
+        { 0, 0, 0, 0 }
+    };
+
+    static struct PyModuleDef psimpl_module = {
+        PyModuleDef_HEAD_INIT,
+        "psimpl",
+        "psimpl - generic n-dimensional polyline simplification",
+        -1,
+        psimpl_methods
+    };
+
+    PyMODINIT_FUNC PyInit_psimpl (void) {
+        PyObject* numpy = PyImport_ImportModule ("numpy");
+        if (numpy) {
+            sAsArray = PyObject_GetAttrString (numpy, "asarray");
+            Py_DECREF (numpy);
+        }
+        PyErr_Clear ();
+        return PyModule_Create (&psimpl_module);
+    }
+}
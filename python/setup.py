@@ -0,0 +1,18 @@
+# -------------------------------------------------
+# Python extension module for psimpl
+#   python setup.py build_ext --inplace
+# -------------------------------------------------
+from setuptools import setup, Extension
+
+setup(
+    name='psimpl',
+    version='7',
+    description='generic n-dimensional polyline simplification',
+    license='MPL 1.1',
+    ext_modules=[
+        Extension('psimpl',
+                  sources=['psimplmodule.cpp'],
+                  depends=['../lib/psimpl.h'],
+                  language='c++'),
+    ],
+)
@@ -0,0 +1,128 @@
+# -------------------------------------------------
+# Tests for the psimpl Python extension module
+#   python setup.py build_ext --inplace
+#   python -m unittest test_psimpl
+# -------------------------------------------------
+import array
+import math
+import random
+import unittest
+
+import psimpl
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+
+def polyline(points, format='d'):
+    """Returns a contiguous (n, dim) buffer holding the given points."""
+    dim = len(points[0]) if points else 2
+    flat = array.array(format, [c for point in points for c in point])
+    return memoryview(flat).cast('B').cast(format, (len(points), dim))
+
+
+def walk(count, seed, dim=2):
+    rng = random.Random(seed)
+    points, current = [], [0.0] * dim
+    for _ in range(count):
+        current = [c + rng.uniform(-1.0, 1.0) for c in current]
+        points.append(tuple(current))
+    return points
+
+
+def rows(result):
+    return [tuple(row) for row in result.tolist()]
+
+
+# each algorithm with parameters that remove a fair amount of points
+ALGORITHMS = [
+    ('np', lambda p, **kw: psimpl.nth_point(p, 3, **kw)),
+    ('rd', lambda p, **kw: psimpl.radial_distance(p, 1.5, **kw)),
+    ('pd', lambda p, **kw: psimpl.perpendicular_distance(p, 1.0, **kw)),
+    ('pd repeat', lambda p, **kw: psimpl.perpendicular_distance(p, 1.0, repeat=5, **kw)),
+    ('rw', lambda p, **kw: psimpl.reumann_witkam(p, 1.0, **kw)),
+    ('op', lambda p, **kw: psimpl.opheim(p, 1.0, 5.0, **kw)),
+    ('la', lambda p, **kw: psimpl.lang(p, 1.0, 8, **kw)),
+    ('dp', lambda p, **kw: psimpl.douglas_peucker(p, 1.0, **kw)),
+    ('dpn', lambda p, **kw: psimpl.douglas_peucker_n(p, 20, **kw)),
+]
+
+
+class TestIndices(unittest.TestCase):
+
+    def check(self, points, buffer=None):
+        """Verifies that the indices select exactly the simplified points."""
+        buffer = polyline(points) if buffer is None else buffer
+        for name, simplify in ALGORITHMS:
+            with self.subTest(algorithm=name):
+                simplified = rows(simplify(buffer))
+                indices = simplify(buffer, indices=True).tolist()
+                self.assertEqual(indices, sorted(set(indices)))
+                self.assertTrue(all(0 <= i < len(points) for i in indices))
+                selected = [points[i] for i in indices]
+                self.assertEqual(len(selected), len(simplified))
+                for expected, actual in zip(selected, simplified):
+                    self.assertTrue(all(e == a or (math.isnan(e) and math.isnan(a))
+                                        for e, a in zip(expected, actual)))
+
+    def test_walk(self):
+        for seed in range(3):
+            self.check(walk(200, seed))
+            self.check(walk(200, seed, dim=3))
+
+    def test_repeated_vertices(self):
+        points = [(0.0, 0.0), (1.0, 1.0), (0.0, 0.0), (1.0, 1.0), (2.0, 0.0)]
+        self.assertEqual(psimpl.nth_point(polyline(points), 2, indices=True).tolist(), [0, 2, 4])
+        back_and_forth = [(float(i % 4), float(i % 3)) for i in range(120)]
+        self.check(back_and_forth)
+
+    def test_nan(self):
+        points = [(0.0, 0.0), (1.0, 0.0), (float('nan'), 0.0), (3.0, 0.0), (4.0, 0.0)]
+        for name, simplify in ALGORITHMS:
+            with self.subTest(algorithm=name):
+                indices = simplify(polyline(points), indices=True).tolist()
+                self.assertTrue(all(0 <= i < len(points) for i in indices))
+                self.assertEqual(indices, sorted(set(indices)))
+        self.check(points)
+
+    def test_invalid_input(self):
+        points = walk(10, 1)
+        self.assertEqual(psimpl.douglas_peucker(polyline(points), 0.0, indices=True).tolist(),
+                         list(range(10)))
+        self.assertEqual(psimpl.douglas_peucker_n(polyline(points), 50, indices=True).tolist(),
+                         list(range(10)))
+        self.assertEqual(psimpl.perpendicular_distance(polyline(points), 1.0, repeat=0,
+                                                       indices=True).tolist(), list(range(10)))
+        if numpy is not None:
+            empty = numpy.empty((0, 2))
+            self.assertEqual(psimpl.radial_distance(empty, 1.0, indices=True).shape, (0,))
+            self.assertEqual(psimpl.radial_distance(empty, 1.0).shape, (0, 2))
+            self.assertEqual(psimpl.radial_distance(empty, 1.0, indices=True).dtype, numpy.intp)
+
+    @unittest.skipIf(numpy is None, 'requires numpy')
+    def test_strided(self):
+        points = numpy.array(walk(400, 5))
+        for view in (points[::2], numpy.asfortranarray(points), points.astype(numpy.float32)[1::3]):
+            expected = [tuple(p) for p in view.tolist()]
+            self.check(expected, view)
+
+    @unittest.skipIf(numpy is None, 'requires numpy')
+    def test_ragged(self):
+        points = numpy.array(walk(300, 7))
+        offsets = numpy.array([0, 100, 100, 103, 300], dtype=numpy.int64)
+        simplified, simplifiedOffsets = psimpl.simplify_ragged(points, offsets, 'dp', tol=1.0)
+        indices, indexOffsets = psimpl.simplify_ragged(points, offsets, 'dp', tol=1.0, indices=True)
+        self.assertEqual(simplifiedOffsets.tolist(), indexOffsets.tolist())
+        self.assertTrue((points[indices] == simplified).all())
+        self.assertEqual(indices.dtype, numpy.intp)
+        for i in range(len(offsets) - 1):
+            part = indices[indexOffsets[i]:indexOffsets[i + 1]]
+            self.assertTrue(all(offsets[i] <= j < offsets[i + 1] for j in part))
+            expected = psimpl.douglas_peucker(points[offsets[i]:offsets[i + 1]], 1.0, indices=True)
+            self.assertEqual((part - offsets[i]).tolist(), expected.tolist())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,349 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "TestAsync.h"
+#include "generators.h"
+#include "../lib/psimpl_async.h"
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        typedef std::vector <double>::const_iterator iterator;
+        typedef std::back_insert_iterator <std::vector <double> > output;
+
+        // executor that queues tasks until they are run explicitly
+        class ManualExecutor : public Executor
+        {
+        public:
+            void Execute (std::function <void ()> task) {
+                std::lock_guard <std::mutex> lock (mMutex);
+                mTasks.push_back (task);
+            }
+
+            // runs all queued tasks on the calling thread, returns the number of tasks
+            std::size_t Run () {
+                std::vector <std::function <void ()> > tasks;
+                {
+                    std::lock_guard <std::mutex> lock (mMutex);
+                    tasks.swap (mTasks);
+                }
+                for (std::size_t t = 0; t < tasks.size (); ++t) {
+                    tasks [t] ();
+                }
+                return tasks.size ();
+            }
+
+            std::mutex mMutex;                              //!< guards mTasks
+            std::vector <std::function <void ()> > mTasks;  //!< queued tasks
+        };
+
+        // executor that counts tasks, and runs them on a thread pool
+        class CountingExecutor : public Executor
+        {
+        public:
+            CountingExecutor () : mPool (2), mTasks (0) {}
+
+            void Execute (std::function <void ()> task) {
+                ++mTasks;
+                mPool.Execute (task);
+            }
+
+            ThreadPool mPool;               //!< runs the tasks
+            std::atomic <unsigned> mTasks;  //!< number of tasks
+        };
+
+        // simplifies a polyline using douglas-peucker
+        struct DouglasPeucker {
+            void operator () (iterator first, iterator last, output result) const {
+                simplify_douglas_peucker <2> (first, last, 5.0, result);
+            }
+        };
+    }
+
+    TestAsync::TestAsync () {
+        TEST_RUN("thread pool", TestThreadPool ());
+        TEST_RUN("parallel for", TestParallelFor ());
+        TEST_RUN("submit", TestSubmit ());
+        TEST_RUN("simplify", TestSimplify ());
+        TEST_RUN("post", TestPost ());
+        TEST_RUN("batching", TestBatching ());
+        TEST_RUN("back-pressure", TestBackPressure ());
+        TEST_RUN("exceptions", TestExceptions ());
+    }
+
+    // all tasks run before the pool is destroyed
+    void TestAsync::TestThreadPool () {
+        std::atomic <unsigned> count (0);
+        {
+            ThreadPool pool (4);
+            VERIFY_TRUE(pool.thread_count () == 4);
+            for (unsigned t = 0; t < 1000; ++t) {
+                pool.Execute ([&count] { ++count; });
+            }
+        }
+        VERIFY_TRUE(count == 1000);
+
+        ThreadPool pool;
+        VERIFY_TRUE(pool.thread_count () >= 1);
+    }
+
+    // each index is visited once, and the first exception reaches the caller
+    void TestAsync::TestParallelFor () {
+        VERIFY_TRUE(ParallelFor (3).thread_count () == 3);
+        VERIFY_TRUE(ParallelFor ().thread_count () >= 1);
+
+        ThreadPool pool (3);
+        ParallelFor loops [] = { ParallelFor (4), ParallelFor (4, &pool), ParallelFor (1) };
+        for (unsigned l = 0; l < 3; ++l) {
+            std::vector <std::atomic <unsigned> > visits (1000);
+            loops [l] (visits.size (), [&visits] (std::size_t i) { ++visits [i]; });
+            bool once = true;
+            for (std::size_t i = 0; i < visits.size (); ++i) {
+                once = once && visits [i] == 1;
+            }
+            VERIFY_TRUE(once);
+
+            bool thrown = false;
+            try {
+                loops [l] (1000, [] (std::size_t i) {
+                    if (i == 10) {
+                        throw std::runtime_error ("parallel");
+                    }
+                });
+            }
+            catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            VERIFY_TRUE(thrown);
+        }
+
+        // an executor that never runs its tasks leaves the loop to the calling thread
+        ManualExecutor executor;
+        unsigned count = 0;
+        ParallelFor (4, &executor) (100, [&count] (std::size_t) { ++count; });
+        VERIFY_TRUE(count == 100);
+        VERIFY_TRUE(executor.Run () == 3);
+    }
+
+    // futures hold the results of the synchronous routines
+    void TestAsync::TestSubmit () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (7), 20000);
+        std::vector <double> dp, rw;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (dp));
+        simplify_reumann_witkam <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (rw));
+
+        AsyncSimplifier async (2);
+        std::future <std::vector <double> > futureDp =
+            async.Simplify (polyline.cbegin (), polyline.cend (), DouglasPeucker ());
+        std::future <std::vector <double> > futureRw = async.Submit ([&polyline] {
+            std::vector <double> result;
+            simplify_reumann_witkam <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+            return result;
+        });
+        std::future <std::size_t> futureSize = async.Submit ([&polyline] { return polyline.size (); }, 10);
+
+        VERIFY_TRUE(futureDp.get () == dp);
+        VERIFY_TRUE(futureRw.get () == rw);
+        // batched jobs run after a flush
+        async.Flush ();
+        VERIFY_TRUE(futureSize.get () == polyline.size ());
+        async.Wait ();
+        VERIFY_TRUE(async.pending_count () == 0);
+    }
+
+    // small simplifications are not batched, unless a cost is passed
+    void TestAsync::TestSimplify () {
+        std::vector <double> polyline = Generate <2, double> (WalkGenerator <2> (5), 50);
+        std::vector <double> dp;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (dp));
+
+        AsyncSimplifier async (2);
+        std::future <std::vector <double> > future =
+            async.Simplify (polyline.cbegin (), polyline.cend (), DouglasPeucker ());
+        VERIFY_TRUE(future.wait_for (std::chrono::seconds (10)) == std::future_status::ready);
+        VERIFY_TRUE(future.get () == dp);
+
+        ManualExecutor executor;
+        AsyncSimplifier batched (executor, 0, 1000);
+        future = batched.Simplify (polyline.cbegin (), polyline.cend (), DouglasPeucker (), polyline.size ());
+        VERIFY_TRUE(executor.Run () == 0);
+        batched.Flush ();
+        VERIFY_TRUE(executor.Run () == 1);
+        VERIFY_TRUE(future.get () == dp);
+    }
+
+    // callbacks receive the results of many tiny jobs
+    void TestAsync::TestPost () {
+        std::vector <double> polyline = Generate <2, double> (WalkGenerator <2> (3), 100);
+        std::vector <double> expected;
+        simplify_radial_distance <2> (polyline.begin (), polyline.end (), 2.0, std::back_inserter (expected));
+
+        std::atomic <unsigned> matches (0);
+        {
+            AsyncSimplifier async (4, 64, 4096);
+            for (unsigned j = 0; j < 10000; ++j) {
+                async.Post (
+                    [&polyline] {
+                        std::vector <double> result;
+                        simplify_radial_distance <2> (polyline.begin (), polyline.end (), 2.0,
+                                                      std::back_inserter (result));
+                        return result;
+                    },
+                    [&matches, &expected] (const std::vector <double>& result) {
+                        matches += result == expected ? 1 : 0;
+                    },
+                    polyline.size ());
+            }
+            async.Wait ();
+            VERIFY_TRUE(matches == 10000);
+            VERIFY_TRUE(async.pending_count () == 0);
+        }
+    }
+
+    // small jobs are handed to the executor in batches
+    void TestAsync::TestBatching () {
+        std::atomic <unsigned> count (0);
+        CountingExecutor executor;
+        {
+            AsyncSimplifier async (executor, 0, 1000);
+            for (unsigned j = 0; j < 10000; ++j) {
+                async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 10);
+            }
+        }
+        VERIFY_TRUE(count == 10000);
+        VERIFY_TRUE(executor.mTasks == 100);
+
+        // large jobs and unbatched jobs are not batched
+        executor.mTasks = 0;
+        {
+            AsyncSimplifier async (executor, 0, 1000);
+            async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 1000);
+            async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; });
+            async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 10);
+            VERIFY_TRUE(executor.mTasks == 2);
+        }
+        VERIFY_TRUE(count == 10003);
+        VERIFY_TRUE(executor.mTasks == 3);
+
+        // batching disabled
+        executor.mTasks = 0;
+        {
+            AsyncSimplifier async (executor, 0, 0);
+            for (unsigned j = 0; j < 10; ++j) {
+                async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 0);
+            }
+        }
+        VERIFY_TRUE(count == 10013);
+        VERIFY_TRUE(executor.mTasks == 10);
+    }
+
+    // try variants fail while the maximum number of incomplete jobs is reached
+    void TestAsync::TestBackPressure () {
+        ManualExecutor executor;
+        unsigned count = 0;
+        AsyncSimplifier async (executor, 4, 100);
+        for (unsigned j = 0; j < 4; ++j) {
+            VERIFY_TRUE(async.TryPost ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 10));
+        }
+        VERIFY_TRUE(async.pending_count () == 4);
+        VERIFY_FALSE(async.TryPost ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 10));
+        std::future <unsigned> future;
+        VERIFY_FALSE(async.TrySubmit ([] { return 1u; }, future));
+        VERIFY_FALSE(future.valid ());
+
+        // the batch is not handed over until flushed
+        VERIFY_TRUE(executor.Run () == 0);
+        async.Flush ();
+        VERIFY_TRUE(executor.Run () == 1);
+        VERIFY_TRUE(count == 4);
+        VERIFY_TRUE(async.pending_count () == 0);
+
+        VERIFY_TRUE(async.TrySubmit ([] { return 1u; }, future));
+        VERIFY_TRUE(future.valid ());
+        VERIFY_TRUE(executor.Run () == 1);
+        VERIFY_TRUE(future.get () == 1);
+
+        // a blocking submit flushes the batch, and waits until a job completes
+        for (unsigned j = 0; j < 4; ++j) {
+            async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 10);
+        }
+        std::thread runner ([&executor] {
+            while (executor.Run () == 0) {
+                std::this_thread::yield ();
+            }
+        });
+        async.Post ([] { return 1u; }, [&count] (unsigned c) { count += c; }, 10);
+        runner.join ();
+        async.Flush ();
+        executor.Run ();
+        VERIFY_TRUE(count == 9);
+        VERIFY_TRUE(async.pending_count () == 0);
+    }
+
+    // exceptions propagate through futures
+    void TestAsync::TestExceptions () {
+        AsyncSimplifier async (1, 0, 100);
+        std::future <int> single = async.Submit ([] () -> int { throw std::runtime_error ("single"); });
+        std::future <int> batched = async.Submit ([] () -> int { throw std::runtime_error ("batched"); }, 1);
+        std::future <int> next = async.Submit ([] { return 42; }, 1);
+        async.Wait ();
+
+        bool thrown = false;
+        try {
+            single.get ();
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        VERIFY_TRUE(thrown);
+        thrown = false;
+        try {
+            batched.get ();
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        VERIFY_TRUE(thrown);
+        // the remainder of the batch still runs
+        VERIFY_TRUE(next.get () == 42);
+    }
+}}
@@ -0,0 +1,228 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "TestBinary.h"
+#include "helper.h"
+#include "../lib/psimpl_binary.h"
+#include <vector>
+#include <cstdio>
+
+
+namespace psimpl {
+    namespace test
+{
+    static const char* binary_file = "psimpl_test_binary.bin";
+
+    TestBinary::TestBinary () {
+        TEST_RUN("header", TestHeader ());
+        TEST_RUN("round trip", TestRoundTrip ());
+        TEST_RUN("empty features", TestEmptyFeatures ());
+        TEST_RUN("simplification", TestSimplification ());
+        TEST_RUN("invalid file", TestInvalidFile ());
+    }
+
+    void TestBinary::TestHeader () {
+        VERIFY_TRUE(sizeof (util::binary_header) == util::binary_header::SIZE);
+    }
+
+    // features are read back unchanged, and their coordinates are aligned
+    void TestBinary::TestRoundTrip () {
+        const unsigned DIM = 3;
+
+        std::vector <double> a = RandomWalk <double, DIM> (100, 1, true);
+        std::vector <double> b = RandomWalk <double, DIM> (7, 2, false);
+        {
+            BinaryPolylineWriter <double> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            std::copy (a.begin (), a.end (), writer.feature ());
+            std::copy (b.begin (), b.end (), writer.feature ());
+            VERIFY_TRUE(writer.close ());
+        }
+        BinaryPolylineReader <double> reader;
+        ASSERT_TRUE(reader.open (binary_file));
+        VERIFY_TRUE(reader.dimension () == DIM);
+        VERIFY_TRUE(reader.feature_count () == 2);
+        VERIFY_TRUE(reader.point_count () == 107);
+        VERIFY_TRUE(std::vector <double> (reader.first (0), reader.last (0)) == a);
+        VERIFY_TRUE(std::vector <double> (reader.first (1), reader.last (1)) == b);
+        VERIFY_TRUE(reinterpret_cast <std::size_t> (reader.first (0)) % util::binary_header::SIZE == 0);
+
+        // the value type must match
+        BinaryPolylineReader <float> floatReader;
+        VERIFY_TRUE(!floatReader.open (binary_file));
+        VERIFY_TRUE(!floatReader.is_open ());
+
+        reader.close ();
+        std::remove (binary_file);
+    }
+
+    void TestBinary::TestEmptyFeatures () {
+        const unsigned DIM = 2;
+
+        std::vector <int> a;
+        std::generate_n (std::back_inserter (a), 5*DIM, SawToothLine <int, DIM> ());
+        {
+            BinaryPolylineWriter <int> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            writer.feature ();
+            std::copy (a.begin (), a.end (), writer.feature ());
+            writer.feature ();
+            VERIFY_TRUE(writer.close ());
+        }
+        BinaryPolylineReader <int> reader;
+        ASSERT_TRUE(reader.open (binary_file));
+        VERIFY_TRUE(reader.feature_count () == 3);
+        VERIFY_TRUE(reader.first (0) == reader.last (0));
+        VERIFY_TRUE(std::vector <int> (reader.first (1), reader.last (1)) == a);
+        VERIFY_TRUE(reader.first (2) == reader.last (2));
+
+        reader.close ();
+        std::remove (binary_file);
+
+        // no features at all
+        {
+            BinaryPolylineWriter <int> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            VERIFY_TRUE(writer.close ());
+        }
+        ASSERT_TRUE(reader.open (binary_file));
+        VERIFY_TRUE(reader.feature_count () == 0);
+        VERIFY_TRUE(reader.point_count () == 0);
+
+        reader.close ();
+        std::remove (binary_file);
+    }
+
+    // pointer ranges plug into the simplification routines, which stream into a writer
+    void TestBinary::TestSimplification () {
+        const unsigned DIM = 2;
+        const float tol = 1.f;
+        const char* simplified_file = "psimpl_test_binary_simplified.bin";
+
+        std::vector <float> polyline = RandomWalk <float, DIM> (1000, 3, true);
+        {
+            BinaryPolylineWriter <float> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            std::copy (polyline.begin (), polyline.end (), writer.feature ());
+            VERIFY_TRUE(writer.close ());
+        }
+        std::vector <float> expected;
+        psimpl::simplify_douglas_peucker <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (expected));
+
+        BinaryPolylineReader <float> reader;
+        ASSERT_TRUE(reader.open (binary_file));
+        {
+            BinaryPolylineWriter <float> writer;
+            ASSERT_TRUE(writer.open (simplified_file, DIM));
+            psimpl::simplify_douglas_peucker <DIM> (
+                reader.first (0), reader.last (0), tol,
+                writer.feature ());
+            VERIFY_TRUE(writer.close ());
+        }
+        BinaryPolylineReader <float> simplified;
+        ASSERT_TRUE(simplified.open (simplified_file));
+        VERIFY_TRUE(std::vector <float> (simplified.first (0), simplified.last (0)) == expected);
+
+        reader.close ();
+        simplified.close ();
+        std::remove (binary_file);
+        std::remove (simplified_file);
+    }
+
+    void TestBinary::TestInvalidFile () {
+        const unsigned DIM = 2;
+
+        BinaryPolylineReader <float> reader;
+        std::remove (binary_file);
+        VERIFY_TRUE(!reader.open (binary_file));
+
+        // incomplete point
+        {
+            BinaryPolylineWriter <float> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            *writer.feature () = 1.f;
+            VERIFY_TRUE(!writer.close ());
+        }
+
+        // incomplete point in a feature that is followed by another feature
+        {
+            BinaryPolylineWriter <float> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            std::fill_n (writer.feature (), 3, 1.f);
+            std::fill_n (writer.feature (), 1, 1.f);
+            VERIFY_TRUE(!writer.close ());
+        }
+
+        // truncated file
+        {
+            BinaryPolylineWriter <float> writer;
+            ASSERT_TRUE(writer.open (binary_file, DIM));
+            std::vector <float> polyline = RandomWalk <float, DIM> (10, 4, true);
+            std::copy (polyline.begin (), polyline.end (), writer.feature ());
+            VERIFY_TRUE(writer.close ());
+        }
+        ASSERT_TRUE(reader.open (binary_file));
+        reader.close ();
+        std::vector <char> bytes;
+        {
+            std::FILE* file = std::fopen (binary_file, "rb");
+            ASSERT_TRUE(file);
+            int c;
+            while ((c = std::fgetc (file)) != EOF) {
+                bytes.push_back (static_cast <char> (c));
+            }
+            std::fclose (file);
+        }
+        {
+            std::FILE* file = std::fopen (binary_file, "wb");
+            ASSERT_TRUE(file);
+            std::fwrite (&bytes [0], 1, bytes.size () - 8, file);
+            std::fclose (file);
+        }
+        VERIFY_TRUE(!reader.open (binary_file));
+
+        // bad magic
+        bytes [0] = 'X';
+        {
+            std::FILE* file = std::fopen (binary_file, "wb");
+            ASSERT_TRUE(file);
+            std::fwrite (&bytes [0], 1, bytes.size (), file);
+            std::fclose (file);
+        }
+        VERIFY_TRUE(!reader.open (binary_file));
+        std::remove (binary_file);
+    }
+}}
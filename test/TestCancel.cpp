@@ -0,0 +1,285 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestCancel.h"
+#include "generators.h"
+#include "../lib/psimpl_cancel.h"
+#include <iterator>
+#include <list>
+#include <thread>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        typedef std::vector <double>::const_iterator iterator;
+        typedef std::back_insert_iterator <std::vector <double> > output;
+        typedef PolylineSimplification <2, iterator, output> Simplification;
+
+        // token that is cancelled from the nth check onwards
+        class CountdownToken : public CancellationToken
+        {
+        public:
+            CountdownToken (unsigned n) : mN (n), mChecks (0) {}
+
+            bool Cancelled () const { return mN <= ++mChecks; }
+
+            unsigned mN;                //!< number of the first check that cancels
+            mutable unsigned mChecks;   //!< number of checks so far
+        };
+
+        // determines if each point of the simplification is a point of the polyline, in order
+        bool IsSubsequence (const std::vector <double>& simplification, const std::vector <double>& polyline) {
+            std::size_t s = 0;
+            for (std::size_t p = 0; p < polyline.size () && s < simplification.size (); p += 2) {
+                if (polyline [p] == simplification [s] && polyline [p+1] == simplification [s+1]) {
+                    s += 2;
+                }
+            }
+            return s == simplification.size ();
+        }
+
+        // determines if a simplification keeps the first and last point of the polyline
+        bool KeepsEndPoints (const std::vector <double>& simplification, const std::vector <double>& polyline) {
+            return 4 <= simplification.size () &&
+                   std::equal (polyline.begin (), polyline.begin () + 2, simplification.begin ()) &&
+                   std::equal (polyline.end () - 2, polyline.end (), simplification.end () - 2);
+        }
+
+        // the simplification of a cancelled linear routine: a prefix of the full result, and the last point
+        bool IsTruncated (const std::vector <double>& truncated, const std::vector <double>& full,
+                          const std::vector <double>& polyline)
+        {
+            return KeepsEndPoints (truncated, polyline) && truncated.size () < full.size () &&
+                   std::equal (truncated.begin (), truncated.end () - 2, full.begin ());
+        }
+    }
+
+    TestCancel::TestCancel () {
+        TEST_RUN("not cancelled", TestNotCancelled ());
+        TEST_RUN("linear routines", TestLinearRoutines ());
+        TEST_RUN("douglas-peucker", TestDouglasPeucker ());
+        TEST_RUN("douglas-peucker n", TestDouglasPeuckerN ());
+        TEST_RUN("tokens", TestTokens ());
+        TEST_RUN("deadline", TestDeadline ());
+    }
+
+    // a token that is never cancelled does not change any simplification
+    void TestCancel::TestNotCancelled () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (7), 20000);
+        CountdownToken token (1000000);
+        Simplification ps (NoInstrumentation (), &token);
+
+        std::vector <double> expected, result;
+        simplify_radial_distance <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        ps.RadialDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_lang <2> (polyline.begin (), polyline.end (), 5.0, 16, std::back_inserter (expected));
+        ps.Lang (polyline.begin (), polyline.end (), 5.0, 16, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+        result.clear ();
+        ps.DouglasPeuckerAccelerated (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_douglas_peucker_n <2> (polyline.begin (), polyline.end (), 500, std::back_inserter (expected));
+        ps.DouglasPeuckerN (polyline.begin (), polyline.end (), 500, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        // checked at coarse granularity
+        VERIFY_TRUE(0 < token.mChecks && token.mChecks < 1000);
+    }
+
+    // stop after the first check, at CHECK_INTERVAL points
+    void TestCancel::TestLinearRoutines () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (7), 20000);
+        CancellationFlag flag;
+        flag.Cancel ();
+        Simplification full;
+        Simplification cancelled (NoInstrumentation (), &flag);
+
+        std::vector <double> expected, result;
+        full.RadialDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        cancelled.RadialDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(IsTruncated (result, expected, polyline));
+
+        expected.clear (); result.clear ();
+        full.PerpendicularDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        cancelled.PerpendicularDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(IsTruncated (result, expected, polyline));
+
+        expected.clear (); result.clear ();
+        full.ReumannWitkam (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        cancelled.ReumannWitkam (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(IsTruncated (result, expected, polyline));
+
+        expected.clear (); result.clear ();
+        full.Opheim (polyline.begin (), polyline.end (), 5.0, 20.0, std::back_inserter (expected));
+        cancelled.Opheim (polyline.begin (), polyline.end (), 5.0, 20.0, std::back_inserter (result));
+        VERIFY_TRUE(IsTruncated (result, expected, polyline));
+
+        // bidirectional iterators
+        std::list <double> list (polyline.begin (), polyline.end ());
+        PolylineSimplification <2, std::list <double>::const_iterator, output> listCancelled (
+            NoInstrumentation (), &flag);
+        expected.clear (); result.clear ();
+        full.Lang (polyline.begin (), polyline.end (), 5.0, 16, std::back_inserter (expected));
+        listCancelled.Lang (list.begin (), list.end (), 5.0, 16, std::back_inserter (result));
+        VERIFY_TRUE(IsTruncated (result, expected, polyline));
+
+        // too small to be checked
+        std::vector <double> small (polyline.begin (), polyline.begin () + 2000);
+        expected.clear (); result.clear ();
+        full.RadialDistance (small.begin (), small.end (), 5.0, std::back_inserter (expected));
+        cancelled.RadialDistance (small.begin (), small.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+    }
+
+    // the keys found so far are douglas-peucker keys
+    void TestCancel::TestDouglasPeucker () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (7), 20000);
+        std::vector <double> expected;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected),
+                                      PREFILTER_NONE);
+
+        std::size_t previous = 0;
+        const unsigned checks [] = { 1, 2, 5, 10 };
+        for (unsigned c = 0; c < 4; ++c) {
+            CountdownToken token (checks [c]);
+            Simplification ps (NoInstrumentation (), &token);
+            std::vector <double> result;
+            ps.DouglasPeucker (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result), PREFILTER_NONE);
+            VERIFY_TRUE(KeepsEndPoints (result, polyline));
+            VERIFY_TRUE(IsSubsequence (result, expected));
+            VERIFY_TRUE(previous < result.size () && result.size () < expected.size ());
+            previous = result.size ();
+        }
+
+        // with prefilter, the keys of the accelerated variant and the importance
+        CancellationFlag flag;
+        flag.Cancel ();
+        Simplification ps (NoInstrumentation (), &flag);
+        std::vector <double> result;
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(KeepsEndPoints (result, polyline));
+        VERIFY_TRUE(IsSubsequence (result, polyline));
+        result.clear ();
+        ps.DouglasPeuckerAccelerated (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(KeepsEndPoints (result, polyline));
+        VERIFY_TRUE(IsSubsequence (result, polyline));
+
+        PolylineSimplification <2, iterator, std::back_insert_iterator <std::vector <double> > > importancePs (
+            NoInstrumentation (), &flag);
+        std::vector <double> importance;
+        bool valid = false;
+        importancePs.ComputeDouglasPeuckerImportance2 (polyline.begin (), polyline.end (),
+            std::back_inserter (importance), &valid);
+        VERIFY_TRUE(valid && importance.size () == 20000);
+        VERIFY_TRUE(std::count (importance.begin (), importance.end (), 0.0) > 19000);
+    }
+
+    // the best simplification found so far
+    void TestCancel::TestDouglasPeuckerN () {
+        std::vector <double> polyline = Generate <2, double> (CoastlineGenerator <2> (20000, 3), 20000);
+
+        const unsigned checks [] = { 1, 2, 5, 10 };
+        for (unsigned c = 0; c < 4; ++c) {
+            CountdownToken token (checks [c]);
+            Simplification ps (NoInstrumentation (), &token);
+            std::vector <double> result;
+            ps.DouglasPeuckerN (polyline.begin (), polyline.end (), 5000, std::back_inserter (result));
+            ASSERT_TRUE(KeepsEndPoints (result, polyline));
+            VERIFY_TRUE(result.size () < 10000);
+
+            std::vector <double> expected;
+            simplify_douglas_peucker_n <2> (polyline.begin (), polyline.end (),
+                static_cast <unsigned> (result.size () / 2), std::back_inserter (expected));
+            VERIFY_TRUE(result == expected);
+        }
+    }
+
+    void TestCancel::TestTokens () {
+        CancellationFlag flag;
+        VERIFY_FALSE(flag.Cancelled ());
+        std::thread canceller (&CancellationFlag::Cancel, &flag);
+        canceller.join ();
+        VERIFY_TRUE(flag.Cancelled ());
+        flag.Reset ();
+        VERIFY_FALSE(flag.Cancelled ());
+
+        Deadline expired (Deadline::clock::duration::zero ());
+        VERIFY_TRUE(expired.Cancelled ());
+        VERIFY_TRUE(expired.Remaining () == Deadline::clock::duration::zero ());
+
+        Deadline later (std::chrono::hours (1), &flag);
+        VERIFY_FALSE(later.Cancelled ());
+        VERIFY_TRUE(std::chrono::minutes (59) < later.Remaining ());
+        flag.Cancel ();
+        VERIFY_TRUE(later.Cancelled ());
+
+        Deadline past (Deadline::clock::now () - std::chrono::seconds (1));
+        VERIFY_TRUE(past.Cancelled ());
+    }
+
+    // a pathological quadratic input stops shortly after the deadline
+    void TestCancel::TestDeadline () {
+        std::vector <double> polyline = Generate <2, double> (ZigZagGenerator <2> (100000), 100000);
+        Deadline::clock::time_point start = Deadline::clock::now ();
+        Deadline deadline (std::chrono::milliseconds (10));
+        Simplification ps (NoInstrumentation (), &deadline);
+
+        std::vector <double> result;
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 2.4, std::back_inserter (result));
+        VERIFY_TRUE(Deadline::clock::now () - start < std::chrono::milliseconds (500));
+        VERIFY_TRUE(KeepsEndPoints (result, polyline));
+        VERIFY_TRUE(result.size () < polyline.size ());
+
+        result.clear ();
+        Deadline deadlineN (std::chrono::milliseconds (10));
+        Simplification psN (NoInstrumentation (), &deadlineN);
+        start = Deadline::clock::now ();
+        psN.DouglasPeuckerN (polyline.begin (), polyline.end (), 99999, std::back_inserter (result));
+        VERIFY_TRUE(Deadline::clock::now () - start < std::chrono::milliseconds (500));
+        VERIFY_TRUE(KeepsEndPoints (result, polyline));
+    }
+}}
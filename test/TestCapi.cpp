@@ -0,0 +1,296 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+
+#include "TestCapi.h"
+#include "generators.h"
+#include "../capi/psimpl_c.h"
+#include "../lib/psimpl.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        //! \brief The C interface routines for one value type and dimension.
+        template <class T>
+        struct CapiRoutines
+        {
+            int (*np) (const T*, size_t, unsigned, T*, size_t*);
+            int (*rd) (const T*, size_t, T, T*, size_t*);
+            int (*pd) (const T*, size_t, T, unsigned, T*, size_t*);
+            int (*rw) (const T*, size_t, T, T*, size_t*);
+            int (*op) (const T*, size_t, T, T, T*, size_t*);
+            int (*la) (const T*, size_t, T, unsigned, T*, size_t*);
+            int (*dp) (const T*, size_t, T, T*, size_t*);
+            int (*dpn) (const T*, size_t, unsigned, T*, size_t*);
+            int (*error2) (const T*, size_t, const T*, size_t, T*, size_t*);
+            int (*stats) (const T*, size_t, const T*, size_t, psimpl_statistics*);
+        };
+
+        CapiRoutines <float> Float2d () {
+            CapiRoutines <float> c = {
+                psimpl_np_f32_2d, psimpl_rd_f32_2d, psimpl_pd_f32_2d, psimpl_rw_f32_2d, psimpl_op_f32_2d,
+                psimpl_la_f32_2d, psimpl_dp_f32_2d, psimpl_dpn_f32_2d, psimpl_pos_error2_f32_2d,
+                psimpl_pos_error_stats_f32_2d };
+            return c;
+        }
+
+        CapiRoutines <float> Float3d () {
+            CapiRoutines <float> c = {
+                psimpl_np_f32_3d, psimpl_rd_f32_3d, psimpl_pd_f32_3d, psimpl_rw_f32_3d, psimpl_op_f32_3d,
+                psimpl_la_f32_3d, psimpl_dp_f32_3d, psimpl_dpn_f32_3d, psimpl_pos_error2_f32_3d,
+                psimpl_pos_error_stats_f32_3d };
+            return c;
+        }
+
+        CapiRoutines <double> Double2d () {
+            CapiRoutines <double> c = {
+                psimpl_np_f64_2d, psimpl_rd_f64_2d, psimpl_pd_f64_2d, psimpl_rw_f64_2d, psimpl_op_f64_2d,
+                psimpl_la_f64_2d, psimpl_dp_f64_2d, psimpl_dpn_f64_2d, psimpl_pos_error2_f64_2d,
+                psimpl_pos_error_stats_f64_2d };
+            return c;
+        }
+
+        CapiRoutines <double> Double3d () {
+            CapiRoutines <double> c = {
+                psimpl_np_f64_3d, psimpl_rd_f64_3d, psimpl_pd_f64_3d, psimpl_rw_f64_3d, psimpl_op_f64_3d,
+                psimpl_la_f64_3d, psimpl_dp_f64_3d, psimpl_dpn_f64_3d, psimpl_pos_error2_f64_3d,
+                psimpl_pos_error_stats_f64_3d };
+            return c;
+        }
+
+        //! \brief Caller allocated output of exactly n vertices, followed by a guard vertex.
+        template <unsigned DIM, class T>
+        class Output
+        {
+        public:
+            explicit Output (size_t n) :
+                coords ((n + 1) * DIM, T (-12345)),
+                n (n),
+                count (0)
+            {}
+
+            T* data () {
+                return &coords [0];
+            }
+
+            //! \brief Checks the result of a routine against the template routine.
+            bool Equals (int status, const std::vector <T>& expected) const {
+                return status == PSIMPL_OK &&
+                       count * DIM == expected.size () &&
+                       std::equal (expected.begin (), expected.end (), coords.begin ()) &&
+                       Untouched ();
+            }
+
+            //! \brief Checks that nothing was written beyond n vertices.
+            bool Untouched () const {
+                for (unsigned d = 0; d < DIM; ++d) {
+                    if (coords [n * DIM + d] != T (-12345)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            std::vector <T> coords;
+            size_t n;
+            size_t count;           //!< receives out_n
+        };
+
+        //! \brief Compares each routine with its template routine.
+        template <unsigned DIM, class T>
+        void CompareRoutines (const CapiRoutines <T>& c) {
+            std::vector <T> polyline = Generate <DIM, T> (GpsGenerator <DIM> (5), 2000);
+            const T* coords = &polyline [0];
+            size_t n = polyline.size () / DIM;
+            T tol = 5;
+
+            {
+                std::vector <T> expected;
+                simplify_nth_point <DIM> (polyline.begin (), polyline.end (), 7, std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.np (coords, n, 7, out.data (), &out.count), expected));
+            }
+            {
+                std::vector <T> expected;
+                simplify_radial_distance <DIM> (polyline.begin (), polyline.end (), tol, std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.rd (coords, n, tol, out.data (), &out.count), expected));
+            }
+            {
+                std::vector <T> expected;
+                simplify_perpendicular_distance <DIM> (polyline.begin (), polyline.end (), tol, 3,
+                                                       std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.pd (coords, n, tol, 3, out.data (), &out.count), expected));
+            }
+            {
+                std::vector <T> expected;
+                simplify_reumann_witkam <DIM> (polyline.begin (), polyline.end (), tol, std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.rw (coords, n, tol, out.data (), &out.count), expected));
+            }
+            {
+                std::vector <T> expected;
+                simplify_opheim <DIM> (polyline.begin (), polyline.end (), tol, 4 * tol, std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.op (coords, n, tol, 4 * tol, out.data (), &out.count), expected));
+            }
+            {
+                std::vector <T> expected;
+                simplify_lang <DIM> (polyline.begin (), polyline.end (), tol, 8, std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.la (coords, n, tol, 8, out.data (), &out.count), expected));
+            }
+            std::vector <T> simplified;
+            {
+                simplify_douglas_peucker <DIM> (polyline.begin (), polyline.end (), tol,
+                                                std::back_inserter (simplified));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.dp (coords, n, tol, out.data (), &out.count), simplified));
+                VERIFY_TRUE(out.count < n);
+            }
+            {
+                std::vector <T> expected;
+                simplify_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), 100,
+                                                  std::back_inserter (expected));
+                Output <DIM, T> out (n);
+                VERIFY_TRUE(out.Equals (c.dpn (coords, n, 100, out.data (), &out.count), expected));
+                VERIFY_TRUE(out.count == 100);
+            }
+
+            // positional errors of the douglas-peucker simplification
+            size_t m = simplified.size () / DIM;
+            std::vector <T> expected;
+            compute_positional_errors2 <DIM> (polyline.begin (), polyline.end (),
+                                              simplified.begin (), simplified.end (),
+                                              std::back_inserter (expected));
+            std::vector <T> errors (n + 1, T (-1));
+            size_t errorCount = 0;
+            VERIFY_TRUE(c.error2 (coords, n, &simplified [0], m, &errors [0], &errorCount) == PSIMPL_OK);
+            VERIFY_TRUE(errorCount == n);
+            VERIFY_TRUE(std::equal (expected.begin (), expected.end (), errors.begin ()));
+            VERIFY_TRUE(errors [n] == T (-1));
+
+            math::Statistics stats = compute_positional_error_statistics <DIM> (
+                polyline.begin (), polyline.end (), simplified.begin (), simplified.end ());
+            psimpl_statistics cstats;
+            VERIFY_TRUE(c.stats (coords, n, &simplified [0], m, &cstats) == PSIMPL_OK);
+            VERIFY_TRUE(cstats.max == stats.max);
+            VERIFY_TRUE(cstats.sum == stats.sum);
+            VERIFY_TRUE(cstats.mean == stats.mean);
+            VERIFY_TRUE(cstats.std == stats.std);
+        }
+    }
+
+    TestCapi::TestCapi () {
+        TEST_RUN("f32 2d", TestFloat2d ());
+        TEST_RUN("f32 3d", TestFloat3d ());
+        TEST_RUN("f64 2d", TestDouble2d ());
+        TEST_RUN("f64 3d", TestDouble3d ());
+        TEST_RUN("null arguments", TestNullArguments ());
+        TEST_RUN("invalid input", TestInvalidInput ());
+    }
+
+    void TestCapi::TestFloat2d () {
+        CompareRoutines <2> (Float2d ());
+    }
+
+    void TestCapi::TestFloat3d () {
+        CompareRoutines <3> (Float3d ());
+    }
+
+    void TestCapi::TestDouble2d () {
+        CompareRoutines <2> (Double2d ());
+    }
+
+    void TestCapi::TestDouble3d () {
+        CompareRoutines <3> (Double3d ());
+    }
+
+    // each required pointer is checked, before anything is written
+    void TestCapi::TestNullArguments () {
+        const double coords [] = { 0, 0, 1, 1, 2, 0, 3, 1 };
+        double out [8];
+        size_t count = 42;
+        psimpl_statistics stats;
+
+        VERIFY_TRUE(psimpl_np_f64_2d (0, 4, 2, out, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_rd_f64_2d (coords, 4, 1.0, 0, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_pd_f64_2d (coords, 4, 1.0, 2, out, 0) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_rw_f64_2d (0, 4, 1.0, out, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_op_f64_2d (coords, 4, 1.0, 2.0, 0, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_la_f64_2d (coords, 4, 1.0, 8, out, 0) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_dp_f64_2d (0, 4, 1.0, out, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_dpn_f64_2d (coords, 4, 3, 0, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_pos_error2_f64_2d (coords, 4, 0, 2, out, &count) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_pos_error_stats_f64_2d (coords, 4, coords, 4, 0) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(psimpl_pos_error_stats_f32_3d (0, 4, 0, 4, &stats) == PSIMPL_ERROR_NULL);
+        VERIFY_TRUE(count == 42);
+    }
+
+    // invalid input is copied to the output unchanged, and reported through out_n
+    void TestCapi::TestInvalidInput () {
+        const float coords [] = { 0, 0, 1, 1, 2, 0, 3, 1, 4, 0 };
+        size_t n = 5;
+
+        Output <2, float> out (n);
+        VERIFY_TRUE(psimpl_dp_f32_2d (coords, n, 0.f, out.data (), &out.count) == PSIMPL_OK);
+        VERIFY_TRUE(out.count == n);
+        VERIFY_TRUE(std::equal (coords, coords + 10, out.coords.begin ()));
+        VERIFY_TRUE(out.Untouched ());
+
+        out.count = 0;
+        VERIFY_TRUE(psimpl_np_f32_2d (coords, n, 1, out.data (), &out.count) == PSIMPL_OK);
+        VERIFY_TRUE(out.count == n);
+
+        // empty polyline
+        out.count = 42;
+        VERIFY_TRUE(psimpl_rd_f32_2d (coords, 0, 1.f, out.data (), &out.count) == PSIMPL_OK);
+        VERIFY_TRUE(out.count == 0);
+
+        // the simplification is not a subset of the original polyline
+        const float other [] = { 0, 0, 2, 5, 4, 0 };
+        float errors [5];
+        size_t errorCount = 0;
+        VERIFY_TRUE(psimpl_pos_error2_f32_2d (coords, n, other, 3, errors, &errorCount) == PSIMPL_ERROR_INVALID);
+        psimpl_statistics stats;
+        VERIFY_TRUE(psimpl_pos_error_stats_f32_2d (coords, n, other, 3, &stats) == PSIMPL_ERROR_INVALID);
+    }
+}}
@@ -0,0 +1,227 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+
+#include "TestCli.h"
+#include "helper.h"
+#include "../cli/Stages.h"
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        typedef std::vector <std::vector <double> > Polylines;
+
+        //! \brief Collects the written features.
+        class VectorSink : public cli::Sink <double> {
+        public:
+            bool Write (const double* first, const double* last) {
+                features.push_back (std::vector <double> (first, last));
+                return true;
+            }
+
+            bool Close () {
+                closed = true;
+                return true;
+            }
+
+            Polylines features;
+            bool closed = false;
+        };
+
+        //! \brief Writes each polyline as a CSV line, without loss of precision.
+        std::string ToCsv (const Polylines& polylines) {
+            std::ostringstream stream;
+            cli::CsvSink <double> sink (stream);
+            for (std::size_t p = 0; p < polylines.size (); ++p) {
+                const std::vector <double>& polyline = polylines [p];
+                sink.Write (polyline.empty () ? 0 : &polyline [0],
+                            polyline.empty () ? 0 : &polyline [0] + polyline.size ());
+            }
+            return stream.str ();
+        }
+
+        cli::Options QuietOptions () {
+            cli::Options options;
+            options.quiet = true;
+            options.threads = 4;
+            options.queueSize = 3;
+            return options;
+        }
+    }
+
+    TestCli::TestCli () {
+        TEST_RUN("csv source", TestCsvSource ());
+        TEST_RUN("invalid lines", TestInvalidLines ());
+        TEST_RUN("pipeline", TestPipeline ());
+        TEST_RUN("incomplete points", TestIncompletePoints ());
+        TEST_RUN("wkb round trip", TestWkbRoundTrip ());
+        TEST_RUN("thread count", TestThreadCount ());
+    }
+
+    // separators, comments and empty lines, with the line number of each feature
+    void TestCli::TestCsvSource () {
+        std::istringstream stream ("# comment\n1,2;3 4\t5,6\r\n\n-1.5e1,2\n");
+        cli::CsvSource <double> source (stream);
+        cli::Feature <double> feature;
+
+        ASSERT_TRUE(source.Next (feature));
+        VERIFY_TRUE(feature.line == 2);
+        ASSERT_TRUE(feature.last - feature.first == 6);
+        for (int c = 0; c < 6; ++c) {
+            VERIFY_TRUE(feature.first [c] == c + 1);
+        }
+
+        ASSERT_TRUE(source.Next (feature));
+        VERIFY_TRUE(feature.line == 4);
+        ASSERT_TRUE(feature.last - feature.first == 2);
+        VERIFY_TRUE(feature.first [0] == -15);
+        VERIFY_TRUE(feature.first [1] == 2);
+
+        VERIFY_TRUE(!source.Next (feature));
+    }
+
+    // lines with unparsable tokens are skipped entirely, instead of ending the input
+    void TestCli::TestInvalidLines () {
+        std::istringstream stream ("1,2,3,4\n1,2,x,4\n1,2,3,4 trailing\n5,6,7,8\n");
+        cli::CsvSource <double> source (stream);
+        cli::Feature <double> feature;
+
+        ASSERT_TRUE(source.Next (feature));
+        VERIFY_TRUE(feature.line == 1);
+        ASSERT_TRUE(source.Next (feature));
+        VERIFY_TRUE(feature.line == 4);
+        ASSERT_TRUE(feature.last - feature.first == 4);
+        VERIFY_TRUE(feature.first [0] == 5);
+        VERIFY_TRUE(!source.Next (feature));
+    }
+
+    // each feature is simplified, and written in input order
+    void TestCli::TestPipeline () {
+        Polylines polylines;
+        for (unsigned p = 0; p < 20; ++p) {
+            polylines.push_back (RandomWalk <double, 2> (50 + 37 * p, p + 1, p % 2 == 0));
+        }
+        cli::Options options = QuietOptions ();
+        options.tol = 2;
+
+        std::istringstream stream (ToCsv (polylines));
+        cli::CsvSource <double> source (stream);
+        VectorSink sink;
+        VERIFY_TRUE(cli::Process (options, 2, source, sink));
+        VERIFY_TRUE(sink.closed);
+        ASSERT_TRUE(sink.features.size () == polylines.size ());
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            std::vector <double> expected;
+            simplify_douglas_peucker <2> (polylines [p].begin (), polylines [p].end (), 2.0,
+                                          std::back_inserter (expected), PREFILTER_INDEX);
+            VERIFY_TRUE(sink.features [p] == expected);
+        }
+    }
+
+    // features whose coordinate count is not a multiple of the dimension are skipped
+    void TestCli::TestIncompletePoints () {
+        cli::Options options = QuietOptions ();
+        options.algorithm = cli::NONE;
+
+        std::istringstream stream ("0,0,1,1,2,2\n0,0,1,1,2\n3,3,4,4\n");
+        cli::CsvSource <double> source (stream);
+        VectorSink sink;
+        VERIFY_TRUE(cli::Process (options, 2, source, sink));
+        ASSERT_TRUE(sink.features.size () == 2);
+        VERIFY_TRUE(sink.features [0].size () == 6);
+        VERIFY_TRUE(sink.features [1].size () == 4);
+        VERIFY_TRUE(sink.features [1][0] == 3);
+
+        // the same features are incomplete 3D points, except for the last
+        std::istringstream stream3 ("0,0,1,1,2,2\n0,0,1,1,2\n3,3,4,4\n");
+        cli::CsvSource <double> source3 (stream3);
+        VectorSink sink3;
+        VERIFY_TRUE(cli::Process (options, 3, source3, sink3));
+        ASSERT_TRUE(sink3.features.size () == 1);
+        VERIFY_TRUE(sink3.features [0].size () == 6);
+    }
+
+    // features written by the wkb sink are read back unchanged by the wkb source
+    void TestCli::TestWkbRoundTrip () {
+        Polylines polylines;
+        polylines.push_back (RandomWalk <double, 3> (25, 3, true));
+        polylines.push_back (RandomWalk <double, 3> (2, 4, false));
+
+        std::ostringstream output;
+        {
+            cli::WkbSink <double> sink (output, 3);
+            for (std::size_t p = 0; p < polylines.size (); ++p) {
+                VERIFY_TRUE(sink.Write (&polylines [p][0], &polylines [p][0] + polylines [p].size ()));
+            }
+            VERIFY_TRUE(sink.Close ());
+        }
+
+        cli::Options options = QuietOptions ();
+        options.algorithm = cli::NONE;
+        std::istringstream input (output.str ());
+        cli::WkbSource <double> source (input, 3);
+        VectorSink sink;
+        VERIFY_TRUE(cli::Process (options, 3, source, sink));
+        VERIFY_TRUE(sink.features == polylines);
+    }
+
+    // workers are limited to the number of features in flight
+    void TestCli::TestThreadCount () {
+        cli::Options options = QuietOptions ();
+        VERIFY_TRUE(cli::WorkerCount (options) == 3);
+        options.threads = 2;
+        VERIFY_TRUE(cli::WorkerCount (options) == 2);
+        options.threads = 0;
+        VERIFY_TRUE(cli::WorkerCount (options) >= 1);
+        VERIFY_TRUE(cli::WorkerCount (options) <= 3);
+
+        Polylines polylines;
+        for (unsigned p = 0; p < 5; ++p) {
+            polylines.push_back (RandomWalk <double, 2> (100, p + 1, true));
+        }
+        options.threads = 1000000;
+        options.algorithm = cli::NONE;
+        std::istringstream stream (ToCsv (polylines));
+        cli::CsvSource <double> source (stream);
+        VectorSink sink;
+        VERIFY_TRUE(cli::Process (options, 2, source, sink));
+        VERIFY_TRUE(sink.features == polylines);
+    }
+}}
@@ -0,0 +1,263 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestComplexity.h"
+#include "counted.h"
+#include "generators.h"
+#include "../lib/psimpl_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        typedef Counted <double> value_type;
+        typedef CountingIterator <std::vector <value_type>::const_iterator> iterator;
+        typedef std::back_insert_iterator <std::vector <value_type> > output;
+        typedef void (*Simplify) (iterator, iterator, output);
+
+        enum Shape { WALK, GPS, ZIGZAG, COAST };
+
+        std::vector <value_type> Workload (Shape shape, unsigned pointCount) {
+            std::vector <double> coords;
+            switch (shape) {
+            case WALK:      coords = Generate <2, double> (WalkGenerator <2> (1), pointCount); break;
+            case GPS:       coords = Generate <2, double> (GpsGenerator <2> (1), pointCount); break;
+            case ZIGZAG:    coords = Generate <2, double> (ZigZagGenerator <2> (pointCount), pointCount); break;
+            case COAST:     coords = Generate <2, double> (CoastlineGenerator <2> (pointCount, 1), pointCount); break;
+            }
+            return std::vector <value_type> (coords.begin (), coords.end ());
+        }
+
+        void NthPoint (iterator first, iterator last, output result) {
+            simplify_nth_point <2> (first, last, 4, result);
+        }
+
+        void RadialDistance (iterator first, iterator last, output result) {
+            simplify_radial_distance <2> (first, last, value_type (5), result);
+        }
+
+        void PerpendicularDistance (iterator first, iterator last, output result) {
+            simplify_perpendicular_distance <2> (first, last, value_type (5), result);
+        }
+
+        void ReumannWitkam (iterator first, iterator last, output result) {
+            simplify_reumann_witkam <2> (first, last, value_type (5), result);
+        }
+
+        void Opheim (iterator first, iterator last, output result) {
+            simplify_opheim <2> (first, last, value_type (5), value_type (20), result);
+        }
+
+        void Lang8 (iterator first, iterator last, output result) {
+            simplify_lang <2> (first, last, value_type (5), 8, result);
+        }
+
+        void Lang32 (iterator first, iterator last, output result) {
+            simplify_lang <2> (first, last, value_type (5), 32, result);
+        }
+
+        void DouglasPeucker (iterator first, iterator last, output result) {
+            simplify_douglas_peucker <2> (first, last, value_type (5), result);
+        }
+
+        void DouglasPeuckerN (iterator first, iterator last, output result) {
+            simplify_douglas_peucker_n <2> (first, last, std::distance (first, last) / 40, result);
+        }
+
+        // errors against a simplification that is computed without counting any operations
+        void PositionalErrors (iterator first, iterator last, output result) {
+            std::vector <value_type> simplified;
+            simplify_nth_point <2> (first.Base (), last.Base (), 10, std::back_inserter (simplified));
+            compute_positional_errors2 <2> (first, last, iterator (simplified.begin ()), iterator (simplified.end ()), result);
+        }
+
+        //! \brief Counts the operations of a simplification of a generated polyline.
+        OperationCounts Count (Simplify simplify, Shape shape, unsigned pointCount) {
+            std::vector <value_type> coords = Workload (shape, pointCount);
+            std::vector <value_type> result;
+            Counts ().Reset ();
+            simplify (iterator (coords.begin ()), iterator (coords.end ()), std::back_inserter (result));
+            return Counts ();
+        }
+
+        //! \brief Growth of the operation counts when the input grows from pointCount by factor.
+        struct Growth {
+            Growth (Simplify simplify, Shape shape, unsigned pointCount, unsigned factor) {
+                OperationCounts small = Count (simplify, shape, pointCount);
+                OperationCounts large = Count (simplify, shape, pointCount * factor);
+                operations = Ratio (large.Arithmetic () + large.comparisons, small.Arithmetic () + small.comparisons);
+                increments = Ratio (large.increments, small.increments);
+            }
+
+            static double Ratio (std::size_t large, std::size_t small) {
+                return static_cast <double> (large) / std::max <std::size_t> (small, 1);
+            }
+
+            double operations;  //!< growth of the number of arithmetic operations and comparisons
+            double increments;  //!< growth of the number of iterator increments
+        };
+
+        //! \brief Counts the distance evaluations of DP, or of DPn when count is not 0.
+        std::size_t Distances (Shape shape, unsigned pointCount, unsigned count) {
+            std::vector <value_type> coords = Workload (shape, pointCount);
+            std::vector <value_type> result;
+            SimplificationStats stats;
+            PolylineSimplification <2, iterator, output, StatsInstrumentation> ps ((StatsInstrumentation (stats)));
+            if (count) {
+                ps.DouglasPeuckerN (iterator (coords.begin ()), iterator (coords.end ()), count, std::back_inserter (result));
+            }
+            else {
+                ps.DouglasPeucker (iterator (coords.begin ()), iterator (coords.end ()), value_type (5), std::back_inserter (result));
+            }
+            return stats.distances;
+        }
+
+        //! \brief Upper bound for the growth of an O(n log n) algorithm, with 25% slack.
+        double LogLinearBound (unsigned pointCount, unsigned factor) {
+            return 1.25 * factor * std::log (double (pointCount * factor)) / std::log (double (pointCount));
+        }
+    }
+
+    TestComplexity::TestComplexity () {
+        TEST_RUN("counting", TestCounting ());
+        TEST_RUN("linear algorithms", TestLinear ());
+        TEST_RUN("lang", TestLang ());
+        TEST_RUN("douglas-peucker", TestDouglasPeucker ());
+        TEST_RUN("douglas-peucker worst case", TestDouglasPeuckerWorstCase ());
+    }
+
+    void TestComplexity::TestCounting () {
+        Counts ().Reset ();
+        value_type a (3), b (4);
+        value_type c = a * a + b * b;
+        VERIFY_TRUE(Counts ().multiplications == 2);
+        VERIFY_TRUE(Counts ().additions == 1);
+        VERIFY_TRUE(Counts ().Arithmetic () == 3);
+        VERIFY_TRUE(c.Value () == 25);
+        VERIFY_TRUE(a < b && !(c == b));
+        VERIFY_TRUE(Counts ().comparisons == 2);
+        c /= b;
+        c = -c;
+        VERIFY_TRUE(Counts ().divisions == 1);
+        VERIFY_TRUE(Counts ().additions == 2);
+        VERIFY_TRUE(static_cast <int> (c) == -6);
+
+        std::vector <value_type> values (10, a);
+        Counts ().Reset ();
+        iterator it (values.begin ());
+        iterator copy = it;
+        ++it;
+        it += 3;
+        it--;
+        VERIFY_TRUE(Counts ().increments == 3);
+        VERIFY_TRUE(*it == a && it [1] == a);
+        VERIFY_TRUE(Counts ().dereferences == 2);
+        VERIFY_TRUE(Counts ().iteratorCopies == 2);
+        VERIFY_TRUE(it - copy == 3);
+        VERIFY_TRUE(it.Base () == values.begin () + 3);
+    }
+
+    // operations and increments grow proportionally to the number of points
+    void TestComplexity::TestLinear () {
+        const Simplify simplify [] = { NthPoint, RadialDistance, PerpendicularDistance, ReumannWitkam, Opheim, PositionalErrors };
+        const Shape shapes [] = { WALK, GPS, ZIGZAG, COAST };
+
+        for (unsigned a = 0; a < 6; ++a) {
+            for (unsigned s = 0; s < 4; ++s) {
+                Growth growth (simplify [a], shapes [s], 2000, 8);
+                VERIFY_TRUE(growth.operations <= 10);
+                VERIFY_TRUE(growth.increments <= 10);
+            }
+        }
+        // nth point does not compute anything
+        VERIFY_TRUE(Count (NthPoint, WALK, 1000).Arithmetic () == 0);
+    }
+
+    // O(n look_ahead)
+    void TestComplexity::TestLang () {
+        const Shape shapes [] = { WALK, GPS, ZIGZAG, COAST };
+
+        for (unsigned s = 0; s < 4; ++s) {
+            Growth growth (Lang8, shapes [s], 2000, 8);
+            VERIFY_TRUE(growth.operations <= 10);
+            VERIFY_TRUE(growth.increments <= 10);
+        }
+        // growth in the look ahead
+        for (unsigned s = 0; s < 4; ++s) {
+            OperationCounts la8 = Count (Lang8, shapes [s], 4000);
+            OperationCounts la32 = Count (Lang32, shapes [s], 4000);
+            VERIFY_TRUE(Growth::Ratio (la32.Arithmetic () + la32.comparisons, la8.Arithmetic () + la8.comparisons) <= 5);
+            VERIFY_TRUE(Growth::Ratio (la32.increments, la8.increments) <= 5);
+        }
+    }
+
+    // O(n log n) on average
+    void TestComplexity::TestDouglasPeucker () {
+        const Simplify simplify [] = { DouglasPeucker, DouglasPeuckerN };
+        const Shape shapes [] = { WALK, GPS, COAST };
+        const double bound = LogLinearBound (2000, 8);
+
+        for (unsigned a = 0; a < 2; ++a) {
+            for (unsigned s = 0; s < 3; ++s) {
+                Growth growth (simplify [a], shapes [s], 2000, 8);
+                VERIFY_TRUE(growth.operations <= bound);
+                VERIFY_TRUE(growth.increments <= 10);
+            }
+        }
+        // distance evaluations
+        for (unsigned s = 0; s < 3; ++s) {
+            VERIFY_TRUE(Growth::Ratio (Distances (shapes [s], 16000, 0), Distances (shapes [s], 2000, 0)) <= bound);
+            VERIFY_TRUE(Growth::Ratio (Distances (shapes [s], 16000, 400), Distances (shapes [s], 2000, 50)) <= bound);
+        }
+    }
+
+    // O(n^2) for a zig-zag that keeps all points, splitting off a single point per step
+    void TestComplexity::TestDouglasPeuckerWorstCase () {
+        const Simplify simplify [] = { DouglasPeucker, DouglasPeuckerN };
+
+        for (unsigned a = 0; a < 2; ++a) {
+            Growth growth (simplify [a], ZIGZAG, 250, 8);
+            VERIFY_TRUE(growth.operations > LogLinearBound (250, 8));
+            VERIFY_TRUE(growth.operations > 0.75 * 8 * 8);
+            VERIFY_TRUE(growth.increments <= 10);
+        }
+        // radial distance tests n - 2 points, after which each sub polyline of m points splits off
+        // a single point, using m - 2 distance evaluations
+        VERIFY_TRUE(Distances (ZIGZAG, 2000, 0) == 1998u + 1999u * 1998u / 2);
+    }
+}}
@@ -35,7 +35,10 @@
 #include "helper.h"
 #include "../lib/psimpl.h"
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include <deque>
+#include <limits>
 #include <list>
 
 
@@ -52,6 +55,8 @@ namespace psimpl {
         TEST_RUN("bidirectional iterator", TestBidirectionalIterator ());
         TEST_DISABLED("forward iterator", TestForwardIterator ());
         TEST_RUN("return value", TestReturnValue ());
+        TEST_RUN("prefilter", TestPrefilter ());
+        TEST_RUN("importance", TestImportance ());
     }
 
     // incomplete point: coord count % DIM > 1
@@ -313,6 +318,133 @@ namespace psimpl {
             == 2*DIM);
     }
 
+    // index and copy prefilters yield the same result, none skips the prefilter
+    void TestDouglasPeucker::TestPrefilter () {
+        const unsigned DIM = 2;
+        const unsigned count = 200;
+        const float tol = 0.5f;
+
+        std::vector <float> polyline;
+        for (unsigned i = 0; i < count; ++i) {
+            polyline.push_back (i * 0.3f);
+            polyline.push_back (std::sin (i * 0.1f) * 5.f + (i % 7) * 0.2f);
+        }
+        std::list <float> list (polyline.begin (), polyline.end ());
+
+        std::vector <float> reduced;
+        psimpl::simplify_radial_distance <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (reduced));
+        std::ptrdiff_t removed = count - reduced.size () / DIM;
+        VERIFY_TRUE(removed > 0);
+
+        std::vector <float> expected;
+        psimpl::simplify_douglas_peucker <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (expected));
+
+        // contiguous
+        {
+            std::vector <float> result;
+            std::ptrdiff_t r = -1;
+            psimpl::simplify_douglas_peucker <DIM> (
+                polyline.begin (), polyline.end (), tol,
+                std::back_inserter (result), PREFILTER_COPY, &r);
+            VERIFY_TRUE(result == expected);
+            VERIFY_TRUE(r == removed);
+        }
+        {
+            std::vector <float> result;
+            std::ptrdiff_t r = -1;
+            psimpl::simplify_douglas_peucker <DIM> (
+                polyline.begin (), polyline.end (), tol,
+                std::back_inserter (result), PREFILTER_INDEX, &r);
+            VERIFY_TRUE(result == expected);
+            VERIFY_TRUE(r == removed);
+        }
+        {
+            std::vector <float> result;
+            std::ptrdiff_t r = -1;
+            psimpl::simplify_douglas_peucker <DIM> (
+                &polyline [0], &polyline [0] + count*DIM, tol,
+                std::back_inserter (result), PREFILTER_INDEX, &r);
+            VERIFY_TRUE(result == expected);
+            VERIFY_TRUE(r == removed);
+        }
+        // non-contiguous
+        {
+            std::vector <float> result;
+            std::ptrdiff_t r = -1;
+            psimpl::simplify_douglas_peucker <DIM> (
+                list.begin (), list.end (), tol,
+                std::back_inserter (result), PREFILTER_INDEX, &r);
+            VERIFY_TRUE(result == expected);
+            VERIFY_TRUE(r == removed);
+        }
+        // no prefilter equals the copy prefilter when nothing is removed
+        {
+            const float small = 0.25f;
+            std::vector <float> copy, none, noneList;
+            std::ptrdiff_t r = -1;
+            psimpl::simplify_douglas_peucker <DIM> (
+                polyline.begin (), polyline.end (), small,
+                std::back_inserter (copy), PREFILTER_COPY, &r);
+            VERIFY_TRUE(r == 0);
+            r = -1;
+            psimpl::simplify_douglas_peucker <DIM> (
+                polyline.begin (), polyline.end (), small,
+                std::back_inserter (none), PREFILTER_NONE, &r);
+            VERIFY_TRUE(r == 0);
+            psimpl::simplify_douglas_peucker <DIM> (
+                list.begin (), list.end (), small,
+                std::back_inserter (noneList), PREFILTER_NONE);
+            VERIFY_TRUE(none == copy);
+            VERIFY_TRUE(noneList == copy);
+        }
+    }
+
+    // filtering on importance equals douglas-peucker without prefilter, for any tolerance
+    void TestDouglasPeucker::TestImportance () {
+        const unsigned DIM = 2;
+        std::vector <double> polyline = RandomWalk <double, DIM> (500, 11, true);
+        std::list <double> list (polyline.begin (), polyline.end ());
+
+        std::vector <double> importance;
+        bool valid = false;
+        compute_douglas_peucker_importance2 <DIM> (polyline.begin (), polyline.end (),
+            std::back_inserter (importance), &valid);
+        VERIFY_TRUE(valid);
+        ASSERT_TRUE(importance.size () == 500);
+        VERIFY_TRUE(importance [0] == std::numeric_limits <double>::max ());
+        VERIFY_TRUE(importance [499] == std::numeric_limits <double>::max ());
+
+        std::vector <double> listImportance;
+        compute_douglas_peucker_importance2 <DIM> (list.begin (), list.end (), std::back_inserter (listImportance));
+        VERIFY_TRUE(listImportance == importance);
+
+        const double tols [] = { 0, 0.1, 0.5, 1, 2, 5, 10, 100 };
+        for (unsigned t = 0; t < sizeof (tols) / sizeof (tols [0]); ++t) {
+            std::vector <double> expected;
+            simplify_douglas_peucker <DIM> (polyline.begin (), polyline.end (), tols [t],
+                std::back_inserter (expected), PREFILTER_NONE);
+            std::vector <double> filtered;
+            for (std::size_t i = 0; i < importance.size (); ++i) {
+                if (tols [t] * tols [t] < importance [i]) {
+                    filtered.push_back (polyline [i * DIM]);
+                    filtered.push_back (polyline [i * DIM + 1]);
+                }
+            }
+            VERIFY_TRUE(filtered == expected);
+        }
+
+        // invalid input
+        importance.clear ();
+        compute_douglas_peucker_importance2 <DIM> (polyline.begin (), polyline.begin () + 3,
+            std::back_inserter (importance), &valid);
+        VERIFY_FALSE(valid);
+        VERIFY_TRUE(importance.empty ());
+    }
+
     // --------------------------------------------------------------------------------------------
 
     TestDouglasPeuckerN::TestDouglasPeuckerN () {
@@ -681,4 +813,231 @@ namespace psimpl {
                     result))
             == 5*DIM);
     }
+
+    // --------------------------------------------------------------------------------------------
+
+    template <typename T, unsigned DIM>
+    static bool CompareWithDouglasPeucker (const std::vector <T>& polyline, T tol) {
+        std::vector <T> expected;
+        std::vector <T> result;
+        psimpl::simplify_douglas_peucker <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (expected));
+        psimpl::simplify_douglas_peucker_accelerated <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (result));
+        return result == expected;
+    }
+
+    TestDouglasPeuckerAccelerated::TestDouglasPeuckerAccelerated () {
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("smooth line", TestSmoothLine ());
+        TEST_RUN("noisy line", TestNoisyLine ());
+        TEST_RUN("integer type", TestIntegerType ());
+    }
+
+    // invalid input is copied
+    void TestDouglasPeuckerAccelerated::TestInvalidInput () {
+        const unsigned DIM = 2;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), 10*DIM-1, StraightLine <float, DIM> ());
+        std::vector <float> result;
+
+        psimpl::simplify_douglas_peucker_accelerated <DIM> (
+            polyline.begin (), polyline.end (), 2.f,
+            std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+
+        polyline.push_back (0.f);
+        result.clear ();
+        psimpl::simplify_douglas_peucker_accelerated <DIM> (
+            polyline.begin (), polyline.end (), 0.f,
+            std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+    }
+
+    // pruning is effective, and the result matches DP
+    void TestDouglasPeuckerAccelerated::TestSmoothLine () {
+        const unsigned count = 10000;
+
+        for (unsigned seed = 1; seed <= 3; ++seed) {
+            VERIFY_TRUE((CompareWithDouglasPeucker <float, 2> (RandomWalk <float, 2> (count, seed, true), 0.5f)));
+            VERIFY_TRUE((CompareWithDouglasPeucker <float, 2> (RandomWalk <float, 2> (count, seed, true), 5.f)));
+            VERIFY_TRUE((CompareWithDouglasPeucker <double, 2> (RandomWalk <double, 2> (count, seed, true), 0.05)));
+            VERIFY_TRUE((CompareWithDouglasPeucker <double, 3> (RandomWalk <double, 3> (count, seed, true), 1.)));
+        }
+    }
+
+    // little pruning, but the result still matches DP
+    void TestDouglasPeuckerAccelerated::TestNoisyLine () {
+        const unsigned count = 5000;
+
+        for (unsigned seed = 1; seed <= 3; ++seed) {
+            VERIFY_TRUE((CompareWithDouglasPeucker <float, 2> (RandomWalk <float, 2> (count, seed, false), 1.f)));
+            VERIFY_TRUE((CompareWithDouglasPeucker <double, 2> (RandomWalk <double, 2> (count, seed, false), 3.)));
+            VERIFY_TRUE((CompareWithDouglasPeucker <float, 4> (RandomWalk <float, 4> (count, seed, false), 2.f)));
+        }
+    }
+
+    // integer types are approximated without pruning
+    void TestDouglasPeuckerAccelerated::TestIntegerType () {
+        const unsigned count = 2000;
+
+        std::vector <double> walk = RandomWalk <double, 2> (count, 7, true);
+        std::vector <int> polyline;
+        for (unsigned c = 0; c < walk.size (); ++c) {
+            polyline.push_back (static_cast <int> (walk [c] * 10));
+        }
+        VERIFY_TRUE((CompareWithDouglasPeucker <int, 2> (polyline, 5)));
+    }
+
+    // --------------------------------------------------------------------------------------------
+
+    // square of size 12 with steps points per edge, starting at vertex offset
+    static std::vector <float> Square (unsigned steps, unsigned offset, bool closed) {
+        const float corners [] = { 0.f, 0.f, 12.f, 0.f, 12.f, 12.f, 0.f, 12.f, 0.f, 0.f };
+        std::vector <float> vertices;
+        for (unsigned c = 0; c < 4; ++c) {
+            for (unsigned s = 0; s < steps; ++s) {
+                float f = static_cast <float> (s) / steps;
+                vertices.push_back (corners [2*c] + f * (corners [2*c+2] - corners [2*c]));
+                vertices.push_back (corners [2*c+1] + f * (corners [2*c+3] - corners [2*c+1]));
+            }
+        }
+        std::rotate (vertices.begin (), vertices.begin () + 2 * offset, vertices.end ());
+        if (closed) {
+            vertices.push_back (vertices [0]);
+            vertices.push_back (vertices [1]);
+        }
+        return vertices;
+    }
+
+    TestDouglasPeuckerRing::TestDouglasPeuckerRing () {
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("seam", TestSeam ());
+        TEST_RUN("implicitly closed", TestImplicitlyClosed ());
+        TEST_RUN("start vertex", TestStartVertex ());
+        TEST_RUN("large tol", TestLargeTol ());
+        TEST_RUN("count", TestCount ());
+    }
+
+    // invalid input is copied
+    void TestDouglasPeuckerRing::TestInvalidInput () {
+        const unsigned DIM = 2;
+
+        // incomplete point
+        std::vector <float> ring = Square (3, 0, true);
+        ring.pop_back ();
+        std::vector <float> result;
+        psimpl::simplify_douglas_peucker_ring <DIM> (ring.begin (), ring.end (), 1.f, std::back_inserter (result));
+        VERIFY_TRUE(result == ring);
+
+        // invalid tol
+        ring = Square (3, 0, true);
+        result.clear ();
+        psimpl::simplify_douglas_peucker_ring <DIM> (ring.begin (), ring.end (), 0.f, std::back_inserter (result));
+        VERIFY_TRUE(result == ring);
+
+        // two vertices and a closing point
+        const float line [] = { 0.f, 0.f, 5.f, 5.f, 0.f, 0.f };
+        result.clear ();
+        psimpl::simplify_douglas_peucker_ring <DIM> (line, line + 6, 1.f, std::back_inserter (result));
+        VERIFY_TRUE(result == std::vector <float> (line, line + 6));
+        result.clear ();
+        psimpl::simplify_douglas_peucker_n_ring <DIM> (line, line + 6, 3, std::back_inserter (result));
+        VERIFY_TRUE(result == std::vector <float> (line, line + 6));
+    }
+
+    // the seam vertex is not kept, unlike simplifying the ring as polyline
+    void TestDouglasPeuckerRing::TestSeam () {
+        const unsigned DIM = 2;
+        std::vector <float> ring = Square (4, 2, true);
+
+        std::vector <float> polyline;
+        psimpl::simplify_douglas_peucker <DIM> (ring.begin (), ring.end (), 1.f, std::back_inserter (polyline));
+        VERIFY_TRUE(polyline.size () == 6 * DIM);
+
+        std::vector <float> result;
+        psimpl::simplify_douglas_peucker_ring <DIM> (ring.begin (), ring.end (), 1.f, std::back_inserter (result));
+        const float expected [] = { 12.f, 0.f, 12.f, 12.f, 0.f, 12.f, 0.f, 0.f, 12.f, 0.f };
+        VERIFY_TRUE(result == std::vector <float> (expected, expected + 10));
+    }
+
+    // an implicitly closed ring remains implicitly closed
+    void TestDouglasPeuckerRing::TestImplicitlyClosed () {
+        const unsigned DIM = 2;
+        std::vector <float> ring = Square (4, 2, false);
+        std::vector <float> result;
+        psimpl::simplify_douglas_peucker_ring <DIM> (ring.begin (), ring.end (), 1.f, std::back_inserter (result));
+        const float expected [] = { 12.f, 0.f, 12.f, 12.f, 0.f, 12.f, 0.f, 0.f };
+        VERIFY_TRUE(result == std::vector <float> (expected, expected + 8));
+
+        std::list <float> list (ring.begin (), ring.end ());
+        result.clear ();
+        psimpl::simplify_douglas_peucker_ring <DIM> (list.begin (), list.end (), 1.f, std::back_inserter (result));
+        VERIFY_TRUE(result == std::vector <float> (expected, expected + 8));
+    }
+
+    // the corners are found regardless of the start vertex, and keep their original order
+    void TestDouglasPeuckerRing::TestStartVertex () {
+        const unsigned DIM = 2;
+        const unsigned steps = 5;
+        std::vector <float> corners = Square (1, 0, false);
+        for (unsigned offset = 0; offset < 4 * steps; ++offset) {
+            std::vector <float> result;
+            std::vector <float> ring = Square (steps, offset, true);
+            psimpl::simplify_douglas_peucker_ring <DIM> (ring.begin (), ring.end (), 0.5f, std::back_inserter (result));
+            VERIFY_TRUE(result.size () == 5 * DIM);
+            if (result.size () != 5 * DIM) {
+                continue;
+            }
+            // the first corner at or after the start vertex
+            unsigned first = (offset + steps - 1) / steps % 4;
+            std::rotate (corners.begin (), corners.begin () + 2 * first, corners.end ());
+            VERIFY_TRUE(std::equal (corners.begin (), corners.end (), result.begin ()));
+            std::rotate (corners.begin (), corners.end () - 2 * first, corners.end ());
+        }
+    }
+
+    // a ring within tolerance keeps two vertices that lie far apart
+    void TestDouglasPeuckerRing::TestLargeTol () {
+        const unsigned DIM = 2;
+        std::vector <float> ring = Square (4, 1, true);
+        std::vector <float> result;
+        psimpl::simplify_douglas_peucker_ring <DIM> (ring.begin (), ring.end (), 100.f, std::back_inserter (result));
+        VERIFY_TRUE(result.size () == 3 * DIM);
+        if (result.size () == 3 * DIM) {
+            VERIFY_TRUE(std::abs (result [0] - result [2]) == 12.f);
+            VERIFY_TRUE(std::abs (result [1] - result [3]) == 12.f);
+            VERIFY_TRUE(result [0] == result [4] && result [1] == result [5]);
+        }
+    }
+
+    // DPn keeps count vertices, excluding the closing point
+    void TestDouglasPeuckerRing::TestCount () {
+        const unsigned DIM = 2;
+        std::vector <float> ring = Square (4, 2, true);
+        std::vector <float> result;
+        psimpl::simplify_douglas_peucker_n_ring <DIM> (ring.begin (), ring.end (), 4, std::back_inserter (result));
+        const float expected [] = { 12.f, 0.f, 12.f, 12.f, 0.f, 12.f, 0.f, 0.f, 12.f, 0.f };
+        VERIFY_TRUE(result == std::vector <float> (expected, expected + 10));
+
+        result.clear ();
+        psimpl::simplify_douglas_peucker_n_ring <DIM> (ring.begin (), ring.end (), 3, std::back_inserter (result));
+        VERIFY_TRUE(result.size () == 4 * DIM);
+
+        result.clear ();
+        ring = Square (4, 2, false);
+        psimpl::simplify_douglas_peucker_n_ring <DIM> (ring.begin (), ring.end (), 10, std::back_inserter (result));
+        VERIFY_TRUE(result.size () == 10 * DIM);
+
+        // invalid count
+        result.clear ();
+        psimpl::simplify_douglas_peucker_n_ring <DIM> (ring.begin (), ring.end (), 2, std::back_inserter (result));
+        VERIFY_TRUE(result == ring);
+        result.clear ();
+        psimpl::simplify_douglas_peucker_n_ring <DIM> (ring.begin (), ring.end (), 16, std::back_inserter (result));
+        VERIFY_TRUE(result == ring);
+    }
 }}
@@ -57,6 +57,8 @@ namespace psimpl {
         void TestBidirectionalIterator ();
         void TestForwardIterator ();
         void TestReturnValue ();
+        void TestPrefilter ();
+        void TestImportance ();
     };
 
     //! Tests function psimpl::simplify_douglas_peucker_n
@@ -76,7 +78,35 @@ namespace psimpl {
         void TestForwardIterator ();
         void TestReturnValue ();
     };
+
+    //! Tests function psimpl::simplify_douglas_peucker_accelerated
+    class TestDouglasPeuckerAccelerated
+    {
+    public:
+        TestDouglasPeuckerAccelerated ();
+
+    private:
+        void TestInvalidInput ();
+        void TestSmoothLine ();
+        void TestNoisyLine ();
+        void TestIntegerType ();
+    };
+
+    //! Tests functions psimpl::simplify_douglas_peucker_ring and simplify_douglas_peucker_n_ring
+    class TestDouglasPeuckerRing
+    {
+    public:
+        TestDouglasPeuckerRing ();
+
+    private:
+        void TestInvalidInput ();
+        void TestSeam ();
+        void TestImplicitlyClosed ();
+        void TestStartVertex ();
+        void TestLargeTol ();
+        void TestCount ();
+    };
 }}
 
 
-#endif // PSIMPL_TEST_DOUGLAS_PEUCKER
\ No newline at end of file
+#endif // PSIMPL_TEST_DOUGLAS_PEUCKER
@@ -0,0 +1,166 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestEncode.h"
+#include "helper.h"
+#include "../lib/psimpl.h"
+#include "../lib/psimpl_encode.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    TestEncode::TestEncode () {
+        TEST_RUN("varint", TestVarint ());
+        TEST_RUN("varint delta", TestVarintDelta ());
+        TEST_RUN("google polyline", TestGooglePolyline ());
+        TEST_RUN("simplification", TestSimplification ());
+        TEST_RUN("invalid input", TestInvalidInput ());
+    }
+
+    void TestEncode::TestVarint () {
+        VERIFY_TRUE(util::zigzag_encode (0) == 0);
+        VERIFY_TRUE(util::zigzag_encode (-1) == 1);
+        VERIFY_TRUE(util::zigzag_encode (1) == 2);
+        VERIFY_TRUE(util::zigzag_encode (-2) == 3);
+
+        const int64_t values [] = { 0, 1, -1, 63, -64, 300, -300, 2147483647, -2147483647 - 1 };
+        for (unsigned i = 0; i < sizeof (values) / sizeof (values [0]); ++i) {
+            VERIFY_TRUE(util::zigzag_decode (util::zigzag_encode (values [i])) == values [i]);
+
+            std::vector <unsigned char> bytes;
+            util::encode_varint (util::zigzag_encode (values [i]), std::back_inserter (bytes));
+            uint64_t decoded = 0;
+            const unsigned char* end = util::decode_varint (&bytes [0], &bytes [0] + bytes.size (), decoded);
+            VERIFY_TRUE(end == &bytes [0] + bytes.size ());
+            VERIFY_TRUE(util::zigzag_decode (decoded) == values [i]);
+        }
+        {
+            std::vector <unsigned char> bytes;
+            util::encode_varint (300, std::back_inserter (bytes));
+            VERIFY_TRUE(bytes.size () == 2 && bytes [0] == 0xAC && bytes [1] == 0x02);
+
+            // truncated
+            uint64_t decoded = 0;
+            VERIFY_TRUE(util::decode_varint (&bytes [0], &bytes [0] + 1, decoded) == 0);
+        }
+    }
+
+    // coordinates survive up to the quantization error, deltas stay small
+    void TestEncode::TestVarintDelta () {
+        const unsigned DIM = 3;
+        std::vector <double> coords = RandomWalk <double, DIM> (1000, 1, true);
+
+        std::vector <unsigned char> bytes;
+        varint_delta_iterator <DIM, std::back_insert_iterator <std::vector <unsigned char> > > it =
+            std::copy (coords.begin (), coords.end (), make_varint_delta_iterator <DIM> (std::back_inserter (bytes), 1e3));
+        VERIFY_TRUE(it.coordinate_count () == coords.size ());
+        VERIFY_TRUE(bytes.size () < coords.size () * 3);
+
+        bool valid = false;
+        std::vector <double> decoded;
+        decode_varint_delta <DIM> (&bytes [0], &bytes [0] + bytes.size (), 1e3, std::back_inserter (decoded), &valid);
+        VERIFY_TRUE(valid);
+        ASSERT_TRUE(decoded.size () == coords.size ());
+        for (std::size_t c = 0; c < coords.size (); ++c) {
+            VERIFY_TRUE(std::abs (decoded [c] - coords [c]) <= 0.0005 + 1e-9);
+        }
+    }
+
+    // example from the Google encoded polyline algorithm format documentation
+    void TestEncode::TestGooglePolyline () {
+        const double coords [] = { 38.5, -120.2, 40.7, -120.95, 43.252, -126.453 };
+        const std::string expected = "_p~iF~ps|U_ulLnnqC_mqNvxq`@";
+
+        std::string encoded;
+        std::copy (coords, coords + 6, make_google_polyline_iterator (std::back_inserter (encoded)));
+        VERIFY_TRUE(encoded == expected);
+
+        bool valid = false;
+        std::vector <double> decoded;
+        decode_google_polyline (expected.c_str (), expected.c_str () + expected.size (), std::back_inserter (decoded), 5, &valid);
+        VERIFY_TRUE(valid);
+        ASSERT_TRUE(decoded.size () == 6);
+        for (unsigned c = 0; c < 6; ++c) {
+            VERIFY_TRUE(std::abs (decoded [c] - coords [c]) < 1e-9);
+        }
+    }
+
+    // simplified polylines are encoded while they are being written
+    void TestEncode::TestSimplification () {
+        std::vector <double> coords = RandomWalk <double, 2> (1000, 2, true);
+        std::vector <double> simplified;
+        simplify_douglas_peucker <2> (coords.begin (), coords.end (), 2.0, std::back_inserter (simplified));
+
+        std::vector <unsigned char> fused;
+        simplify_douglas_peucker <2> (coords.begin (), coords.end (), 2.0,
+            make_varint_delta_iterator <2> (std::back_inserter (fused), 1e6));
+        std::vector <unsigned char> twoPass;
+        std::copy (simplified.begin (), simplified.end (), make_varint_delta_iterator <2> (std::back_inserter (twoPass), 1e6));
+        VERIFY_TRUE(fused == twoPass);
+
+        std::string encoded;
+        simplify_douglas_peucker_n <2> (coords.begin (), coords.end (), 50,
+            make_google_polyline_iterator (std::back_inserter (encoded), 6));
+        std::vector <double> decoded;
+        decode_google_polyline (encoded.c_str (), encoded.c_str () + encoded.size (), std::back_inserter (decoded), 6);
+        VERIFY_TRUE(decoded.size () == 100);
+    }
+
+    void TestEncode::TestInvalidInput () {
+        bool valid = true;
+        std::vector <double> decoded;
+
+        // truncated varint
+        const unsigned char bytes [] = { 0x02, 0x04, 0x86 };
+        decode_varint_delta <2> (bytes, bytes + 3, 1, std::back_inserter (decoded), &valid);
+        VERIFY_FALSE(valid);
+        VERIFY_TRUE(decoded.size () == 2);
+
+        // incomplete point
+        decoded.clear ();
+        decode_varint_delta <2> (bytes, bytes + 1, 1, std::back_inserter (decoded), &valid);
+        VERIFY_FALSE(valid);
+
+        // character out of range, truncated chunk
+        const std::string invalid = "_p~iF ";
+        decode_google_polyline (invalid.c_str (), invalid.c_str () + invalid.size (), std::back_inserter (decoded), 5, &valid);
+        VERIFY_FALSE(valid);
+        const std::string truncated = "_p~iF~ps|";
+        decode_google_polyline (truncated.c_str (), truncated.c_str () + truncated.size (), std::back_inserter (decoded), 5, &valid);
+        VERIFY_FALSE(valid);
+    }
+}}
@@ -0,0 +1,192 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "TestGenerator.h"
+#include "../lib/psimpl_generator.h"
+
+#if defined (__cpp_impl_coroutine)
+
+#include "counted.h"
+#include "generators.h"
+#include <iterator>
+#include <list>
+#include <vector>
+
+#endif
+
+
+namespace psimpl {
+    namespace test
+{
+#if defined (__cpp_impl_coroutine)
+    namespace
+    {
+        // copies the coordinates of each produced key
+        template <unsigned DIM, class Iterator>
+        std::vector <double> Collect (Generator <Iterator> keys) {
+            std::vector <double> coords;
+            for (Iterator key : keys) {
+                for (unsigned d = 0; d < DIM; ++d, ++key) {
+                    coords.push_back (*key);
+                }
+            }
+            return coords;
+        }
+
+        // determines if the lazy routines produce the keys of the simplify_* functions
+        template <unsigned DIM>
+        bool SameKeys (const std::vector <double>& polyline) {
+            std::vector <double>::const_iterator first = polyline.begin ();
+            std::vector <double>::const_iterator last = polyline.end ();
+            std::list <double> list (first, last);
+            std::vector <double> expected;
+            bool same = true;
+
+            simplify_nth_point <DIM> (first, last, 3, std::back_inserter (expected));
+            same = same && Collect <DIM> (generate_nth_point <DIM> (first, last, 3)) == expected;
+
+            expected.clear ();
+            simplify_radial_distance <DIM> (first, last, 5.0, std::back_inserter (expected));
+            same = same && Collect <DIM> (generate_radial_distance <DIM> (first, last, 5.0)) == expected;
+
+            expected.clear ();
+            simplify_perpendicular_distance <DIM> (first, last, 5.0, std::back_inserter (expected));
+            same = same && Collect <DIM> (generate_perpendicular_distance <DIM> (first, last, 5.0)) == expected;
+
+            expected.clear ();
+            simplify_reumann_witkam <DIM> (first, last, 5.0, std::back_inserter (expected));
+            same = same && Collect <DIM> (generate_reumann_witkam <DIM> (first, last, 5.0)) == expected;
+
+            expected.clear ();
+            simplify_opheim <DIM> (first, last, 5.0, 20.0, std::back_inserter (expected));
+            same = same && Collect <DIM> (generate_opheim <DIM> (first, last, 5.0, 20.0)) == expected;
+
+            expected.clear ();
+            simplify_lang <DIM> (first, last, 5.0, 8, std::back_inserter (expected));
+            same = same && Collect <DIM> (generate_lang <DIM> (list.begin (), list.end (), 5.0, 8)) == expected;
+
+            return same;
+        }
+    }
+#endif
+
+    TestGenerator::TestGenerator () {
+#if defined (__cpp_impl_coroutine)
+        TEST_RUN("same keys", TestSameKeys ());
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("lazy", TestLazy ());
+        TEST_RUN("resume", TestResume ());
+#else
+        TEST_DISABLED("same keys", TestSameKeys ());
+        TEST_DISABLED("invalid input", TestInvalidInput ());
+        TEST_DISABLED("lazy", TestLazy ());
+        TEST_DISABLED("resume", TestResume ());
+#endif
+    }
+
+#if defined (__cpp_impl_coroutine)
+    // each lazy routine produces the keys of its simplify_* function
+    void TestGenerator::TestSameKeys () {
+        for (unsigned seed = 1; seed < 5; ++seed) {
+            VERIFY_TRUE(SameKeys <2> (Generate <2, double> (GpsGenerator <2> (seed), 5000)));
+            VERIFY_TRUE(SameKeys <2> (Generate <2, double> (WalkGenerator <2> (seed), 5000)));
+            VERIFY_TRUE(SameKeys <3> (Generate <3, double> (CoastlineGenerator <3> (seed), 5000)));
+        }
+        VERIFY_TRUE(SameKeys <2> (Generate <2, double> (ZigZagGenerator <2> (1000), 1000)));
+    }
+
+    // each complete point is produced
+    void TestGenerator::TestInvalidInput () {
+        VERIFY_TRUE(SameKeys <2> (std::vector <double> ()));
+        VERIFY_TRUE(SameKeys <2> (Generate <2, double> (GpsGenerator <2> (1), 1)));
+        VERIFY_TRUE(SameKeys <2> (Generate <2, double> (GpsGenerator <2> (1), 2)));
+
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (1), 100);
+        polyline.pop_back ();
+        std::vector <double> complete (polyline.begin (), polyline.end () - 1);
+        VERIFY_TRUE(Collect <2> (generate_radial_distance <2> (polyline.cbegin (), polyline.cend (), 5.0)) == complete);
+        VERIFY_TRUE(Collect <2> (generate_nth_point <2> (polyline.cbegin (), polyline.cend (), 0)) == complete);
+        VERIFY_TRUE(Collect <2> (generate_radial_distance <2> (complete.cbegin (), complete.cend (), 0.0)) == complete);
+    }
+
+    // the polyline is only processed as far as required for the requested keys
+    void TestGenerator::TestLazy () {
+        typedef CountingIterator <std::vector <double>::const_iterator> iterator;
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (7), 100000);
+        iterator first (polyline.begin ());
+        iterator last (polyline.end ());
+
+        Counts ().Reset ();
+        Generator <iterator> keys = generate_reumann_witkam <2> (first, last, 5.0);
+        VERIFY_TRUE(Counts ().dereferences == 0);
+
+        std::size_t keyCount = 0;
+        iterator key;
+        for (iterator k : keys) {
+            key = k;
+            if (++keyCount == 10) {
+                break;
+            }
+        }
+        std::size_t prefix = Counts ().dereferences;
+        VERIFY_TRUE(keyCount == 10);
+        VERIFY_TRUE(key.Base () - polyline.begin () < 1000);
+
+        Counts ().Reset ();
+        Collect <2> (generate_reumann_witkam <2> (first, last, 5.0));
+        VERIFY_TRUE(prefix * 100 < Counts ().dereferences);
+    }
+
+    // a traversal that stopped early can be continued
+    void TestGenerator::TestResume () {
+        std::vector <double> polyline = Generate <2, double> (WalkGenerator <2> (3), 10000);
+        std::vector <double> expected;
+        simplify_opheim <2> (polyline.begin (), polyline.end (), 5.0, 20.0, std::back_inserter (expected));
+
+        Generator <std::vector <double>::const_iterator> keys =
+            generate_opheim <2> (polyline.cbegin (), polyline.cend (), 5.0, 20.0);
+        Generator <std::vector <double>::const_iterator>::iterator key = keys.begin ();
+        std::vector <double> result;
+        unsigned frames = 0;
+        for (; key != keys.end (); ++frames) {
+            // a few keys per frame
+            for (unsigned count = 0; key != keys.end () && count < 5; ++key, ++count) {
+                result.insert (result.end (), *key, *key + 2);
+            }
+        }
+        VERIFY_TRUE(frames == (expected.size () / 2 + 4) / 5);
+        VERIFY_TRUE(result == expected);
+    }
+#endif
+}}
@@ -0,0 +1,149 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestGenerators.h"
+#include "generators.h"
+#include "../lib/psimpl.h"
+#include <cmath>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    TestGenerators::TestGenerators () {
+        TEST_RUN("splitmix64", TestSplitMix64 ());
+        TEST_RUN("determinism", TestDeterminism ());
+        TEST_RUN("lazy iterator", TestLazyIterator ());
+        TEST_RUN("zig-zag", TestZigZag ());
+        TEST_RUN("coastline", TestCoastline ());
+        TEST_RUN("dwell", TestDwell ());
+    }
+
+    // reference values of the splitmix64 algorithm for seed 1234567
+    void TestGenerators::TestSplitMix64 () {
+        SplitMix64 random (1234567);
+        VERIFY_TRUE(random.Next () == 6457827717110365317ull);
+        VERIFY_TRUE(random.Next () == 3203168211198807973ull);
+        VERIFY_TRUE(random.Next () == 9817491932198370423ull);
+
+        double min = 1, max = 0;
+        for (unsigned i = 0; i < 10000; ++i) {
+            double u = random.Uniform ();
+            min = std::min (min, u);
+            max = std::max (max, u);
+        }
+        VERIFY_TRUE(0 <= min && min < 0.01);
+        VERIFY_TRUE(0.99 < max && max < 1);
+    }
+
+    // the same seed produces the same polyline, another seed does not
+    void TestGenerators::TestDeterminism () {
+        VERIFY_TRUE((Generate <2, double> (WalkGenerator <2> (5), 1000) == Generate <2, double> (WalkGenerator <2> (5), 1000)));
+        VERIFY_FALSE((Generate <2, double> (WalkGenerator <2> (5), 1000) == Generate <2, double> (WalkGenerator <2> (6), 1000)));
+        VERIFY_TRUE((Generate <3, double> (GpsGenerator <3> (5), 1000) == Generate <3, double> (GpsGenerator <3> (5), 1000)));
+        VERIFY_TRUE((Generate <2, float> (CoastlineGenerator <2> (1000, 5), 1000) == Generate <2, float> (CoastlineGenerator <2> (1000, 5), 1000)));
+        VERIFY_TRUE((Generate <2, int> (DwellGenerator <2> (5, 10, 10, 10, 1), 1000) == Generate <2, int> (DwellGenerator <2> (5, 10, 10, 10, 1), 1000)));
+
+        // one point per turn
+        std::vector <double> spiral = Generate <3, double> (SpiralGenerator <3> (1, 10), 3);
+        const double expected [] = { 0, 0, 0, 10, 0, 10, 20, 0, 20 };
+        for (unsigned c = 0; c < 9; ++c) {
+            VERIFY_TRUE(std::fabs (spiral [c] - expected [c]) < 1e-9);
+        }
+    }
+
+    // iterating lazily equals generating at once, and copies replay the same points
+    void TestGenerators::TestLazyIterator () {
+        typedef GeneratedPolyline <2, double, GpsGenerator <2> > Polyline;
+        Polyline polyline (GpsGenerator <2> (3), 500);
+        std::vector <double> coords = polyline.ToVector ();
+        ASSERT_TRUE(coords.size () == 1000);
+
+        std::vector <double> lazy;
+        Polyline::const_iterator it = polyline.begin ();
+        Polyline::const_iterator copy = it;
+        for (; it != polyline.end (); ++it) {
+            lazy.push_back (*it);
+        }
+        VERIFY_TRUE(lazy == coords);
+        VERIFY_TRUE(*copy == coords [0]);
+        VERIFY_TRUE(std::distance (copy, polyline.end ()) == 1000);
+
+        // algorithms accept the iterators directly
+        std::vector <double> expected;
+        simplify_radial_distance <2> (coords.begin (), coords.end (), 5.0, std::back_inserter (expected));
+        std::vector <double> result;
+        simplify_radial_distance <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        // empty
+        Polyline empty (GpsGenerator <2> (3), 0);
+        VERIFY_TRUE(empty.begin () == empty.end ());
+    }
+
+    // douglas-peucker keeps all points
+    void TestGenerators::TestZigZag () {
+        std::vector <double> coords = Generate <2, double> (ZigZagGenerator <2> (2000), 2000);
+        VERIFY_TRUE(coords [0] == 0 && coords [1] == 10);
+        VERIFY_TRUE(coords [2] == 10 && coords [3] < -9.99 && coords [3] > -10);
+        VERIFY_TRUE(coords [3999] < -5);
+
+        std::vector <double> result;
+        simplify_douglas_peucker <2> (coords.begin (), coords.end (), 2.4, std::back_inserter (result));
+        VERIFY_TRUE(result == coords);
+    }
+
+    // a prefix of 2^k + 1 points, ending at the last point of the subdivision
+    void TestGenerators::TestCoastline () {
+        std::vector <double> coords = Generate <2, double> (CoastlineGenerator <2> (1025, 7, 10), 1025);
+        ASSERT_TRUE(coords.size () == 2050);
+        VERIFY_TRUE(coords [0] == 0 && coords [1] == 0);
+        VERIFY_TRUE(coords [2048] == 10240 && coords [2049] == 0);
+
+        std::vector <double> prefix = Generate <2, double> (CoastlineGenerator <2> (1000, 7, 10), 1000);
+        VERIFY_TRUE(std::equal (prefix.begin (), prefix.end (), coords.begin ()));
+    }
+
+    // dwell periods without noise are exact duplicates
+    void TestGenerators::TestDwell () {
+        std::vector <double> coords = Generate <2, double> (DwellGenerator <2> (1, 10, 90), 300);
+        unsigned duplicates = 0;
+        for (std::size_t p = 1; p < 300; ++p) {
+            if (coords [p * 2] == coords [p * 2 - 2] && coords [p * 2 + 1] == coords [p * 2 - 1]) {
+                ++duplicates;
+            }
+        }
+        VERIFY_TRUE(duplicates == 3 * 90);
+    }
+}}
@@ -0,0 +1,264 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestIncremental.h"
+#include "helper.h"
+#include "../lib/psimpl_incremental.h"
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    // compares the incremental simplification with a full douglas-peucker run
+    template <unsigned DIM>
+    bool SameAsFullRun (const IncrementalDouglasPeucker <DIM, double>& dp,
+                        const std::vector <double>& polyline, double tol)
+    {
+        std::vector <double> expected;
+        simplify_douglas_peucker <DIM> (polyline.begin (), polyline.end (), tol,
+            std::back_inserter (expected), PREFILTER_NONE);
+        std::vector <double> result;
+        dp.Simplification (std::back_inserter (result));
+        return dp.point_count () * DIM == polyline.size () && result == expected;
+    }
+
+    TestIncremental::TestIncremental () {
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("assign", TestAssign ());
+        TEST_RUN("move", TestMove ());
+        TEST_RUN("insert", TestInsert ());
+        TEST_RUN("erase", TestErase ());
+        TEST_RUN("endpoints", TestEndpoints ());
+        TEST_RUN("random edits", TestRandomEdits ());
+    }
+
+    void TestIncremental::TestInvalidInput () {
+        const double coords [] = { 1, 2, 3, 4, 5 };
+        const double point [] = { 0, 0 };
+        IncrementalDouglasPeucker <2, double> dp;
+
+        // incomplete point
+        VERIFY_FALSE(dp.Assign (coords, coords + 5, 1.0));
+        VERIFY_TRUE(dp.point_count () == 0);
+        // single point
+        VERIFY_FALSE(dp.Assign (coords, coords + 2, 1.0));
+        VERIFY_FALSE(dp.Insert (0, point));
+        VERIFY_FALSE(dp.Move (0, point));
+        VERIFY_FALSE(dp.Erase (0));
+
+        // index out of range
+        VERIFY_TRUE(dp.Assign (coords, coords + 4, 1.0));
+        VERIFY_FALSE(dp.Move (2, point));
+        VERIFY_FALSE(dp.Insert (3, point));
+        // at least 2 points remain
+        VERIFY_FALSE(dp.Erase (0));
+        VERIFY_TRUE(dp.point_count () == 2);
+    }
+
+    void TestIncremental::TestAssign () {
+        std::vector <double> polyline = RandomWalk <double, 2> (2000, 1, true);
+        const double tols [] = { 0, 0.1, 1, 10 };
+        for (unsigned t = 0; t < sizeof (tols) / sizeof (tols [0]); ++t) {
+            IncrementalDouglasPeucker <2, double> dp;
+            VERIFY_TRUE(dp.Assign (polyline.begin (), polyline.end (), tols [t]));
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tols [t]));
+        }
+        std::vector <double> polyline3d = RandomWalk <double, 3> (2000, 2, true);
+        IncrementalDouglasPeucker <3, double> dp3d;
+        VERIFY_TRUE(dp3d.Assign (polyline3d.begin (), polyline3d.end (), 1.0));
+        VERIFY_TRUE(SameAsFullRun (dp3d, polyline3d, 1.0));
+    }
+
+    // moves keys and non-keys, far away and back again
+    void TestIncremental::TestMove () {
+        std::vector <double> polyline = RandomWalk <double, 2> (2000, 3, true);
+        const double tol = 1.0;
+        IncrementalDouglasPeucker <2, double> dp;
+        ASSERT_TRUE(dp.Assign (polyline.begin (), polyline.end (), tol));
+
+        for (std::size_t index = 1; index < 2000; index += 97) {
+            const double original [] = { polyline [index * 2], polyline [index * 2 + 1] };
+            const double far [] = { original [0] + 50, original [1] - 30 };
+            const double near [] = { original [0] + 0.01, original [1] };
+
+            ASSERT_TRUE(dp.Move (index, far));
+            polyline [index * 2] = far [0];
+            polyline [index * 2 + 1] = far [1];
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+            ASSERT_TRUE(dp.Move (index, near));
+            polyline [index * 2] = near [0];
+            polyline [index * 2 + 1] = near [1];
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+            ASSERT_TRUE(dp.Move (index, original));
+            polyline [index * 2] = original [0];
+            polyline [index * 2 + 1] = original [1];
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+        }
+    }
+
+    void TestIncremental::TestInsert () {
+        std::vector <double> polyline = RandomWalk <double, 2> (1000, 4, true);
+        const double tol = 0.5;
+        IncrementalDouglasPeucker <2, double> dp;
+        ASSERT_TRUE(dp.Assign (polyline.begin (), polyline.end (), tol));
+
+        for (std::size_t index = 1; index < 1000; index += 83) {
+            // a spike, and a point halfway its neighbours
+            const double spike [] = { polyline [index * 2] + 20, polyline [index * 2 + 1] + 20 };
+            ASSERT_TRUE(dp.Insert (index, spike));
+            polyline.insert (polyline.begin () + index * 2, spike, spike + 2);
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+            const double halfway [] = { (polyline [index * 2] + polyline [index * 2 + 2]) / 2,
+                                        (polyline [index * 2 + 1] + polyline [index * 2 + 3]) / 2 };
+            ASSERT_TRUE(dp.Insert (index + 1, halfway));
+            polyline.insert (polyline.begin () + (index + 1) * 2, halfway, halfway + 2);
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+        }
+    }
+
+    void TestIncremental::TestErase () {
+        std::vector <double> polyline = RandomWalk <double, 2> (1000, 5, true);
+        const double tol = 0.5;
+        IncrementalDouglasPeucker <2, double> dp;
+        ASSERT_TRUE(dp.Assign (polyline.begin (), polyline.end (), tol));
+
+        // erase keys and non-keys alike, until only the endpoints remain
+        std::size_t index = 1;
+        while (dp.point_count () > 2) {
+            index = 1 + (index * 7919) % (dp.point_count () - 2);
+            ASSERT_TRUE(dp.Erase (index));
+            polyline.erase (polyline.begin () + index * 2, polyline.begin () + index * 2 + 2);
+            VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+        }
+        VERIFY_FALSE(dp.Erase (1));
+    }
+
+    void TestIncremental::TestEndpoints () {
+        std::vector <double> polyline = RandomWalk <double, 2> (1000, 6, true);
+        const double tol = 0.5;
+        IncrementalDouglasPeucker <2, double> dp;
+        ASSERT_TRUE(dp.Assign (polyline.begin (), polyline.end (), tol));
+
+        const double point [] = { -10, 10 };
+        ASSERT_TRUE(dp.Move (0, point));
+        polyline [0] = point [0];
+        polyline [1] = point [1];
+        VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+        ASSERT_TRUE(dp.Move (999, point));
+        polyline [1998] = point [0];
+        polyline [1999] = point [1];
+        VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+        ASSERT_TRUE(dp.Insert (0, point));
+        polyline.insert (polyline.begin (), point, point + 2);
+        VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+        ASSERT_TRUE(dp.Insert (dp.point_count (), point));
+        polyline.insert (polyline.end (), point, point + 2);
+        VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+        ASSERT_TRUE(dp.Erase (0));
+        polyline.erase (polyline.begin (), polyline.begin () + 2);
+        VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+
+        ASSERT_TRUE(dp.Erase (dp.point_count () - 1));
+        polyline.erase (polyline.end () - 2, polyline.end ());
+        VERIFY_TRUE(SameAsFullRun (dp, polyline, tol));
+    }
+
+    // a mix of all edits, including points on exact integer positions to provoke ties
+    void TestIncremental::TestRandomEdits () {
+        std::vector <double> polyline = RandomWalk <double, 2> (500, 7, false);
+        for (std::size_t c = 0; c < polyline.size (); ++c) {
+            polyline [c] = static_cast <int> (polyline [c] * 2);
+        }
+        const double tol = 1.5;
+        IncrementalDouglasPeucker <2, double> dp;
+        ASSERT_TRUE(dp.Assign (polyline.begin (), polyline.end (), tol));
+
+        unsigned seed = 42;
+        bool same = true;
+        for (unsigned edit = 0; edit < 2000; ++edit) {
+            seed = seed * 1103515245u + 12345u;
+            std::size_t pointCount = dp.point_count ();
+            std::size_t index = (seed >> 8) % pointCount;
+            const double point [] = { static_cast <double> ((seed >> 4) % 41) - 20,
+                                      static_cast <double> ((seed >> 12) % 41) - 20 };
+            switch ((seed >> 20) % 3) {
+            case 0:
+                dp.Move (index, point);
+                polyline [index * 2] = point [0];
+                polyline [index * 2 + 1] = point [1];
+                break;
+            case 1:
+                dp.Insert (index, point);
+                polyline.insert (polyline.begin () + index * 2, point, point + 2);
+                break;
+            default:
+                if (dp.Erase (index)) {
+                    polyline.erase (polyline.begin () + index * 2, polyline.begin () + index * 2 + 2);
+                }
+                break;
+            }
+            same = same && SameAsFullRun (dp, polyline, tol);
+        }
+        VERIFY_TRUE(same);
+
+        // short polylines on a small grid, where equal distances are common
+        same = true;
+        for (unsigned run = 0; run < 200; ++run) {
+            polyline.clear ();
+            for (unsigned c = 0; c < 16; ++c) {
+                seed = seed * 1103515245u + 12345u;
+                polyline.push_back (static_cast <double> ((seed >> 8) % 5));
+            }
+            ASSERT_TRUE(dp.Assign (polyline.begin (), polyline.end (), 0.5));
+            for (unsigned edit = 0; edit < 20; ++edit) {
+                seed = seed * 1103515245u + 12345u;
+                std::size_t index = 1 + (seed >> 8) % (dp.point_count () - 2);
+                const double point [] = { static_cast <double> ((seed >> 4) % 5),
+                                          static_cast <double> ((seed >> 12) % 5) };
+                dp.Move (index, point);
+                polyline [index * 2] = point [0];
+                polyline [index * 2 + 1] = point [1];
+                same = same && SameAsFullRun (dp, polyline, 0.5);
+            }
+        }
+        VERIFY_TRUE(same);
+    }
+}}
@@ -0,0 +1,273 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "TestInplace.h"
+#include "helper.h"
+#include "../lib/psimpl.h"
+#include <vector>
+#include <deque>
+#include <list>
+
+
+namespace psimpl {
+    namespace test
+{
+    //! \brief checks if the range [first, last) equals the expected simplification
+    template <class InputIterator, class T>
+    bool CompareInplace (InputIterator first, InputIterator last, const std::vector <T>& expected) {
+        return std::distance (first, last) == static_cast <std::ptrdiff_t> (expected.size ()) &&
+               std::equal (expected.begin (), expected.end (), first);
+    }
+
+    TestInplace::TestInplace () {
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("nth point", TestNthPoint ());
+        TEST_RUN("radial distance", TestRadialDistance ());
+        TEST_RUN("perpendicular distance", TestPerpendicularDistance ());
+        TEST_RUN("reumann witkam", TestReumannWitkam ());
+        TEST_RUN("opheim", TestOpheim ());
+        TEST_RUN("lang", TestLang ());
+        TEST_RUN("douglas peucker", TestDouglasPeucker ());
+        TEST_RUN("douglas peucker n", TestDouglasPeuckerN ());
+    }
+
+    // invalid input leaves the range untouched and returns last
+    void TestInplace::TestInvalidInput () {
+        const unsigned DIM = 2;
+
+        // 4th point incomplete
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), 4*DIM-1, SawToothLine <float, DIM> ());
+        std::vector <float> original (polyline);
+
+        VERIFY_TRUE(psimpl::simplify_nth_point_inplace <DIM> (polyline.begin (), polyline.end (), 2) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_radial_distance_inplace <DIM> (polyline.begin (), polyline.end (), 1.f) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_perpendicular_distance_inplace <DIM> (polyline.begin (), polyline.end (), 1.f, 3) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_reumann_witkam_inplace <DIM> (polyline.begin (), polyline.end (), 1.f) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_opheim_inplace <DIM> (polyline.begin (), polyline.end (), 1.f, 2.f) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_lang_inplace <DIM> (polyline.begin (), polyline.end (), 1.f, 3) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_douglas_peucker_inplace <DIM> (polyline.begin (), polyline.end (), 1.f) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_douglas_peucker_n_inplace <DIM> (polyline.begin (), polyline.end (), 3) == polyline.end ());
+        VERIFY_TRUE(polyline == original);
+
+        // invalid tol
+        polyline.push_back (4.f);
+        original = polyline;
+
+        VERIFY_TRUE(psimpl::simplify_radial_distance_inplace <DIM> (polyline.begin (), polyline.end (), 0.f) == polyline.end ());
+        VERIFY_TRUE(psimpl::simplify_douglas_peucker_inplace <DIM> (polyline.begin (), polyline.end (), 0.f) == polyline.end ());
+        VERIFY_TRUE(polyline == original);
+    }
+
+    void TestInplace::TestNthPoint () {
+        const unsigned DIM = 2;
+        const unsigned count = 21;
+        const unsigned n = 3;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SawToothLine <float, DIM> ());
+        std::vector <float> expected;
+        psimpl::simplify_nth_point <DIM> (polyline.begin (), polyline.end (), n, std::back_inserter (expected));
+        {
+            std::vector <float> inplace (polyline);
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_nth_point_inplace <DIM> (inplace.begin (), inplace.end (), n), expected));
+        }
+        {
+            std::list <float> inplace (polyline.begin (), polyline.end ());
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_nth_point_inplace <DIM> (inplace.begin (), inplace.end (), n), expected));
+        }
+    }
+
+    void TestInplace::TestRadialDistance () {
+        const unsigned DIM = 3;
+        const unsigned count = 21;
+        const double tol = 2.5;
+
+        std::vector <double> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SawToothLine <double, DIM> ());
+        std::vector <double> expected;
+        psimpl::simplify_radial_distance <DIM> (polyline.begin (), polyline.end (), tol, std::back_inserter (expected));
+        ASSERT_TRUE(expected.size () < polyline.size ());
+        {
+            std::vector <double> inplace (polyline);
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_radial_distance_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+        }
+        {
+            std::deque <double> inplace (polyline.begin (), polyline.end ());
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_radial_distance_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+        }
+    }
+
+    void TestInplace::TestPerpendicularDistance () {
+        const unsigned DIM = 2;
+        const unsigned count = 31;
+        const float tol = 1.5f;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SquareToothLine <float, DIM> ());
+
+        // single pass
+        {
+            std::vector <float> expected;
+            psimpl::simplify_perpendicular_distance <DIM> (polyline.begin (), polyline.end (), tol, std::back_inserter (expected));
+            ASSERT_TRUE(expected.size () < polyline.size ());
+
+            std::vector <float> inplace (polyline);
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_perpendicular_distance_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+        }
+        // multiple passes
+        for (unsigned repeat = 1; repeat < 5; ++repeat) {
+            std::vector <float> expected;
+            psimpl::simplify_perpendicular_distance <DIM> (polyline.begin (), polyline.end (), tol, repeat, std::back_inserter (expected));
+
+            float inplace [count*DIM];
+            std::copy (polyline.begin (), polyline.end (), inplace);
+            VERIFY_TRUE(CompareInplace (inplace + 0,
+                psimpl::simplify_perpendicular_distance_inplace <DIM> (inplace, inplace + count*DIM, tol, repeat), expected));
+        }
+    }
+
+    void TestInplace::TestReumannWitkam () {
+        const unsigned DIM = 2;
+        const unsigned count = 31;
+        const float tol = 1.5f;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SquareToothLine <float, DIM> ());
+        std::vector <float> expected;
+        psimpl::simplify_reumann_witkam <DIM> (polyline.begin (), polyline.end (), tol, std::back_inserter (expected));
+        ASSERT_TRUE(expected.size () < polyline.size ());
+        {
+            std::vector <float> inplace (polyline);
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_reumann_witkam_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+        }
+        {
+            std::list <float> inplace (polyline.begin (), polyline.end ());
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_reumann_witkam_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+        }
+    }
+
+    void TestInplace::TestOpheim () {
+        const unsigned DIM = 2;
+        const unsigned count = 31;
+        const float min_tol = 1.5f;
+        const float max_tol = 5.f;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SquareToothLine <float, DIM> ());
+        std::vector <float> expected;
+        psimpl::simplify_opheim <DIM> (polyline.begin (), polyline.end (), min_tol, max_tol, std::back_inserter (expected));
+        ASSERT_TRUE(expected.size () < polyline.size ());
+        {
+            std::vector <float> inplace (polyline);
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_opheim_inplace <DIM> (inplace.begin (), inplace.end (), min_tol, max_tol), expected));
+        }
+        {
+            std::list <float> inplace (polyline.begin (), polyline.end ());
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_opheim_inplace <DIM> (inplace.begin (), inplace.end (), min_tol, max_tol), expected));
+        }
+    }
+
+    void TestInplace::TestLang () {
+        const unsigned DIM = 2;
+        const unsigned count = 31;
+        const float tol = 1.5f;
+        const unsigned look_ahead = 7;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SquareToothLine <float, DIM> ());
+        std::vector <float> expected;
+        psimpl::simplify_lang <DIM> (polyline.begin (), polyline.end (), tol, look_ahead, std::back_inserter (expected));
+        ASSERT_TRUE(expected.size () < polyline.size ());
+        {
+            std::vector <float> inplace (polyline);
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_lang_inplace <DIM> (inplace.begin (), inplace.end (), tol, look_ahead), expected));
+        }
+        {
+            std::list <float> inplace (polyline.begin (), polyline.end ());
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_lang_inplace <DIM> (inplace.begin (), inplace.end (), tol, look_ahead), expected));
+        }
+    }
+
+    void TestInplace::TestDouglasPeucker () {
+        const unsigned DIM = 2;
+        const unsigned count = 31;
+
+        std::vector <double> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SquareToothLine <double, DIM> ());
+
+        for (double tol = 0.5; tol < 4.0; tol += 0.5) {
+            std::vector <double> expected;
+            psimpl::simplify_douglas_peucker <DIM> (polyline.begin (), polyline.end (), tol, std::back_inserter (expected));
+            {
+                std::vector <double> inplace (polyline);
+                VERIFY_TRUE(CompareInplace (inplace.begin (),
+                    psimpl::simplify_douglas_peucker_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+            }
+            {
+                std::list <double> inplace (polyline.begin (), polyline.end ());
+                VERIFY_TRUE(CompareInplace (inplace.begin (),
+                    psimpl::simplify_douglas_peucker_inplace <DIM> (inplace.begin (), inplace.end (), tol), expected));
+            }
+        }
+    }
+
+    void TestInplace::TestDouglasPeuckerN () {
+        const unsigned DIM = 3;
+        const unsigned count = 31;
+
+        std::vector <int> polyline;
+        std::generate_n (std::back_inserter (polyline), count*DIM, SquareToothLine <int, DIM> ());
+
+        for (unsigned n = 2; n < count; n += 4) {
+            std::vector <int> expected;
+            psimpl::simplify_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), n, std::back_inserter (expected));
+
+            std::deque <int> inplace (polyline.begin (), polyline.end ());
+            VERIFY_TRUE(CompareInplace (inplace.begin (),
+                psimpl::simplify_douglas_peucker_n_inplace <DIM> (inplace.begin (), inplace.end (), n), expected));
+        }
+    }
+}}
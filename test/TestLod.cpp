@@ -0,0 +1,221 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestLod.h"
+#include "helper.h"
+#include "../lib/psimpl_lod.h"
+#include <algorithm>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    // records all parts
+    struct LodRecord
+    {
+        void operator () (const double* first, const double* last) {
+            parts.push_back (std::vector <double> (first, last));
+        }
+
+        std::vector <std::vector <double> > parts;
+    };
+
+    // brute force 2d segment box intersection, by clipping against each box edge
+    bool SegmentIntersectsBox (const double* p, const double* q, const double* min, const double* max) {
+        double a [2] = { p [0], p [1] };
+        double b [2] = { q [0], q [1] };
+        for (unsigned d = 0; d < 2; ++d) {
+            for (int side = 0; side < 2; ++side) {
+                double bound = side ? max [d] : min [d];
+                bool aIn = side ? a [d] <= bound : a [d] >= bound;
+                bool bIn = side ? b [d] <= bound : b [d] >= bound;
+                if (!aIn && !bIn) {
+                    return false;
+                }
+                if (aIn != bIn) {
+                    double t = (bound - a [d]) / (b [d] - a [d]);
+                    double* out = aIn ? b : a;
+                    double x [2] = { a [0] + t * (b [0] - a [0]), a [1] + t * (b [1] - a [1]) };
+                    out [0] = x [0];
+                    out [1] = x [1];
+                    out [d] = bound;
+                }
+            }
+        }
+        return true;
+    }
+
+    // splits the douglas-peucker simplification into parts that intersect the viewport
+    std::vector <std::vector <double> > ExpectedParts (const std::vector <double>& polyline, double tol,
+                                                       const double* min, const double* max)
+    {
+        std::vector <double> simplification;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), tol,
+            std::back_inserter (simplification), PREFILTER_NONE);
+
+        std::vector <std::vector <double> > parts;
+        std::vector <double> part;
+        for (std::size_t i = 0; i + 2 < simplification.size (); i += 2) {
+            const double* p = &simplification [i];
+            const double* q = &simplification [i + 2];
+            if (!SegmentIntersectsBox (p, q, min, max)) {
+                if (!part.empty ()) {
+                    parts.push_back (part);
+                    part.clear ();
+                }
+                continue;
+            }
+            if (part.empty ()) {
+                part.insert (part.end (), p, p + 2);
+            }
+            part.insert (part.end (), q, q + 2);
+        }
+        if (!part.empty ()) {
+            parts.push_back (part);
+        }
+        return parts;
+    }
+
+    TestLod::TestLod () {
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("full viewport", TestFullViewport ());
+        TEST_RUN("viewports", TestViewports ());
+        TEST_RUN("empty viewport", TestEmptyViewport ());
+        TEST_RUN("zero tolerance", TestZeroTolerance ());
+    }
+
+    void TestLod::TestInvalidInput () {
+        const double coords [] = { 1, 2, 3 };
+        LodIndex <2, double> index;
+        VERIFY_FALSE(index.Build (coords, coords + 3));
+        VERIFY_TRUE(index.point_count () == 0);
+
+        const double min [] = { -1e9, -1e9 };
+        const double max [] = { 1e9, 1e9 };
+        LodRecord sink;
+        VERIFY_TRUE(index.Query (min, max, 1.0, sink) == 0);
+        VERIFY_TRUE(sink.parts.empty ());
+
+        // two points
+        const double line [] = { 1, 2, 3, 4 };
+        VERIFY_TRUE(index.Build (line, line + 4));
+        VERIFY_TRUE(index.Query (min, max, 1.0, sink) == 2);
+        ASSERT_TRUE(sink.parts.size () == 1);
+        VERIFY_TRUE(sink.parts [0] == std::vector <double> (line, line + 4));
+    }
+
+    // the whole polyline equals the douglas-peucker simplification
+    void TestLod::TestFullViewport () {
+        std::vector <double> polyline = RandomWalk <double, 2> (5000, 3, true);
+        LodIndex <2, double> index;
+        ASSERT_TRUE(index.Build (polyline.begin (), polyline.end ()));
+        VERIFY_TRUE(index.point_count () == 5000);
+
+        double min [2], max [2];
+        index.Bounds (min, max);
+        const double tols [] = { 0, 0.1, 0.5, 2, 10, 1000 };
+        for (unsigned t = 0; t < sizeof (tols) / sizeof (tols [0]); ++t) {
+            std::vector <double> expected;
+            simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), tols [t],
+                std::back_inserter (expected), PREFILTER_NONE);
+
+            LodRecord sink;
+            VERIFY_TRUE(index.Query (min, max, tols [t], sink) == expected.size () / 2);
+            ASSERT_TRUE(sink.parts.size () == 1);
+            VERIFY_TRUE(sink.parts [0] == expected);
+        }
+    }
+
+    // random viewports match a brute force selection of the visible segments
+    void TestLod::TestViewports () {
+        std::vector <double> polyline = RandomWalk <double, 2> (5000, 7, true);
+        LodIndex <2, double> index;
+        ASSERT_TRUE(index.Build (polyline.begin (), polyline.end ()));
+
+        const double tols [] = { 0.2, 1, 5, 25 };
+        for (std::size_t p = 0; p < 5000; p += 450) {
+            // a viewport around a polyline point, growing in size
+            double size = 2.0 + p / 50.0;
+            double min [2], max [2];
+            for (unsigned d = 0; d < 2; ++d) {
+                min [d] = polyline [p * 2 + d] - size;
+                max [d] = polyline [p * 2 + d] + size / 2;
+            }
+            for (unsigned t = 0; t < sizeof (tols) / sizeof (tols [0]); ++t) {
+                LodRecord sink;
+                index.Query (min, max, tols [t], sink);
+                VERIFY_TRUE(sink.parts == ExpectedParts (polyline, tols [t], min, max));
+            }
+        }
+    }
+
+    void TestLod::TestEmptyViewport () {
+        std::vector <double> polyline = RandomWalk <double, 2> (1000, 5, true);
+        LodIndex <2, double> index;
+        ASSERT_TRUE(index.Build (polyline.begin (), polyline.end ()));
+
+        double min [2], max [2];
+        index.Bounds (min, max);
+        const double outsideMin [] = { max [0] + 1, min [1] };
+        const double outsideMax [] = { max [0] + 2, max [1] };
+        LodRecord sink;
+        VERIFY_TRUE(index.Query (outsideMin, outsideMax, 0.5, sink) == 0);
+        VERIFY_TRUE(sink.parts.empty ());
+    }
+
+    // like douglas-peucker, a zero tolerance keeps points with importance 0
+    void TestLod::TestZeroTolerance () {
+        // collinear and duplicate points
+        const double coords [] = { 0, 0, 1, 0, 2, 0, 2, 0, 3, 1, 4, 2, 4, 2, 5, 0 };
+        std::vector <double> polyline (coords, coords + 16);
+        LodIndex <2, double> index;
+        ASSERT_TRUE(index.Build (polyline.begin (), polyline.end ()));
+
+        std::vector <double> expected;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 0.0,
+            std::back_inserter (expected), PREFILTER_NONE);
+        VERIFY_TRUE(expected == polyline);
+
+        double min [2], max [2];
+        index.Bounds (min, max);
+        LodRecord sink;
+        VERIFY_TRUE(index.Query (min, max, 0.0, sink) == 8);
+        ASSERT_TRUE(sink.parts.size () == 1);
+        VERIFY_TRUE(sink.parts [0] == expected);
+
+        // any positive tolerance drops them
+        LodRecord reduced;
+        VERIFY_TRUE(index.Query (min, max, 1e-9, reduced) < 8);
+    }
+}}
@@ -0,0 +1,178 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "TestOutOfCore.h"
+#include "helper.h"
+#include "../lib/psimpl_mmap.h"
+#include <vector>
+#include <cstdio>
+
+
+namespace psimpl {
+    namespace test
+{
+    static const char* test_file = "psimpl_test_out_of_core.bin";
+
+    //! \brief checks if the out-of-core and in-memory DP yield the same simplification
+    template <unsigned DIM, typename T>
+    bool CompareOutOfCore (const std::vector <T>& polyline, T tol) {
+        std::vector <T> expected;
+        std::vector <T> result;
+        psimpl::simplify_douglas_peucker <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (expected));
+        psimpl::simplify_douglas_peucker_out_of_core <DIM> (
+            &polyline [0], &polyline [0] + polyline.size (), tol,
+            std::back_inserter (result));
+        return result == expected;
+    }
+
+    //! \brief writes the coordinates of a polyline to a file
+    template <typename T>
+    bool WriteFile (const char* path, const std::vector <T>& polyline) {
+        std::FILE* file = std::fopen (path, "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = polyline.empty () ||
+                  std::fwrite (&polyline [0], sizeof (T), polyline.size (), file) == polyline.size ();
+        return std::fclose (file) == 0 && ok;
+    }
+
+    TestOutOfCore::TestOutOfCore () {
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("smooth line", TestSmoothLine ());
+        TEST_RUN("noisy line", TestNoisyLine ());
+        TEST_RUN("large line", TestLargeLine ());
+        TEST_RUN("mapped file", TestMappedFile ());
+        TEST_RUN("invalid file", TestInvalidFile ());
+    }
+
+    // invalid input is copied
+    void TestOutOfCore::TestInvalidInput () {
+        const unsigned DIM = 2;
+
+        std::vector <float> polyline;
+        std::generate_n (std::back_inserter (polyline), 10*DIM-1, SawToothLine <float, DIM> ());
+        std::vector <float> result;
+
+        psimpl::simplify_douglas_peucker_out_of_core <DIM> (
+            &polyline [0], &polyline [0] + polyline.size (), 1.f,
+            std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+
+        polyline.push_back (0.f);
+        result.clear ();
+        psimpl::simplify_douglas_peucker_out_of_core <DIM> (
+            &polyline [0], &polyline [0] + polyline.size (), 0.f,
+            std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+    }
+
+    void TestOutOfCore::TestSmoothLine () {
+        const unsigned count = 5000;
+
+        for (unsigned seed = 1; seed <= 3; ++seed) {
+            VERIFY_TRUE((CompareOutOfCore <2, float> (RandomWalk <float, 2> (count, seed, true), 0.5f)));
+            VERIFY_TRUE((CompareOutOfCore <3, double> (RandomWalk <double, 3> (count, seed, true), 0.1)));
+        }
+    }
+
+    void TestOutOfCore::TestNoisyLine () {
+        const unsigned count = 5000;
+
+        for (unsigned seed = 1; seed <= 3; ++seed) {
+            VERIFY_TRUE((CompareOutOfCore <2, float> (RandomWalk <float, 2> (count, seed, false), 1.f)));
+            VERIFY_TRUE((CompareOutOfCore <2, int> (RandomWalk <int, 2> (count, seed, false), 2)));
+        }
+    }
+
+    // spans multiple read ahead chunks
+    void TestOutOfCore::TestLargeLine () {
+        const unsigned count = 300000;
+
+        VERIFY_TRUE((CompareOutOfCore <2, double> (RandomWalk <double, 2> (count, 5, true), 0.2)));
+    }
+
+    void TestOutOfCore::TestMappedFile () {
+        const unsigned DIM = 2;
+        const float tol = 0.5f;
+
+        std::vector <float> polyline = RandomWalk <float, DIM> (20000, 11, true);
+        ASSERT_TRUE(WriteFile (test_file, polyline));
+
+        std::vector <float> expected;
+        psimpl::simplify_douglas_peucker <DIM> (
+            polyline.begin (), polyline.end (), tol,
+            std::back_inserter (expected));
+
+        std::vector <float> result;
+        bool valid = false;
+        psimpl::simplify_douglas_peucker_mapped <DIM> (
+            test_file, tol, std::back_inserter (result), &valid);
+        std::remove (test_file);
+
+        VERIFY_TRUE(valid);
+        VERIFY_TRUE(result == expected);
+    }
+
+    void TestOutOfCore::TestInvalidFile () {
+        const unsigned DIM = 2;
+
+        // missing file
+        std::remove (test_file);
+        std::vector <double> result;
+        bool valid = true;
+        psimpl::simplify_douglas_peucker_mapped <DIM> (
+            test_file, 1., std::back_inserter (result), &valid);
+        VERIFY_TRUE(!valid);
+        VERIFY_TRUE(result.empty ());
+
+        // incomplete value
+        std::vector <char> bytes (sizeof (double) * 4 + 1, 0);
+        ASSERT_TRUE(WriteFile (test_file, bytes));
+        valid = true;
+        psimpl::simplify_douglas_peucker_mapped <DIM> (
+            test_file, 1., std::back_inserter (result), &valid);
+        std::remove (test_file);
+        VERIFY_TRUE(!valid);
+        VERIFY_TRUE(result.empty ());
+
+        // mapping
+        util::mapped_file file;
+        VERIFY_TRUE(!file.is_open ());
+        VERIFY_TRUE(!file.open (test_file));
+        VERIFY_TRUE(file.size () == 0);
+    }
+}}
@@ -0,0 +1,417 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+
+#include "TestParallel.h"
+#include "generators.h"
+#include "../lib/psimpl_parallel.h"
+#include "../lib/psimpl_stats.h"
+#include <iterator>
+#include <list>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        typedef std::vector <double>::const_iterator iterator;
+        typedef std::back_insert_iterator <std::vector <double> > output;
+        typedef ParallelSimplification <2, iterator, output> Parallel;
+
+        // polylines that require chunks to be reconciled in different ways
+        std::vector <std::vector <double> > Polylines () {
+            std::vector <std::vector <double> > polylines;
+            polylines.push_back (Generate <2, double> (GpsGenerator <2> (3), 40000));
+            polylines.push_back (Generate <2, double> (WalkGenerator <2> (5), 40000));
+            polylines.push_back (Generate <2, double> (DwellGenerator <2> (7), 40000));
+            return polylines;
+        }
+
+        // tolerances from almost no reduction to a single segment
+        const double tolerances [] = { 0.5, 5.0, 50.0, 1e6 };
+    }
+
+    TestParallel::TestParallel () {
+        TEST_RUN("policies", TestPolicies ());
+        TEST_RUN("radial distance", TestRadialDistance ());
+        TEST_RUN("perpendicular distance", TestPerpendicularDistance ());
+        TEST_RUN("reumann-witkam", TestReumannWitkam ());
+        TEST_RUN("opheim", TestOpheim ());
+        TEST_RUN("chunk size", TestChunkSize ());
+        TEST_RUN("douglas-peucker", TestDouglasPeucker ());
+        TEST_RUN("douglas-peucker n", TestDouglasPeuckerN ());
+        TEST_RUN("positional errors", TestPositionalErrors ());
+        TEST_RUN("invalid input", TestInvalidInput ());
+        TEST_RUN("instrumentation", TestInstrumentation ());
+    }
+
+    // overloads taking an execution policy produce the sequential result
+    void TestParallel::TestPolicies () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (3), 20000);
+        std::vector <double> expected, seq, par, parUnseq;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        simplify_douglas_peucker <2> (execution::seq, polyline.begin (), polyline.end (), 5.0, std::back_inserter (seq));
+        simplify_douglas_peucker <2> (execution::par, polyline.begin (), polyline.end (), 5.0, std::back_inserter (par));
+        simplify_douglas_peucker <2> (execution::par_unseq, polyline.begin (), polyline.end (), 5.0,
+                                      std::back_inserter (parUnseq));
+        VERIFY_TRUE(seq == expected);
+        VERIFY_TRUE(par == expected);
+        VERIFY_TRUE(parUnseq == expected);
+
+        // sequential routines
+        std::vector <double> nthPoint, parNthPoint, lang, parLang;
+        simplify_nth_point <2> (polyline.begin (), polyline.end (), 7, std::back_inserter (nthPoint));
+        simplify_nth_point <2> (execution::par, polyline.begin (), polyline.end (), 7, std::back_inserter (parNthPoint));
+        VERIFY_TRUE(parNthPoint == nthPoint);
+        simplify_lang <2> (polyline.begin (), polyline.end (), 5.0, 8, std::back_inserter (lang));
+        simplify_lang <2> (execution::par, polyline.begin (), polyline.end (), 5.0, 8, std::back_inserter (parLang));
+        VERIFY_TRUE(parLang == lang);
+
+        VERIFY_TRUE(execution::thread_count (execution::seq) == 1);
+        VERIFY_TRUE(execution::thread_count (execution::par) == 0);
+        VERIFY_TRUE(Parallel ().thread_count () >= 1);
+        VERIFY_TRUE(Parallel (3).thread_count () == 3);
+
+        // threads taken from a pool
+        ThreadPool pool (3);
+        std::vector <double> pooled;
+        Parallel (4, 0, &pool).DouglasPeucker (polyline.begin (), polyline.end (), 5.0, std::back_inserter (pooled));
+        VERIFY_TRUE(pooled == expected);
+#if defined (PSIMPL_STD_EXECUTION)
+        std::vector <double> stdPar;
+        simplify_douglas_peucker <2> (std::execution::par, polyline.begin (), polyline.end (), 5.0,
+                                      std::back_inserter (stdPar));
+        VERIFY_TRUE(stdPar == expected);
+        VERIFY_TRUE(execution::thread_count (std::execution::seq) == 1);
+#endif
+    }
+
+    // chunked RD equals RD, also for non-contiguous input
+    void TestParallel::TestRadialDistance () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            std::list <double> list (polyline.begin (), polyline.end ());
+            for (unsigned t = 0; t < 4; ++t) {
+                std::vector <double> expected, result, listResult;
+                simplify_radial_distance <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                              std::back_inserter (expected));
+                Parallel (4).RadialDistance (polyline.begin (), polyline.end (), tolerances [t],
+                                             std::back_inserter (result));
+                ParallelSimplification <2, std::list <double>::const_iterator, output> (3).RadialDistance (
+                    list.begin (), list.end (), tolerances [t], std::back_inserter (listResult));
+                VERIFY_TRUE(result == expected);
+                VERIFY_TRUE(listResult == expected);
+            }
+        }
+    }
+
+    // chunked PD equals PD, for single and repeated passes, also for non-contiguous input
+    void TestParallel::TestPerpendicularDistance () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            std::list <double> list (polyline.begin (), polyline.end ());
+            for (unsigned t = 0; t < 4; ++t) {
+                std::vector <double> expected, result, listResult;
+                simplify_perpendicular_distance <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                                     std::back_inserter (expected));
+                Parallel (4).PerpendicularDistance (polyline.begin (), polyline.end (), tolerances [t],
+                                                    std::back_inserter (result));
+                VERIFY_TRUE(result == expected);
+
+                expected.clear (); result.clear ();
+                simplify_perpendicular_distance <2> (polyline.begin (), polyline.end (), tolerances [t], 5,
+                                                     std::back_inserter (expected));
+                Parallel (4).PerpendicularDistance (polyline.begin (), polyline.end (), tolerances [t], 5,
+                                                    std::back_inserter (result));
+                ParallelSimplification <2, std::list <double>::const_iterator, output> (3).PerpendicularDistance (
+                    list.begin (), list.end (), tolerances [t], 5, std::back_inserter (listResult));
+                VERIFY_TRUE(result == expected);
+                VERIFY_TRUE(listResult == expected);
+            }
+        }
+    }
+
+    // chunked RW equals RW, also for non-contiguous input
+    void TestParallel::TestReumannWitkam () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            std::list <double> list (polyline.begin (), polyline.end ());
+            for (unsigned t = 0; t < 4; ++t) {
+                std::vector <double> expected, result, listResult, policyResult;
+                simplify_reumann_witkam <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                             std::back_inserter (expected));
+                Parallel (4).ReumannWitkam (polyline.begin (), polyline.end (), tolerances [t],
+                                            std::back_inserter (result));
+                ParallelSimplification <2, std::list <double>::const_iterator, output> (3).ReumannWitkam (
+                    list.begin (), list.end (), tolerances [t], std::back_inserter (listResult));
+                simplify_reumann_witkam <2> (execution::par, polyline.begin (), polyline.end (), tolerances [t],
+                                             std::back_inserter (policyResult));
+                VERIFY_TRUE(result == expected);
+                VERIFY_TRUE(listResult == expected);
+                VERIFY_TRUE(policyResult == expected);
+            }
+        }
+    }
+
+    // chunked OP equals OP, including seams in the middle of a ray
+    void TestParallel::TestOpheim () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            for (unsigned t = 0; t < 4; ++t) {
+                for (unsigned m = 1; m < 4; m += 2) {
+                    std::vector <double> expected, result, policyResult;
+                    simplify_opheim <2> (polyline.begin (), polyline.end (), tolerances [t], m * tolerances [t],
+                                         std::back_inserter (expected));
+                    Parallel (4).Opheim (polyline.begin (), polyline.end (), tolerances [t], m * tolerances [t],
+                                         std::back_inserter (result));
+                    simplify_opheim <2> (execution::par, polyline.begin (), polyline.end (), tolerances [t],
+                                         m * tolerances [t], std::back_inserter (policyResult));
+                    VERIFY_TRUE(result == expected);
+                    VERIFY_TRUE(policyResult == expected);
+                }
+            }
+        }
+    }
+
+    // many small chunks reconcile to the sequential result
+    void TestParallel::TestChunkSize () {
+        VERIFY_TRUE(Parallel (4).chunk_size () > 0);
+        VERIFY_TRUE(Parallel (4, 16).chunk_size () == 16);
+
+        std::vector <std::vector <double> > polylines = Polylines ();
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            for (unsigned t = 0; t < 3; ++t) {
+                Parallel parallel (256, 16);
+                std::vector <double> expected, result;
+                simplify_radial_distance <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                              std::back_inserter (expected));
+                parallel.RadialDistance (polyline.begin (), polyline.end (), tolerances [t],
+                                         std::back_inserter (result));
+                VERIFY_TRUE(result == expected);
+
+                expected.clear (); result.clear ();
+                simplify_perpendicular_distance <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                                     std::back_inserter (expected));
+                parallel.PerpendicularDistance (polyline.begin (), polyline.end (), tolerances [t],
+                                                std::back_inserter (result));
+                VERIFY_TRUE(result == expected);
+
+                expected.clear (); result.clear ();
+                simplify_reumann_witkam <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                             std::back_inserter (expected));
+                parallel.ReumannWitkam (polyline.begin (), polyline.end (), tolerances [t],
+                                        std::back_inserter (result));
+                VERIFY_TRUE(result == expected);
+
+                expected.clear (); result.clear ();
+                simplify_opheim <2> (polyline.begin (), polyline.end (), tolerances [t], 3 * tolerances [t],
+                                     std::back_inserter (expected));
+                parallel.Opheim (polyline.begin (), polyline.end (), tolerances [t], 3 * tolerances [t],
+                                 std::back_inserter (result));
+                VERIFY_TRUE(result == expected);
+            }
+        }
+    }
+
+    // parallel DP equals DP
+    void TestParallel::TestDouglasPeucker () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        polylines.push_back (Generate <2, double> (ZigZagGenerator <2> (10000), 10000));
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            std::list <double> list (polyline.begin (), polyline.end ());
+            for (unsigned t = 0; t < 4; ++t) {
+                std::vector <double> expected, result, listResult;
+                simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), tolerances [t],
+                                              std::back_inserter (expected));
+                Parallel (4).DouglasPeucker (polyline.begin (), polyline.end (), tolerances [t],
+                                             std::back_inserter (result));
+                ParallelSimplification <2, std::list <double>::const_iterator, output> (3).DouglasPeucker (
+                    list.begin (), list.end (), tolerances [t], std::back_inserter (listResult));
+                VERIFY_TRUE(result == expected);
+                VERIFY_TRUE(listResult == expected);
+            }
+        }
+        // a single segment, searched in parallel
+        std::vector <double> line;
+        for (unsigned i = 0; i < 100000; ++i) {
+            line.push_back (i);
+            line.push_back (i % 2 ? 1e-3 : 0.0);
+        }
+        std::vector <double> expected, result;
+        simplify_douglas_peucker <2> (line.begin (), line.end (), 1e-6, std::back_inserter (expected));
+        Parallel (4).DouglasPeucker (line.begin (), line.end (), 1e-6, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+    }
+
+    // parallel key searches do not change the DPn order
+    void TestParallel::TestDouglasPeuckerN () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        // large enough to search keys in parallel
+        polylines.push_back (Generate <2, double> (GpsGenerator <2> (11), 150000));
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            const std::vector <double>& polyline = polylines [p];
+            const unsigned counts [] = { 2, 3, 100, 5000 };
+            for (unsigned c = 0; c < 4; ++c) {
+                std::vector <double> expected, result;
+                simplify_douglas_peucker_n <2> (polyline.begin (), polyline.end (), counts [c],
+                                                std::back_inserter (expected));
+                Parallel (4).DouglasPeuckerN (polyline.begin (), polyline.end (), counts [c],
+                                              std::back_inserter (result));
+                VERIFY_TRUE(result == expected);
+            }
+        }
+    }
+
+    // parallel positional errors equal the sequential ones
+    void TestParallel::TestPositionalErrors () {
+        std::vector <std::vector <double> > polylines = Polylines ();
+        for (std::size_t p = 0; p < polylines.size (); ++p) {
+            std::vector <double>& polyline = polylines [p];
+            std::vector <double> simplified;
+            simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (simplified));
+
+            std::vector <double> expected, result;
+            bool expectedValid = false, valid = false;
+            compute_positional_errors2 <2> (polyline.begin (), polyline.end (), simplified.begin (), simplified.end (),
+                                            std::back_inserter (expected), &expectedValid);
+            Parallel (4).ComputePositionalErrors2 (polyline.begin (), polyline.end (), simplified.begin (),
+                                                   simplified.end (), std::back_inserter (result), &valid);
+            VERIFY_TRUE(result == expected);
+            VERIFY_TRUE(valid && expectedValid);
+
+            math::Statistics expectedStats = compute_positional_error_statistics <2> (
+                polyline.begin (), polyline.end (), simplified.begin (), simplified.end ());
+            math::Statistics stats = Parallel (4).ComputePositionalErrorStatistics (
+                polyline.begin (), polyline.end (), simplified.begin (), simplified.end ());
+            VERIFY_TRUE(stats.max == expectedStats.max);
+            VERIFY_TRUE(stats.sum == expectedStats.sum);
+            VERIFY_TRUE(stats.std == expectedStats.std);
+
+            // the simplification ends before the polyline
+            std::vector <double> prefix (polyline.begin (), polyline.begin () + polyline.size () / 2);
+            expected.clear (); result.clear ();
+            compute_positional_errors2 <2> (polyline.begin (), polyline.end (), prefix.begin (), prefix.end (),
+                                            std::back_inserter (expected), &expectedValid);
+            Parallel (4).ComputePositionalErrors2 (polyline.begin (), polyline.end (), prefix.begin (),
+                                                   prefix.end (), std::back_inserter (result), &valid);
+            VERIFY_TRUE(result == expected);
+            VERIFY_TRUE(valid && expectedValid);
+
+            // a point of the simplification is not part of the polyline
+            simplified [simplified.size () / 2] += 0.5;
+            expected.clear (); result.clear ();
+            compute_positional_errors2 <2> (polyline.begin (), polyline.end (), simplified.begin (), simplified.end (),
+                                            std::back_inserter (expected), &expectedValid);
+            Parallel (4).ComputePositionalErrors2 (polyline.begin (), polyline.end (), simplified.begin (),
+                                                   simplified.end (), std::back_inserter (result), &valid);
+            VERIFY_TRUE(result == expected);
+            VERIFY_FALSE(valid || expectedValid);
+        }
+    }
+
+    // invalid and small input is handled like the sequential routines
+    void TestParallel::TestInvalidInput () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (3), 20000);
+        polyline.pop_back ();
+        std::vector <double> result;
+        Parallel (4).RadialDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+        result.clear ();
+        Parallel (4).DouglasPeucker (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+        result.clear ();
+        Parallel (4).DouglasPeuckerN (polyline.begin (), polyline.end (), 100, std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+        result.clear ();
+        Parallel (4).ReumannWitkam (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+        result.clear ();
+        Parallel (4).Opheim (polyline.begin (), polyline.end (), 5.0, 10.0, std::back_inserter (result));
+        VERIFY_TRUE(result == polyline);
+
+        polyline = Generate <2, double> (GpsGenerator <2> (3), 100);
+        std::vector <double> expected;
+        simplify_radial_distance <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        result.clear ();
+        Parallel (4).RadialDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 0.0, std::back_inserter (expected));
+        Parallel (4).DouglasPeucker (polyline.begin (), polyline.end (), 0.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+    }
+
+    // work on all threads is reported to the instrumentation
+    void TestParallel::TestInstrumentation () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (13), 150000);
+        std::list <double> list (polyline.begin (), polyline.end ());
+        typedef ParallelSimplification <2, std::list <double>::const_iterator, output, StatsInstrumentation> Instrumented;
+
+        SimplificationStats sequential, stats;
+        std::vector <double> expected, result;
+        PolylineSimplification <2, iterator, output, StatsInstrumentation> (StatsInstrumentation (sequential)).DouglasPeucker (
+            polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        Instrumented (4, 0, 0, StatsInstrumentation (stats)).DouglasPeucker (
+            list.begin (), list.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+        VERIFY_TRUE(stats.inputPoints == 150000);
+        VERIFY_TRUE(stats.reducedPoints == sequential.reducedPoints);
+        VERIFY_TRUE(stats.distances >= 150000);
+        VERIFY_TRUE(stats.subPolylines > 0);
+        VERIFY_TRUE(stats.allocations == 3);
+
+        stats.Reset ();
+        expected.clear (); result.clear ();
+        simplify_douglas_peucker_n <2> (polyline.begin (), polyline.end (), 1000, std::back_inserter (expected));
+        Instrumented (4, 0, 0, StatsInstrumentation (stats)).DouglasPeuckerN (
+            list.begin (), list.end (), 1000, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+        VERIFY_TRUE(stats.subPolylines > 0);
+        VERIFY_TRUE(stats.distances >= 150000);
+
+        stats.Reset ();
+        result.clear ();
+        Instrumented (4, 0, 0, StatsInstrumentation (stats)).RadialDistance (
+            list.begin (), list.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(stats.distances >= 150000 - 2);
+    }
+}}
@@ -0,0 +1,219 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestProgressive.h"
+#include "helper.h"
+#include "../lib/psimpl_progressive.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    typedef std::pair <std::ptrdiff_t, double> Key;
+
+    TestProgressive::TestProgressive () {
+        TEST_RUN("key order", TestKeyOrder ());
+        TEST_RUN("collinear", TestCollinear ());
+        TEST_RUN("round trip", TestRoundTrip ());
+        TEST_RUN("prefix", TestPrefix ());
+        TEST_RUN("chunks", TestChunks ());
+        TEST_RUN("invalid input", TestInvalidInput ());
+    }
+
+    // each prefix of the key order is a DPn simplification
+    void TestProgressive::TestKeyOrder () {
+        const unsigned DIM = 2;
+        std::vector <double> polyline = RandomWalk <double, DIM> (200, 1, true);
+
+        std::vector <Key> keys;
+        order_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), 200, std::back_inserter (keys));
+        ASSERT_TRUE(keys.size () > 100);
+
+        for (unsigned count = 3; count < 40; ++count) {
+            std::vector <double> expected;
+            simplify_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), count, std::back_inserter (expected));
+
+            std::vector <int> indices (1, 0);
+            for (unsigned k = 0; k + 2 < count; ++k) {
+                indices.push_back (static_cast <int> (keys [k].first));
+            }
+            indices.push_back (199);
+            std::sort (indices.begin (), indices.end ());
+            VERIFY_TRUE(expected.size () == count * DIM);
+            VERIFY_TRUE(ComparePoints <DIM> (polyline.begin (), expected.begin (), indices));
+        }
+
+        // the distance of the next key bounds the error of the current simplification
+        std::vector <double> simplification;
+        simplify_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), 12, std::back_inserter (simplification));
+        std::vector <double> errors;
+        compute_positional_errors2 <DIM> (polyline.begin (), polyline.end (),
+            simplification.begin (), simplification.end (), std::back_inserter (errors));
+        VERIFY_TRUE(std::abs (*std::max_element (errors.begin (), errors.end ()) - keys [10].second) < 1e-9);
+
+        // limited count, invalid input
+        keys.clear ();
+        order_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), 10, std::back_inserter (keys));
+        VERIFY_TRUE(keys.size () == 8);
+        keys.clear ();
+        order_douglas_peucker_n <DIM> (polyline.begin (), polyline.begin () + 5, 10, std::back_inserter (keys));
+        VERIFY_TRUE(keys.empty ());
+    }
+
+    // points on the simplification are reported last, with distance 0
+    void TestProgressive::TestCollinear () {
+        const unsigned DIM = 2;
+        const double coords [] = { 0,0, 1,0, 2,0, 4,0, 4,1, 4,2, 4,4, 5,4, 6,4, 8,4 };
+        std::vector <double> polyline (coords, coords + 20);
+
+        std::vector <Key> keys;
+        order_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), 10, std::back_inserter (keys));
+        ASSERT_TRUE(keys.size () == 8);
+        std::vector <int> corners;
+        for (std::size_t k = 0; k < keys.size (); ++k) {
+            VERIFY_TRUE(k < 2 ? keys [k].second > 0 : keys [k].second == 0);
+            if (k < 2) {
+                corners.push_back (static_cast <int> (keys [k].first));
+            }
+        }
+        std::sort (corners.begin (), corners.end ());
+        VERIFY_TRUE(corners.size () == 2 && corners [0] == 3 && corners [1] == 6);
+
+        // a complete stream still reproduces every point, the error drops to 0 after the corners
+        std::vector <unsigned char> bytes;
+        progressive_encode <DIM> (polyline.begin (), polyline.end (), 0, std::back_inserter (bytes));
+        double error = -1;
+        std::vector <double> decoded;
+        progressive_decode <DIM> (&bytes [0], &bytes [0] + bytes.size (), std::back_inserter (decoded), &error);
+        VERIFY_TRUE(error == 0);
+        VERIFY_TRUE(decoded == polyline);
+    }
+
+    // a complete stream reproduces the quantized polyline
+    void TestProgressive::TestRoundTrip () {
+        const unsigned DIM = 3;
+        std::vector <double> polyline = RandomWalk <double, DIM> (500, 2, false);
+
+        std::vector <unsigned char> bytes;
+        progressive_encode <DIM> (polyline.begin (), polyline.end (), 4, std::back_inserter (bytes));
+
+        double error = -1;
+        std::vector <double> decoded;
+        progressive_decode <DIM> (&bytes [0], &bytes [0] + bytes.size (), std::back_inserter (decoded), &error);
+        VERIFY_TRUE(error == 0);
+        ASSERT_TRUE(decoded.size () == polyline.size ());
+        for (std::size_t c = 0; c < polyline.size (); ++c) {
+            VERIFY_TRUE(std::abs (decoded [c] - polyline [c]) <= 0.00005 + 1e-12);
+        }
+    }
+
+    // every prefix describes the DPn simplification of the keys it contains
+    void TestProgressive::TestPrefix () {
+        const unsigned DIM = 2;
+        std::vector <double> polyline = RandomWalk <double, DIM> (300, 3, true);
+        std::vector <unsigned char> bytes;
+        progressive_encode <DIM> (polyline.begin (), polyline.end (), 6, std::back_inserter (bytes));
+
+        std::size_t previousCount = 0;
+        for (std::size_t size = 1; size <= bytes.size (); ++size) {
+            ProgressiveDecoder <DIM> decoder;
+            decoder.append (&bytes [0], &bytes [0] + size);
+            VERIFY_TRUE(decoder.valid ());
+            if (!decoder.ready ()) {
+                VERIFY_TRUE(decoder.simplification_point_count () == 0);
+                continue;
+            }
+            std::size_t count = decoder.simplification_point_count ();
+            VERIFY_TRUE(count >= previousCount);
+            previousCount = count;
+            if (count == 2 || count % 25) {
+                continue;
+            }
+            std::vector <double> expected;
+            simplify_douglas_peucker_n <DIM> (polyline.begin (), polyline.end (), static_cast <unsigned> (count), std::back_inserter (expected));
+            std::vector <double> decoded;
+            decoder.simplification (std::back_inserter (decoded));
+            ASSERT_TRUE(decoded.size () == expected.size ());
+            for (std::size_t c = 0; c < expected.size (); ++c) {
+                VERIFY_TRUE(std::abs (decoded [c] - expected [c]) <= 0.0000005 + 1e-12);
+            }
+
+            std::vector <double> errors;
+            compute_positional_errors2 <DIM> (polyline.begin (), polyline.end (),
+                expected.begin (), expected.end (), std::back_inserter (errors));
+            double maxError = std::sqrt (*std::max_element (errors.begin (), errors.end ()));
+            VERIFY_TRUE(std::abs (decoder.error () - maxError) <= 0.0000005 + 1e-12);
+        }
+        VERIFY_TRUE(previousCount > 250);
+    }
+
+    // appending in chunks yields the same result as a single append
+    void TestProgressive::TestChunks () {
+        const unsigned DIM = 2;
+        std::vector <double> polyline = RandomWalk <double, DIM> (1000, 4, true);
+        std::vector <unsigned char> bytes;
+        progressive_encode <DIM> (polyline.begin (), polyline.end (), 3, std::back_inserter (bytes));
+
+        std::vector <double> expected;
+        progressive_decode <DIM> (&bytes [0], &bytes [0] + bytes.size (), std::back_inserter (expected));
+
+        ProgressiveDecoder <DIM> decoder;
+        for (std::size_t offset = 0; offset < bytes.size (); offset += 7) {
+            VERIFY_TRUE(decoder.append (&bytes [0] + offset, &bytes [0] + std::min (offset + 7, bytes.size ())));
+        }
+        VERIFY_TRUE(decoder.complete ());
+        std::vector <double> decoded;
+        decoder.simplification (std::back_inserter (decoded));
+        VERIFY_TRUE(decoded == expected);
+    }
+
+    void TestProgressive::TestInvalidInput () {
+        std::vector <double> polyline = RandomWalk <double, 2> (10, 5, false);
+        std::vector <unsigned char> bytes;
+
+        // incomplete point, not enough points
+        progressive_encode <2> (polyline.begin (), polyline.end () - 1, 3, std::back_inserter (bytes));
+        VERIFY_TRUE(bytes.empty ());
+        progressive_encode <2> (polyline.begin (), polyline.begin () + 2, 3, std::back_inserter (bytes));
+        VERIFY_TRUE(bytes.empty ());
+
+        // dimension mismatch
+        progressive_encode <2> (polyline.begin (), polyline.end (), 3, std::back_inserter (bytes));
+        ProgressiveDecoder <3> decoder;
+        VERIFY_FALSE(decoder.append (&bytes [0], &bytes [0] + bytes.size ()));
+        VERIFY_FALSE(decoder.ready ());
+    }
+}}
@@ -43,6 +43,8 @@
 #include "TestOpheim.h"
 #include "TestLang.h"
 #include "TestDouglasPeucker.h"
+#include "TestInplace.h"
+#include "TestOutOfCore.h"
 
 
 namespace psimpl {
@@ -60,6 +62,10 @@ namespace psimpl {
             TEST_RUN("lang", TestLang ());
             TEST_RUN("douglas peucker", TestDouglasPeucker ());
             TEST_RUN("douglas peucker n", TestDouglasPeuckerN ());
+            TEST_RUN("douglas peucker accelerated", TestDouglasPeuckerAccelerated ());
+            TEST_RUN("douglas peucker ring", TestDouglasPeuckerRing ());
+            TEST_RUN("in place", TestInplace ());
+            TEST_RUN("out of core", TestOutOfCore ());
         }
     };
 }}
@@ -0,0 +1,224 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestStats.h"
+#include "generators.h"
+#include "../lib/psimpl_stats.h"
+#include <iterator>
+#include <list>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    namespace
+    {
+        typedef std::vector <double>::const_iterator iterator;
+        typedef std::back_insert_iterator <std::vector <double> > output;
+        typedef PolylineSimplification <2, iterator, output, StatsInstrumentation> InstrumentedSimplification;
+
+        // straight line of pointCount points, 10 units apart
+        std::vector <double> StraightLine (unsigned pointCount) {
+            std::vector <double> coords;
+            for (unsigned p = 0; p < pointCount; ++p) {
+                coords.push_back (10.0 * p);
+                coords.push_back (0.0);
+            }
+            return coords;
+        }
+    }
+
+    TestStats::TestStats () {
+        TEST_RUN("same result", TestSameResult ());
+        TEST_RUN("linear routines", TestLinearRoutines ());
+        TEST_RUN("douglas-peucker", TestDouglasPeucker ());
+        TEST_RUN("prefilter", TestPrefilter ());
+        TEST_RUN("douglas-peucker n", TestDouglasPeuckerN ());
+        TEST_RUN("accumulate", TestAccumulate ());
+    }
+
+    // instrumentation does not change any simplification
+    void TestStats::TestSameResult () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (11), 2000);
+        SimplificationStats stats;
+        InstrumentedSimplification ps ((StatsInstrumentation (stats)));
+
+        std::vector <double> expected, result;
+        simplify_douglas_peucker <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_douglas_peucker_n <2> (polyline.begin (), polyline.end (), 100, std::back_inserter (expected));
+        ps.DouglasPeuckerN (polyline.begin (), polyline.end (), 100, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_douglas_peucker_accelerated <2> (polyline.begin (), polyline.end (), 5.0, std::back_inserter (expected));
+        ps.DouglasPeuckerAccelerated (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+
+        expected.clear (); result.clear ();
+        simplify_lang <2> (polyline.begin (), polyline.end (), 5.0, 8, std::back_inserter (expected));
+        ps.Lang (polyline.begin (), polyline.end (), 5.0, 8, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+        VERIFY_TRUE(0 < stats.distances);
+    }
+
+    // each point, except the first and last, is tested exactly once
+    void TestStats::TestLinearRoutines () {
+        std::vector <double> polyline = Generate <2, double> (WalkGenerator <2> (3), 1000);
+        std::vector <double> result;
+        SimplificationStats stats;
+        InstrumentedSimplification ps ((StatsInstrumentation (stats)));
+
+        ps.RadialDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(stats.distances == 998);
+        stats.Reset ();
+        ps.ReumannWitkam (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(stats.distances == 998);
+        stats.Reset ();
+        ps.Opheim (polyline.begin (), polyline.end (), 5.0, 20.0, std::back_inserter (result));
+        VERIFY_TRUE(stats.distances == 998);
+        stats.Reset ();
+        ps.PerpendicularDistance (polyline.begin (), polyline.end (), 5.0, std::back_inserter (result));
+        VERIFY_TRUE(499 <= stats.distances && stats.distances <= 998);
+
+        // no sub polylines, phases or allocations
+        VERIFY_TRUE(stats.subPolylines == 0);
+        VERIFY_TRUE(stats.allocations == 0);
+        VERIFY_TRUE(stats.TotalSeconds () == 0);
+    }
+
+    // a straight line is resolved by a single sub polyline
+    void TestStats::TestDouglasPeucker () {
+        std::vector <double> polyline = StraightLine (100);
+        std::vector <double> result;
+        SimplificationStats stats;
+        InstrumentedSimplification ps ((StatsInstrumentation (stats)));
+
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 1.0, std::back_inserter (result));
+        VERIFY_TRUE(result.size () == 4);
+        VERIFY_TRUE(stats.distances == 2 * 98);     // radial distance + a single key search
+        VERIFY_TRUE(stats.subPolylines == 1);
+        VERIFY_TRUE(stats.maxDepth == 1);
+        VERIFY_TRUE(stats.inputPoints == 100 && stats.reducedPoints == 100);
+        VERIFY_TRUE(stats.ReductionRatio () == 1);
+        VERIFY_TRUE(stats.allocations == 2);         // reduced copy and keys
+        VERIFY_TRUE(stats.allocatedBytes >= 200 * sizeof (double) + 100 / 8);
+        VERIFY_TRUE(stats.seconds [PHASE_COPY] == 0);
+        VERIFY_TRUE(stats.seconds [PHASE_APPROXIMATE] >= 0);
+
+        // all points of a zig-zag are keys; each key splits a sub polyline in two
+        polyline = Generate <2, double> (ZigZagGenerator <2> (500), 500);
+        stats.Reset ();
+        result.clear ();
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 2.4, std::back_inserter (result), PREFILTER_NONE);
+        VERIFY_TRUE(result == polyline);
+        VERIFY_TRUE(stats.subPolylines == 2 * 498 + 1);
+        VERIFY_TRUE(1 < stats.maxDepth && stats.maxDepth <= 498);
+        VERIFY_TRUE(stats.inputPoints == 0);
+        VERIFY_TRUE(stats.allocations == 1);         // keys only
+
+        // a non-contiguous input is copied
+        std::list <double> list (polyline.begin (), polyline.end ());
+        SimplificationStats listStats;
+        PolylineSimplification <2, std::list <double>::const_iterator, output, StatsInstrumentation> listPs (
+            (StatsInstrumentation (listStats)));
+        result.clear ();
+        listPs.DouglasPeucker (list.begin (), list.end (), 2.4, std::back_inserter (result), PREFILTER_NONE);
+        VERIFY_TRUE(result == polyline);
+        VERIFY_TRUE(listStats.distances == stats.distances);
+        VERIFY_TRUE(listStats.allocations == 2);
+    }
+
+    // duplicate points are removed by radial distance preprocessing
+    void TestStats::TestPrefilter () {
+        std::vector <double> polyline;
+        std::vector <double> line = StraightLine (100);
+        for (unsigned c = 0; c < line.size (); c += 2) {
+            polyline.insert (polyline.end (), line.begin () + c, line.begin () + c + 2);
+            polyline.insert (polyline.end (), line.begin () + c, line.begin () + c + 2);
+        }
+        std::vector <double> result;
+        SimplificationStats stats;
+        InstrumentedSimplification ps ((StatsInstrumentation (stats)));
+
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 1.0, std::back_inserter (result));
+        VERIFY_TRUE(stats.inputPoints == 200 && stats.reducedPoints == 101);
+        VERIFY_TRUE(stats.ReductionRatio () == 101 / 200.0);
+
+        // the same reduction without copying
+        stats.Reset ();
+        ps.DouglasPeucker (polyline.begin (), polyline.end (), 1.0, std::back_inserter (result), PREFILTER_INDEX);
+        VERIFY_TRUE(stats.inputPoints == 200 && stats.reducedPoints == 101);
+        VERIFY_TRUE(stats.allocations == 2);         // filter and keys
+        VERIFY_TRUE(stats.allocatedBytes < 200);
+    }
+
+    // one sub polyline per key
+    void TestStats::TestDouglasPeuckerN () {
+        std::vector <double> polyline = Generate <2, double> (GpsGenerator <2> (5), 1000);
+        std::vector <double> result;
+        SimplificationStats stats;
+        InstrumentedSimplification ps ((StatsInstrumentation (stats)));
+
+        ps.DouglasPeuckerN (polyline.begin (), polyline.end (), 50, std::back_inserter (result));
+        VERIFY_TRUE(result.size () == 100);
+        VERIFY_TRUE(stats.subPolylines == 48);
+        VERIFY_TRUE(1 <= stats.maxDepth && stats.maxDepth <= 48);
+        VERIFY_TRUE(998 <= stats.distances);
+        VERIFY_TRUE(stats.inputPoints == 0);
+    }
+
+    // copies report to the same statistics, until they are reset
+    void TestStats::TestAccumulate () {
+        std::vector <double> polyline = StraightLine (100);
+        std::vector <double> result;
+        SimplificationStats stats;
+        StatsInstrumentation instrumentation (stats);
+        InstrumentedSimplification ps1 (instrumentation);
+        InstrumentedSimplification ps2 (instrumentation);
+
+        ps1.DouglasPeucker (polyline.begin (), polyline.end (), 1.0, std::back_inserter (result));
+        ps2.DouglasPeucker (polyline.begin (), polyline.end (), 1.0, std::back_inserter (result));
+        VERIFY_TRUE(stats.distances == 4 * 98);
+        VERIFY_TRUE(stats.subPolylines == 2);
+        VERIFY_TRUE(stats.inputPoints == 200);
+
+        stats.Reset ();
+        VERIFY_TRUE(stats.distances == 0 && stats.subPolylines == 0 && stats.maxDepth == 0);
+        VERIFY_TRUE(stats.allocations == 0 && stats.TotalSeconds () == 0);
+    }
+}}
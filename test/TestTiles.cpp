@@ -0,0 +1,317 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestTiles.h"
+#include "helper.h"
+#include "../lib/psimpl_tiles.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    // provides a fixed set of features
+    struct Features
+    {
+        explicit Features (const std::vector <std::vector <double> >& features) :
+            features (features), next (0) {}
+
+        bool operator () (std::vector <double>& coords) {
+            if (next == features.size ()) {
+                return false;
+            }
+            coords = features [next++];
+            return true;
+        }
+
+        const std::vector <std::vector <double> >& features;
+        std::size_t next;
+    };
+
+    // records all parts
+    struct Record
+    {
+        struct Part {
+            TileKey key;
+            std::size_t feature;
+            std::vector <double> coords;
+
+            bool operator== (const Part& other) const {
+                return key == other.key && feature == other.feature && coords == other.coords;
+            }
+        };
+
+        void operator () (const TileKey& key, std::size_t feature, const double* first, const double* last) {
+            Part part;
+            part.key = key;
+            part.feature = feature;
+            part.coords.assign (first, last);
+            parts.push_back (part);
+        }
+
+        std::vector <Part> parts;
+    };
+
+    // random walks scaled into the unit square
+    std::vector <std::vector <double> > RandomFeatures (unsigned count) {
+        std::vector <std::vector <double> > features;
+        for (unsigned f = 0; f < count; ++f) {
+            std::vector <double> coords = RandomWalk <double, 2> (200 + f * 10, f + 1, true);
+            for (std::size_t c = 0; c < coords.size (); ++c) {
+                coords [c] = 0.5 + coords [c] / 200;
+            }
+            features.push_back (coords);
+        }
+        return features;
+    }
+
+    TestTiles::TestTiles () {
+        TEST_RUN("clipping", TestClipping ());
+        TEST_RUN("long segment", TestLongSegment ());
+        TEST_RUN("zoom levels", TestZoomLevels ());
+        TEST_RUN("threads", TestThreads ());
+        TEST_RUN("wkb writer", TestWkbWriter ());
+        TEST_RUN("binary writer", TestBinaryWriter ());
+    }
+
+    // a line crossing the four tiles of zoom level 1
+    void TestTiles::TestClipping () {
+        TileGrid grid;
+        grid.minZoom = grid.maxZoom = 1;
+        grid.buffer = 0;
+        std::vector <std::vector <double> > features (1);
+        const double coords [] = { 0.25, 0.75, 0.75, 0.75, 0.75, 0.25 };
+        features [0].assign (coords, coords + 6);
+
+        Features source (features);
+        Record sink;
+        TilePyramid <double> pyramid (grid, 1);
+        VERIFY_TRUE(pyramid.Build (source, sink) == 1);
+        ASSERT_TRUE(sink.parts.size () == 3);
+
+        // top left
+        VERIFY_TRUE(sink.parts [0].key == TileKey (1, 0, 0));
+        const double a [] = { 0.25, 0.75, 0.5, 0.75 };
+        VERIFY_TRUE(sink.parts [0].coords == std::vector <double> (a, a + 4));
+        // top right, joined at the corner
+        VERIFY_TRUE(sink.parts [1].key == TileKey (1, 1, 0));
+        const double b [] = { 0.5, 0.75, 0.75, 0.75, 0.75, 0.5 };
+        VERIFY_TRUE(sink.parts [1].coords == std::vector <double> (b, b + 6));
+        // bottom right
+        VERIFY_TRUE(sink.parts [2].key == TileKey (1, 1, 1));
+        const double c [] = { 0.75, 0.5, 0.75, 0.25 };
+        VERIFY_TRUE(sink.parts [2].coords == std::vector <double> (c, c + 4));
+    }
+
+    // a diagonal across a 4096 x 4096 grid only visits the tiles it crosses
+    void TestTiles::TestLongSegment () {
+        TileGrid grid;
+        grid.minZoom = grid.maxZoom = 12;
+        grid.buffer = 0;
+        std::vector <std::vector <double> > features (1);
+        const double coords [] = { 0.01, 0.02, 0.99, 0.97 };
+        features [0].assign (coords, coords + 4);
+
+        Features source (features);
+        Record sink;
+        TilePyramid <double> (grid, 1).Build (source, sink);
+        ASSERT_TRUE(sink.parts.size () >= 4096 * 0.95);
+        VERIFY_TRUE(sink.parts.size () <= 2 * 4096);
+
+        // the parts lie within their tiles, and together cover the segment
+        const double width = grid.TileWidth (12);
+        double length = 0;
+        for (std::size_t p = 0; p < sink.parts.size (); ++p) {
+            const Record::Part& part = sink.parts [p];
+            ASSERT_TRUE(part.coords.size () == 4);
+            for (std::size_t c = 0; c < 4; c += 2) {
+                VERIFY_TRUE(part.coords [c] >= part.key.x * width - 1e-12);
+                VERIFY_TRUE(part.coords [c] <= (part.key.x + 1) * width + 1e-12);
+                VERIFY_TRUE(1 - part.coords [c + 1] >= part.key.y * width - 1e-12);
+                VERIFY_TRUE(1 - part.coords [c + 1] <= (part.key.y + 1) * width + 1e-12);
+            }
+            length += std::sqrt (math::point_distance2 <2> (&part.coords [0], &part.coords [2]));
+        }
+        VERIFY_TRUE(std::abs (length - std::sqrt (0.98 * 0.98 + 0.95 * 0.95)) < 1e-9);
+    }
+
+    // each zoom level holds the douglas-peucker simplification for its tolerance
+    void TestTiles::TestZoomLevels () {
+        TileGrid grid;
+        grid.minZoom = 0;
+        grid.maxZoom = 6;
+        grid.tolerance = 1.0 / 16;
+        std::vector <std::vector <double> > features = RandomFeatures (3);
+
+        Features source (features);
+        Record sink;
+        TilePyramid <double> pyramid (grid, 2);
+        pyramid.Build (source, sink);
+
+        std::size_t previousCount = 0;
+        for (unsigned zoom = 0; zoom <= 6; ++zoom) {
+            std::size_t pointCount = 0;
+            for (std::size_t p = 0; p < sink.parts.size (); ++p) {
+                const Record::Part& part = sink.parts [p];
+                if (part.key.zoom != zoom || part.feature != 1) {
+                    continue;
+                }
+                pointCount += part.coords.size () / 2;
+                // parts stay within the buffered tile
+                double width = grid.TileWidth (zoom);
+                for (std::size_t c = 0; c < part.coords.size (); c += 2) {
+                    VERIFY_TRUE(part.coords [c] >= part.key.x * width - grid.buffer * width - 1e-12);
+                    VERIFY_TRUE(part.coords [c] <= (part.key.x + 1) * width + grid.buffer * width + 1e-12);
+                    VERIFY_TRUE(1 - part.coords [c + 1] >= part.key.y * width - grid.buffer * width - 1e-12);
+                    VERIFY_TRUE(1 - part.coords [c + 1] <= (part.key.y + 1) * width + grid.buffer * width + 1e-12);
+                }
+            }
+            // zoom 0 holds the single tile, its only part is the simplification itself
+            if (zoom == 0) {
+                std::vector <double> expected;
+                simplify_douglas_peucker <2> (features [1].begin (), features [1].end (), grid.Tolerance (0),
+                    std::back_inserter (expected), PREFILTER_NONE);
+                VERIFY_TRUE(pointCount == expected.size () / 2);
+            }
+            VERIFY_TRUE(pointCount >= previousCount);
+            previousCount = pointCount;
+        }
+    }
+
+    // the output does not depend on the number of threads, the batch size or the executor
+    void TestTiles::TestThreads () {
+        TileGrid grid;
+        grid.maxZoom = 8;
+        std::vector <std::vector <double> > features = RandomFeatures (20);
+
+        Features source1 (features);
+        Record sink1;
+        TilePyramid <double> (grid, 1, 256).Build (source1, sink1);
+
+        Features source4 (features);
+        Record sink4;
+        TilePyramid <double> (grid, 4, 3).Build (source4, sink4);
+
+        Features sourcePool (features);
+        Record sinkPool;
+        ThreadPool pool (3);
+        TilePyramid <double> (grid, 4, 5, &pool).Build (sourcePool, sinkPool);
+
+        VERIFY_TRUE(!sink1.parts.empty ());
+        VERIFY_TRUE(sink1.parts == sink4.parts);
+        VERIFY_TRUE(sink1.parts == sinkPool.parts);
+    }
+
+    void TestTiles::TestWkbWriter () {
+        TileGrid grid;
+        grid.minZoom = grid.maxZoom = 1;
+        grid.buffer = 0;
+        std::vector <std::vector <double> > features (2);
+        const double coords [] = { 0.25, 0.75, 0.75, 0.75, 0.75, 0.25 };
+        features [0].assign (coords, coords + 6);
+        features [1].assign (coords, coords + 4);
+
+        Features source (features);
+        {
+            WkbTileWriter <double> sink ("psimpl_test_tile_", 1);    // flushes after each part
+            TilePyramid <double> (grid, 1).Build (source, sink);
+            VERIFY_TRUE(sink.Flush ());
+        }
+        std::ifstream file ("psimpl_test_tile_1-0-0.wkb");
+        std::vector <std::string> lines;
+        for (std::string line; std::getline (file, line); ) {
+            lines.push_back (line);
+        }
+        VERIFY_TRUE(lines.size () == 2);
+        // LINESTRING (0.25 0.75, 0.5 0.75)
+        VERIFY_TRUE(!lines.empty () && lines [0] ==
+            "010200000002000000000000000000D03F000000000000E83F000000000000E03F000000000000E83F");
+        file.close ();
+        std::remove ("psimpl_test_tile_1-0-0.wkb");
+        std::remove ("psimpl_test_tile_1-1-0.wkb");
+        std::remove ("psimpl_test_tile_1-1-1.wkb");
+    }
+
+    void TestTiles::TestBinaryWriter () {
+        TileGrid grid;
+        grid.maxZoom = 3;
+        std::vector <std::vector <double> > features = RandomFeatures (4);
+
+        Features source (features);
+        Record record;
+        TilePyramid <double> (grid, 2).Build (source, record);
+
+        Features source2 (features);
+        {
+            BinaryTileWriter <double> sink ("psimpl_test_tiles_");
+            TilePyramid <double> (grid, 2).Build (source2, sink);
+            VERIFY_TRUE(sink.Close ());
+        }
+        // parts are grouped per zoom level, in feature order
+        std::size_t partCount = 0;
+        for (unsigned zoom = 0; zoom <= 3; ++zoom) {
+            std::vector <Record::Part> parts;
+            for (std::size_t p = 0; p < record.parts.size (); ++p) {
+                if (record.parts [p].key.zoom == zoom) {
+                    parts.push_back (record.parts [p]);
+                }
+            }
+            char name [64];
+            std::sprintf (name, "psimpl_test_tiles_%u.bin", zoom);
+            BinaryPolylineReader <double> reader;
+            VERIFY_TRUE(reader.open (name));
+            VERIFY_TRUE(reader.feature_count () == parts.size ());
+            std::sprintf (name, "psimpl_test_tiles_%u.tiles", zoom);
+            std::ifstream index (name);
+            for (std::size_t f = 0; f < reader.feature_count () && f < parts.size (); ++f) {
+                unsigned x, y;
+                std::size_t feature;
+                index >> x >> y >> feature;
+                VERIFY_TRUE(parts [f].key == TileKey (zoom, x, y));
+                VERIFY_TRUE(parts [f].feature == feature);
+                VERIFY_TRUE(std::vector <double> (reader.first (f), reader.last (f)) == parts [f].coords);
+            }
+            partCount += reader.feature_count ();
+            reader.close ();
+            index.close ();
+            std::remove (name);
+            std::sprintf (name, "psimpl_test_tiles_%u.bin", zoom);
+            std::remove (name);
+        }
+        VERIFY_TRUE(partCount == record.parts.size ());
+    }
+}}
@@ -41,6 +41,7 @@ namespace psimpl {
 {
     TestUtil::TestUtil () {
         TEST_RUN("scoped_array", TestScopedArray ());
+        TEST_RUN("bit_array", TestBitArray ());
     }
 
     void TestUtil::TestScopedArray () {
@@ -86,5 +87,37 @@ namespace psimpl {
         ASSERT_TRUE(a3 [0] == 321.f);
         ASSERT_TRUE(a3 [1] == 654.f);
     }
-}}
 
+    void TestUtil::TestBitArray () {
+        // construction clears all bits
+        psimpl::util::bit_array a1 (100);
+        ASSERT_TRUE(a1.size () == 100);
+        for (unsigned i = 0; i < 100; ++i) {
+            ASSERT_FALSE(a1 [i]);
+        }
+
+        // setting / getting bits, also across word boundaries
+        a1.set (0);     ASSERT_TRUE(a1 [0]);
+        a1.set (31);    ASSERT_TRUE(a1 [31]);
+        a1.set (32);    ASSERT_TRUE(a1.test (32));
+        a1.set (99);    ASSERT_TRUE(a1.test (99));
+        ASSERT_FALSE(a1 [1]);
+        ASSERT_FALSE(a1 [30]);
+        ASSERT_FALSE(a1 [33]);
+        ASSERT_FALSE(a1 [98]);
+
+        // setting twice
+        a1.set (32);    ASSERT_TRUE(a1 [32]);
+
+        // resetting
+        a1.reset (31);  ASSERT_FALSE(a1 [31]);
+        ASSERT_TRUE(a1 [0]);
+        ASSERT_TRUE(a1 [32]);
+
+        // clearing
+        a1.clear ();
+        for (unsigned i = 0; i < 100; ++i) {
+            ASSERT_FALSE(a1 [i]);
+        }
+    }
+}}
@@ -45,6 +45,7 @@ namespace psimpl {
 
     private:
         void TestScopedArray ();
+        void TestBitArray ();
     };
 }}
 
@@ -0,0 +1,417 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#include "TestWkb.h"
+#include "helper.h"
+#include "../lib/psimpl.h"
+#include "../lib/psimpl_wkb.h"
+#include <vector>
+#include <cstring>
+#include <cmath>
+
+
+namespace psimpl {
+    namespace test
+{
+    // appends a value to a WKB buffer in the specified byte order
+    template <typename T>
+    void Append (std::vector <unsigned char>& wkb, T value, bool littleEndian) {
+        unsigned char bytes [sizeof (T)];
+        std::memcpy (bytes, &value, sizeof (T));
+        bool swap = littleEndian != util::host_is_little_endian ();
+        for (unsigned b = 0; b < sizeof (T); ++b) {
+            wkb.push_back (bytes [swap ? sizeof (T) - 1 - b : b]);
+        }
+    }
+
+    // appends a LineString to a WKB buffer
+    void AppendLineString (std::vector <unsigned char>& wkb, const std::vector <double>& coords,
+                           unsigned dim, bool littleEndian)
+    {
+        wkb.push_back (littleEndian ? wkb::NDR : wkb::XDR);
+        Append (wkb, uint32_t (dim == 2 ? 2 : dim == 3 ? 1002 : 3002), littleEndian);
+        Append (wkb, uint32_t (coords.size () / dim), littleEndian);
+        for (std::size_t c = 0; c < coords.size (); ++c) {
+            Append (wkb, coords [c], littleEndian);
+        }
+    }
+
+    // collects the coordinates of a LineString through wkb::visit
+    struct Collect
+    {
+        template <class InputIterator>
+        void operator () (InputIterator first, InputIterator last) {
+            coords.assign (first, last);
+        }
+
+        std::vector <double> coords;
+    };
+
+    // simplifies a LineString through wkb::visit
+    struct Simplify
+    {
+        template <class InputIterator>
+        void operator () (InputIterator first, InputIterator last) {
+            simplify_douglas_peucker <2> (first, last, 2.0, std::back_inserter (result));
+        }
+
+        std::vector <double> result;
+    };
+
+    TestWkb::TestWkb () {
+        TEST_RUN("little endian", TestLittleEndian ());
+        TEST_RUN("big endian", TestBigEndian ());
+        TEST_RUN("extended", TestExtended ());
+        TEST_RUN("multi linestring", TestMultiLineString ());
+        TEST_RUN("invalid wkb", TestInvalidWkb ());
+        TEST_RUN("simplification", TestSimplification ());
+        TEST_RUN("twkb", TestTwkb ());
+        TEST_RUN("twkb round trip", TestTwkbRoundTrip ());
+        TEST_RUN("invalid twkb", TestInvalidTwkb ());
+        TEST_RUN("dimensions", TestDimensions ());
+        TEST_RUN("incomplete points", TestIncompletePoints ());
+    }
+
+    void TestWkb::TestLittleEndian () {
+        std::vector <double> coords = RandomWalk <double, 2> (10, 1, false);
+        std::vector <unsigned char> bytes;
+        AppendLineString (bytes, coords, 2, true);
+
+        std::vector <wkb::linestring> lines;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == &bytes [0] + bytes.size ());
+        ASSERT_TRUE(lines.size () == 1);
+        VERIFY_TRUE(lines [0].dimension () == 2);
+        VERIFY_TRUE(lines [0].point_count () == 10);
+        VERIFY_TRUE(lines [0].native () == util::host_is_little_endian ());
+
+        Collect collect;
+        wkb::visit (lines [0], collect);
+        VERIFY_TRUE(collect.coords == coords);
+    }
+
+    void TestWkb::TestBigEndian () {
+        std::vector <double> coords = RandomWalk <double, 3> (10, 2, false);
+        std::vector <unsigned char> bytes;
+        AppendLineString (bytes, coords, 3, false);
+
+        std::vector <wkb::linestring> lines;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == &bytes [0] + bytes.size ());
+        ASSERT_TRUE(lines.size () == 1);
+        VERIFY_TRUE(lines [0].dimension () == 3);
+        VERIFY_TRUE(lines [0].point_count () == 10);
+        VERIFY_TRUE(lines [0].native () == !util::host_is_little_endian ());
+
+        Collect collect;
+        wkb::visit (lines [0], collect);
+        VERIFY_TRUE(collect.coords == coords);
+    }
+
+    // EWKB with z, m and srid flags
+    void TestWkb::TestExtended () {
+        std::vector <double> coords = RandomWalk <double, 4> (5, 3, false);
+        std::vector <unsigned char> bytes;
+        bytes.push_back (wkb::NDR);
+        Append (bytes, uint32_t (0xE0000002u), true);
+        Append (bytes, uint32_t (4326), true);
+        Append (bytes, uint32_t (5), true);
+        for (std::size_t c = 0; c < coords.size (); ++c) {
+            Append (bytes, coords [c], true);
+        }
+        std::vector <wkb::linestring> lines;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == &bytes [0] + bytes.size ());
+        ASSERT_TRUE(lines.size () == 1);
+        VERIFY_TRUE(lines [0].dimension () == 4);
+
+        Collect collect;
+        wkb::visit (lines [0], collect);
+        VERIFY_TRUE(collect.coords == coords);
+    }
+
+    // parts may use different byte orders; the writer produces the same geometry
+    void TestWkb::TestMultiLineString () {
+        std::vector <double> a = RandomWalk <double, 2> (10, 4, false);
+        std::vector <double> b = RandomWalk <double, 2> (3, 5, false);
+        std::vector <unsigned char> bytes;
+        bytes.push_back (wkb::NDR);
+        Append (bytes, uint32_t (wkb::MULTILINESTRING), true);
+        Append (bytes, uint32_t (2), true);
+        AppendLineString (bytes, a, 2, false);
+        AppendLineString (bytes, b, 2, true);
+
+        std::vector <wkb::linestring> lines;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == &bytes [0] + bytes.size ());
+        ASSERT_TRUE(lines.size () == 2);
+        Collect collect;
+        wkb::visit (lines [0], collect);
+        VERIFY_TRUE(collect.coords == a);
+        wkb::visit (lines [1], collect);
+        VERIFY_TRUE(collect.coords == b);
+
+        std::vector <unsigned char> written;
+        {
+            wkb::writer writer (written, 2);
+            writer.begin_multi ();
+            std::copy (a.begin (), a.end (), writer.begin_linestring ());
+            writer.end_linestring ();
+            std::copy (b.begin (), b.end (), writer.begin_linestring ());
+            writer.end_linestring ();
+            writer.end_multi ();
+        }
+        std::vector <unsigned char> expected;
+        expected.push_back (wkb::NDR);
+        Append (expected, uint32_t (wkb::MULTILINESTRING), true);
+        Append (expected, uint32_t (2), true);
+        AppendLineString (expected, a, 2, true);
+        AppendLineString (expected, b, 2, true);
+        VERIFY_TRUE(written == expected);
+    }
+
+    void TestWkb::TestInvalidWkb () {
+        std::vector <double> coords = RandomWalk <double, 2> (10, 6, false);
+        std::vector <unsigned char> bytes;
+        AppendLineString (bytes, coords, 2, true);
+        std::vector <wkb::linestring> lines;
+
+        // truncated
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size () - 1, lines) == 0);
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + 7, lines) == 0);
+        // invalid byte order
+        bytes [0] = 2;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == 0);
+        // unsupported type (point)
+        bytes [0] = wkb::NDR;
+        bytes [1] = 1;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == 0);
+        VERIFY_TRUE(lines.empty ());
+
+        // parts in front of a truncated part are not appended
+        std::vector <unsigned char> multi;
+        multi.push_back (wkb::NDR);
+        Append (multi, uint32_t (wkb::MULTILINESTRING), true);
+        Append (multi, uint32_t (2), true);
+        AppendLineString (multi, coords, 2, true);
+        AppendLineString (multi, coords, 2, true);
+        VERIFY_TRUE(wkb::parse (&multi [0], &multi [0] + multi.size () - 1, lines) == 0);
+        VERIFY_TRUE(lines.empty ());
+    }
+
+    // unaligned and byte swapped coordinates simplify exactly like plain arrays
+    void TestWkb::TestSimplification () {
+        std::vector <double> coords = RandomWalk <double, 2> (1000, 7, true);
+        std::vector <double> expected;
+        simplify_douglas_peucker <2> (coords.begin (), coords.end (), 2.0, std::back_inserter (expected));
+
+        for (int littleEndian = 0; littleEndian < 2; ++littleEndian) {
+            std::vector <unsigned char> bytes;
+            AppendLineString (bytes, coords, 2, littleEndian != 0);
+            std::vector <wkb::linestring> lines;
+            ASSERT_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines));
+
+            Simplify simplify;
+            wkb::visit (lines [0], simplify);
+            VERIFY_TRUE(simplify.result == expected);
+        }
+
+        // simplified WKB is written directly
+        std::vector <unsigned char> written;
+        wkb::writer writer (written, 2);
+        simplify_douglas_peucker <2> (coords.begin (), coords.end (), 2.0, writer.begin_linestring ());
+        writer.end_linestring ();
+        std::vector <wkb::linestring> lines;
+        ASSERT_TRUE(wkb::parse (&written [0], &written [0] + written.size (), lines));
+        VERIFY_TRUE(lines [0].point_count () == expected.size () / 2);
+        Collect collect;
+        wkb::visit (lines [0], collect);
+        VERIFY_TRUE(collect.coords == expected);
+    }
+
+    // example from the TWKB specification: LINESTRING(1 1, 5 5)
+    void TestWkb::TestTwkb () {
+        const unsigned char bytes [] = { 0x02, 0x00, 0x02, 0x02, 0x02, 0x08, 0x08 };
+        std::vector <twkb::linestring> lines;
+        VERIFY_TRUE(twkb::parse (bytes, bytes + sizeof (bytes), lines) == bytes + sizeof (bytes));
+        ASSERT_TRUE(lines.size () == 1);
+        VERIFY_TRUE(lines [0].point_count () == 2);
+
+        std::vector <double> coords (lines [0].begin (), lines [0].end ());
+        const double expected [] = { 1, 1, 5, 5 };
+        VERIFY_TRUE(coords == std::vector <double> (expected, expected + 4));
+
+        std::vector <unsigned char> written;
+        twkb::writer writer (written, 2, 0);
+        std::copy (expected, expected + 4, writer.begin_linestring ());
+        writer.end_linestring ();
+        VERIFY_TRUE(written == std::vector <unsigned char> (bytes, bytes + sizeof (bytes)));
+    }
+
+    // deltas continue across parts; forward iterators can be simplified directly
+    void TestWkb::TestTwkbRoundTrip () {
+        std::vector <double> a = RandomWalk <double, 3> (200, 8, true);
+        std::vector <double> b = RandomWalk <double, 3> (50, 9, true);
+        for (std::size_t c = 0; c < a.size (); ++c) a [c] = static_cast <int> (a [c] * 100) / 100.0;
+        for (std::size_t c = 0; c < b.size (); ++c) b [c] = static_cast <int> (b [c] * 100) / 100.0;
+
+        std::vector <unsigned char> bytes;
+        twkb::writer writer (bytes, 3, 2, 2);
+        writer.begin_multi ();
+        std::copy (a.begin (), a.end (), writer.begin_linestring ());
+        writer.end_linestring ();
+        std::copy (b.begin (), b.end (), writer.begin_linestring ());
+        writer.end_linestring ();
+        writer.end_multi ();
+
+        std::vector <twkb::linestring> lines;
+        VERIFY_TRUE(twkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == &bytes [0] + bytes.size ());
+        ASSERT_TRUE(lines.size () == 2);
+        VERIFY_TRUE(lines [0].dimension () == 3);
+        VERIFY_TRUE(lines [1].point_count () == 50);
+
+        std::vector <double> decoded (lines [1].begin (), lines [1].end ());
+        ASSERT_TRUE(decoded.size () == b.size ());
+        for (std::size_t c = 0; c < b.size (); ++c) {
+            VERIFY_TRUE(std::abs (decoded [c] - b [c]) < 0.001);
+        }
+
+        std::vector <double> expected;
+        std::vector <double> result;
+        simplify_douglas_peucker <3> (decoded.begin (), decoded.end (), 1.0, std::back_inserter (expected));
+        simplify_douglas_peucker <3> (lines [1].begin (), lines [1].end (), 1.0, std::back_inserter (result));
+        VERIFY_TRUE(result == expected);
+    }
+
+    void TestWkb::TestInvalidTwkb () {
+        const unsigned char bytes [] = { 0x02, 0x00, 0x02, 0x02, 0x02, 0x08, 0x08 };
+        std::vector <twkb::linestring> lines;
+        // truncated
+        VERIFY_TRUE(twkb::parse (bytes, bytes + 6, lines) == 0);
+        VERIFY_TRUE(twkb::parse (bytes, bytes + 1, lines) == 0);
+        // unsupported type (point)
+        const unsigned char point [] = { 0x01, 0x00, 0x02, 0x02 };
+        VERIFY_TRUE(twkb::parse (point, point + sizeof (point), lines) == 0);
+        VERIFY_TRUE(lines.empty ());
+
+        // MULTILINESTRING((1 1, 5 5), (6 6, 8 8)), parts in front of a truncated part are not appended
+        const unsigned char multi [] = { 0x05, 0x00, 0x02, 0x02, 0x02, 0x02, 0x08, 0x08, 0x02, 0x02, 0x02, 0x04, 0x04 };
+        VERIFY_TRUE(twkb::parse (multi, multi + sizeof (multi), lines) == multi + sizeof (multi));
+        VERIFY_TRUE(lines.size () == 2);
+        lines.clear ();
+        VERIFY_TRUE(twkb::parse (multi, multi + sizeof (multi) - 1, lines) == 0);
+        VERIFY_TRUE(lines.empty ());
+    }
+
+    // the writers preserve the dimensions of a parsed LineString, including XYM
+    void TestWkb::TestDimensions () {
+        std::vector <double> coords = RandomWalk <double, 3> (5, 10, false);
+        std::vector <unsigned char> bytes;
+        bytes.push_back (wkb::NDR);
+        Append (bytes, uint32_t (2002), true);
+        Append (bytes, uint32_t (5), true);
+        for (std::size_t c = 0; c < coords.size (); ++c) {
+            Append (bytes, coords [c], true);
+        }
+        std::vector <wkb::linestring> lines;
+        ASSERT_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines));
+        VERIFY_TRUE(lines [0].dimension () == 3);
+        VERIFY_TRUE(!lines [0].has_z ());
+        VERIFY_TRUE(lines [0].has_m ());
+        {
+            std::vector <unsigned char> written;
+            wkb::writer writer (written, lines [0]);
+            std::copy (coords.begin (), coords.end (), writer.begin_linestring ());
+            VERIFY_TRUE(writer.end_linestring ());
+            VERIFY_TRUE(written == bytes);
+        }
+
+        // LINESTRING M (1 1 3, 5 5 7), m with 1 decimal
+        const unsigned char twkbBytes [] = { 0x02, 0x08, 0x22, 0x02, 0x02, 0x02, 0x3C, 0x08, 0x08, 0x50 };
+        std::vector <twkb::linestring> twkbLines;
+        ASSERT_TRUE(twkb::parse (twkbBytes, twkbBytes + sizeof (twkbBytes), twkbLines));
+        VERIFY_TRUE(twkbLines [0].dimension () == 3);
+        VERIFY_TRUE(!twkbLines [0].has_z ());
+        VERIFY_TRUE(twkbLines [0].has_m ());
+        VERIFY_TRUE(twkbLines [0].m_precision () == 1);
+        std::vector <double> decoded (twkbLines [0].begin (), twkbLines [0].end ());
+        const double expected [] = { 1, 1, 3, 5, 5, 7 };
+        VERIFY_TRUE(decoded == std::vector <double> (expected, expected + 6));
+        {
+            std::vector <unsigned char> written;
+            twkb::writer writer (written, twkbLines [0]);
+            std::copy (decoded.begin (), decoded.end (), writer.begin_linestring ());
+            VERIFY_TRUE(writer.end_linestring ());
+            VERIFY_TRUE(written == std::vector <unsigned char> (twkbBytes, twkbBytes + sizeof (twkbBytes)));
+        }
+    }
+
+    // LineStrings that end with an incomplete point are rejected, and leave no trace
+    void TestWkb::TestIncompletePoints () {
+        const double coords [] = { 1, 1, 5, 5, 6 };
+
+        std::vector <unsigned char> bytes;
+        {
+            wkb::writer writer (bytes, 2);
+            std::copy (coords, coords + 5, writer.begin_linestring ());
+            VERIFY_TRUE(!writer.end_linestring ());
+            VERIFY_TRUE(bytes.empty ());
+
+            writer.begin_multi ();
+            std::copy (coords, coords + 4, writer.begin_linestring ());
+            VERIFY_TRUE(writer.end_linestring ());
+            std::copy (coords, coords + 5, writer.begin_linestring ());
+            VERIFY_TRUE(!writer.end_linestring ());
+            writer.end_multi ();
+        }
+        std::vector <wkb::linestring> lines;
+        VERIFY_TRUE(wkb::parse (&bytes [0], &bytes [0] + bytes.size (), lines) == &bytes [0] + bytes.size ());
+        VERIFY_TRUE(lines.size () == 1);
+
+        // the deltas of the next part do not include the rejected part
+        std::vector <unsigned char> twkbBytes;
+        {
+            twkb::writer writer (twkbBytes, 2, 0);
+            writer.begin_multi ();
+            std::copy (coords, coords + 4, writer.begin_linestring ());
+            VERIFY_TRUE(writer.end_linestring ());
+            std::copy (coords, coords + 5, writer.begin_linestring ());
+            VERIFY_TRUE(!writer.end_linestring ());
+            std::copy (coords, coords + 4, writer.begin_linestring ());
+            VERIFY_TRUE(writer.end_linestring ());
+            writer.end_multi ();
+        }
+        std::vector <twkb::linestring> twkbLines;
+        VERIFY_TRUE(twkb::parse (&twkbBytes [0], &twkbBytes [0] + twkbBytes.size (), twkbLines) ==
+                    &twkbBytes [0] + twkbBytes.size ());
+        ASSERT_TRUE(twkbLines.size () == 2);
+        VERIFY_TRUE(std::vector <double> (twkbLines [1].begin (), twkbLines [1].end ()) ==
+                    std::vector <double> (coords, coords + 4));
+    }
+}}
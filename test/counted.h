@@ -0,0 +1,198 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#ifndef PSIMPL_COUNTED
+#define PSIMPL_COUNTED
+
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+
+namespace psimpl {
+    namespace test
+{
+    /*!
+        \brief Number of operations performed on Counted values and CountingIterators.
+    */
+    struct OperationCounts {
+        OperationCounts () { Reset (); }
+
+        void Reset () {
+            additions = multiplications = divisions = comparisons = copies = 0;
+            increments = dereferences = iteratorCopies = 0;
+        }
+
+        //! \brief Returns the number of arithmetic operations.
+        std::size_t Arithmetic () const {
+            return additions + multiplications + divisions;
+        }
+
+        std::size_t additions;          //!< additions, subtractions and negations
+        std::size_t multiplications;    //!< multiplications
+        std::size_t divisions;          //!< divisions
+        std::size_t comparisons;        //!< comparisons
+        std::size_t copies;             //!< copy constructions and assignments of values
+        std::size_t increments;         //!< iterator increments, decrements and advances
+        std::size_t dereferences;       //!< iterator dereferences
+        std::size_t iteratorCopies;     //!< iterator copy constructions and assignments
+    };
+
+    //! \brief Returns the global operation counts.
+    inline OperationCounts& Counts () {
+        static OperationCounts counts;
+        return counts;
+    }
+
+    /*!
+        \brief Numeric value type that counts all operations performed on it.
+
+        Use as the value type of a polyline to verify the complexity of an algorithm, independent
+        of timings. Conversion to other types is explicit, as algorithms should not depend on it
+        other than for deliberate (integer safe) divisions.
+    */
+    template <class T>
+    class Counted {
+    public:
+        Counted () : mValue () {}
+        Counted (T value) : mValue (value) {}
+        Counted (const Counted& other) : mValue (other.mValue) { ++Counts ().copies; }
+
+        Counted& operator = (const Counted& other) {
+            ++Counts ().copies;
+            mValue = other.mValue;
+            return *this;
+        }
+
+        template <class U>
+        explicit operator U () const { return static_cast <U> (mValue); }
+
+        T Value () const { return mValue; }
+
+        Counted& operator += (const Counted& other) { ++Counts ().additions; mValue += other.mValue; return *this; }
+        Counted& operator -= (const Counted& other) { ++Counts ().additions; mValue -= other.mValue; return *this; }
+        Counted& operator *= (const Counted& other) { ++Counts ().multiplications; mValue *= other.mValue; return *this; }
+        Counted& operator /= (const Counted& other) { ++Counts ().divisions; mValue /= other.mValue; return *this; }
+
+        friend Counted operator + (const Counted& a, const Counted& b) { ++Counts ().additions; return Counted (a.mValue + b.mValue); }
+        friend Counted operator - (const Counted& a, const Counted& b) { ++Counts ().additions; return Counted (a.mValue - b.mValue); }
+        friend Counted operator * (const Counted& a, const Counted& b) { ++Counts ().multiplications; return Counted (a.mValue * b.mValue); }
+        friend Counted operator / (const Counted& a, const Counted& b) { ++Counts ().divisions; return Counted (a.mValue / b.mValue); }
+        friend Counted operator - (const Counted& a) { ++Counts ().additions; return Counted (-a.mValue); }
+
+        friend bool operator == (const Counted& a, const Counted& b) { ++Counts ().comparisons; return a.mValue == b.mValue; }
+        friend bool operator != (const Counted& a, const Counted& b) { ++Counts ().comparisons; return a.mValue != b.mValue; }
+        friend bool operator < (const Counted& a, const Counted& b) { ++Counts ().comparisons; return a.mValue < b.mValue; }
+        friend bool operator <= (const Counted& a, const Counted& b) { ++Counts ().comparisons; return a.mValue <= b.mValue; }
+        friend bool operator > (const Counted& a, const Counted& b) { ++Counts ().comparisons; return a.mValue > b.mValue; }
+        friend bool operator >= (const Counted& a, const Counted& b) { ++Counts ().comparisons; return a.mValue >= b.mValue; }
+
+    private:
+        T mValue;   //!< the actual value
+    };
+
+    /*!
+        \brief Iterator adaptor that counts increments, dereferences and copies.
+
+        Models the same iterator category as the adapted iterator.
+    */
+    template <class Iterator>
+    class CountingIterator {
+    public:
+        typedef typename std::iterator_traits <Iterator>::iterator_category iterator_category;
+        typedef typename std::iterator_traits <Iterator>::value_type value_type;
+        typedef typename std::iterator_traits <Iterator>::difference_type difference_type;
+        typedef typename std::iterator_traits <Iterator>::pointer pointer;
+        typedef typename std::iterator_traits <Iterator>::reference reference;
+
+        CountingIterator () : mIterator () {}
+        explicit CountingIterator (Iterator iterator) : mIterator (iterator) {}
+        CountingIterator (const CountingIterator& other) : mIterator (other.mIterator) { ++Counts ().iteratorCopies; }
+
+        CountingIterator& operator = (const CountingIterator& other) {
+            ++Counts ().iteratorCopies;
+            mIterator = other.mIterator;
+            return *this;
+        }
+
+        Iterator Base () const { return mIterator; }
+
+        reference operator * () const { ++Counts ().dereferences; return *mIterator; }
+        pointer operator -> () const { ++Counts ().dereferences; return &*mIterator; }
+        reference operator [] (difference_type n) const { ++Counts ().dereferences; return mIterator [n]; }
+
+        CountingIterator& operator ++ () { ++Counts ().increments; ++mIterator; return *this; }
+        CountingIterator& operator -- () { ++Counts ().increments; --mIterator; return *this; }
+        CountingIterator operator ++ (int) { CountingIterator copy (*this); ++*this; return copy; }
+        CountingIterator operator -- (int) { CountingIterator copy (*this); --*this; return copy; }
+        CountingIterator& operator += (difference_type n) { ++Counts ().increments; mIterator += n; return *this; }
+        CountingIterator& operator -= (difference_type n) { ++Counts ().increments; mIterator -= n; return *this; }
+
+        friend CountingIterator operator + (CountingIterator it, difference_type n) { return it += n; }
+        friend CountingIterator operator + (difference_type n, CountingIterator it) { return it += n; }
+        friend CountingIterator operator - (CountingIterator it, difference_type n) { return it -= n; }
+        friend difference_type operator - (const CountingIterator& a, const CountingIterator& b) { return a.mIterator - b.mIterator; }
+
+        friend bool operator == (const CountingIterator& a, const CountingIterator& b) { return a.mIterator == b.mIterator; }
+        friend bool operator != (const CountingIterator& a, const CountingIterator& b) { return a.mIterator != b.mIterator; }
+        friend bool operator < (const CountingIterator& a, const CountingIterator& b) { return a.mIterator < b.mIterator; }
+        friend bool operator <= (const CountingIterator& a, const CountingIterator& b) { return a.mIterator <= b.mIterator; }
+        friend bool operator > (const CountingIterator& a, const CountingIterator& b) { return a.mIterator > b.mIterator; }
+        friend bool operator >= (const CountingIterator& a, const CountingIterator& b) { return a.mIterator >= b.mIterator; }
+
+    private:
+        Iterator mIterator;     //!< the adapted iterator
+    };
+
+    //! \brief Adapts an iterator.
+    template <class Iterator>
+    CountingIterator <Iterator> make_counting_iterator (Iterator iterator) {
+        return CountingIterator <Iterator> (iterator);
+    }
+}}
+
+
+namespace std {
+    template <class T>
+    class numeric_limits <psimpl::test::Counted <T> > : public numeric_limits <T> {
+    public:
+        static psimpl::test::Counted <T> min () { return numeric_limits <T>::min (); }
+        static psimpl::test::Counted <T> max () { return numeric_limits <T>::max (); }
+        static psimpl::test::Counted <T> lowest () { return numeric_limits <T>::lowest (); }
+        static psimpl::test::Counted <T> epsilon () { return numeric_limits <T>::epsilon (); }
+    };
+}
+
+
+#endif // PSIMPL_COUNTED
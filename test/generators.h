@@ -0,0 +1,457 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is
+ * 'psimpl - generic n-dimensional polyline simplification'.
+ *
+ * The Initial Developer of the Original Code is
+ * Elmar de Koning.
+ * Portions created by the Initial Developer are Copyright (C) 2010-2011
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/*
+    psimpl - generic n-dimensional polyline simplification
+    Copyright (C) 2010-2011 Elmar de Koning, edekoning@gmail.com
+
+    This file is part of psimpl, and is hosted at SourceForge:
+    http://sourceforge.net/projects/psimpl/
+*/
+
+#ifndef PSIMPL_GENERATORS
+#define PSIMPL_GENERATORS
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+
+namespace psimpl {
+    namespace test
+{
+    /*!
+        \brief SplitMix64 pseudo random number generator.
+
+        Small, fast and fully deterministic across platforms, so that each seed always produces
+        the same workload.
+    */
+    class SplitMix64 {
+    public:
+        explicit SplitMix64 (unsigned long long seed = 0) :
+            mState (seed)
+        {}
+
+        //! \brief Returns the next 64 random bits.
+        unsigned long long Next () {
+            unsigned long long z = (mState += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        //! \brief Returns a uniform random number in [0, 1).
+        double Uniform () {
+            return (Next () >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        //! \brief Returns a normal distributed random number (Box-Muller).
+        double Normal (double sigma = 1) {
+            double u1 = 1 - Uniform ();     // (0, 1]
+            double u2 = Uniform ();
+            return sigma * std::sqrt (-2 * std::log (u1)) * std::cos (6.283185307179586 * u2);
+        }
+
+    private:
+        unsigned long long mState;  //!< the generator state
+    };
+
+    /*!
+        \brief Generates a smooth random walk, one point at a time.
+
+        The direction changes gradually, and each step is at most stepSize long per coordinate.
+    */
+    template <unsigned DIM>
+    class WalkGenerator {
+    public:
+        WalkGenerator (unsigned long long seed = 1, double stepSize = 10) :
+            mRandom (seed),
+            mStepSize (stepSize)
+        {
+            for (unsigned d = 0; d < DIM; ++d) {
+                mPosition [d] = mDirection [d] = 0;
+            }
+        }
+
+        void operator () (double* point) {
+            for (unsigned d = 0; d < DIM; ++d) {
+                mDirection [d] = 0.95 * mDirection [d] + 0.05 * (2 * mRandom.Uniform () - 1);
+                mPosition [d] += mDirection [d] * mStepSize;
+                point [d] = mPosition [d];
+            }
+        }
+
+    private:
+        SplitMix64 mRandom;         //!< random direction changes
+        double mStepSize;           //!< maximum step size per coordinate
+        double mPosition [DIM];     //!< the current point
+        double mDirection [DIM];    //!< the current direction
+    };
+
+    /*!
+        \brief Generates an archimedean spiral, one point at a time.
+
+        The radius grows by spacing each turn. For DIM > 2 the third coordinate rises by spacing
+        each turn (a conical helix), further coordinates are 0. Dense spirals result in deep
+        Douglas-Peucker recursions.
+    */
+    template <unsigned DIM>
+    class SpiralGenerator {
+    public:
+        SpiralGenerator (unsigned pointsPerTurn = 100, double spacing = 10) :
+            mPointsPerTurn (pointsPerTurn),
+            mSpacing (spacing),
+            mIndex (0)
+        {}
+
+        void operator () (double* point) {
+            double turns = static_cast <double> (mIndex++) / mPointsPerTurn;
+            double angle = 6.283185307179586 * turns;
+            double radius = mSpacing * turns;
+            point [0] = radius * std::cos (angle);
+            if (DIM > 1) {
+                point [1] = radius * std::sin (angle);
+            }
+            for (unsigned d = 2; d < DIM; ++d) {
+                point [d] = d == 2 ? mSpacing * turns : 0;
+            }
+        }
+
+    private:
+        unsigned mPointsPerTurn;    //!< number of points per turn
+        double mSpacing;            //!< distance between turns
+        std::size_t mIndex;         //!< index of the current point
+    };
+
+    /*!
+        \brief Generates a GPS track with measurement noise, one point at a time.
+
+        The track is nearly straight: its heading changes very slowly, while each point is
+        displaced by normal distributed noise. With a tolerance of a few sigma all points are
+        nearly collinear, which is a common input for RD, PD and RW.
+    */
+    template <unsigned DIM>
+    class GpsGenerator {
+    public:
+        GpsGenerator (unsigned long long seed = 1, double stepSize = 10, double sigma = 0.5) :
+            mRandom (seed),
+            mStepSize (stepSize),
+            mSigma (sigma),
+            mHeading (0),
+            mTurnRate (0)
+        {
+            for (unsigned d = 0; d < DIM; ++d) {
+                mPosition [d] = 0;
+            }
+        }
+
+        void operator () (double* point) {
+            mTurnRate = 0.99 * mTurnRate + 0.0001 * mRandom.Normal ();
+            mHeading += mTurnRate;
+            mPosition [0] += mStepSize * std::cos (mHeading);
+            if (DIM > 1) {
+                mPosition [1] += mStepSize * std::sin (mHeading);
+            }
+            for (unsigned d = 0; d < DIM; ++d) {
+                point [d] = mPosition [d] + mRandom.Normal (mSigma);
+            }
+        }
+
+    private:
+        SplitMix64 mRandom;         //!< heading changes and noise
+        double mStepSize;           //!< distance between successive points
+        double mSigma;              //!< standard deviation of the noise
+        double mHeading;            //!< the current heading, in radians
+        double mTurnRate;           //!< the current change of heading per point
+        double mPosition [DIM];     //!< the current exact position
+    };
+
+    /*!
+        \brief Generates the Douglas-Peucker worst case zig-zag, one point at a time.
+
+        Points alternate above and below the x-axis, with an amplitude that decreases linearly
+        from amplitude to amplitude / 2. For each sub polyline the point next to its first point
+        is furthest away, so DP splits off a single point per step: O(n^2) distance
+        calculations and a recursion depth of n. This holds for any tolerance below amplitude / 4,
+        as long as stepSize is not smaller than amplitude.
+    */
+    template <unsigned DIM>
+    class ZigZagGenerator {
+    public:
+        ZigZagGenerator (std::size_t count, double stepSize = 10, double amplitude = 10) :
+            mCount (count),
+            mStepSize (stepSize),
+            mAmplitude (amplitude),
+            mIndex (0)
+        {}
+
+        void operator () (double* point) {
+            double amplitude = mAmplitude * (1 - 0.5 * mIndex / static_cast <double> (mCount));
+            point [0] = mStepSize * mIndex;
+            if (DIM > 1) {
+                point [1] = mIndex % 2 ? -amplitude : amplitude;
+            }
+            for (unsigned d = 2; d < DIM; ++d) {
+                point [d] = 0;
+            }
+            ++mIndex;
+        }
+
+    private:
+        std::size_t mCount;         //!< total number of points
+        double mStepSize;           //!< distance between points along the x-axis
+        double mAmplitude;          //!< initial amplitude
+        std::size_t mIndex;         //!< index of the current point
+    };
+
+    /*!
+        \brief Generates a fractal coastline using midpoint displacement, one point at a time.
+
+        The segment from the origin to (count * stepSize, 0) is recursively subdivided, and each
+        midpoint is displaced perpendicular to its segment by a normal distributed amount that is
+        proportional to the segment length. Subdivision happens depth first, so only O(log n)
+        segments are stored. Detail is present at every scale, as in real coastlines. The first
+        count points of the subdivision are generated.
+    */
+    template <unsigned DIM>
+    class CoastlineGenerator {
+    public:
+        CoastlineGenerator (std::size_t count, unsigned long long seed = 1, double stepSize = 10,
+                            double roughness = 0.3) :
+            mRandom (seed),
+            mRoughness (roughness)
+        {
+            unsigned levels = 0;
+            while ((std::size_t (1) << levels) + 1 < count) {
+                ++levels;
+            }
+            Segment segment;
+            for (unsigned d = 0; d < DIM; ++d) {
+                segment.first [d] = segment.last [d] = 0;
+            }
+            segment.last [0] = stepSize * (std::size_t (1) << levels);
+            segment.levels = levels;
+            mStack.push_back (segment);
+        }
+
+        void operator () (double* point) {
+            if (mStack.empty ()) {
+                // the last point of the coastline
+                std::copy (mLast, mLast + DIM, point);
+                return;
+            }
+            while (mStack.back ().levels) {
+                Segment segment = mStack.back ();
+                mStack.pop_back ();
+                Segment left = segment;
+                Segment right = segment;
+                left.levels = right.levels = segment.levels - 1;
+                Midpoint (segment, left.last);
+                std::copy (left.last, left.last + DIM, right.first);
+                mStack.push_back (right);
+                mStack.push_back (left);
+            }
+            std::copy (mStack.back ().first, mStack.back ().first + DIM, point);
+            std::copy (mStack.back ().last, mStack.back ().last + DIM, mLast);
+            mStack.pop_back ();
+        }
+
+    private:
+        struct Segment {
+            double first [DIM];     //!< the first point
+            double last [DIM];      //!< the last point
+            unsigned levels;        //!< number of remaining subdivisions
+        };
+
+        //! \brief Computes the displaced midpoint of a segment.
+        void Midpoint (const Segment& segment, double* midpoint) {
+            double dx = segment.last [0] - segment.first [0];
+            double dy = DIM > 1 ? segment.last [1] - segment.first [1] : 0;
+            double offset = mRandom.Normal (mRoughness);
+            for (unsigned d = 0; d < DIM; ++d) {
+                midpoint [d] = (segment.first [d] + segment.last [d]) / 2;
+            }
+            // perpendicular to the segment in the xy-plane
+            midpoint [0] -= offset * dy;
+            if (DIM > 1) {
+                midpoint [1] += offset * dx;
+            }
+        }
+
+        SplitMix64 mRandom;                 //!< midpoint displacements
+        double mRoughness;                  //!< displacement relative to the segment length
+        std::vector <Segment> mStack;       //!< segments that still need to be generated
+        double mLast [DIM];                 //!< the last point of the most recent segment
+    };
+
+    /*!
+        \brief Generates a track with long static dwell periods, one point at a time.
+
+        The track alternates between moveCount moving points and dwellCount points that stay at
+        the same position, optionally displaced by normal distributed noise. Without noise the
+        dwell points are exact duplicates.
+    */
+    template <unsigned DIM>
+    class DwellGenerator {
+    public:
+        DwellGenerator (unsigned long long seed = 1, unsigned moveCount = 100, unsigned dwellCount = 1000,
+                        double stepSize = 10, double sigma = 0) :
+            mWalk (seed, stepSize),
+            mRandom (seed + 1),
+            mMoveCount (moveCount),
+            mDwellCount (dwellCount),
+            mSigma (sigma),
+            mIndex (0)
+        {}
+
+        void operator () (double* point) {
+            if (mIndex % (mMoveCount + mDwellCount) < mMoveCount) {
+                mWalk (mPosition);
+            }
+            for (unsigned d = 0; d < DIM; ++d) {
+                point [d] = mPosition [d] + (mSigma > 0 ? mRandom.Normal (mSigma) : 0);
+            }
+            ++mIndex;
+        }
+
+    private:
+        WalkGenerator <DIM> mWalk;  //!< movement between dwell periods
+        SplitMix64 mRandom;         //!< noise
+        unsigned mMoveCount;        //!< number of moving points per period
+        unsigned mDwellCount;       //!< number of static points per period
+        double mSigma;              //!< standard deviation of the noise
+        std::size_t mIndex;         //!< index of the current point
+        double mPosition [DIM];     //!< the current position
+    };
+
+    /*!
+        \brief Forward iterator over the coordinates of a generated polyline.
+
+        Points are generated lazily, so arbitrarily large inputs take constant memory. Copies of
+        an iterator hold a copy of the generator state, and therefore replay the same points.
+        Dereferencing returns a value, and not a reference.
+    */
+    template <unsigned DIM, class T, class Generator>
+    class GeneratedIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef T reference;
+
+        GeneratedIterator (const Generator& generator, std::size_t pointCount, std::size_t point) :
+            mGenerator (generator),
+            mPointCount (pointCount),
+            mPoint (point),
+            mCoord (0)
+        {
+            if (mPoint < mPointCount) {
+                mGenerator (mCoords);
+            }
+        }
+
+        T operator * () const {
+            return static_cast <T> (mCoords [mCoord]);
+        }
+
+        GeneratedIterator& operator ++ () {
+            if (++mCoord == DIM) {
+                mCoord = 0;
+                if (++mPoint < mPointCount) {
+                    mGenerator (mCoords);
+                }
+            }
+            return *this;
+        }
+
+        GeneratedIterator operator ++ (int) {
+            GeneratedIterator copy (*this);
+            ++*this;
+            return copy;
+        }
+
+        bool operator == (const GeneratedIterator& other) const {
+            return mPoint == other.mPoint && mCoord == other.mCoord;
+        }
+
+        bool operator != (const GeneratedIterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        Generator mGenerator;       //!< state for the next point
+        std::size_t mPointCount;    //!< total number of points
+        std::size_t mPoint;         //!< index of the current point
+        unsigned mCoord;            //!< index of the current coordinate
+        double mCoords [DIM];       //!< the current point
+    };
+
+    /*!
+        \brief A lazily generated polyline of pointCount points.
+    */
+    template <unsigned DIM, class T, class Generator>
+    class GeneratedPolyline {
+    public:
+        typedef GeneratedIterator <DIM, T, Generator> const_iterator;
+
+        GeneratedPolyline (const Generator& generator, std::size_t pointCount) :
+            mGenerator (generator),
+            mPointCount (pointCount)
+        {}
+
+        const_iterator begin () const {
+            return const_iterator (mGenerator, mPointCount, 0);
+        }
+
+        const_iterator end () const {
+            return const_iterator (mGenerator, mPointCount, mPointCount);
+        }
+
+        //! \brief Generates all coordinates at once.
+        std::vector <T> ToVector () const {
+            std::vector <T> coords;
+            coords.reserve (mPointCount * DIM);
+            coords.assign (begin (), end ());
+            return coords;
+        }
+
+    private:
+        Generator mGenerator;       //!< state for the first point
+        std::size_t mPointCount;    //!< number of points
+    };
+
+    //! \brief Generates pointCount points at once.
+    template <unsigned DIM, class T, class Generator>
+    std::vector <T> Generate (const Generator& generator, std::size_t pointCount) {
+        return GeneratedPolyline <DIM, T, Generator> (generator, pointCount).ToVector ();
+    }
+}}
+
+
+#endif // PSIMPL_GENERATORS
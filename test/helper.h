@@ -239,6 +239,24 @@ namespace psimpl {
         return true;
     }
 
+    //! \brief pseudo random polyline; smooth lines change direction slowly, noisy lines randomly
+    template <typename T, unsigned DIM>
+    std::vector <T> RandomWalk (unsigned count, unsigned seed, bool smooth) {
+        std::vector <T> polyline;
+        double position [DIM] = {0};
+        double direction [DIM] = {0};
+        for (unsigned p = 0; p < count; ++p) {
+            for (unsigned d = 0; d < DIM; ++d) {
+                seed = seed * 1103515245u + 12345u;
+                double random = ((seed >> 8) % 2001) / 1000.0 - 1.0;
+                direction [d] = smooth ? 0.95 * direction [d] + 0.05 * random : random;
+                position [d] += direction [d];
+                polyline.push_back (static_cast <T> (position [d]));
+            }
+        }
+        return polyline;
+    }
+
 }}
 
 #endif // PSIMPL_HELPER
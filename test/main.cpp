@@ -36,6 +36,22 @@
 #include "TestMath.h"
 #include "TestSimplification.h"
 #include "TestError.h"
+#include "TestBinary.h"
+#include "TestEncode.h"
+#include "TestWkb.h"
+#include "TestProgressive.h"
+#include "TestTiles.h"
+#include "TestLod.h"
+#include "TestIncremental.h"
+#include "TestGenerators.h"
+#include "TestComplexity.h"
+#include "TestStats.h"
+#include "TestCancel.h"
+#include "TestAsync.h"
+#include "TestGenerator.h"
+#include "TestParallel.h"
+#include "TestCli.h"
+#include "TestCapi.h"
 
 
 int main (int /*argc*/, char * /*argv*/ [])
@@ -46,6 +62,22 @@ int main (int /*argc*/, char * /*argv*/ [])
     TEST_RUN("math namspace", psimpl::test::TestMath ());
     TEST_RUN("simplification algorithms", psimpl::test::TestSimplification ());
     TEST_RUN("error algorithms", psimpl::test::TestError ());
+    TEST_RUN("binary files", psimpl::test::TestBinary ());
+    TEST_RUN("encoding", psimpl::test::TestEncode ());
+    TEST_RUN("wkb", psimpl::test::TestWkb ());
+    TEST_RUN("progressive encoding", psimpl::test::TestProgressive ());
+    TEST_RUN("tile pyramid", psimpl::test::TestTiles ());
+    TEST_RUN("level of detail", psimpl::test::TestLod ());
+    TEST_RUN("incremental simplification", psimpl::test::TestIncremental ());
+    TEST_RUN("workload generators", psimpl::test::TestGenerators ());
+    TEST_RUN("complexity", psimpl::test::TestComplexity ());
+    TEST_RUN("instrumentation", psimpl::test::TestStats ());
+    TEST_RUN("cancellation", psimpl::test::TestCancel ());
+    TEST_RUN("asynchronous simplification", psimpl::test::TestAsync ());
+    TEST_RUN("lazy simplification", psimpl::test::TestGenerator ());
+    TEST_RUN("parallel simplification", psimpl::test::TestParallel ());
+    TEST_RUN("command line tool", psimpl::test::TestCli ());
+    TEST_RUN("c interface", psimpl::test::TestCapi ());
 
     return TEST_RESULT();
 }
@@ -0,0 +1,12 @@
+# -------------------------------------------------
+# psimpl-test built as C++20, which also runs the
+# coroutine tests of TestGenerator (psimpl_generator.h)
+# -------------------------------------------------
+include(psimpl.pro)
+
+TARGET = psimpl-test-cxx20
+CONFIG -= c++11
+CONFIG += c++2a
+
+# gcc 10 only enables coroutines on request
+*-g++*:QMAKE_CXXFLAGS += -fcoroutines
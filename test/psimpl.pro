@@ -3,7 +3,8 @@
 # -------------------------------------------------
 TARGET = psimpl-test
 TEMPLATE = app
-CONFIG += console
+CONFIG += console c++11 thread
+DEFINES += PSIMPL_C_STATIC
 
 HEADERS += \
     TestUtil.h \
@@ -20,7 +21,43 @@ HEADERS += \
     TestOpheim.h \
     TestLang.h \
     TestDouglasPeucker.h \
-    TestReumannWitkam.h
+    TestReumannWitkam.h \
+    TestInplace.h \
+    TestOutOfCore.h \
+    ../lib/psimpl_mmap.h \
+    TestBinary.h \
+    ../lib/psimpl_binary.h \
+    TestEncode.h \
+    ../lib/psimpl_encode.h \
+    TestWkb.h \
+    ../lib/psimpl_wkb.h \
+    TestProgressive.h \
+    ../lib/psimpl_progressive.h \
+    TestTiles.h \
+    ../lib/psimpl_tiles.h \
+    TestLod.h \
+    ../lib/psimpl_lod.h \
+    TestIncremental.h \
+    ../lib/psimpl_incremental.h \
+    generators.h \
+    TestGenerators.h \
+    counted.h \
+    TestComplexity.h \
+    TestStats.h \
+    ../lib/psimpl_stats.h \
+    TestCancel.h \
+    ../lib/psimpl_cancel.h \
+    TestAsync.h \
+    ../lib/psimpl_async.h \
+    TestGenerator.h \
+    ../lib/psimpl_generator.h \
+    TestParallel.h \
+    ../lib/psimpl_parallel.h \
+    TestCli.h \
+    ../cli/Stages.h \
+    ../cli/Pipeline.h \
+    TestCapi.h \
+    ../capi/psimpl_c.h
 
 SOURCES += \
     TestRadialDistance.cpp \
@@ -34,4 +71,23 @@ SOURCES += \
     TestPerpendicularDistance.cpp \
     TestOpheim.cpp \
     TestLang.cpp \
-    TestDouglasPeucker.cpp
+    TestDouglasPeucker.cpp \
+    TestInplace.cpp \
+    TestOutOfCore.cpp \
+    TestBinary.cpp \
+    TestEncode.cpp \
+    TestWkb.cpp \
+    TestProgressive.cpp \
+    TestTiles.cpp \
+    TestLod.cpp \
+    TestIncremental.cpp \
+    TestGenerators.cpp \
+    TestComplexity.cpp \
+    TestStats.cpp \
+    TestCancel.cpp \
+    TestAsync.cpp \
+    TestGenerator.cpp \
+    TestParallel.cpp \
+    TestCli.cpp \
+    TestCapi.cpp \
+    ../capi/psimpl_c.cpp